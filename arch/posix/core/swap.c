@@ -61,6 +61,7 @@ int __swap(unsigned int key)
 		_kernel.current->callee_saved.thread_status;
 
 
+	z_sched_usage_switch();
 	_kernel.current = _kernel.ready_q.cache;
 
 	/*
@@ -95,6 +96,7 @@ void _arch_switch_to_main_thread(struct k_thread *main_thread,
 	posix_thread_status_t *ready_thread_ptr =
 			(posix_thread_status_t *)
 			_kernel.ready_q.cache->callee_saved.thread_status;
+	z_sched_usage_switch();
 	_kernel.current = _kernel.ready_q.cache;
 
 	posix_main_thread_start(ready_thread_ptr->thread_idx);
@@ -28,8 +28,27 @@ static isr_table_entry_t irq_vector_table[N_IRQS] = { { 0 } };
 
 static int currently_running_irq = -1;
 
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+static u64_t irq_cycles[N_IRQS];
+
+u64_t k_irq_runtime_cycles_get(unsigned int irq)
+{
+	if (irq >= N_IRQS) {
+		return 0;
+	}
+
+	return irq_cycles[irq];
+}
+#endif
+
 static inline void vector_to_irq(int irq_nbr, int *may_swap)
 {
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	struct z_isr_usage usage;
+
+	z_sched_usage_isr_enter(&usage);
+#endif
+
 	/*
 	 * As in this architecture an irq (code) executes in 0 time,
 	 * it is a bit senseless to call _int_latency_start/stop()
@@ -57,6 +76,10 @@ static inline void vector_to_irq(int irq_nbr, int *may_swap)
 			*may_swap = 1;
 		}
 	}
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	irq_cycles[irq_nbr] += z_sched_usage_isr_exit(&usage);
+#endif
 	/* _int_latency_stop(); */
 }
 
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Host performance counter, read from clock_gettime() or the x86 time
+ * stamp counter
+ */
+
+#include <time.h>
+#include "native_perf.h"
+
+#define NSEC_PER_SEC_HOST 1000000000ULL
+
+static u64_t host_ns(void)
+{
+	struct timespec tv;
+
+#if defined(CLOCK_MONOTONIC_RAW)
+	clock_gettime(CLOCK_MONOTONIC_RAW, &tv);
+#else
+	clock_gettime(CLOCK_MONOTONIC, &tv);
+#endif
+	return (u64_t)tv.tv_sec * NSEC_PER_SEC_HOST + tv.tv_nsec;
+}
+
+#if defined(CONFIG_NATIVE_POSIX_PERF_COUNTER_RDTSC)
+
+#if !defined(__i386__) && !defined(__x86_64__)
+#error "The time stamp counter needs an x86 host"
+#endif
+
+/* how long to count TSC cycles for to find their frequency */
+#define CALIBRATION_NS 10000000ULL
+
+static u64_t tsc_freq;
+
+u64_t native_perf_counter_get(void)
+{
+	u32_t lo, hi;
+
+	/* do not let rdtsc run ahead of the code being measured */
+	__asm__ __volatile__("lfence; rdtsc" : "=a"(lo), "=d"(hi));
+
+	return ((u64_t)hi << 32) | lo;
+}
+
+u64_t native_perf_counter_freq_get(void)
+{
+	if (tsc_freq == 0) {
+		u64_t tsc = native_perf_counter_get();
+		u64_t start = host_ns();
+		u64_t now;
+
+		do {
+			now = host_ns();
+		} while (now - start < CALIBRATION_NS);
+
+		tsc = native_perf_counter_get() - tsc;
+		tsc_freq = tsc * NSEC_PER_SEC_HOST / (now - start);
+	}
+
+	return tsc_freq;
+}
+
+#else
+
+u64_t native_perf_counter_get(void)
+{
+	return host_ns();
+}
+
+u64_t native_perf_counter_freq_get(void)
+{
+	return NSEC_PER_SEC_HOST;
+}
+
+#endif
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief API to the native_posix host performance counter
+ *
+ * The kernel's cycle counter on native_posix follows simulated time, which
+ * does not advance while code runs. This counter follows the host instead,
+ * so it tells how long code actually took to run.
+ */
+
+#ifndef _NATIVE_POSIX_PERF_H
+#define _NATIVE_POSIX_PERF_H
+
+#include "zephyr/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Read the host performance counter
+ *
+ * @return Counter value, counting at native_perf_counter_freq_get() Hz
+ */
+u64_t native_perf_counter_get(void);
+
+/**
+ * @brief Get the frequency of the host performance counter
+ *
+ * @return Counts per second
+ */
+u64_t native_perf_counter_freq_get(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _NATIVE_POSIX_PERF_H */
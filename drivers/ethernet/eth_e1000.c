@@ -37,6 +37,7 @@ static const char *e1000_reg_to_string(enum e1000_reg_t r)
 	_(TDLEN);
 	_(TDH);
 	_(TDT);
+	_(RXCSUM);
 	_(RAL);
 	_(RAH);
 	}
@@ -123,6 +124,15 @@ static struct net_pkt *e1000_rx(struct e1000_dev *dev)
 		dev_err("Out of memory for received frame");
 		net_pkt_unref(pkt);
 		pkt = NULL;
+		goto out;
+	}
+
+	/* Leave frames the hardware did not check, or found bad, to the
+	 * stack, which also counts the bad ones
+	 */
+	if ((dev->rx.sta & (RDESC_STA_TCPCS | RDESC_STA_IXSM)) ==
+	    RDESC_STA_TCPCS && !(dev->rx.err & RDESC_ERR_TCPE)) {
+		net_pkt_set_chksum_ok(pkt, true);
 	}
 out:
 	return pkt;
@@ -202,6 +212,8 @@ static void e1000_init(struct net_if *iface)
 	iow32(dev, RDH, 0);
 	iow32(dev, RDT, 1);
 
+	iow32(dev, RXCSUM, RXCSUM_TUOFL);
+
 	iow32(dev, RCTL, RCTL_EN);
 
 	iow32(dev, IMS, IMS_RXO);
@@ -25,7 +25,12 @@ extern "C" {
 #define TDESC_EOP	     (1) /* End Of Packet */
 #define TDESC_RS	(1 << 3) /* Report Status */
 
+#define RXCSUM_TUOFL	(1 << 9) /* TCP/UDP Checksum Offload Enable */
+
 #define RDESC_STA_DD	     (1) /* Descriptor Done */
+#define RDESC_STA_IXSM	(1 << 2) /* Ignore Checksum Indication */
+#define RDESC_STA_TCPCS	(1 << 5) /* TCP/UDP Checksum Calculated */
+#define RDESC_ERR_TCPE	(1 << 5) /* TCP/UDP Checksum Error */
 #define TDESC_STA_DD	     (1) /* Descriptor Done */
 
 #define E1000_MTU 1500
@@ -49,6 +54,7 @@ enum e1000_reg_t {
 	TDLEN	= 0x3808,	/* Tx Descriptor Length */
 	TDH	= 0x3810,	/* Tx Descriptor Head */
 	TDT	= 0x3818,	/* Tx Descriptor Tail */
+	RXCSUM	= 0x5000,	/* Rx Checksum Control */
 	RAL	= 0x5400,	/* Receive Address Low */
 	RAH	= 0x5404,	/* Receive Address High */
 };
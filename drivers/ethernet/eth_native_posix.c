@@ -42,14 +42,21 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 #define _ETH_MTU 1500
 #endif
 
-#define NET_BUF_TIMEOUT K_MSEC(100)
-
 #if defined(CONFIG_NET_VLAN)
 #define ETH_HDR_LEN sizeof(struct net_eth_vlan_hdr)
 #else
 #define ETH_HDR_LEN sizeof(struct net_eth_hdr)
 #endif
 
+#define ETH_FRAME_LEN (_ETH_MTU + ETH_HDR_LEN)
+
+/* Frames are read straight into network buffers, enough of them for the
+ * largest one are handed to the host at once.
+ */
+BUILD_ASSERT_MSG((ETH_FRAME_LEN + CONFIG_NET_BUF_DATA_SIZE - 1) /
+		 CONFIG_NET_BUF_DATA_SIZE <= ETH_NATIVE_POSIX_IOV_MAX,
+		 "CONFIG_NET_BUF_DATA_SIZE too small for a full frame");
+
 #if defined(CONFIG_NET_LLDP)
 static const struct net_lldpdu lldpdu = {
 	.chassis_id = {
@@ -80,8 +87,8 @@ static const struct net_lldpdu lldpdu = {
 #endif /* CONFIG_NET_LLDP */
 
 struct eth_context {
-	u8_t recv[_ETH_MTU + ETH_HDR_LEN];
-	u8_t send[_ETH_MTU + ETH_HDR_LEN];
+	/* Only for packets in more buffers than can be written at once */
+	u8_t send[ETH_FRAME_LEN];
 	u8_t mac_addr[6];
 	struct net_linkaddr ll_addr;
 	struct net_if *iface;
@@ -91,6 +98,15 @@ struct eth_context {
 	bool status;
 	bool promisc_mode;
 
+	/* Receiving is driven by a timer polling the host interface, which
+	 * stands in for the receive interrupt, and done by a softirq
+	 */
+	struct k_timer rx_poll;
+	struct k_softirq rx_softirq;
+
+	/* Buffers the next frame is read into, left over from the last one */
+	struct net_buf *rx_frags;
+
 #if defined(CONFIG_NET_STATISTICS_ETHERNET)
 	struct net_stats_eth stats;
 #endif
@@ -99,11 +115,6 @@ struct eth_context {
 #endif
 };
 
-NET_STACK_DEFINE(RX_ZETH, eth_rx_stack,
-		 CONFIG_ARCH_POSIX_RECOMMENDED_STACK_SIZE,
-		 CONFIG_ARCH_POSIX_RECOMMENDED_STACK_SIZE);
-static struct k_thread rx_thread_data;
-
 /* TODO: support multiple interfaces */
 static struct eth_context eth_context_data;
 
@@ -208,21 +219,50 @@ static void update_gptp(struct net_if *iface, struct net_pkt *pkt,
 static int eth_send(struct net_if *iface, struct net_pkt *pkt)
 {
 	struct eth_context *ctx = get_context(iface);
+	struct eth_iovec iov[ETH_NATIVE_POSIX_IOV_MAX];
 	struct net_buf *frag;
+	int iovcnt = 1;
 	int count = 0;
 	int ret;
 
 	/* First fragment contains link layer (Ethernet) headers.
 	 */
-	count = net_pkt_ll_reserve(pkt) + pkt->frags->len;
-	memcpy(ctx->send, net_pkt_ll(pkt), count);
+	iov[0].base = net_pkt_ll(pkt);
+	iov[0].len = net_pkt_ll_reserve(pkt) + pkt->frags->len;
+	count = iov[0].len;
+
+	/* Then the remaining data, written from where it is */
+	for (frag = pkt->frags->frags; frag; frag = frag->frags) {
+		if (iovcnt == ETH_NATIVE_POSIX_IOV_MAX) {
+			break;
+		}
 
-	/* Then the remaining data */
-	frag = pkt->frags->frags;
-	while (frag) {
-		memcpy(ctx->send + count, frag->data, frag->len);
+		iov[iovcnt].base = frag->data;
+		iov[iovcnt].len = frag->len;
+		iovcnt++;
 		count += frag->len;
-		frag = frag->frags;
+	}
+
+	/* Unless there is too much of it */
+	if (frag) {
+		count = 0;
+
+		for (frag = pkt->frags; frag; frag = frag->frags) {
+			u8_t *data = frag->data;
+			u16_t len = frag->len;
+
+			if (frag == pkt->frags) {
+				data = net_pkt_ll(pkt);
+				len += net_pkt_ll_reserve(pkt);
+			}
+
+			memcpy(ctx->send + count, data, len);
+			count += len;
+		}
+
+		iov[0].base = ctx->send;
+		iov[0].len = count;
+		iovcnt = 1;
 	}
 
 	eth_stats_update_bytes_tx(iface, count);
@@ -243,7 +283,7 @@ static int eth_send(struct net_if *iface, struct net_pkt *pkt)
 
 	LOG_DBG("Send pkt %p len %d", pkt, count);
 
-	ret = eth_write_data(ctx->dev_fd, ctx->send, count);
+	ret = eth_write_iov(ctx->dev_fd, iov, iovcnt);
 	if (ret < 0) {
 		LOG_DBG("Cannot send pkt %p (%d)", pkt, ret);
 	} else {
@@ -288,38 +328,69 @@ static inline struct net_if *get_iface(struct eth_context *ctx,
 
 static int read_data(struct eth_context *ctx, int fd)
 {
+	struct eth_iovec iov[ETH_NATIVE_POSIX_IOV_MAX];
 	u16_t vlan_tag = NET_VLAN_TAG_UNSPEC;
-	int count = 0;
+	struct net_buf *frag, *last = NULL;
 	struct net_if *iface;
 	struct net_pkt *pkt;
-	struct net_buf *frag;
+	size_t room = 0;
+	int iovcnt = 0;
 	u32_t pkt_len;
 	int ret;
 
-	ret = eth_read_data(fd, ctx->recv, sizeof(ctx->recv));
-	if (ret <= 0) {
-		return 0;
-	}
-
-	pkt = net_pkt_get_reserve_rx(0, NET_BUF_TIMEOUT);
+	/* Leave the frame with the host when out of buffers, rather than
+	 * reading it only to drop it. Softirq handlers must not block.
+	 */
+	pkt = net_pkt_get_reserve_rx(0, K_NO_WAIT);
 	if (!pkt) {
 		return -ENOMEM;
 	}
 
-	do {
-		frag = net_pkt_get_frag(pkt, NET_BUF_TIMEOUT);
+	/* Top up the buffers left over from the last frame so that they
+	 * can take the largest one
+	 */
+	for (frag = ctx->rx_frags; room < ETH_FRAME_LEN; frag = frag->frags) {
 		if (!frag) {
-			net_pkt_unref(pkt);
-			return -ENOMEM;
+			frag = net_pkt_get_frag(pkt, K_NO_WAIT);
+			if (!frag) {
+				net_pkt_unref(pkt);
+				return -ENOMEM;
+			}
+
+			if (last) {
+				net_buf_frag_insert(last, frag);
+			} else {
+				ctx->rx_frags = frag;
+			}
 		}
 
-		net_pkt_frag_add(pkt, frag);
+		iov[iovcnt].base = frag->data;
+		iov[iovcnt].len = net_buf_tailroom(frag);
+		room += iov[iovcnt].len;
+		iovcnt++;
+		last = frag;
+	}
+
+	ret = eth_read_iov(fd, iov, iovcnt);
+	if (ret <= 0) {
+		net_pkt_unref(pkt);
+		return -EAGAIN;
+	}
 
-		net_buf_add_mem(frag, ctx->recv + count,
-				min(net_buf_tailroom(frag), ret));
+	/* The packet takes the buffers the frame went into, the others are
+	 * kept for the next one
+	 */
+	for (frag = ctx->rx_frags; ; frag = frag->frags) {
+		net_buf_add(frag, min(net_buf_tailroom(frag), ret));
 		ret -= frag->len;
-		count += frag->len;
-	} while (ret > 0);
+		if (!ret) {
+			break;
+		}
+	}
+
+	net_pkt_frag_add(pkt, ctx->rx_frags);
+	ctx->rx_frags = frag->frags;
+	frag->frags = NULL;
 
 #if defined(CONFIG_NET_VLAN)
 	{
@@ -372,31 +443,44 @@ static int read_data(struct eth_context *ctx, int fd)
 	return 0;
 }
 
-static void eth_rx(struct eth_context *ctx)
+static int eth_rx(struct k_softirq *softirq, int budget)
 {
-	int ret;
-
-	LOG_DBG("Starting ZETH RX thread");
+	struct eth_context *ctx = CONTAINER_OF(softirq, struct eth_context,
+					       rx_softirq);
+	int count;
 
-	while (1) {
-		if (net_if_is_up(ctx->iface)) {
-			ret = eth_wait_data(ctx->dev_fd);
-			if (!ret) {
-				read_data(ctx, ctx->dev_fd);
-			}
+	/* The host interface does not block, so read until it has nothing
+	 * left rather than asking it first
+	 */
+	for (count = 0; count < budget; count++) {
+		if (!net_if_is_up(ctx->iface) ||
+		    read_data(ctx, ctx->dev_fd) < 0) {
+			/* try again at the next poll */
+			break;
 		}
+	}
 
-		k_sleep(K_MSEC(50));
+	return count;
+}
+
+static void eth_rx_poll(struct k_timer *timer)
+{
+	struct eth_context *ctx = CONTAINER_OF(timer, struct eth_context,
+					       rx_poll);
+
+	if (net_if_is_up(ctx->iface) && eth_wait_data(ctx->dev_fd) == 0) {
+		(void)k_softirq_raise(&ctx->rx_softirq);
 	}
 }
 
 static void create_rx_handler(struct eth_context *ctx)
 {
-	k_thread_create(&rx_thread_data, eth_rx_stack,
-			K_THREAD_STACK_SIZEOF(eth_rx_stack),
-			(k_thread_entry_t)eth_rx,
-			ctx, NULL, NULL, K_PRIO_COOP(14),
-			0, K_NO_WAIT);
+	k_softirq_init(&ctx->rx_softirq, eth_rx, 0);
+
+	k_timer_init(&ctx->rx_poll, eth_rx_poll, NULL);
+	k_timer_start(&ctx->rx_poll,
+		      K_MSEC(CONFIG_ETH_NATIVE_POSIX_RX_POLL_INTERVAL),
+		      K_MSEC(CONFIG_ETH_NATIVE_POSIX_RX_POLL_INTERVAL));
 }
 
 static void eth_iface_init(struct net_if *iface)
@@ -450,7 +534,7 @@ static void eth_iface_init(struct net_if *iface)
 	if (ctx->dev_fd < 0) {
 		LOG_ERR("Cannot create %s (%d)", ctx->if_name, ctx->dev_fd);
 	} else {
-		/* Create a thread that will handle incoming data from host */
+		/* Start handling incoming data from host */
 		create_rx_handler(ctx);
 
 		eth_setup_host(ctx->if_name);
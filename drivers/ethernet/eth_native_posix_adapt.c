@@ -23,6 +23,7 @@
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <sys/select.h>
+#include <sys/uio.h>
 #include <net/if.h>
 #include <time.h>
 #include "posix_trace.h"
@@ -77,6 +78,16 @@ int eth_iface_create(const char *if_name, bool tun_only)
 	}
 #endif
 
+	/* The receive handler reads until there is nothing left, rather
+	 * than checking with select() before every frame.
+	 */
+	ret = fcntl(fd, F_GETFL);
+	if (ret < 0 || fcntl(fd, F_SETFL, ret | O_NONBLOCK) < 0) {
+		ret = -errno;
+		close(fd);
+		return ret;
+	}
+
 	return fd;
 }
 
@@ -165,14 +176,53 @@ int eth_wait_data(int fd)
 	return -EAGAIN;
 }
 
-ssize_t eth_read_data(int fd, void *buf, size_t buf_len)
+static void host_iov_get(struct iovec *host_iov, const struct eth_iovec *iov,
+			 int iovcnt)
 {
-	return read(fd, buf, buf_len);
+	int i;
+
+	for (i = 0; i < iovcnt; i++) {
+		host_iov[i].iov_base = iov[i].base;
+		host_iov[i].iov_len = iov[i].len;
+	}
 }
 
-ssize_t eth_write_data(int fd, void *buf, size_t buf_len)
+ssize_t eth_read_iov(int fd, const struct eth_iovec *iov, int iovcnt)
 {
-	return write(fd, buf, buf_len);
+	struct iovec host_iov[ETH_NATIVE_POSIX_IOV_MAX];
+	ssize_t ret;
+
+	if (iovcnt > ETH_NATIVE_POSIX_IOV_MAX) {
+		return -EINVAL;
+	}
+
+	host_iov_get(host_iov, iov, iovcnt);
+
+	ret = readv(fd, host_iov, iovcnt);
+	if (ret < 0) {
+		return -errno;
+	}
+
+	return ret;
+}
+
+ssize_t eth_write_iov(int fd, const struct eth_iovec *iov, int iovcnt)
+{
+	struct iovec host_iov[ETH_NATIVE_POSIX_IOV_MAX];
+	ssize_t ret;
+
+	if (iovcnt > ETH_NATIVE_POSIX_IOV_MAX) {
+		return -EINVAL;
+	}
+
+	host_iov_get(host_iov, iov, iovcnt);
+
+	ret = writev(fd, host_iov, iovcnt);
+	if (ret < 0) {
+		return -errno;
+	}
+
+	return ret;
 }
 
 #if defined(CONFIG_NET_GPTP)
@@ -25,13 +25,24 @@
 #define ETH_NATIVE_POSIX_STARTUP_SCRIPT_USER ""
 #endif
 
+/* Max number of buffers a frame is read from or written to at once */
+#define ETH_NATIVE_POSIX_IOV_MAX 32
+
+/* Part of a frame, as struct iovec of the host which cannot be used on
+ * the Zephyr side.
+ */
+struct eth_iovec {
+	void *base;
+	size_t len;
+};
+
 int eth_iface_create(const char *if_name, bool tun_only);
 int eth_iface_remove(int fd);
 int eth_setup_host(const char *if_name);
 int eth_start_script(const char *if_name);
 int eth_wait_data(int fd);
-ssize_t eth_read_data(int fd, void *buf, size_t buf_len);
-ssize_t eth_write_data(int fd, void *buf, size_t buf_len);
+ssize_t eth_read_iov(int fd, const struct eth_iovec *iov, int iovcnt);
+ssize_t eth_write_iov(int fd, const struct eth_iovec *iov, int iovcnt);
 int eth_if_up(const char *if_name);
 int eth_if_down(const char *if_name);
 
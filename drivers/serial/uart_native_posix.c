@@ -30,6 +30,10 @@
  *
  * When connected to its own pseudo terminal, it may also auto attach a terminal
  * emulator to it, if set so from command line.
+ *
+ * With CONFIG_UART_INTERRUPT_DRIVEN the input is polled by a timer, which
+ * stands in for the receive interrupt, and the UART callback is run by a
+ * softirq handler, with a budget, rather than from an ISR.
  */
 
 static int np_uart_stdin_poll_in(struct device *dev, unsigned char *p_char);
@@ -37,6 +41,25 @@ static int np_uart_tty_poll_in(struct device *dev, unsigned char *p_char);
 static unsigned char np_uart_poll_out(struct device *dev,
 				      unsigned char out_char);
 
+#ifdef CONFIG_UART_INTERRUPT_DRIVEN
+static int np_uart_fifo_fill(struct device *dev, const u8_t *tx_data,
+			     int len);
+static int np_uart_fifo_read(struct device *dev, u8_t *rx_data,
+			     const int size);
+static void np_uart_irq_tx_enable(struct device *dev);
+static void np_uart_irq_tx_disable(struct device *dev);
+static int np_uart_irq_tx_ready(struct device *dev);
+static int np_uart_irq_tx_complete(struct device *dev);
+static void np_uart_irq_rx_enable(struct device *dev);
+static void np_uart_irq_rx_disable(struct device *dev);
+static int np_uart_irq_rx_ready(struct device *dev);
+static int np_uart_irq_is_pending(struct device *dev);
+static int np_uart_irq_update(struct device *dev);
+static void np_uart_irq_callback_set(struct device *dev,
+				     uart_irq_callback_user_data_t cb,
+				     void *user_data);
+#endif
+
 static bool auto_attach;
 static const char default_cmd[] = CONFIG_NATIVE_UART_AUTOATTACH_DEFAULT_CMD;
 static char *auto_attach_cmd;
@@ -44,11 +67,35 @@ static char *auto_attach_cmd;
 static struct uart_driver_api np_uart_driver_api = {
 	.poll_out = np_uart_poll_out,
 	.poll_in = np_uart_tty_poll_in,
+#ifdef CONFIG_UART_INTERRUPT_DRIVEN
+	.fifo_fill = np_uart_fifo_fill,
+	.fifo_read = np_uart_fifo_read,
+	.irq_tx_enable = np_uart_irq_tx_enable,
+	.irq_tx_disable = np_uart_irq_tx_disable,
+	.irq_tx_ready = np_uart_irq_tx_ready,
+	.irq_tx_complete = np_uart_irq_tx_complete,
+	.irq_rx_enable = np_uart_irq_rx_enable,
+	.irq_rx_disable = np_uart_irq_rx_disable,
+	.irq_rx_ready = np_uart_irq_rx_ready,
+	.irq_is_pending = np_uart_irq_is_pending,
+	.irq_update = np_uart_irq_update,
+	.irq_callback_set = np_uart_irq_callback_set,
+#endif
 };
 
 struct native_uart_status {
 	int out_fd; /* File descriptor used for output */
 	int in_fd; /* File descriptor used for input */
+#ifdef CONFIG_UART_INTERRUPT_DRIVEN
+	struct k_timer rx_poll; /* Polls the input for the RX interrupt */
+	struct k_softirq softirq; /* Runs the UART callback */
+	uart_irq_callback_user_data_t cb;
+	void *cb_data;
+	u32_t rx_count; /* Bytes read so far, to tell the callback's progress */
+	bool rx_irq_en;
+	bool tx_irq_en;
+	bool rx_eof; /* Input was closed */
+#endif
 };
 
 #define ERROR posix_print_error_and_exit
@@ -154,6 +201,10 @@ static int open_tty(void)
 	return master_pty;
 }
 
+#ifdef CONFIG_UART_INTERRUPT_DRIVEN
+static void np_uart_irq_init(struct native_uart_status *d);
+#endif
+
 /**
  * @brief Initialize the native_posix serial port
  *
@@ -189,6 +240,10 @@ static int np_uart_init(struct device *dev)
 		}
 	}
 
+#ifdef CONFIG_UART_INTERRUPT_DRIVEN
+	np_uart_irq_init(d);
+#endif
+
 	dev->driver_api = &np_uart_driver_api;
 
 	return 0;
@@ -285,6 +340,170 @@ static int np_uart_tty_poll_in(struct device *dev, unsigned char *p_char)
 	return 0;
 }
 
+#ifdef CONFIG_UART_INTERRUPT_DRIVEN
+/* Poll interval of the input, standing in for the RX interrupt */
+#define RX_POLL_INTERVAL K_MSEC(10)
+
+static struct native_uart_status *get_status(struct device *dev)
+{
+	return (struct native_uart_status *)dev->driver_data;
+}
+
+static bool np_uart_input_ready(struct native_uart_status *d)
+{
+	static struct timeval timeout; /* just zero */
+	fd_set readfds;
+
+	if (d->rx_eof) {
+		return false;
+	}
+
+	FD_ZERO(&readfds);
+	FD_SET(d->in_fd, &readfds);
+
+	return select(d->in_fd + 1, &readfds, NULL, NULL, &timeout) > 0;
+}
+
+static int np_uart_fifo_fill(struct device *dev, const u8_t *tx_data,
+			     int len)
+{
+	int ret = write(get_status(dev)->out_fd, tx_data, len);
+
+	return ret < 0 ? 0 : ret;
+}
+
+static int np_uart_fifo_read(struct device *dev, u8_t *rx_data,
+			     const int size)
+{
+	struct native_uart_status *d = get_status(dev);
+	int ret = read(d->in_fd, rx_data, size);
+
+	if (ret == 0) {
+		d->rx_eof = true;
+	}
+	if (ret <= 0) {
+		return 0;
+	}
+
+	d->rx_count += ret;
+
+	return ret;
+}
+
+static void np_uart_irq_tx_enable(struct device *dev)
+{
+	struct native_uart_status *d = get_status(dev);
+
+	/* Output never blocks, so the TX interrupt fires right away */
+	d->tx_irq_en = true;
+	(void)k_softirq_raise(&d->softirq);
+}
+
+static void np_uart_irq_tx_disable(struct device *dev)
+{
+	get_status(dev)->tx_irq_en = false;
+}
+
+static int np_uart_irq_tx_ready(struct device *dev)
+{
+	return get_status(dev)->tx_irq_en;
+}
+
+static int np_uart_irq_tx_complete(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return 1;
+}
+
+static void np_uart_irq_rx_enable(struct device *dev)
+{
+	struct native_uart_status *d = get_status(dev);
+
+	d->rx_irq_en = true;
+	k_timer_start(&d->rx_poll, RX_POLL_INTERVAL, RX_POLL_INTERVAL);
+}
+
+static void np_uart_irq_rx_disable(struct device *dev)
+{
+	struct native_uart_status *d = get_status(dev);
+
+	d->rx_irq_en = false;
+	k_timer_stop(&d->rx_poll);
+}
+
+static int np_uart_irq_rx_ready(struct device *dev)
+{
+	struct native_uart_status *d = get_status(dev);
+
+	return d->rx_irq_en && np_uart_input_ready(d);
+}
+
+static int np_uart_irq_is_pending(struct device *dev)
+{
+	return np_uart_irq_rx_ready(dev) || np_uart_irq_tx_ready(dev);
+}
+
+static int np_uart_irq_update(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return 1;
+}
+
+static void np_uart_irq_callback_set(struct device *dev,
+				     uart_irq_callback_user_data_t cb,
+				     void *user_data)
+{
+	struct native_uart_status *d = get_status(dev);
+
+	d->cb = cb;
+	d->cb_data = user_data;
+}
+
+static void np_uart_rx_poll(struct k_timer *timer)
+{
+	struct native_uart_status *d =
+		CONTAINER_OF(timer, struct native_uart_status, rx_poll);
+
+	if (np_uart_input_ready(d)) {
+		(void)k_softirq_raise(&d->softirq);
+	}
+}
+
+/* Each run of the callback is a unit of work */
+static int np_uart_softirq(struct k_softirq *softirq, int budget)
+{
+	struct native_uart_status *d =
+		CONTAINER_OF(softirq, struct native_uart_status, softirq);
+	int count;
+
+	for (count = 0; count < budget && d->cb != NULL; count++) {
+		u32_t rx_count = d->rx_count;
+		bool rx_ready = d->rx_irq_en && np_uart_input_ready(d);
+
+		if (!rx_ready && !d->tx_irq_en) {
+			break;
+		}
+
+		d->cb(d->cb_data);
+
+		/* input left unread waits for the next poll */
+		if (!d->tx_irq_en && d->rx_count == rx_count) {
+			break;
+		}
+	}
+
+	return count;
+}
+
+static void np_uart_irq_init(struct native_uart_status *d)
+{
+	k_timer_init(&d->rx_poll, np_uart_rx_poll, NULL);
+	k_softirq_init(&d->softirq, np_uart_softirq, K_SOFTIRQ_LEVELS - 1);
+}
+#endif /* CONFIG_UART_INTERRUPT_DRIVEN */
+
 static struct native_uart_status native_uart_status_0;
 
 DEVICE_INIT(uart_native_posix0,
@@ -219,6 +219,10 @@ struct device_config {
 				 void *context);
 #endif
 	const void *config_info;
+#ifdef CONFIG_SYS_INIT_PARALLEL
+	/* set by SYS_INIT_PARALLEL() */
+	u8_t init_parallel;
+#endif
 };
 
 /**
@@ -232,6 +236,10 @@ struct device {
 	struct device_config *config;
 	const void *driver_api;
 	void *driver_data;
+#ifdef CONFIG_BOOT_PROFILE
+	/* hardware cycles the init function took */
+	u32_t init_cycles;
+#endif
 };
 
 void _sys_device_do_config_level(s32_t level);
@@ -70,6 +70,65 @@ extern "C" {
 	DEVICE_DEFINE(_SYS_NAME(init_fn), drv_name, init_fn, pm_control_fn, \
 		      NULL, NULL, level, prio, NULL)
 
+/**
+ * @def SYS_INIT_PARALLEL
+ *
+ * @brief Run an initialization function at boot, possibly concurrently
+ *
+ * @details This macro is like SYS_INIT(), for functions of the POST_KERNEL
+ * and APPLICATION levels that do not depend on, and are not depended on
+ * by, any other initialization function of their level. With
+ * CONFIG_SYS_INIT_PARALLEL enabled they are run by worker threads,
+ * concurrently with the other functions of the level, which ends once
+ * they have returned. Otherwise they are run like SYS_INIT() functions.
+ *
+ * @param init_fn Pointer to the boot function to run
+ *
+ * @param level The initialization level, POST_KERNEL or APPLICATION.
+ * Functions of earlier levels are always run in priority order.
+ *
+ * @param prio Priority within the selected initialization level. See
+ * DEVICE_INIT for details.
+ */
+#ifdef CONFIG_SYS_INIT_PARALLEL
+#define SYS_INIT_PARALLEL(init_fn, level, prio) \
+	_SYS_INIT_PARALLEL(_SYS_NAME(init_fn), init_fn, level, prio)
+#else
+#define SYS_INIT_PARALLEL(init_fn, level, prio) \
+	SYS_INIT(init_fn, level, prio)
+#endif
+
+#ifdef CONFIG_DEVICE_POWER_MANAGEMENT
+#define _SYS_INIT_PM_CONTROL .device_pm_control = device_pm_control_nop,
+#else
+#define _SYS_INIT_PM_CONTROL
+#endif
+
+#define _SYS_INIT_PARALLEL(dev_name, init_fn, level, prio)		  \
+	static struct device_config _CONCAT(__config_, dev_name) __used	  \
+	__attribute__((__section__(".devconfig.init"))) = {		  \
+		.name = "", .init = (init_fn),				  \
+		_SYS_INIT_PM_CONTROL					  \
+		.init_parallel = 1,					  \
+	};								  \
+	static struct device _CONCAT(__device_, dev_name) __used	  \
+	__attribute__((__section__(".init_" #level STRINGIFY(prio)))) = { \
+		.config = &_CONCAT(__config_, dev_name),		  \
+	}
+
+#ifdef CONFIG_BOOT_PROFILE
+/**
+ * @brief Get how long an initialization level took.
+ *
+ * @param level The initialization level, _SYS_INIT_LEVEL_PRE_KERNEL_1 to
+ * _SYS_INIT_LEVEL_APPLICATION.
+ *
+ * @return Hardware cycles from the start to the end of @a level, 0 if it
+ * has not run yet or @a level is out of range.
+ */
+u32_t sys_init_level_cycles_get(s32_t level);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -448,6 +448,19 @@ struct _thread_base {
 	u8_t global_lock_count;
 #endif
 
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
+	/* CPU whose ready queue holds the thread while it is queued */
+	u8_t runq_cpu;
+
+	/* True while queued, protected by that CPU's ready queue lock */
+	u8_t queued;
+#endif
+
+#ifdef CONFIG_SCHED_CPU_MASK
+	/* Bitmask of the CPUs on which the thread may run */
+	u8_t cpu_mask;
+#endif
+
 	/* data returned by APIs */
 	void *swap_data;
 
@@ -472,6 +485,13 @@ struct _thread_stack_info {
 	 * that should be writable by the thread
 	 */
 	u32_t size;
+
+#ifdef CONFIG_STACK_WATERMARK
+	/* High-water mark - Most bytes of the stack buffer found used so
+	 * far, as of the last scan of the stack
+	 */
+	u32_t max_used;
+#endif
 };
 
 typedef struct _thread_stack_info _thread_stack_info_t;
@@ -485,6 +505,20 @@ struct _mem_domain_info {
 	struct k_mem_domain *mem_domain;
 };
 
+#if defined(CONFIG_USERSPACE_OBJ_CACHE)
+struct _k_object;
+
+/* Kernel objects the thread recently passed permission checks on */
+struct _thread_obj_cache {
+	/* value of z_object_cache_gen the entries are valid for */
+	u32_t gen;
+	/* object addresses, direct mapped by address */
+	void *obj[CONFIG_USERSPACE_OBJ_CACHE_SIZE];
+	/* metadata of each cached object */
+	struct _k_object *ko[CONFIG_USERSPACE_OBJ_CACHE_SIZE];
+};
+#endif /* CONFIG_USERSPACE_OBJ_CACHE */
+
 #endif /* CONFIG_USERSPACE */
 
 #ifdef CONFIG_THREAD_USERSPACE_LOCAL_DATA
@@ -493,6 +527,17 @@ struct _thread_userspace_local_data {
 };
 #endif
 
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+/**
+ * @ingroup profiling_apis
+ * Thread runtime statistics
+ */
+struct k_thread_runtime_stats {
+	/** hardware cycles the thread has been running for */
+	u64_t execution_cycles;
+};
+#endif
+
 /**
  * @ingroup thread_apis
  * Thread Structure
@@ -549,11 +594,20 @@ struct k_thread {
 	struct _thread_stack_info stack_info;
 #endif /* CONFIG_THREAD_STACK_INFO */
 
+#if defined(CONFIG_THREAD_RUNTIME_STATS)
+	/** Runtime statistics */
+	struct k_thread_runtime_stats rt_stats;
+#endif
+
 #if defined(CONFIG_USERSPACE)
 	/** memory domain info of the thread */
 	struct _mem_domain_info mem_domain_info;
 	/** Base address of thread stack */
 	k_thread_stack_t *stack_obj;
+#if defined(CONFIG_USERSPACE_OBJ_CACHE)
+	/** validated kernel object cache */
+	struct _thread_obj_cache obj_cache;
+#endif
 #endif /* CONFIG_USERSPACE */
 
 #if defined(CONFIG_USE_SWITCH)
@@ -610,6 +664,107 @@ typedef void (*k_thread_user_cb_t)(const struct k_thread *thread,
  */
 extern void k_thread_foreach(k_thread_user_cb_t user_cb, void *user_data);
 
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+/**
+ * @brief Get the runtime statistics of a thread.
+ *
+ * Threads are charged the hardware cycles they ran for at every context
+ * switch, less the time spent in ISRs on architectures that measure it.
+ * When called from a thread for itself the statistics are brought up to
+ * date first; for other threads they cover the time up to their last
+ * context switch.
+ *
+ * @param thread Thread to query.
+ * @param stats Filled in with the statistics of @a thread.
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if @a thread or @a stats is NULL.
+ */
+extern int k_thread_runtime_stats_get(k_tid_t thread,
+				      struct k_thread_runtime_stats *stats);
+
+/**
+ * @brief Get the runtime statistics of the whole system.
+ *
+ * The execution cycles are all the cycles accounted on all CPUs, charged
+ * to threads (the idle threads included) or spent in ISRs.
+ *
+ * @param stats Filled in with the system statistics.
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if @a stats is NULL.
+ */
+extern int k_thread_runtime_stats_all_get(struct k_thread_runtime_stats *stats);
+
+/**
+ * @brief System load averages
+ *
+ * The load is the share of the time all CPUs together were not running
+ * their idle thread, in thousandths: 1000 means every CPU was busy for
+ * the whole period. It is sampled every 5 seconds.
+ */
+struct k_load_avg {
+	/** load averaged over 1, 5 and 15 minutes */
+	u32_t load[3];
+	/** load over the last sampling period */
+	u32_t last;
+	/** share of the last sampling period spent in ISRs */
+	u32_t isr;
+};
+
+/**
+ * @brief Get the system load averages.
+ *
+ * @param avg Filled in with the load averages.
+ *
+ * @return N/A
+ */
+extern void k_load_avg_get(struct k_load_avg *avg);
+
+#ifdef CONFIG_ARCH_HAS_IRQ_RUNTIME_STATS
+/**
+ * @brief Get the time spent handling an interrupt.
+ *
+ * Time spent in nested interrupts is only counted for the nested one.
+ *
+ * @param irq IRQ line.
+ *
+ * @return Hardware cycles spent in the ISR of @a irq, 0 for an invalid
+ * IRQ line.
+ */
+extern u64_t k_irq_runtime_cycles_get(unsigned int irq);
+#endif
+#endif /* CONFIG_THREAD_RUNTIME_STATS */
+
+#ifdef CONFIG_STACK_WATERMARK
+/**
+ * @brief Thread stack usage
+ */
+struct k_thread_stack_usage {
+	/** size of the stack buffer, in bytes */
+	size_t size;
+	/** most bytes of the stack buffer ever used */
+	size_t max_used;
+};
+
+/**
+ * @brief Get the stack high-water mark of a thread.
+ *
+ * Stacks are painted when threads are created, and the idle thread keeps
+ * the high-water marks of all threads up to date by scanning their stacks
+ * for overwritten paint, one thread at a time. This routine scans the
+ * stack of @a thread first, so the result is current.
+ *
+ * @param thread Thread to query.
+ * @param usage Filled in with the stack usage of @a thread.
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if @a thread or @a usage is NULL.
+ */
+extern int k_thread_stack_usage_get(k_tid_t thread,
+				    struct k_thread_stack_usage *usage);
+#endif /* CONFIG_STACK_WATERMARK */
+
 /** @} */
 
 /**
@@ -1033,6 +1188,52 @@ __syscall void k_thread_priority_set(k_tid_t thread, int prio);
 __syscall void k_thread_deadline_set(k_tid_t thread, int deadline);
 #endif
 
+#ifdef CONFIG_SCHED_CPU_MASK
+/**
+ * @brief Sets all CPU enable masks to zero
+ *
+ * After this returns, the thread will no longer be schedulable on any
+ * CPUs.  The thread must not be currently runnable.
+ *
+ * @param thread Thread to operate upon
+ * @return Zero on success, otherwise error code
+ */
+int k_thread_cpu_mask_clear(k_tid_t thread);
+
+/**
+ * @brief Sets all CPU enable masks to one
+ *
+ * After this returns, the thread will be schedulable on any CPU.  The
+ * thread must not be currently runnable.
+ *
+ * @param thread Thread to operate upon
+ * @return Zero on success, otherwise error code
+ */
+int k_thread_cpu_mask_enable_all(k_tid_t thread);
+
+/**
+ * @brief Enable thread to run on specified CPU
+ *
+ * The thread must not be currently runnable.
+ *
+ * @param thread Thread to operate upon
+ * @param cpu CPU index
+ * @return Zero on success, otherwise error code
+ */
+int k_thread_cpu_mask_enable(k_tid_t thread, int cpu);
+
+/**
+ * @brief Prevent thread to run on specified CPU
+ *
+ * The thread must not be currently runnable.
+ *
+ * @param thread Thread to operate upon
+ * @param cpu CPU index
+ * @return Zero on success, otherwise error code
+ */
+int k_thread_cpu_mask_disable(k_tid_t thread, int cpu);
+#endif
+
 /**
  * @brief Suspend a thread.
  *
@@ -1506,6 +1707,57 @@ static inline s32_t _impl_k_timer_remaining_get(struct k_timer *timer)
 	return __ticks_to_ms(z_timeout_remaining(&timer->timeout));
 }
 
+/**
+ * @brief Set the slack of a timer.
+ *
+ * This routine allows each expiry of @a timer, the first one and every
+ * periodic one, to be delayed by up to @a slack milliseconds so that it
+ * can share a wakeup from idle with other timeouts due around the same
+ * time. The slack stays in effect across k_timer_start() and
+ * k_timer_stop() and applies from the next start of the timer.
+ *
+ * The slack has no effect unless CONFIG_TIMER_COALESCING is enabled.
+ *
+ * @param timer     Address of timer.
+ * @param slack     Maximum expiry delay (in milliseconds).
+ *
+ * @return N/A
+ */
+__syscall void k_timer_slack_set(struct k_timer *timer, s32_t slack);
+
+static inline void _impl_k_timer_slack_set(struct k_timer *timer, s32_t slack)
+{
+#ifdef CONFIG_TIMER_COALESCING
+	timer->timeout.slack = _ms_to_ticks(slack);
+#else
+	ARG_UNUSED(timer);
+	ARG_UNUSED(slack);
+#endif
+}
+
+/**
+ * @brief Timer wakeup statistics.
+ *
+ * Counts of timer interrupts that expired at least one timeout, and of
+ * the wakeups avoided by letting timeouts with slack expire together with
+ * later ones. See k_wakeup_stats_get().
+ */
+struct k_wakeup_stats {
+	u32_t timer_wakeups;
+	u32_t wakeups_saved;
+};
+
+/**
+ * @brief Get timer wakeup statistics.
+ *
+ * This routine is only available when CONFIG_TIMER_COALESCING is enabled.
+ *
+ * @param stats     Filled in with the statistics since boot.
+ *
+ * @return N/A
+ */
+extern void k_wakeup_stats_get(struct k_wakeup_stats *stats);
+
 /**
  * @brief Associate user-specific data with a timer.
  *
@@ -1824,6 +2076,27 @@ extern void k_queue_insert(struct k_queue *queue, void *prev, void *data);
  */
 extern void k_queue_append_list(struct k_queue *queue, void *head, void *tail);
 
+/**
+ * @brief Atomically append an array of elements to a queue.
+ *
+ * This routine adds @a count data items to @a queue in one operation,
+ * in array order.  The items are chained together before interrupts
+ * are locked, then handed to at most @a count waiting threads, with the
+ * rest appended to the queue, and the scheduler is invoked only once.
+ * This makes it much cheaper than appending a burst of items one by one.
+ * The first 32 bits of each data item are reserved for the kernel's use.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param queue Address of the queue.
+ * @param items Array of addresses of the data items.
+ * @param count Number of data items in @a items.
+ *
+ * @return N/A
+ */
+extern void k_queue_append_batch(struct k_queue *queue, void **items,
+				 size_t count);
+
 /**
  * @brief Atomically add a list of elements to a queue.
  *
@@ -2083,6 +2356,25 @@ struct k_fifo {
 #define k_fifo_put_list(fifo, head, tail) \
 	k_queue_append_list((struct k_queue *) fifo, head, tail)
 
+/**
+ * @brief Atomically add an array of elements to a FIFO.
+ *
+ * This routine adds @a count data items to @a fifo in one operation,
+ * in array order, waking at most @a count waiting threads and invoking
+ * the scheduler only once.  The first 32 bits of each data item are
+ * reserved for the kernel's use.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param fifo Address of the FIFO queue.
+ * @param items Array of addresses of the data items.
+ * @param count Number of data items in @a items.
+ *
+ * @return N/A
+ */
+#define k_fifo_put_batch(fifo, items, count) \
+	k_queue_append_batch((struct k_queue *) fifo, items, count)
+
 /**
  * @brief Atomically add a list of elements to a FIFO queue.
  *
@@ -2599,6 +2891,70 @@ extern void k_work_q_start(struct k_work_q *work_q,
 			   k_thread_stack_t *stack,
 			   size_t stack_size, int prio);
 
+/* Let a workqueue worker thread run on any CPU */
+#define K_WORK_Q_ANY_CPU (-1)
+
+/**
+ * @brief Add a worker thread to a workqueue.
+ *
+ * This routine spawns one more thread processing the work items of
+ * workqueue @a work_q, which must have been started with k_work_q_start().
+ * All threads of a workqueue take items from the same queue, so a work
+ * item with a slow handler only holds up the thread running it.
+ *
+ * With more than one thread, work items are no longer processed strictly
+ * one after the other: handlers of different items may run concurrently,
+ * and an item resubmitted while its handler runs may be picked up by
+ * another thread before that handler has returned.
+ *
+ * @param work_q Address of workqueue.
+ * @param thread Thread object for the new worker.
+ * @param stack Pointer to the worker's stack space, as defined by
+ *		K_THREAD_STACK_DEFINE()
+ * @param stack_size Size of the worker's stack (in bytes).
+ * @param prio Priority of the worker thread.
+ * @param cpu CPU the worker is restricted to, or K_WORK_Q_ANY_CPU. Only
+ *		honored with CONFIG_SCHED_CPU_MASK.
+ *
+ * @return N/A
+ */
+extern void k_work_q_worker_add(struct k_work_q *work_q,
+				struct k_thread *thread,
+				k_thread_stack_t *stack,
+				size_t stack_size, int prio, int cpu);
+
+/**
+ * @brief Execution time statistics of a work handler.
+ */
+struct k_work_handler_stats {
+	/** Handler function */
+	k_work_handler_t handler;
+	/** Number of times it was run */
+	u32_t count;
+	/** Longest execution time, in hardware clock cycles */
+	u32_t max_cycles;
+	/** Total execution time, in hardware clock cycles */
+	u64_t total_cycles;
+};
+
+/**
+ * @brief Get the slowest work handlers.
+ *
+ * With CONFIG_WORKQUEUE_STATS the workqueue threads time every handler
+ * they run and keep track of the CONFIG_WORKQUEUE_STATS_HANDLERS
+ * handlers with the longest single execution time. This routine copies
+ * up to @a max of them to @a stats, slowest first.
+ *
+ * @note Only available with CONFIG_WORKQUEUE_STATS.
+ *
+ * @param stats Array to fill in.
+ * @param max Number of entries in @a stats.
+ *
+ * @return Number of entries filled in.
+ */
+extern int k_work_handler_stats_get(struct k_work_handler_stats *stats,
+				    int max);
+
 /**
  * @brief Initialize a delayed work item.
  *
@@ -2751,7 +3107,154 @@ static inline s32_t k_delayed_work_remaining_get(struct k_delayed_work *work)
 	return __ticks_to_ms(z_timeout_remaining(&work->timeout));
 }
 
+/**
+ * @brief Set the slack of a delayed work item.
+ *
+ * This routine allows the delay of @a work to be extended by up to
+ * @a slack milliseconds so that its timeout can share a wakeup from idle
+ * with other timeouts due around the same time. The slack applies to
+ * every later k_delayed_work_submit_to_queue() of the work item.
+ *
+ * The slack has no effect unless CONFIG_TIMER_COALESCING is enabled.
+ *
+ * @param work Address of delayed work item.
+ * @param slack Maximum extra delay (in milliseconds).
+ *
+ * @return N/A
+ */
+static inline void k_delayed_work_slack_set(struct k_delayed_work *work,
+					    s32_t slack)
+{
+#ifdef CONFIG_TIMER_COALESCING
+	work->timeout.slack = _ms_to_ticks(slack);
+#else
+	ARG_UNUSED(work);
+	ARG_UNUSED(slack);
+#endif
+}
+
+/** @} */
+
+#ifdef CONFIG_SOFTIRQ
+/**
+ * @defgroup softirq_apis Deferred Interrupt APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+struct k_softirq;
+
+/**
+ * @typedef k_softirq_handler_t
+ * @brief Deferred interrupt handler function type.
+ *
+ * A handler processes at most @a budget units of work, in whatever unit
+ * suits the driver (packets, characters, ...), and returns how many it
+ * processed. A handler that used its whole budget is assumed to have more
+ * work and is run again after the other pending handlers of its level.
+ *
+ * Handlers run in cooperative threads and must not block.
+ *
+ * @param softirq Address of the deferred interrupt that was raised.
+ * @param budget Most units of work the handler may process.
+ *
+ * @return Units of work processed.
+ */
+typedef int (*k_softirq_handler_t)(struct k_softirq *softirq, int budget);
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+enum {
+	K_SOFTIRQ_STATE_PENDING,	/* Raised and not yet handled */
+};
+
+struct k_softirq {
+	sys_snode_t node;
+	k_softirq_handler_t handler;
+	atomic_t flags[1];
+	u8_t level;
+};
+
+#define _K_SOFTIRQ_INITIALIZER(softirq_handler, softirq_level) \
+	{ \
+	.node = { NULL }, \
+	.handler = softirq_handler, \
+	.flags = { 0 }, \
+	.level = softirq_level, \
+	}
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/** Number of deferred interrupt levels, level 0 runs first */
+#define K_SOFTIRQ_LEVELS CONFIG_SOFTIRQ_LEVELS
+
+/**
+ * @brief Statically define and initialize a deferred interrupt.
+ *
+ * @param name Name of the deferred interrupt.
+ * @param softirq_handler Function to invoke when it is raised.
+ * @param softirq_level Level to run the handler at, 0 being the highest
+ * priority and K_SOFTIRQ_LEVELS - 1 the lowest.
+ */
+#define K_SOFTIRQ_DEFINE(name, softirq_handler, softirq_level) \
+	struct k_softirq name = \
+		_K_SOFTIRQ_INITIALIZER(softirq_handler, softirq_level)
+
+/**
+ * @brief Initialize a deferred interrupt.
+ *
+ * @param softirq Address of the deferred interrupt.
+ * @param handler Function to invoke when it is raised.
+ * @param level Level to run the handler at, 0 being the highest priority
+ * and K_SOFTIRQ_LEVELS - 1 the lowest.
+ *
+ * @return N/A
+ */
+static inline void k_softirq_init(struct k_softirq *softirq,
+				  k_softirq_handler_t handler, int level)
+{
+	__ASSERT(level >= 0 && level < K_SOFTIRQ_LEVELS,
+		 "invalid softirq level %d", level);
+
+	*softirq = (struct k_softirq)_K_SOFTIRQ_INITIALIZER(handler, level);
+}
+
+/**
+ * @brief Raise a deferred interrupt.
+ *
+ * This routine queues the handler of @a softirq to be run by the softirq
+ * thread of its level on the current CPU. Raising a deferred interrupt
+ * that is already pending has no further effect, so an ISR may raise it
+ * for every interrupt and leave the work to the handler.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param softirq Address of the deferred interrupt.
+ *
+ * @retval 0 Deferred interrupt queued.
+ * @retval -EALREADY Deferred interrupt was already pending.
+ */
+extern int k_softirq_raise(struct k_softirq *softirq);
+
+/**
+ * @brief Check whether a deferred interrupt is pending.
+ *
+ * @param softirq Address of the deferred interrupt.
+ *
+ * @return true if @a softirq was raised and its handler has not run yet.
+ */
+static inline bool k_softirq_is_pending(struct k_softirq *softirq)
+{
+	return atomic_test_bit(softirq->flags, K_SOFTIRQ_STATE_PENDING);
+}
+
 /** @} */
+#endif /* CONFIG_SOFTIRQ */
+
 /**
  * @defgroup mutex_apis Mutex APIs
  * @ingroup kernel_apis
@@ -2862,41 +3365,242 @@ __syscall void k_mutex_unlock(struct k_mutex *mutex);
  */
 
 /**
- * @cond INTERNAL_HIDDEN
+ * @defgroup rwlock_apis Reader/Writer Lock APIs
+ * @ingroup kernel_apis
+ * @{
  */
 
-struct k_sem {
-	_wait_q_t wait_q;
-	u32_t count;
-	u32_t limit;
-	_POLL_EVENT;
-
-	_OBJECT_TRACING_NEXT_PTR(k_sem);
+/**
+ * Reader/writer lock structure
+ * @ingroup rwlock_apis
+ */
+struct k_rwlock {
+	/** Threads waiting to read */
+	_wait_q_t read_q;
+	/** Threads waiting to write */
+	_wait_q_t write_q;
+	/** Thread holding the lock for writing, or NULL */
+	struct k_thread *writer;
+	/** Number of threads holding the lock for reading */
+	u32_t readers;
+	int writer_orig_prio;
 };
 
-#define _K_SEM_INITIALIZER(obj, initial_count, count_limit) \
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+#define _K_RWLOCK_INITIALIZER(obj) \
 	{ \
-	.wait_q = _WAIT_Q_INIT(&obj.wait_q), \
-	.count = initial_count, \
-	.limit = count_limit, \
-	_POLL_EVENT_OBJ_INIT(obj) \
-	_OBJECT_TRACING_INIT \
+	.read_q = _WAIT_Q_INIT(&obj.read_q), \
+	.write_q = _WAIT_Q_INIT(&obj.write_q), \
+	.writer = NULL, \
+	.readers = 0, \
+	.writer_orig_prio = K_LOWEST_THREAD_PRIO, \
 	}
 
-#define K_SEM_INITIALIZER DEPRECATED_MACRO _K_SEM_INITIALIZER
-
 /**
  * INTERNAL_HIDDEN @endcond
  */
 
 /**
- * @defgroup semaphore_apis Semaphore APIs
- * @ingroup kernel_apis
- * @{
+ * @brief Statically define and initialize a reader/writer lock.
+ *
+ * The lock can be accessed outside the module where it is defined using:
+ *
+ * @code extern struct k_rwlock <name>; @endcode
+ *
+ * @param name Name of the reader/writer lock.
  */
+#define K_RWLOCK_DEFINE(name) \
+	struct k_rwlock name = _K_RWLOCK_INITIALIZER(name)
 
 /**
- * @brief Initialize a semaphore.
+ * @brief Initialize a reader/writer lock.
+ *
+ * This routine initializes a reader/writer lock object, prior to its first
+ * use. Upon completion the lock is not held.
+ *
+ * @param rwlock Address of the reader/writer lock.
+ *
+ * @return N/A
+ */
+__syscall void k_rwlock_init(struct k_rwlock *rwlock);
+
+/**
+ * @brief Lock a reader/writer lock for reading.
+ *
+ * Any number of threads may hold @a rwlock for reading at the same time.
+ * The calling thread waits if the lock is held for writing, or if a thread
+ * is waiting to write: writers take precedence over new readers.
+ *
+ * A thread waiting for a lock held for writing raises the priority of the
+ * writer, as for a mutex. A thread must not lock for reading a lock it
+ * already holds for writing.
+ *
+ * @param rwlock Address of the reader/writer lock.
+ * @param timeout Waiting period to lock (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Lock held for reading.
+ * @retval -EBUSY Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+__syscall int k_rwlock_read_lock(struct k_rwlock *rwlock, s32_t timeout);
+
+/**
+ * @brief Release a reader/writer lock held for reading.
+ *
+ * When the last reader releases @a rwlock, the first waiting writer, if
+ * any, gets it.
+ *
+ * @param rwlock Address of the reader/writer lock.
+ *
+ * @return N/A
+ */
+__syscall void k_rwlock_read_unlock(struct k_rwlock *rwlock);
+
+/**
+ * @brief Lock a reader/writer lock for writing.
+ *
+ * The calling thread waits until no other thread holds @a rwlock, for
+ * reading or for writing. The lock is not recursive.
+ *
+ * Waiters raise the priority of a thread holding the lock for writing, as
+ * for a mutex. Readers are not tracked individually, so a thread holding
+ * the lock for reading is not subject to priority inheritance.
+ *
+ * @param rwlock Address of the reader/writer lock.
+ * @param timeout Waiting period to lock (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Lock held for writing.
+ * @retval -EBUSY Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+__syscall int k_rwlock_write_lock(struct k_rwlock *rwlock, s32_t timeout);
+
+/**
+ * @brief Release a reader/writer lock held for writing.
+ *
+ * The lock must be held for writing by the calling thread. It goes to the
+ * first waiting writer if there is one, otherwise to all waiting readers.
+ *
+ * @param rwlock Address of the reader/writer lock.
+ *
+ * @return N/A
+ */
+__syscall void k_rwlock_write_unlock(struct k_rwlock *rwlock);
+
+/**
+ * @}
+ */
+
+#ifdef CONFIG_RCU
+/**
+ * @defgroup rcu_apis Read-Copy-Update APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/**
+ * @brief Enter an RCU read-side critical section.
+ *
+ * Within the section, pointers published with K_RCU_ASSIGN() may be read
+ * with K_RCU_DEREF(), and the objects they point to stay valid until the
+ * matching k_rcu_read_unlock(), without taking any lock. Sections may nest
+ * and may be used in ISRs. Thread preemption is disabled for the duration
+ * of the section, so it must not block.
+ *
+ * @return N/A
+ */
+extern void k_rcu_read_lock(void);
+
+/**
+ * @brief Leave an RCU read-side critical section.
+ *
+ * @return N/A
+ */
+extern void k_rcu_read_unlock(void);
+
+/**
+ * @brief Wait for an RCU grace period.
+ *
+ * Returns once every read-side critical section that was in progress when
+ * it was called has ended. After replacing a pointer with K_RCU_ASSIGN(),
+ * an updater calls this before freeing or reusing the old object, as no
+ * reader can still be using it. Updaters must serialize among themselves,
+ * e.g. with a mutex.
+ *
+ * On a uniprocessor system this returns immediately. It must not be called
+ * from an ISR or from a read-side critical section.
+ *
+ * @return N/A
+ */
+extern void k_rcu_synchronize(void);
+
+/**
+ * @brief Publish a pointer to RCU readers.
+ *
+ * Orders the initialization of the object pointed to by @a val before the
+ * store of @a val to @a ptr, so readers never see it half initialized.
+ *
+ * @param ptr Pointer variable, read by readers with K_RCU_DEREF()
+ * @param val New value
+ */
+#define K_RCU_ASSIGN(ptr, val) __atomic_store_n(&(ptr), (val), \
+						__ATOMIC_RELEASE)
+
+/**
+ * @brief Read a pointer published with K_RCU_ASSIGN().
+ *
+ * Must be used within a read-side critical section.
+ *
+ * @param ptr Pointer variable
+ * @return Value of @a ptr
+ */
+#define K_RCU_DEREF(ptr) __atomic_load_n(&(ptr), __ATOMIC_ACQUIRE)
+
+/**
+ * @}
+ */
+#endif /* CONFIG_RCU */
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+struct k_sem {
+	_wait_q_t wait_q;
+	u32_t count;
+	u32_t limit;
+	_POLL_EVENT;
+
+	_OBJECT_TRACING_NEXT_PTR(k_sem);
+};
+
+#define _K_SEM_INITIALIZER(obj, initial_count, count_limit) \
+	{ \
+	.wait_q = _WAIT_Q_INIT(&obj.wait_q), \
+	.count = initial_count, \
+	.limit = count_limit, \
+	_POLL_EVENT_OBJ_INIT(obj) \
+	_OBJECT_TRACING_INIT \
+	}
+
+#define K_SEM_INITIALIZER DEPRECATED_MACRO _K_SEM_INITIALIZER
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/**
+ * @defgroup semaphore_apis Semaphore APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/**
+ * @brief Initialize a semaphore.
  *
  * This routine initializes a semaphore object, prior to its first use.
  *
@@ -3150,6 +3854,150 @@ __syscall int k_alert_recv(struct k_alert *alert, s32_t timeout);
  */
 __syscall void k_alert_send(struct k_alert *alert);
 
+/**
+ * @}
+ */
+
+/**
+ * @defgroup event_apis Event APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/**
+ * Event object structure
+ * @ingroup event_apis
+ */
+struct k_event {
+	/** Threads waiting for events */
+	_wait_q_t wait_q;
+	/** Events posted and not yet cleared */
+	u32_t events;
+};
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+#define _K_EVENT_INITIALIZER(obj) \
+	{ \
+	.wait_q = _WAIT_Q_INIT(&obj.wait_q), \
+	.events = 0, \
+	}
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/**
+ * @brief Statically define and initialize an event object.
+ *
+ * The event object can be accessed outside the module where it is defined
+ * using:
+ *
+ * @code extern struct k_event <name>; @endcode
+ *
+ * @param name Name of the event object.
+ */
+#define K_EVENT_DEFINE(name) \
+	struct k_event name = _K_EVENT_INITIALIZER(name)
+
+/**
+ * @brief Initialize an event object.
+ *
+ * This routine initializes an event object, prior to its first use. Upon
+ * completion no event is posted.
+ *
+ * @param event Address of the event object.
+ *
+ * @return N/A
+ */
+__syscall void k_event_init(struct k_event *event);
+
+/**
+ * @brief Post events.
+ *
+ * This routine adds @a events to the events of @a event, and wakes the
+ * threads whose wait is then satisfied. Posting costs the same whatever
+ * the number of events, plus a check of each waiting thread.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param event Address of the event object.
+ * @param events Set of events to post.
+ *
+ * @return N/A
+ */
+__syscall void k_event_post(struct k_event *event, u32_t events);
+
+/**
+ * @brief Set the events.
+ *
+ * This routine is like k_event_post(), but replaces the events of
+ * @a event with @a events instead of adding them.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param event Address of the event object.
+ * @param events Set of events to set.
+ *
+ * @return N/A
+ */
+__syscall void k_event_set(struct k_event *event, u32_t events);
+
+/**
+ * @brief Clear events.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param event Address of the event object.
+ * @param events Set of events to clear.
+ *
+ * @return N/A
+ */
+__syscall void k_event_clear(struct k_event *event, u32_t events);
+
+/**
+ * @brief Wait for any of a set of events.
+ *
+ * This routine waits until at least one of @a events is posted to
+ * @a event, and returns those of @a events that are. If @a consume is
+ * true, they are cleared as they are returned, so a second waiter does
+ * not see them.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param event Address of the event object.
+ * @param events Set of events to wait for.
+ * @param consume Clear the events returned.
+ * @param timeout Waiting period (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @return Events of @a events that were posted, 0 if the waiting period
+ *         timed out.
+ */
+__syscall u32_t k_event_wait(struct k_event *event, u32_t events,
+			     bool consume, s32_t timeout);
+
+/**
+ * @brief Wait for all of a set of events.
+ *
+ * This routine is like k_event_wait(), but waits until all of @a events
+ * are posted.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param event Address of the event object.
+ * @param events Set of events to wait for.
+ * @param consume Clear the events returned.
+ * @param timeout Waiting period (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @return @a events if they were all posted, 0 if the waiting period
+ *         timed out.
+ */
+__syscall u32_t k_event_wait_all(struct k_event *event, u32_t events,
+				 bool consume, s32_t timeout);
+
 /**
  * @}
  */
@@ -3200,6 +4048,8 @@ struct k_msgq {
 
 
 #define K_MSGQ_FLAG_ALLOC	BIT(0)
+#define K_MSGQ_FLAG_PUT_CLAIM	BIT(1)
+#define K_MSGQ_FLAG_GET_CLAIM	BIT(2)
 
 /**
  * @brief Message Queue Attributes
@@ -3303,6 +4153,7 @@ void k_msgq_cleanup(struct k_msgq *q);
  * @retval 0 Message sent.
  * @retval -ENOMSG Returned without waiting or queue purged.
  * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY Returned without waiting; a put claim is in progress.
  * @req K-MSGQ-002
  */
 __syscall int k_msgq_put(struct k_msgq *q, void *data, s32_t timeout);
@@ -3321,18 +4172,109 @@ __syscall int k_msgq_put(struct k_msgq *q, void *data, s32_t timeout);
  *                or one of the special values K_NO_WAIT and K_FOREVER.
  *
  * @retval 0 Message received.
- * @retval -ENOMSG Returned without waiting.
+ * @retval -ENOMSG Returned without waiting or queue purged.
  * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY Returned without waiting; a get claim is in progress.
  * @req K-MSGQ-002
  */
 __syscall int k_msgq_get(struct k_msgq *q, void *data, s32_t timeout);
 
+/**
+ * @brief Claim a message slot for writing in place.
+ *
+ * This routine reserves the next free slot of message queue @a q and
+ * returns its address in @a data, so that the message can be written
+ * directly into the queue's ring buffer instead of being copied in by
+ * k_msgq_put(). The message is sent by k_msgq_put_finish().
+ *
+ * Only one put claim can be in progress on a message queue at a time.
+ * Until it finishes, other put claims and k_msgq_put() wait for it, or
+ * fail with -EBUSY if told not to wait. A user mode thread
+ * needs access to the queue's buffer to claim a slot.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param q Address of the message queue.
+ * @param data Address of area to hold the address of the claimed slot.
+ * @param timeout Waiting period for a free slot (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Slot claimed.
+ * @retval -ENOMSG Returned without waiting or queue purged.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY Returned without waiting; another put claim is in
+ *                progress.
+ */
+__syscall int k_msgq_put_claim(struct k_msgq *q, void **data, s32_t timeout);
+
+/**
+ * @brief Send a message written in place.
+ *
+ * This routine sends the message written to the slot claimed with
+ * k_msgq_put_claim(). If a thread is waiting in k_msgq_get() the message
+ * is copied to it, just as k_msgq_put() would.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param q Address of the message queue.
+ *
+ * @return N/A
+ */
+__syscall void k_msgq_put_finish(struct k_msgq *q);
+
+/**
+ * @brief Claim the oldest message for reading in place.
+ *
+ * This routine returns the address of the first message of message queue
+ * @a q in @a data without removing it from the queue, so that it can be
+ * read directly from the queue's ring buffer instead of being copied out
+ * by k_msgq_get(). The message is removed by k_msgq_get_finish().
+ *
+ * Only one get claim can be in progress on a message queue at a time.
+ * Until it finishes, other get claims and k_msgq_get() wait for it, or
+ * fail with -EBUSY if told not to wait. A user mode thread
+ * needs access to the queue's buffer to claim a message.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param q Address of the message queue.
+ * @param data Address of area to hold the address of the message.
+ * @param timeout Waiting period for a message (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Message claimed.
+ * @retval -ENOMSG Returned without waiting or queue purged.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY Returned without waiting; another get claim is in
+ *                progress.
+ */
+__syscall int k_msgq_get_claim(struct k_msgq *q, void **data, s32_t timeout);
+
+/**
+ * @brief Release a message read in place.
+ *
+ * This routine removes the message claimed with k_msgq_get_claim() from
+ * the queue, freeing its slot.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param q Address of the message queue.
+ *
+ * @return N/A
+ */
+__syscall void k_msgq_get_finish(struct k_msgq *q);
+
 /**
  * @brief Purge a message queue.
  *
  * This routine discards all unreceived messages in a message queue's ring
  * buffer. Any threads that are blocked waiting to send a message to the
- * message queue are unblocked and see an -ENOMSG error code.
+ * message queue are unblocked and see an -ENOMSG error code, as are those
+ * waiting to receive one.
+ *
+ * A message claimed with k_msgq_get_claim() is kept until
+ * k_msgq_get_finish() removes it. If a put claim is also in progress, the
+ * messages queued after the claimed one are kept as well.
  *
  * @param q Address of the message queue.
  *
@@ -3643,6 +4585,8 @@ struct k_pipe {
  * @cond INTERNAL_HIDDEN
  */
 #define K_PIPE_FLAG_ALLOC	BIT(0)	/** Buffer was allocated */
+#define K_PIPE_FLAG_PUT_CLAIM	BIT(1)	/** Buffer space claimed */
+#define K_PIPE_FLAG_GET_CLAIM	BIT(2)	/** Buffer data claimed */
 
 #define _K_PIPE_INITIALIZER(obj, pipe_buffer, pipe_buffer_size)        \
 	{                                                             \
@@ -3747,6 +4691,7 @@ __syscall int k_pipe_alloc_init(struct k_pipe *pipe, size_t size);
  * @retval -EIO Returned without waiting; zero data bytes were written.
  * @retval -EAGAIN Waiting period timed out; between zero and @a min_xfer
  *                 minus one data bytes were written.
+ * @retval -EBUSY A put claim is in progress; zero data bytes were written.
  * @req K-PIPE-002
  */
 __syscall int k_pipe_put(struct k_pipe *pipe, void *data,
@@ -3771,18 +4716,110 @@ __syscall int k_pipe_put(struct k_pipe *pipe, void *data,
  * @retval -EIO Returned without waiting; zero data bytes were read.
  * @retval -EAGAIN Waiting period timed out; between zero and @a min_xfer
  *                 minus one data bytes were read.
+ * @retval -EBUSY A get claim is in progress; zero data bytes were read.
  * @req K-PIPE-002
  */
 __syscall int k_pipe_get(struct k_pipe *pipe, void *data,
 			 size_t bytes_to_read, size_t *bytes_read,
 			 size_t min_xfer, s32_t timeout);
 
+/**
+ * @brief Claim space in a pipe's buffer for writing in place.
+ *
+ * This routine returns the address of contiguous free space in the
+ * buffer of @a pipe in @a data, so that data can be written directly into
+ * it instead of being copied in by k_pipe_put(). On entry @a bytes holds
+ * the number of bytes wanted, on return the number of bytes claimed,
+ * which may be less when the free space wraps around the end of the
+ * buffer. The data is added to the pipe by k_pipe_put_finish().
+ *
+ * Only one put claim can be in progress on a pipe at a time. Until it
+ * finishes, other put claims and k_pipe_put() fail with -EBUSY, including
+ * claims already waiting for free space. A user mode thread needs access
+ * to the pipe's buffer to claim it.
+ *
+ * @param pipe Address of the pipe.
+ * @param data Address of area to hold the address of the claimed space.
+ * @param bytes Address of the number of bytes wanted/claimed.
+ * @param timeout Waiting period for free space (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Space claimed.
+ * @retval -EINVAL The pipe has no buffer.
+ * @retval -EIO Returned without waiting; the buffer is full.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY Another put claim is in progress.
+ */
+__syscall int k_pipe_put_claim(struct k_pipe *pipe, void **data,
+			       size_t *bytes, s32_t timeout);
+
+/**
+ * @brief Add data written in place to a pipe.
+ *
+ * This routine adds the first @a bytes bytes of the space claimed with
+ * k_pipe_put_claim() to the data in the pipe, and ends the claim. Readers
+ * waiting in k_pipe_get() are given the data as k_pipe_put() would.
+ *
+ * @param pipe Address of the pipe.
+ * @param bytes Number of bytes written, at most the number claimed.
+ *
+ * @return N/A
+ */
+__syscall void k_pipe_put_finish(struct k_pipe *pipe, size_t bytes);
+
+/**
+ * @brief Claim data in a pipe's buffer for reading in place.
+ *
+ * This routine returns the address of contiguous data in the buffer of
+ * @a pipe in @a data, so that it can be read directly instead of being
+ * copied out by k_pipe_get(). On entry @a bytes holds the number of bytes
+ * wanted, on return the number of bytes claimed, which may be less when
+ * the data wraps around the end of the buffer. The data is removed from
+ * the pipe by k_pipe_get_finish().
+ *
+ * Only data in the pipe's buffer can be claimed: data of writers blocked
+ * in k_pipe_put() enters the buffer as space is freed. Only one get claim
+ * can be in progress on a pipe at a time. Until it finishes, other get
+ * claims and k_pipe_get() fail with -EBUSY, including claims already
+ * waiting for data. A user mode thread needs access to the pipe's buffer
+ * to claim it.
+ *
+ * @param pipe Address of the pipe.
+ * @param data Address of area to hold the address of the claimed data.
+ * @param bytes Address of the number of bytes wanted/claimed.
+ * @param timeout Waiting period for data (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Data claimed.
+ * @retval -EINVAL The pipe has no buffer.
+ * @retval -EIO Returned without waiting; the buffer is empty.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY Another get claim is in progress.
+ */
+__syscall int k_pipe_get_claim(struct k_pipe *pipe, void **data,
+			       size_t *bytes, s32_t timeout);
+
+/**
+ * @brief Remove data read in place from a pipe.
+ *
+ * This routine removes the first @a bytes bytes of the data claimed with
+ * k_pipe_get_claim() from the pipe, and ends the claim. Writers waiting
+ * in k_pipe_put() refill the freed space.
+ *
+ * @param pipe Address of the pipe.
+ * @param bytes Number of bytes read, at most the number claimed.
+ *
+ * @return N/A
+ */
+__syscall void k_pipe_get_finish(struct k_pipe *pipe, size_t bytes);
+
 /**
  * @brief Write memory block to a pipe.
  *
  * This routine writes the data contained in a memory block to @a pipe.
  * Once all of the data in the block has been written to the pipe, it will
  * free the memory block @a block and give the semaphore @a sem (if specified).
+ * The data is dropped, and the same done, if a put claim is in progress.
  *
  * @param pipe Address of the pipe.
  * @param block Memory block containing data to send
@@ -3801,14 +4838,42 @@ extern void k_pipe_block_put(struct k_pipe *pipe, struct k_mem_block *block,
  * @cond INTERNAL_HIDDEN
  */
 
+#ifdef CONFIG_MEM_SLAB_CACHE
+struct _mem_slab_cache {
+	struct k_spinlock lock;
+	u32_t count;
+	void *blocks[CONFIG_MEM_SLAB_CACHE_SIZE];
+};
+#endif
+
+struct k_mem_slab_stats {
+	/* highest num_used seen, blocks held in per-CPU caches included */
+	u32_t max_used;
+	/* allocations that found no free block */
+	u32_t num_exhausted;
+	/* operations that had to lock the shared free list */
+	u32_t num_shared;
+};
+
 struct k_mem_slab {
 	_wait_q_t wait_q;
 	u32_t num_blocks;
 	size_t block_size;
 	char *buffer;
 	char *free_list;
+	/* blocks not on free_list, including those in the per-CPU caches */
 	u32_t num_used;
 
+#ifdef CONFIG_MEM_SLAB_CACHE
+	/* threads pending on wait_q, checked locklessly after a cached free */
+	atomic_t waiters;
+	struct _mem_slab_cache cache[CONFIG_MP_NUM_CPUS];
+#endif
+
+#ifdef CONFIG_MEM_SLAB_STATS
+	struct k_mem_slab_stats stats;
+#endif
+
 	_OBJECT_TRACING_NEXT_PTR(k_mem_slab);
 };
 
@@ -3934,7 +4999,17 @@ extern void k_mem_slab_free(struct k_mem_slab *slab, void **mem);
  */
 static inline u32_t k_mem_slab_num_used_get(struct k_mem_slab *slab)
 {
+#ifdef CONFIG_MEM_SLAB_CACHE
+	u32_t cached = 0;
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		cached += slab->cache[i].count;
+	}
+
+	return slab->num_used - cached;
+#else
 	return slab->num_used;
+#endif
 }
 
 /**
@@ -3950,9 +5025,31 @@ static inline u32_t k_mem_slab_num_used_get(struct k_mem_slab *slab)
  */
 static inline u32_t k_mem_slab_num_free_get(struct k_mem_slab *slab)
 {
-	return slab->num_blocks - slab->num_used;
+	return slab->num_blocks - k_mem_slab_num_used_get(slab);
 }
 
+/**
+ * @brief Get usage statistics of a memory slab.
+ *
+ * This routine copies the usage statistics gathered for @a slab since it
+ * was initialized: the high-water mark of used blocks, the number of
+ * allocations that found the slab exhausted and the number of operations
+ * that had to lock the slab's shared free list.
+ *
+ * With CONFIG_MEM_SLAB_CACHE the high-water mark also counts blocks held
+ * in per-CPU caches, so it may exceed the real peak by up to
+ * CONFIG_MEM_SLAB_CACHE_SIZE blocks per CPU.
+ *
+ * @note Only available with CONFIG_MEM_SLAB_STATS.
+ *
+ * @param slab Address of the memory slab.
+ * @param stats Address of the structure to fill in.
+ *
+ * @return N/A
+ */
+extern void k_mem_slab_stats_get(struct k_mem_slab *slab,
+				 struct k_mem_slab_stats *stats);
+
 /** @} */
 
 /**
@@ -4132,6 +5229,7 @@ extern void *k_calloc(size_t nmemb, size_t size);
 
 /* private - implementation data created as needed, per-type */
 struct _poller {
+	/* NULL for the poller embedded in a struct k_poll_set */
 	struct k_thread *thread;
 	volatile int is_polling;
 };
@@ -4425,6 +5523,106 @@ __syscall void k_poll_signal_check(struct k_poll_signal *signal,
 
 __syscall int k_poll_signal_raise(struct k_poll_signal *signal, int result);
 
+/* public - persistent poll set */
+struct k_poll_set {
+	/* PRIVATE - DO NOT TOUCH */
+	struct _poller poller;
+
+	/* PRIVATE - DO NOT TOUCH: events waiting to be reported */
+	sys_dlist_t ready;
+
+	/* PRIVATE - DO NOT TOUCH: events reported by the last wait */
+	sys_dlist_t reported;
+
+	/* PRIVATE - DO NOT TOUCH */
+	_wait_q_t wait_q;
+};
+
+/* public - member of a persistent poll set */
+struct k_poll_set_event {
+	/* initialized with k_poll_event_init() before being added */
+	struct k_poll_event event;
+
+	/* PRIVATE - DO NOT TOUCH */
+	sys_dnode_t _ready_node;
+
+	/* PRIVATE - DO NOT TOUCH */
+	u8_t _list;
+};
+
+/**
+ * @brief Initialize a persistent poll set.
+ *
+ * A poll set is an alternative to k_poll() for a thread that repeatedly
+ * waits on the same, possibly large, group of events.  Events are
+ * registered with their objects once, by k_poll_set_add(), instead of on
+ * every call, and the objects push them onto the set's ready list when
+ * they trigger, so that k_poll_set_wait() costs time proportional to the
+ * number of ready events rather than to the size of the set.
+ *
+ * Poll sets are not available to user mode threads.
+ *
+ * @param set The poll set to initialize.
+ *
+ * @return N/A
+ */
+extern void k_poll_set_init(struct k_poll_set *set);
+
+/**
+ * @brief Add an event to a persistent poll set.
+ *
+ * The event stays registered with its object until it is removed with
+ * k_poll_set_remove(), which must be done before the object or @a event
+ * is reused or goes out of scope.  If the event's condition is already
+ * met it is ready immediately.
+ *
+ * @param set The poll set.
+ * @param event Set event, whose @a event member was initialized with
+ *              k_poll_event_init().  It must not be in any other set.
+ *
+ * @retval 0 The event was added.
+ */
+extern int k_poll_set_add(struct k_poll_set *set,
+			  struct k_poll_set_event *event);
+
+/**
+ * @brief Remove an event from a persistent poll set.
+ *
+ * @param set The poll set.
+ * @param event An event previously added to @a set.
+ *
+ * @return N/A
+ */
+extern void k_poll_set_remove(struct k_poll_set *set,
+			      struct k_poll_set_event *event);
+
+/**
+ * @brief Wait for events of a persistent poll set to be ready.
+ *
+ * This routine returns the events of @a set that are ready, waiting up to
+ * @a timeout for at least one to be.  The state field of each returned
+ * event tells what happened and stays valid until the next call.
+ *
+ * Reporting is level-triggered: an event is reported again by the next
+ * call if its condition still holds then (e.g. the queue still has data),
+ * whereas K_POLL_STATE_CANCELLED is only reported once.  The same
+ * precedence rules as for k_poll() apply.
+ *
+ * Only one thread may wait on a given set at a time.
+ *
+ * @param set The poll set.
+ * @param ready Array filled with the ready events.
+ * @param max Size of the @a ready array.
+ * @param timeout Waiting period for an event to be ready (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @return Number of events stored in @a ready, at least 1.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+extern int k_poll_set_wait(struct k_poll_set *set,
+			   struct k_poll_set_event **ready, int max,
+			   s32_t timeout);
+
 /**
  * @internal
  */
@@ -34,5 +34,6 @@
 #include <arch/cpu.h>
 #include <misc/rb.h>
 #include <sys_clock.h>
+#include <spinlock.h>
 
 #endif /* ZEPHYR_INCLUDE_KERNEL_INCLUDES_H_ */
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_MISC_HEAP_H_
+#define ZEPHYR_INCLUDE_MISC_HEAP_H_
+
+#include <zephyr/types.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <toolchain.h>
+
+/*
+ * General purpose heap using a two-level segregated fit (TLSF) allocator.
+ *
+ * Free blocks are kept on one list per size class. The first level of
+ * classes are powers of two, each split linearly into SYS_HEAP_SL_COUNT
+ * second level classes, and a bitmap per level makes finding a non-empty
+ * class a couple of find-first-set operations. Allocation and free are
+ * O(1), blocks are split to the requested size and coalesced with their
+ * free neighbours on free, so unlike the buddy based sys_mem_pool there
+ * is no rounding up to powers of two.
+ *
+ * A sys_heap does no locking of its own: callers serialize access, with
+ * irq_lock() or a mutex as appropriate.
+ */
+
+/* Log2 of the number of second level size classes per power of two */
+#define SYS_HEAP_SL_LOG2 3
+#define SYS_HEAP_SL_COUNT (1 << SYS_HEAP_SL_LOG2)
+
+/* Alignment of all memory returned by sys_heap_alloc() */
+#define SYS_HEAP_ALIGN (2 * sizeof(void *))
+
+struct z_heap;
+
+struct sys_heap {
+	struct z_heap *heap;
+	void *init_mem;
+	size_t init_bytes;
+};
+
+struct sys_heap_stats {
+	/* bytes available for allocation, in all free blocks */
+	size_t free_bytes;
+	/* bytes handed out, including per-block overhead */
+	size_t allocated_bytes;
+	/* high-water mark of allocated_bytes */
+	size_t max_allocated_bytes;
+};
+
+/**
+ * @brief Initialize a heap
+ *
+ * Sets up a heap in the @a bytes long memory area at @a mem. A few
+ * hundred bytes of it are used for the heap's own bookkeeping.
+ *
+ * @param h Heap to initialize
+ * @param mem Start of the memory area
+ * @param bytes Size of the memory area
+ */
+void sys_heap_init(struct sys_heap *h, void *mem, size_t bytes);
+
+/**
+ * @brief Allocate memory from a heap
+ *
+ * The returned memory is aligned to SYS_HEAP_ALIGN bytes.
+ *
+ * @param h Heap to allocate from
+ * @param bytes Number of bytes requested
+ * @return Pointer to the memory, or NULL if no large enough block is free
+ */
+void *sys_heap_alloc(struct sys_heap *h, size_t bytes);
+
+/**
+ * @brief Free memory allocated from a heap
+ *
+ * It is safe to pass NULL to this function, in which case it is a no-op.
+ *
+ * @param h Heap the memory was allocated from
+ * @param mem Pointer returned by sys_heap_alloc()
+ */
+void sys_heap_free(struct sys_heap *h, void *mem);
+
+/**
+ * @brief Get the usable size of an allocation
+ *
+ * Returns the number of bytes that may actually be used at @a mem, which
+ * is at least the size that was requested from sys_heap_alloc().
+ *
+ * @param h Heap the memory was allocated from
+ * @param mem Pointer returned by sys_heap_alloc()
+ * @return Usable size in bytes
+ */
+size_t sys_heap_usable_size(struct sys_heap *h, void *mem);
+
+/**
+ * @brief Check whether memory belongs to a heap
+ *
+ * @param h Heap to check
+ * @param mem Any pointer
+ * @return true if @a mem lies within the memory managed by @a h
+ */
+static inline bool sys_heap_contains(struct sys_heap *h, void *mem)
+{
+	return (u8_t *)mem >= (u8_t *)h->init_mem &&
+		(u8_t *)mem < (u8_t *)h->init_mem + h->init_bytes;
+}
+
+/**
+ * @brief Heap walk callback
+ *
+ * @param mem Start of the block's usable memory
+ * @param bytes Usable size of the block
+ * @param used true if the block is allocated, false if it is free
+ * @param user_data Pointer passed to sys_heap_walk()
+ */
+typedef void (*sys_heap_walk_cb_t)(void *mem, size_t bytes, bool used,
+				   void *user_data);
+
+/**
+ * @brief Walk all blocks of a heap
+ *
+ * Calls @a cb for every block of the heap, free or allocated, in address
+ * order. The heap must not be modified during the walk.
+ *
+ * @param h Heap to walk
+ * @param cb Callback
+ * @param user_data Passed through to @a cb
+ */
+void sys_heap_walk(struct sys_heap *h, sys_heap_walk_cb_t cb,
+		   void *user_data);
+
+/**
+ * @brief Get heap usage statistics
+ *
+ * @param h Heap to query
+ * @param stats Filled in with the current statistics
+ */
+void sys_heap_stats_get(struct sys_heap *h, struct sys_heap_stats *stats);
+
+/**
+ * @brief Check the heap's internal consistency
+ *
+ * Walks the heap and its free lists and checks that blocks are correctly
+ * linked, that no two free blocks are adjacent and that every free block
+ * is on the list of its size class. Meant for tests and debugging.
+ *
+ * @param h Heap to check
+ * @return true if the heap is consistent
+ */
+bool sys_heap_validate(struct sys_heap *h);
+
+#endif /* ZEPHYR_INCLUDE_MISC_HEAP_H_ */
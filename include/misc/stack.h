@@ -44,14 +44,27 @@ static inline size_t stack_unused_space_get(const char *stack, size_t size)
 		}
 	}
 #else
-	size_t i;
-	for (i = 0; i < size; i++) {
-		if (checked_stack[i] == 0xaaU) {
-			unused++;
-		} else {
-			break;
+	const unsigned char *end = checked_stack + size;
+	const unsigned char *p = checked_stack;
+
+	/* Compare a word at a time from the first word boundary on, and
+	 * finish with the bytes of the first word that was overwritten.
+	 */
+	while (p < end && ((uintptr_t)p & (sizeof(u32_t) - 1)) != 0 &&
+	       *p == 0xaaU) {
+		p++;
+	}
+	if (((uintptr_t)p & (sizeof(u32_t) - 1)) == 0) {
+		while (end - p >= sizeof(u32_t) &&
+		       *(const u32_t *)p == 0xaaaaaaaaU) {
+			p += sizeof(u32_t);
 		}
 	}
+	while (p < end && *p == 0xaaU) {
+		p++;
+	}
+
+	unused = p - checked_stack;
 #endif
 	return unused;
 }
@@ -13,6 +13,7 @@
 #include <stddef.h>
 #include <zephyr/types.h>
 #include <misc/util.h>
+#include <misc/heap.h>
 #include <zephyr.h>
 
 #ifdef __cplusplus
@@ -657,7 +658,17 @@ extern const struct net_buf_data_cb net_buf_fixed_cb;
 		NET_BUF_POOL_INITIALIZER(_name, &net_buf_fixed_alloc_##_name, \
 					 net_buf_##_name, _count, _destroy)
 
+#if defined(CONFIG_NET_BUF_VAR_POOL_TLSF)
+struct net_buf_pool_var_heap {
+	struct sys_heap heap;
+	u8_t *mem;
+	size_t size;
+};
+
+extern const struct net_buf_data_cb net_buf_var_heap_cb;
+#else
 extern const struct net_buf_data_cb net_buf_var_cb;
+#endif
 
 /** @def NET_BUF_POOL_VAR_DEFINE
  *  @brief Define a new pool for buffers with variable size payloads
@@ -672,6 +683,12 @@ extern const struct net_buf_data_cb net_buf_var_cb;
  *  The data payload of the buffers will be based on a memory pool from which
  *  variable size payloads may be allocated.
  *
+ *  With CONFIG_NET_BUF_VAR_POOL_TLSF the payloads come from a sys_heap
+ *  instead, which keeps a few hundred bytes of @a _data_size for its own
+ *  bookkeeping. Such pools do not block on the data allocation, so the
+ *  timeout passed to net_buf_alloc will be always treated as K_NO_WAIT
+ *  when trying to allocate the data.
+ *
  *  If provided with a custom destroy callback, this callback is
  *  responsible for eventually calling net_buf_destroy() to complete the
  *  process of returning the buffer to the pool.
@@ -681,6 +698,24 @@ extern const struct net_buf_data_cb net_buf_var_cb;
  *  @param _data_size Total amount of memory available for data payloads.
  *  @param _destroy   Optional destroy callback when buffer is freed.
  */
+#if defined(CONFIG_NET_BUF_VAR_POOL_TLSF)
+#define NET_BUF_POOL_VAR_DEFINE(_name, _count, _data_size, _destroy)          \
+	static struct net_buf _net_buf_##_name[_count] __noinit;              \
+	static u8_t __noinit __aligned(SYS_HEAP_ALIGN)                        \
+		net_buf_mem_##_name[_data_size];                              \
+	static struct net_buf_pool_var_heap net_buf_var_heap_##_name = {      \
+		.mem = net_buf_mem_##_name,                                   \
+		.size = _data_size,                                           \
+	};                                                                    \
+	static const struct net_buf_data_alloc net_buf_data_alloc_##_name = { \
+		.cb = &net_buf_var_heap_cb,                                   \
+		.alloc_data = &net_buf_var_heap_##_name,                      \
+	};                                                                    \
+	struct net_buf_pool _name __net_buf_align                             \
+			__in_section(_net_buf_pool, static, _name) =          \
+		NET_BUF_POOL_INITIALIZER(_name, &net_buf_data_alloc_##_name,  \
+					 _net_buf_##_name, _count, _destroy)
+#else
 #define NET_BUF_POOL_VAR_DEFINE(_name, _count, _data_size, _destroy)          \
 	static struct net_buf _net_buf_##_name[_count] __noinit;              \
 	K_MEM_POOL_DEFINE(net_buf_mem_pool_##_name, 16, _data_size, 1, 4);    \
@@ -692,6 +727,7 @@ extern const struct net_buf_data_cb net_buf_var_cb;
 			__in_section(_net_buf_pool, static, _name) =          \
 		NET_BUF_POOL_INITIALIZER(_name, &net_buf_data_alloc_##_name,  \
 					 _net_buf_##_name, _count, _destroy)
+#endif /* CONFIG_NET_BUF_VAR_POOL_TLSF */
 
 /** @def NET_BUF_POOL_DEFINE
  *  @brief Define a new pool for buffers
@@ -843,6 +843,12 @@ int net_context_update_recv_wnd(struct net_context *context,
 
 enum net_context_option {
 	NET_OPT_PRIORITY = 1,
+	/** TCP congestion control algorithm, a name such as "newreno" or
+	 * "cubic" of at most 15 characters. When getting it, the length
+	 * given is the size of the buffer, which must fit the name and its
+	 * terminating NUL.
+	 */
+	NET_OPT_TCP_CONGESTION = 2,
 };
 
 /**
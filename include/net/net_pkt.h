@@ -130,6 +130,10 @@ struct net_pkt {
 				     * Used only if
 				     * defined(CONFIG_NET_IPV4_AUTO)
 				     */
+	u8_t chksum_ok : 1;	/* For incoming packet: the driver already
+				 * verified the TCP or UDP checksum, so the
+				 * stack does not need to.
+				 */
 
 	union {
 		/* IPv6 hop limit or IPv4 ttl for this network packet.
@@ -309,6 +313,16 @@ static inline void net_pkt_set_queued(struct net_pkt *pkt, bool send)
 	pkt->pkt_queued = send;
 }
 
+static inline bool net_pkt_chksum_ok(struct net_pkt *pkt)
+{
+	return pkt->chksum_ok;
+}
+
+static inline void net_pkt_set_chksum_ok(struct net_pkt *pkt, bool ok)
+{
+	pkt->chksum_ok = ok;
+}
+
 #if defined(CONFIG_NET_SOCKETS)
 static inline u8_t net_pkt_eof(struct net_pkt *pkt)
 {
@@ -147,6 +147,24 @@ __syscall int zsock_fcntl(int sock, int cmd, int flags);
 
 __syscall int zsock_poll(struct zsock_pollfd *fds, int nfds, int timeout);
 
+/**
+ * @brief Add a socket to a persistent poll set
+ *
+ * Registers a ZSOCK_POLLIN-style event for @a sock in @a set once, so
+ * that a server waiting on many sockets with k_poll_set_wait() does not
+ * pay for registering all of them on every wait as zsock_poll() does.
+ * The event must be removed with k_poll_set_remove() before the socket
+ * is closed.  Not available to user mode threads.
+ *
+ * @param set Poll set, initialized with k_poll_set_init()
+ * @param event Set event to use for the socket
+ * @param sock Socket descriptor
+ *
+ * @return 0 on success, -1 with errno set to EBADF if @a sock is invalid
+ */
+int zsock_poll_set_add(struct k_poll_set *set, struct k_poll_set_event *event,
+		       int sock);
+
 int zsock_getsockopt(int sock, int level, int optname,
 		     void *optval, socklen_t *optlen);
 
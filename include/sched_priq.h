@@ -6,6 +6,8 @@
 #ifndef ZEPHYR_INCLUDE_SCHED_PRIQ_H_
 #define ZEPHYR_INCLUDE_SCHED_PRIQ_H_
 
+#include <toolchain.h>
+#include <zephyr/types.h>
 #include <misc/util.h>
 #include <misc/dlist.h>
 #include <misc/rb.h>
@@ -60,4 +62,35 @@ void _priq_mq_add(struct _priq_mq *pq, struct k_thread *thread);
 void _priq_mq_remove(struct _priq_mq *pq, struct k_thread *thread);
 struct k_thread *_priq_mq_best(struct _priq_mq *pq);
 
+/* Bitmap-indexed multi-queue.  Like _priq_mq there is one list per
+ * priority, but it covers every configured priority, and a two-level
+ * bitmap finds the best non-empty list with two count-leading-zeros
+ * operations.  Bits are numbered from the MSB so the lookup maps onto
+ * a plain CLZ instruction, which more architectures have than CTZ.
+ * With deadline scheduling each list is kept sorted by deadline,
+ * otherwise threads of equal priority are queued FIFO.
+ */
+#define _PRIQ_BM_PRIOS (CONFIG_NUM_COOP_PRIORITIES + \
+			CONFIG_NUM_PREEMPT_PRIORITIES + 1)
+#define _PRIQ_BM_WORDS ((_PRIQ_BM_PRIOS + 31) / 32)
+
+#if defined(CONFIG_CACHE_LINE_SIZE) && (CONFIG_CACHE_LINE_SIZE > 0)
+#define _PRIQ_BM_ALIGN CONFIG_CACHE_LINE_SIZE
+#else
+#define _PRIQ_BM_ALIGN 32
+#endif
+
+struct _priq_bm {
+	/* bit (31 - w) set if words[w] is non-zero */
+	u32_t top;
+	/* bit (31 - i % 32) of words[i / 32] set if queues[i] is non-empty */
+	u32_t words[_PRIQ_BM_WORDS];
+	/* Aligned so that no list head straddles a cache line */
+	sys_dlist_t queues[_PRIQ_BM_PRIOS] __aligned(_PRIQ_BM_ALIGN);
+};
+
+void _priq_bm_add(struct _priq_bm *pq, struct k_thread *thread);
+void _priq_bm_remove(struct _priq_bm *pq, struct k_thread *thread);
+struct k_thread *_priq_bm_best(struct _priq_bm *pq);
+
 #endif /* ZEPHYR_INCLUDE_SCHED_PRIQ_H_ */
@@ -18,6 +18,7 @@
 
 #include <misc/util.h>
 #include <misc/dlist.h>
+#include <misc/rb.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -210,9 +211,20 @@ struct _timeout;
 typedef void (*_timeout_func_t)(struct _timeout *t);
 
 struct _timeout {
+#ifdef CONFIG_TIMEOUT_QUEUE_SCALABLE
+	struct rbnode node;
+	/* Absolute expiry tick, and insertion order for equal ticks */
+	u64_t tick;
+	u32_t order_key;
+#else
 	sys_dnode_t node;
+#endif
 	s32_t dticks;
 	_timeout_func_t fn;
+#ifdef CONFIG_TIMER_COALESCING
+	/* Ticks the expiry may be delayed by to share a wakeup */
+	s32_t slack;
+#endif
 };
 
 /*
@@ -8,7 +8,7 @@
 
 #include <kernel.h>
 
-/* Below IDs are used with systemview, not final to the zephyr tracing API */
+/* Below IDs are used with systemview and CTF, not final to the zephyr tracing API */
 #define SYS_TRACE_ID_OFFSET                  (32u)
 
 #define SYS_TRACE_ID_MUTEX_INIT              (1u + SYS_TRACE_ID_OFFSET)
@@ -28,6 +28,8 @@ void z_sys_trace_thread_switched_out(void);
 
 #ifdef CONFIG_SEGGER_SYSTEMVIEW
 #include "tracing_sysview.h"
+#elif defined(CONFIG_TRACING_CTF)
+#include "tracing_ctf.h"
 #else
 
 /**
@@ -6,7 +6,9 @@
 
 #include <errno.h>
 #include <string.h>
+#include <kernel.h>
 #include <device.h>
+#include <init.h>
 #include <misc/util.h>
 #include <atomic.h>
 
@@ -24,6 +26,171 @@ extern u32_t __device_busy_end[];
 #define DEVICE_BUSY_SIZE (__device_busy_end - __device_busy_start)
 #endif
 
+static struct device *config_levels[] = {
+	__device_PRE_KERNEL_1_start,
+	__device_PRE_KERNEL_2_start,
+	__device_POST_KERNEL_start,
+	__device_APPLICATION_start,
+	/* End marker */
+	__device_init_end,
+};
+
+#ifdef CONFIG_BOOT_PROFILE
+static u32_t level_cycles[ARRAY_SIZE(config_levels) - 1];
+
+u32_t sys_init_level_cycles_get(s32_t level)
+{
+	if (level < 0 || level >= ARRAY_SIZE(level_cycles)) {
+		return 0;
+	}
+
+	return level_cycles[level];
+}
+
+static void boot_profile_print(void)
+{
+	static const char * const level_names[] = {
+		"PRE_KERNEL_1", "PRE_KERNEL_2", "POST_KERNEL", "APPLICATION"
+	};
+
+	printk("Boot profile (us, * ran in parallel):\n");
+
+	for (int level = 0; level < ARRAY_SIZE(level_cycles); level++) {
+		printk("%-12s %8u\n", level_names[level],
+		       SYS_CLOCK_HW_CYCLES_TO_NS(level_cycles[level]) / 1000);
+
+		for (struct device *info = config_levels[level];
+		     info < config_levels[level + 1]; info++) {
+			bool parallel = false;
+
+#ifdef CONFIG_SYS_INIT_PARALLEL
+			parallel = info->config->init_parallel != 0 &&
+				   level >= _SYS_INIT_LEVEL_POST_KERNEL;
+#endif
+			printk("  %8u %c %p %s\n",
+			       SYS_CLOCK_HW_CYCLES_TO_NS(info->init_cycles) /
+			       1000, parallel ? '*' : ' ',
+			       info->config->init, info->config->name);
+		}
+	}
+}
+#endif
+
+static void device_init(struct device *info)
+{
+	struct device_config *device_conf = info->config;
+#ifdef CONFIG_BOOT_PROFILE
+	u32_t start = k_cycle_get_32();
+
+	(void)device_conf->init(info);
+	info->init_cycles = k_cycle_get_32() - start;
+#else
+	(void)device_conf->init(info);
+#endif
+	_k_object_init(info);
+}
+
+#ifdef CONFIG_SYS_INIT_PARALLEL
+#define PARALLEL_THREADS CONFIG_SYS_INIT_PARALLEL_THREADS
+
+static K_THREAD_STACK_ARRAY_DEFINE(parallel_stacks, PARALLEL_THREADS,
+				   CONFIG_SYS_INIT_PARALLEL_STACK_SIZE);
+static struct k_thread parallel_threads[PARALLEL_THREADS];
+static K_SEM_DEFINE(parallel_start, 0, PARALLEL_THREADS);
+static K_SEM_DEFINE(parallel_done, 0, PARALLEL_THREADS);
+
+/* devices of the level being run, the index of the next one to claim,
+ * and whether the worker threads should exit
+ */
+static struct device *parallel_devices;
+static int parallel_count;
+static atomic_t parallel_index;
+static bool parallel_exit;
+
+static bool is_parallel(struct device *info)
+{
+	return info->config->init_parallel != 0;
+}
+
+/* Claim and run the parallel init functions nobody has claimed yet */
+static void parallel_run(void)
+{
+	int i;
+
+	while ((i = atomic_inc(&parallel_index)) < parallel_count) {
+		if (is_parallel(&parallel_devices[i])) {
+			device_init(&parallel_devices[i]);
+		}
+	}
+}
+
+static void parallel_main(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		k_sem_take(&parallel_start, K_FOREVER);
+		if (parallel_exit) {
+			return;
+		}
+
+		parallel_run();
+		k_sem_give(&parallel_done);
+	}
+}
+
+static void parallel_level(s32_t level)
+{
+	struct device *info;
+
+	if (level == _SYS_INIT_LEVEL_POST_KERNEL) {
+		int prio = k_thread_priority_get(k_current_get());
+
+		for (int i = 0; i < PARALLEL_THREADS; i++) {
+			struct k_thread *thread = &parallel_threads[i];
+
+			k_thread_create(thread, parallel_stacks[i],
+					CONFIG_SYS_INIT_PARALLEL_STACK_SIZE,
+					parallel_main, NULL, NULL, NULL, prio,
+					0, K_NO_WAIT);
+			k_thread_name_set(thread, "sysinit");
+		}
+	}
+
+	parallel_devices = config_levels[level];
+	parallel_count = config_levels[level + 1] - config_levels[level];
+	atomic_set(&parallel_index, 0);
+
+	for (int i = 0; i < PARALLEL_THREADS; i++) {
+		k_sem_give(&parallel_start);
+	}
+
+	for (info = config_levels[level]; info < config_levels[level + 1];
+	     info++) {
+		if (!is_parallel(info)) {
+			device_init(info);
+		}
+	}
+
+	/* help with what the workers have not got to yet, then wait for
+	 * the rest
+	 */
+	parallel_run();
+	for (int i = 0; i < PARALLEL_THREADS; i++) {
+		k_sem_take(&parallel_done, K_FOREVER);
+	}
+
+	if (level == _SYS_INIT_LEVEL_APPLICATION) {
+		parallel_exit = true;
+		for (int i = 0; i < PARALLEL_THREADS; i++) {
+			k_sem_give(&parallel_start);
+		}
+	}
+}
+#endif /* CONFIG_SYS_INIT_PARALLEL */
+
 /**
  * @brief Execute all the device initialization functions at a given level
  *
@@ -31,29 +198,41 @@ extern u32_t __device_busy_end[];
  * created by the DEVICE_INIT() macro using the specified level.
  * The linker script places the device objects in memory in the order
  * they need to be invoked, with symbols indicating where one level leaves
- * off and the next one begins.
+ * off and the next one begins. With CONFIG_SYS_INIT_PARALLEL, those of
+ * the POST_KERNEL and APPLICATION levels defined with SYS_INIT_PARALLEL()
+ * are run concurrently by worker threads instead.
  *
  * @param level init level to run.
  */
 void _sys_device_do_config_level(s32_t level)
 {
 	struct device *info;
-	static struct device *config_levels[] = {
-		__device_PRE_KERNEL_1_start,
-		__device_PRE_KERNEL_2_start,
-		__device_POST_KERNEL_start,
-		__device_APPLICATION_start,
-		/* End marker */
-		__device_init_end,
-	};
+#ifdef CONFIG_BOOT_PROFILE
+	u32_t start = k_cycle_get_32();
+#endif
 
-	for (info = config_levels[level]; info < config_levels[level+1];
-								info++) {
-		struct device_config *device_conf = info->config;
+#ifdef CONFIG_SYS_INIT_PARALLEL
+	if (level >= _SYS_INIT_LEVEL_POST_KERNEL) {
+		parallel_level(level);
+		info = config_levels[level + 1];
+	} else {
+		info = config_levels[level];
+	}
+#else
+	info = config_levels[level];
+#endif
 
-		(void)device_conf->init(info);
-		_k_object_init(info);
+	for (; info < config_levels[level + 1]; info++) {
+		device_init(info);
 	}
+
+#ifdef CONFIG_BOOT_PROFILE
+	level_cycles[level] = k_cycle_get_32() - start;
+
+	if (level == _SYS_INIT_LEVEL_APPLICATION) {
+		boot_profile_print();
+	}
+#endif
 }
 
 struct device *device_get_binding(const char *name)
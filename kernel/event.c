@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Event objects
+ *
+ * An event object holds 32 event flags and a single wait queue. A waiting
+ * thread describes what it waits for in a waiter kept on its stack and
+ * pointed to by its swap_data. Posting updates the flags and checks the
+ * waiters, linking those that are satisfied through their waiter so they
+ * can be woken once the walk of the wait queue is over.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <wait_q.h>
+#include <ksched.h>
+#include <syscall_handler.h>
+
+struct event_waiter {
+	struct k_thread *thread;
+	struct event_waiter *next;
+	u32_t events;
+	bool all;
+	bool consume;
+	/* events the wait was satisfied with */
+	u32_t matched;
+};
+
+/* events of @a events that satisfy a wait, 0 if it is not satisfied */
+static inline u32_t match(u32_t posted, u32_t events, bool all)
+{
+	u32_t matched = posted & events;
+
+	if (all && matched != events) {
+		return 0;
+	}
+
+	return matched;
+}
+
+void _impl_k_event_init(struct k_event *event)
+{
+	_waitq_init(&event->wait_q);
+	event->events = 0;
+
+	_k_object_init(event);
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_event_init, event)
+{
+	Z_OOPS(Z_SYSCALL_OBJ_INIT(event, K_OBJ_EVENT));
+	_impl_k_event_init((struct k_event *)event);
+
+	return 0;
+}
+#endif
+
+/* Replace the events in @a mask with @a events, then wake the satisfied
+ * waiters
+ */
+static void event_update(struct k_event *event, u32_t events, u32_t mask)
+{
+	u32_t key = irq_lock();
+	struct event_waiter *wake = NULL, *next, **tail = &wake;
+	struct k_thread *thread;
+
+	event->events = (event->events & ~mask) | events;
+
+	_WAIT_Q_FOR_EACH(&event->wait_q, thread) {
+		struct event_waiter *waiter = thread->base.swap_data;
+
+		waiter->matched = match(event->events, waiter->events,
+					waiter->all);
+		if (waiter->matched == 0) {
+			continue;
+		}
+
+		if (waiter->consume) {
+			event->events &= ~waiter->matched;
+		}
+
+		waiter->next = NULL;
+		*tail = waiter;
+		tail = &waiter->next;
+	}
+
+	if (wake == NULL) {
+		irq_unlock(key);
+		return;
+	}
+
+	for (; wake != NULL; wake = next) {
+		/* the waiter is gone once its thread runs */
+		next = wake->next;
+		thread = wake->thread;
+		_unpend_thread(thread);
+		_ready_thread(thread);
+		_set_thread_return_value(thread, 0);
+	}
+
+	_reschedule(key);
+}
+
+void _impl_k_event_post(struct k_event *event, u32_t events)
+{
+	event_update(event, events, 0);
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_event_post, event, events)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(event, K_OBJ_EVENT));
+	_impl_k_event_post((struct k_event *)event, (u32_t)events);
+
+	return 0;
+}
+#endif
+
+void _impl_k_event_set(struct k_event *event, u32_t events)
+{
+	event_update(event, events, UINT32_MAX);
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_event_set, event, events)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(event, K_OBJ_EVENT));
+	_impl_k_event_set((struct k_event *)event, (u32_t)events);
+
+	return 0;
+}
+#endif
+
+void _impl_k_event_clear(struct k_event *event, u32_t events)
+{
+	u32_t key = irq_lock();
+
+	/* nobody waits for no event, so nobody is woken */
+	event->events &= ~events;
+
+	irq_unlock(key);
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_event_clear, event, events)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(event, K_OBJ_EVENT));
+	_impl_k_event_clear((struct k_event *)event, (u32_t)events);
+
+	return 0;
+}
+#endif
+
+static u32_t event_wait(struct k_event *event, u32_t events, bool all,
+			bool consume, s32_t timeout)
+{
+	struct event_waiter waiter;
+	u32_t key;
+
+	if (events == 0) {
+		return 0;
+	}
+
+	key = irq_lock();
+
+	waiter.matched = match(event->events, events, all);
+	if (waiter.matched != 0) {
+		if (consume) {
+			event->events &= ~waiter.matched;
+		}
+		irq_unlock(key);
+		return waiter.matched;
+	}
+
+	if (timeout == K_NO_WAIT) {
+		irq_unlock(key);
+		return 0;
+	}
+
+	waiter.thread = _current;
+	waiter.events = events;
+	waiter.all = all;
+	waiter.consume = consume;
+	_current->base.swap_data = &waiter;
+
+	if (_pend_current_thread(key, &event->wait_q, timeout) != 0) {
+		/* timed out */
+		return 0;
+	}
+
+	return waiter.matched;
+}
+
+u32_t _impl_k_event_wait(struct k_event *event, u32_t events, bool consume,
+			 s32_t timeout)
+{
+	return event_wait(event, events, false, consume, timeout);
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_event_wait, event, events, consume, timeout)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(event, K_OBJ_EVENT));
+	return _impl_k_event_wait((struct k_event *)event, (u32_t)events,
+				  (bool)consume, (s32_t)timeout);
+}
+#endif
+
+u32_t _impl_k_event_wait_all(struct k_event *event, u32_t events,
+			     bool consume, s32_t timeout)
+{
+	return event_wait(event, events, true, consume, timeout);
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_event_wait_all, event, events, consume, timeout)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(event, K_OBJ_EVENT));
+	return _impl_k_event_wait_all((struct k_event *)event, (u32_t)events,
+				      (bool)consume, (s32_t)timeout);
+}
+#endif
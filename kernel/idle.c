@@ -6,6 +6,7 @@
 
 #include <kernel.h>
 #include <kernel_structs.h>
+#include <kernel_internal.h>
 #include <toolchain.h>
 #include <linker/sections.h>
 #include <drivers/system_timer.h>
@@ -142,11 +143,14 @@ void idle(void *unused1, void *unused2, void *unused3)
 	 * term we need to wake up idle CPUs with an IPI.
 	 */
 	while (true) {
+		z_stack_watermark_idle();
 		k_busy_wait(100);
 		k_yield();
 	}
 #else
 	for (;;) {
+		z_stack_watermark_idle();
+
 		(void)irq_lock();
 		sys_power_save_idle(_get_next_timeout_expiry());
 
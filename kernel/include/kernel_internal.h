@@ -202,6 +202,16 @@ extern void _thread_monitor_exit(struct k_thread *thread);
 	} while (false)
 #endif /* CONFIG_THREAD_MONITOR */
 
+/* update the stack high-water mark of the next thread, from idle */
+
+#if defined(CONFIG_STACK_WATERMARK)
+extern void z_stack_watermark_idle(void);
+#else
+#define z_stack_watermark_idle() \
+	do {/* nothing */    \
+	} while (false)
+#endif /* CONFIG_STACK_WATERMARK */
+
 extern void smp_init(void);
 
 extern void smp_timer_init(void);
@@ -14,6 +14,7 @@
 #include <misc/dlist.h>
 #include <misc/rb.h>
 #include <misc/util.h>
+#include <spinlock.h>
 #include <string.h>
 #endif
 
@@ -78,6 +79,8 @@ struct _ready_q {
 	struct _priq_rb runq;
 #elif defined(CONFIG_SCHED_MULTIQ)
 	struct _priq_mq runq;
+#elif defined(CONFIG_SCHED_BITMAP)
+	struct _priq_bm runq;
 #endif
 };
 
@@ -107,6 +110,39 @@ struct _cpu {
 	/* True when _current is allowed to context switch */
 	u8_t swap_ok;
 #endif
+
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
+	/* number of threads in ready_q, a hint for work stealing */
+	int ready_count;
+
+	/* protects ready_q and the queued state of threads in it */
+	struct k_spinlock ready_q_lock;
+
+	/* threads ready to run on this CPU, not including current */
+	struct _ready_q ready_q;
+#endif
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	/* cycle count when time was last charged to a thread */
+	u32_t usage_start;
+
+	/* usage_isr at that time */
+	u64_t usage_isr_start;
+
+	/* cycles spent in ISRs, where the architecture measures it */
+	u64_t usage_isr;
+
+	/* cycles charged to threads and ISRs */
+	u64_t usage_total;
+#endif
+
+#ifdef CONFIG_RCU
+	/* RCU read-side critical section nesting depth */
+	u32_t rcu_nest;
+
+	/* number of outermost read-side sections completed */
+	u32_t rcu_seq;
+#endif
 };
 
 typedef struct _cpu _cpu_t;
@@ -244,13 +280,23 @@ static ALWAYS_INLINE void _new_thread_init(struct k_thread *thread,
 	thread->name = NULL;
 #endif
 
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	thread->rt_stats.execution_cycles = 0;
+#endif
+
 #if defined(CONFIG_USERSPACE)
 	thread->mem_domain_info.mem_domain = NULL;
+#if defined(CONFIG_USERSPACE_OBJ_CACHE)
+	(void)memset(&thread->obj_cache, 0, sizeof(thread->obj_cache));
+#endif
 #endif /* CONFIG_USERSPACE */
 
 #if defined(CONFIG_THREAD_STACK_INFO)
 	thread->stack_info.start = (u32_t)pStack;
 	thread->stack_info.size = (u32_t)stackSize;
+#ifdef CONFIG_STACK_WATERMARK
+	thread->stack_info.max_used = 0;
+#endif
 #endif /* CONFIG_THREAD_STACK_INFO */
 }
 
@@ -50,6 +50,29 @@ struct k_thread *_find_first_thread_to_unpend(_wait_q_t *wait_q,
 void idle(void *a, void *b, void *c);
 void z_time_slice(int ticks);
 
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+/* Snapshot taken when entering an ISR, see z_sched_usage_isr_exit() */
+struct z_isr_usage {
+	u32_t start;
+	u64_t isr;
+};
+
+/* Charge _current for the time since the previous switch on this CPU.
+ * Called with interrupts locked by the context switch code, right before
+ * _current changes.
+ */
+void z_sched_usage_switch(void);
+
+void z_sched_usage_isr_enter(struct z_isr_usage *usage);
+
+/* Returns the cycles spent in the ISR, nested ISRs excluded */
+u32_t z_sched_usage_isr_exit(struct z_isr_usage *usage);
+#else
+static inline void z_sched_usage_switch(void)
+{
+}
+#endif
+
 /* find which one is the next thread to run */
 /* must be called with interrupts locked */
 #ifdef CONFIG_SMP
@@ -62,6 +85,14 @@ static ALWAYS_INLINE struct k_thread *_get_next_ready_thread(void)
 #endif
 
 
+#ifdef CONFIG_SMP
+/* True if the thread is executing on some CPU right now */
+static inline bool _is_thread_running(struct k_thread *thread)
+{
+	return _kernel.cpus[thread->base.cpu].current == thread;
+}
+#endif
+
 static inline bool _is_idle_thread(void *entry_point)
 {
 	return entry_point == idle;
@@ -108,7 +139,14 @@ static inline bool _is_thread_state_set(struct k_thread *thread, u32_t state)
 
 static inline bool _is_thread_queued(struct k_thread *thread)
 {
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
+	/* Kept out of thread_state: it is written under a per-CPU
+	 * ready queue lock, not the lock protecting the other states
+	 */
+	return thread->base.queued;
+#else
 	return _is_thread_state_set(thread, _THREAD_QUEUED);
+#endif
 }
 
 static inline void _mark_thread_as_suspended(struct k_thread *thread)
@@ -149,12 +187,20 @@ static inline void _reset_thread_states(struct k_thread *thread,
 
 static inline void _mark_thread_as_queued(struct k_thread *thread)
 {
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
+	thread->base.queued = 1;
+#else
 	_set_thread_states(thread, _THREAD_QUEUED);
+#endif
 }
 
 static inline void _mark_thread_as_not_queued(struct k_thread *thread)
 {
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
+	thread->base.queued = 0;
+#else
 	_reset_thread_states(thread, _THREAD_QUEUED);
+#endif
 }
 
 static inline bool _is_under_prio_ceiling(int prio)
@@ -65,6 +65,7 @@ static inline int _Swap(unsigned int key)
 		_smp_release_global_lock(new_thread);
 #endif
 
+		z_sched_usage_switch();
 		_current = new_thread;
 		_arch_switch(new_thread->switch_handle,
 			     &old_thread->switch_handle);
@@ -14,6 +14,7 @@
 #include <kernel.h>
 #include <misc/printk.h>
 #include <kernel_internal.h>
+#include <kernel_structs.h>
 #include <stdbool.h>
 
 extern const _k_syscall_handler_t _k_syscall_table[K_SYSCALL_LIMIT];
@@ -409,10 +410,70 @@ static inline int _obj_validation_check(struct _k_object *ko,
 	return ret;
 }
 
+#ifdef CONFIG_USERSPACE_OBJ_CACHE
+/* Bumped whenever a permission is revoked or an object freed, which makes
+ * every thread's object cache stale.
+ */
+extern u32_t z_object_cache_gen;
+
+#define Z_OBJ_CACHE_SLOT(obj) \
+	(((uintptr_t)(obj) >> 3) & (CONFIG_USERSPACE_OBJ_CACHE_SIZE - 1))
+
+/**
+ * Look up an object in the calling thread's object cache
+ *
+ * @param obj Address of the kernel object
+ * @return Kernel object's metadata if the calling thread has already been
+ *	   found to have permission on it, NULL otherwise
+ */
+static inline struct _k_object *z_object_cache_find(void *obj)
+{
+	struct _thread_obj_cache *cache = &_current->obj_cache;
+	unsigned int slot = Z_OBJ_CACHE_SLOT(obj);
+
+	if (cache->gen != z_object_cache_gen || cache->obj[slot] != obj) {
+		return NULL;
+	}
+
+	return cache->ko[slot];
+}
+#endif /* CONFIG_USERSPACE_OBJ_CACHE */
+
+/**
+ * Validate a kernel object pointer passed in from user mode
+ *
+ * Same as _obj_validation_check(), but looks in the calling thread's
+ * object cache first. A hit skips the object lookup and the permission
+ * test; type and initialization state are always checked.
+ *
+ * @param obj Untrusted kernel object pointer
+ * @param otype Expected type of the kernel object, or K_OBJ_ANY
+ * @param init Expected initialization state
+ * @return 0 if the object is valid, see _k_object_validate() otherwise
+ */
+static inline int z_obj_validation_check_cached(void *obj,
+						enum k_objects otype,
+						enum _obj_init_check init)
+{
+#ifdef CONFIG_USERSPACE_OBJ_CACHE
+	struct _k_object *ko = z_object_cache_find(obj);
+
+	if (likely(ko != NULL) && (otype == K_OBJ_ANY || ko->type == otype)) {
+		if (init == _OBJ_INIT_ANY ||
+		    (init == _OBJ_INIT_TRUE &&
+		     (ko->flags & K_OBJ_FLAG_INITIALIZED) != 0)) {
+			return 0;
+		}
+	}
+#endif
+	/* Miss, or an error to report: take the slow path */
+	return _obj_validation_check(_k_object_find(obj), obj, otype, init);
+}
+
 #define Z_SYSCALL_IS_OBJ(ptr, type, init) \
 	Z_SYSCALL_VERIFY_MSG( \
-	    !_obj_validation_check(_k_object_find((void *)ptr), (void *)ptr, \
-				   type, init), "access denied")
+	    !z_obj_validation_check_cached((void *)ptr, type, init), \
+	    "access denied")
 
 /**
  * @brief Runtime check driver object pointer for presence of operation
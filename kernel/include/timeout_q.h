@@ -23,6 +23,9 @@ extern "C" {
 static inline void _init_timeout(struct _timeout *t, _timeout_func_t fn)
 {
 	t->dticks = _INACTIVE;
+#ifdef CONFIG_TIMER_COALESCING
+	t->slack = 0;
+#endif
 }
 
 void _add_timeout(struct _timeout *to, _timeout_func_t fn, s32_t ticks);
@@ -21,6 +21,109 @@ extern struct k_mem_slab _k_mem_slab_list_end[];
 struct k_mem_slab *_trace_list_k_mem_slab;
 #endif	/* CONFIG_OBJECT_TRACING */
 
+#ifdef CONFIG_MEM_SLAB_STATS
+#define STATS_INC(slab, field) ((slab)->stats.field++)
+
+static inline void stats_update_max(struct k_mem_slab *slab)
+{
+	if (slab->num_used > slab->stats.max_used) {
+		slab->stats.max_used = slab->num_used;
+	}
+}
+#else
+#define STATS_INC(slab, field) do { } while (false)
+#define stats_update_max(slab) do { } while (false)
+#endif
+
+#ifdef CONFIG_MEM_SLAB_CACHE
+/* number of blocks moved between a cache and the free list at a time */
+#define CACHE_BATCH (CONFIG_MEM_SLAB_CACHE_SIZE / 2)
+
+/*
+ * The per-CPU caches are protected by their own spinlock, so the common
+ * alloc/free path never touches the global kernel lock. The shared free
+ * list and the wait queue stay under irq_lock(); code holding it may take
+ * a cache lock, but never the other way around.
+ */
+static struct _mem_slab_cache *local_cache(struct k_mem_slab *slab)
+{
+	/* The caller may migrate before it locks the cache.  That only
+	 * costs locality: any cache may be used from any CPU.
+	 */
+	return &slab->cache[_current_cpu->id];
+}
+
+static bool cache_get(struct k_mem_slab *slab, void **mem)
+{
+	struct _mem_slab_cache *cache = local_cache(slab);
+	k_spinlock_key_t key = k_spin_lock(&cache->lock);
+	bool hit = cache->count > 0;
+
+	if (hit) {
+		*mem = cache->blocks[--cache->count];
+	}
+
+	k_spin_unlock(&cache->lock, key);
+
+	return hit;
+}
+
+static bool cache_put(struct k_mem_slab *slab, void *mem)
+{
+	struct _mem_slab_cache *cache = local_cache(slab);
+	k_spinlock_key_t key = k_spin_lock(&cache->lock);
+	bool hit = cache->count < CONFIG_MEM_SLAB_CACHE_SIZE;
+
+	if (hit) {
+		cache->blocks[cache->count++] = mem;
+	}
+
+	k_spin_unlock(&cache->lock, key);
+
+	return hit;
+}
+
+/* Must be called with irq_lock() held */
+static void cache_refill(struct k_mem_slab *slab,
+			 struct _mem_slab_cache *cache)
+{
+	k_spinlock_key_t key = k_spin_lock(&cache->lock);
+
+	while (cache->count < CACHE_BATCH && slab->free_list != NULL) {
+		cache->blocks[cache->count++] = slab->free_list;
+		slab->free_list = *(char **)(slab->free_list);
+		slab->num_used++;
+	}
+
+	k_spin_unlock(&cache->lock, key);
+}
+
+/* Must be called with irq_lock() held */
+static void cache_drain(struct k_mem_slab *slab,
+			struct _mem_slab_cache *cache, u32_t keep)
+{
+	k_spinlock_key_t key = k_spin_lock(&cache->lock);
+
+	while (cache->count > keep) {
+		char *block = cache->blocks[--cache->count];
+
+		*(char **)block = slab->free_list;
+		slab->free_list = block;
+		slab->num_used--;
+	}
+
+	k_spin_unlock(&cache->lock, key);
+}
+
+/* Must be called with irq_lock() held */
+static void cache_reclaim(struct k_mem_slab *slab)
+{
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		cache_drain(slab, &slab->cache[i], 0);
+	}
+}
+#endif /* CONFIG_MEM_SLAB_CACHE */
+
 /**
  * @brief Initialize kernel memory slab subsystem.
  *
@@ -76,6 +179,13 @@ void k_mem_slab_init(struct k_mem_slab *slab, void *buffer,
 	slab->block_size = block_size;
 	slab->buffer = buffer;
 	slab->num_used = 0;
+#ifdef CONFIG_MEM_SLAB_CACHE
+	atomic_clear(&slab->waiters);
+	memset(slab->cache, 0, sizeof(slab->cache));
+#endif
+#ifdef CONFIG_MEM_SLAB_STATS
+	memset(&slab->stats, 0, sizeof(slab->stats));
+#endif
 	create_free_list(slab);
 	_waitq_init(&slab->wait_q);
 	SYS_TRACING_OBJ_INIT(k_mem_slab, slab);
@@ -85,38 +195,127 @@ void k_mem_slab_init(struct k_mem_slab *slab, void *buffer,
 
 int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, s32_t timeout)
 {
-	unsigned int key = irq_lock();
+	unsigned int key;
 	int result;
+#ifdef CONFIG_MEM_SLAB_CACHE
+	bool waiting = false;
+
+	if (cache_get(slab, mem)) {
+		return 0;
+	}
+#endif
+
+	key = irq_lock();
+	STATS_INC(slab, num_shared);
+
+#ifdef CONFIG_MEM_SLAB_CACHE
+	/* Announce ourselves before looking at the other CPUs' caches, so
+	 * that a block cached by a concurrent free is either reclaimed here
+	 * or handed over to us by that free.
+	 */
+	if (slab->free_list == NULL) {
+		atomic_inc(&slab->waiters);
+		waiting = true;
+		cache_reclaim(slab);
+	}
+#endif
 
 	if (slab->free_list != NULL) {
 		/* take a free block */
 		*mem = slab->free_list;
 		slab->free_list = *(char **)(slab->free_list);
 		slab->num_used++;
+#ifdef CONFIG_MEM_SLAB_CACHE
+		/* and a batch more for the next allocations on this CPU */
+		cache_refill(slab, local_cache(slab));
+#endif
+		stats_update_max(slab);
 		result = 0;
 	} else if (timeout == K_NO_WAIT) {
 		/* don't wait for a free block to become available */
+		STATS_INC(slab, num_exhausted);
 		*mem = NULL;
 		result = -ENOMEM;
 	} else {
 		/* wait for a free block or timeout */
+		STATS_INC(slab, num_exhausted);
 		result = _pend_current_thread(key, &slab->wait_q, timeout);
 		if (result == 0) {
 			*mem = _current->base.swap_data;
 		}
+#ifdef CONFIG_MEM_SLAB_CACHE
+		atomic_dec(&slab->waiters);
+#endif
 		return result;
 	}
 
+#ifdef CONFIG_MEM_SLAB_CACHE
+	if (waiting) {
+		atomic_dec(&slab->waiters);
+	}
+#endif
 	irq_unlock(key);
 
 	return result;
 }
 
+#ifdef CONFIG_MEM_SLAB_CACHE
+void k_mem_slab_free(struct k_mem_slab *slab, void **mem)
+{
+	struct k_thread *pending_thread = NULL;
+	bool cached = cache_put(slab, *mem);
+	unsigned int key;
+
+	if (cached && atomic_get(&slab->waiters) == 0) {
+		return;
+	}
+
+	key = irq_lock();
+	STATS_INC(slab, num_shared);
+
+	if (!cached) {
+		**(char ***)mem = slab->free_list;
+		slab->free_list = *(char **)mem;
+		slab->num_used--;
+	}
+
+	if (atomic_get(&slab->waiters) != 0) {
+		/* threads may be waiting: pool all cached blocks for them */
+		cache_reclaim(slab);
+	} else if (!cached) {
+		/* local cache is full, make room for later frees */
+		cache_drain(slab, local_cache(slab), CACHE_BATCH);
+	}
+
+	while (slab->free_list != NULL) {
+		struct k_thread *thread = _unpend_first_thread(&slab->wait_q);
+
+		if (thread == NULL) {
+			break;
+		}
+
+		_set_thread_return_value_with_data(thread, 0,
+						   slab->free_list);
+		slab->free_list = *(char **)(slab->free_list);
+		slab->num_used++;
+		_ready_thread(thread);
+		pending_thread = thread;
+	}
+
+	if (pending_thread != NULL) {
+		_reschedule(key);
+	} else {
+		irq_unlock(key);
+	}
+}
+#else
 void k_mem_slab_free(struct k_mem_slab *slab, void **mem)
 {
 	int key = irq_lock();
 	struct k_thread *pending_thread = _unpend_first_thread(&slab->wait_q);
 
+	STATS_INC(slab, num_shared);
+
 	if (pending_thread != NULL) {
 		_set_thread_return_value_with_data(pending_thread, 0, *mem);
 		_ready_thread(pending_thread);
@@ -128,3 +327,15 @@ void k_mem_slab_free(struct k_mem_slab *slab, void **mem)
 		irq_unlock(key);
 	}
 }
+#endif /* CONFIG_MEM_SLAB_CACHE */
+
+#ifdef CONFIG_MEM_SLAB_STATS
+void k_mem_slab_stats_get(struct k_mem_slab *slab,
+			  struct k_mem_slab_stats *stats)
+{
+	unsigned int key = irq_lock();
+
+	*stats = slab->stats;
+	irq_unlock(key);
+}
+#endif
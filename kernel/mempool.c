@@ -10,6 +10,7 @@
 #include <init.h>
 #include <string.h>
 #include <misc/__assert.h>
+#include <misc/heap.h>
 #include <stdbool.h>
 
 /* Linker-defined symbols bound the static pool structs */
@@ -26,6 +27,12 @@ static int pool_id(struct k_mem_pool *pool)
 	return pool - &_k_mem_pool_list_start[0];
 }
 
+#ifdef CONFIG_HEAP_MEM_POOL_TLSF
+static char __aligned(SYS_HEAP_ALIGN)
+	system_heap_mem[CONFIG_HEAP_MEM_POOL_SIZE];
+static struct sys_heap system_heap;
+#endif
+
 static void k_mem_pool_init(struct k_mem_pool *p)
 {
 	_waitq_init(&p->wait_q);
@@ -156,6 +163,15 @@ void *k_mem_pool_malloc(struct k_mem_pool *pool, size_t size)
 void k_free(void *ptr)
 {
 	if (ptr != NULL) {
+#ifdef CONFIG_HEAP_MEM_POOL_TLSF
+		if (sys_heap_contains(&system_heap, ptr)) {
+			unsigned int key = irq_lock();
+
+			sys_heap_free(&system_heap, ptr);
+			irq_unlock(key);
+			return;
+		}
+#endif
 		/* point to hidden block descriptor at start of block */
 		ptr = (char *)ptr - sizeof(struct k_mem_block_id);
 
@@ -173,6 +189,33 @@ void k_free(void *ptr)
  * that has the address of the associated memory pool struct.
  */
 
+#ifdef CONFIG_HEAP_MEM_POOL_TLSF
+/* The heap is not a k_mem_pool: this address only marks threads assigned
+ * the system pool, see z_thread_malloc()
+ */
+#define _HEAP_MEM_POOL ((struct k_mem_pool *)&system_heap)
+
+static int init_system_heap(struct device *unused)
+{
+	ARG_UNUSED(unused);
+
+	sys_heap_init(&system_heap, system_heap_mem, sizeof(system_heap_mem));
+
+	return 0;
+}
+
+SYS_INIT(init_system_heap, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
+
+void *k_malloc(size_t size)
+{
+	unsigned int key = irq_lock();
+	void *ret = sys_heap_alloc(&system_heap, size);
+
+	irq_unlock(key);
+
+	return ret;
+}
+#else
 K_MEM_POOL_DEFINE(_heap_mem_pool, 64, CONFIG_HEAP_MEM_POOL_SIZE, 1, 4);
 #define _HEAP_MEM_POOL (&_heap_mem_pool)
 
@@ -180,6 +223,7 @@ void *k_malloc(size_t size)
 {
 	return k_mem_pool_malloc(_HEAP_MEM_POOL, size);
 }
+#endif
 
 void *k_calloc(size_t nmemb, size_t size)
 {
@@ -208,6 +252,11 @@ void *z_thread_malloc(size_t size)
 	void *ret;
 
 	if (_current->resource_pool != NULL) {
+#ifdef CONFIG_HEAP_MEM_POOL_TLSF
+		if (_current->resource_pool == _HEAP_MEM_POOL) {
+			return k_malloc(size);
+		}
+#endif
 		ret = k_mem_pool_malloc(_current->resource_pool, size);
 	} else {
 		ret = NULL;
@@ -108,43 +108,242 @@ void k_msgq_cleanup(struct k_msgq *q)
 }
 
 
+/* Account for the message just written at write_ptr */
+static void msgq_write_done(struct k_msgq *q)
+{
+	q->write_ptr += q->msg_size;
+	if (q->write_ptr == q->buffer_end) {
+		q->write_ptr = q->buffer_start;
+	}
+	q->used_msgs++;
+}
+
+/* Account for the message just read at read_ptr */
+static void msgq_read_done(struct k_msgq *q)
+{
+	q->read_ptr += q->msg_size;
+	if (q->read_ptr == q->buffer_end) {
+		q->read_ptr = q->buffer_start;
+	}
+	q->used_msgs--;
+}
+
+/*
+ * Threads waiting for a claim on their side of the queue to finish,
+ * rather than for a message or a free slot, point swap_data at one of
+ * these. msgq_give_reader() and msgq_take_writer() pass them over, and
+ * the claim's *_finish() wakes them up to try again.
+ */
+static u8_t msgq_put_busy;
+static u8_t msgq_get_busy;
+
+/* Returned to a thread woken up by the end of a claim */
+#define MSGQ_RETRY 1
+
+static bool msgq_is_busy(struct k_thread *thread)
+{
+	return thread->base.swap_data == &msgq_put_busy ||
+	       thread->base.swap_data == &msgq_get_busy;
+}
+
+/*
+ * Unpend the first thread waiting for a message or a free slot, if any.
+ * Those only wait on one side at a time: readers on an empty queue with
+ * no get claim, writers on a full one with no put claim.
+ */
+static struct k_thread *msgq_unpend_waiter(struct k_msgq *q)
+{
+	struct k_thread *thread;
+
+	_WAIT_Q_FOR_EACH(&q->wait_q, thread) {
+		if (!msgq_is_busy(thread)) {
+			_unpend_thread(thread);
+			return thread;
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * A claim was just granted: the threads still waiting on its side of the
+ * queue now wait for it to finish instead.
+ */
+static void msgq_mark_busy(struct k_msgq *q, u8_t *busy)
+{
+	struct k_thread *thread;
+
+	_WAIT_Q_FOR_EACH(&q->wait_q, thread) {
+		if (!msgq_is_busy(thread)) {
+			thread->base.swap_data = busy;
+		}
+	}
+}
+
+/* A claim just finished: let the threads waiting for it try again */
+static bool msgq_wake_busy(struct k_msgq *q, u8_t *busy)
+{
+	struct k_thread *thread;
+	bool woken = false;
+
+	for (;;) {
+		struct k_thread *next = NULL;
+
+		_WAIT_Q_FOR_EACH(&q->wait_q, thread) {
+			if (thread->base.swap_data == busy) {
+				next = thread;
+				break;
+			}
+		}
+
+		if (next == NULL) {
+			return woken;
+		}
+
+		_unpend_thread(next);
+		_set_thread_return_value(next, MSGQ_RETRY);
+		_ready_thread(next);
+		woken = true;
+	}
+}
+
+static s64_t msgq_deadline(s32_t timeout)
+{
+	return timeout > 0 ? z_tick_get() + _ms_to_ticks(timeout) : 0;
+}
+
+/*
+ * Pend the current thread on @a q, @a swap_data telling what for. When
+ * woken up by the end of a claim, returns MSGQ_RETRY with interrupts
+ * locked again and @a timeout cut to what is left before @a end.
+ */
+static int msgq_wait(struct k_msgq *q, unsigned int *key, void *swap_data,
+		     s32_t *timeout, s64_t end)
+{
+	int result;
+
+	_current->base.swap_data = swap_data;
+	result = _pend_current_thread(*key, &q->wait_q, *timeout);
+	if (result != MSGQ_RETRY) {
+		return result;
+	}
+
+	*key = irq_lock();
+
+	if (*timeout != K_FOREVER) {
+		s64_t left = end - z_tick_get();
+
+		if (left <= 0) {
+			irq_unlock(*key);
+			return -EAGAIN;
+		}
+		*timeout = __ticks_to_ms(left);
+	}
+
+	return MSGQ_RETRY;
+}
+
+/*
+ * Give the message at @a data to the first thread waiting to read, if any.
+ * Threads waiting in k_msgq_get_claim() have no buffer of their own
+ * (swap_data is NULL): the message is queued and they read it in place.
+ */
+static bool msgq_give_reader(struct k_msgq *q, void *data)
+{
+	struct k_thread *reader = msgq_unpend_waiter(q);
+
+	if (reader == NULL) {
+		return false;
+	}
+
+	if (reader->base.swap_data == NULL) {
+		if (data != q->write_ptr) {
+			(void)memcpy(q->write_ptr, data, q->msg_size);
+		}
+		msgq_write_done(q);
+		q->flags |= K_MSGQ_FLAG_GET_CLAIM;
+		_set_thread_return_value_with_data(reader, 0, q->read_ptr);
+		_ready_thread(reader);
+		msgq_mark_busy(q, &msgq_get_busy);
+	} else {
+		(void)memcpy(reader->base.swap_data, data, q->msg_size);
+		_set_thread_return_value(reader, 0);
+		_ready_thread(reader);
+	}
+
+	return true;
+}
+
+/*
+ * Fill the slot freed by a read from the first thread waiting to write,
+ * if any. Threads waiting in k_msgq_put_claim() (swap_data is NULL) are
+ * handed the free slot to write in place.
+ */
+static bool msgq_take_writer(struct k_msgq *q)
+{
+	struct k_thread *writer = msgq_unpend_waiter(q);
+
+	if (writer == NULL) {
+		return false;
+	}
+
+	if (writer->base.swap_data == NULL) {
+		q->flags |= K_MSGQ_FLAG_PUT_CLAIM;
+		_set_thread_return_value_with_data(writer, 0, q->write_ptr);
+		_ready_thread(writer);
+		msgq_mark_busy(q, &msgq_put_busy);
+	} else {
+		(void)memcpy(q->write_ptr, writer->base.swap_data,
+			     q->msg_size);
+		msgq_write_done(q);
+		_set_thread_return_value(writer, 0);
+		_ready_thread(writer);
+	}
+
+	return true;
+}
+
 int _impl_k_msgq_put(struct k_msgq *q, void *data, s32_t timeout)
 {
 	__ASSERT(!_is_in_isr() || timeout == K_NO_WAIT, "");
 
+	s64_t end = msgq_deadline(timeout);
 	unsigned int key = irq_lock();
-	struct k_thread *pending_thread;
 	int result;
 
-	if (q->used_msgs < q->max_msgs) {
-		/* message queue isn't full */
-		pending_thread = _unpend_first_thread(&q->wait_q);
-		if (pending_thread != NULL) {
-			/* give message to waiting thread */
-			(void)memcpy(pending_thread->base.swap_data, data,
-			       q->msg_size);
-			/* wake up waiting thread */
-			_set_thread_return_value(pending_thread, 0);
-			_ready_thread(pending_thread);
-			_reschedule(key);
-			return 0;
-		} else {
+	for (;;) {
+		if ((q->flags & K_MSGQ_FLAG_PUT_CLAIM) != 0) {
+			/* the slot at write_ptr is being written in place */
+			if (timeout == K_NO_WAIT) {
+				result = -EBUSY;
+				break;
+			}
+			result = msgq_wait(q, &key, &msgq_put_busy,
+					   &timeout, end);
+		} else if (q->used_msgs < q->max_msgs) {
+			/* message queue isn't full */
+			if (msgq_give_reader(q, data)) {
+				_reschedule(key);
+				return 0;
+			}
+
 			/* put message in queue */
 			(void)memcpy(q->write_ptr, data, q->msg_size);
-			q->write_ptr += q->msg_size;
-			if (q->write_ptr == q->buffer_end) {
-				q->write_ptr = q->buffer_start;
-			}
-			q->used_msgs++;
+			msgq_write_done(q);
+			result = 0;
+			break;
+		} else if (timeout == K_NO_WAIT) {
+			/* don't wait for message space to become available */
+			result = -ENOMSG;
+			break;
+		} else {
+			/* wait for put message success, failure, or timeout */
+			result = msgq_wait(q, &key, data, &timeout, end);
+		}
+
+		if (result != MSGQ_RETRY) {
+			return result;
 		}
-		result = 0;
-	} else if (timeout == K_NO_WAIT) {
-		/* don't wait for message space to become available */
-		result = -ENOMSG;
-	} else {
-		/* wait for put message success, failure, or timeout */
-		_current->base.swap_data = data;
-		return _pend_current_thread(key, &q->wait_q, timeout);
 	}
 
 	irq_unlock(key);
@@ -187,45 +386,43 @@ int _impl_k_msgq_get(struct k_msgq *q, void *data, s32_t timeout)
 {
 	__ASSERT(!_is_in_isr() || timeout == K_NO_WAIT, "");
 
+	s64_t end = msgq_deadline(timeout);
 	unsigned int key = irq_lock();
-	struct k_thread *pending_thread;
 	int result;
 
-	if (q->used_msgs > 0) {
-		/* take first available message from queue */
-		(void)memcpy(data, q->read_ptr, q->msg_size);
-		q->read_ptr += q->msg_size;
-		if (q->read_ptr == q->buffer_end) {
-			q->read_ptr = q->buffer_start;
-		}
-		q->used_msgs--;
-
-		/* handle first thread waiting to write (if any) */
-		pending_thread = _unpend_first_thread(&q->wait_q);
-		if (pending_thread != NULL) {
-			/* add thread's message to queue */
-			(void)memcpy(q->write_ptr, pending_thread->base.swap_data,
-			       q->msg_size);
-			q->write_ptr += q->msg_size;
-			if (q->write_ptr == q->buffer_end) {
-				q->write_ptr = q->buffer_start;
+	for (;;) {
+		if ((q->flags & K_MSGQ_FLAG_GET_CLAIM) != 0) {
+			/* the message at read_ptr is being read in place */
+			if (timeout == K_NO_WAIT) {
+				result = -EBUSY;
+				break;
 			}
-			q->used_msgs++;
+			result = msgq_wait(q, &key, &msgq_get_busy,
+					   &timeout, end);
+		} else if (q->used_msgs > 0) {
+			/* take first available message from queue */
+			(void)memcpy(data, q->read_ptr, q->msg_size);
+			msgq_read_done(q);
+
+			/* handle first thread waiting to write (if any) */
+			if (msgq_take_writer(q)) {
+				_reschedule(key);
+				return 0;
+			}
+			result = 0;
+			break;
+		} else if (timeout == K_NO_WAIT) {
+			/* don't wait for a message to become available */
+			result = -ENOMSG;
+			break;
+		} else {
+			/* wait for get message success or timeout */
+			result = msgq_wait(q, &key, data, &timeout, end);
+		}
 
-			/* wake up waiting thread */
-			_set_thread_return_value(pending_thread, 0);
-			_ready_thread(pending_thread);
-			_reschedule(key);
-			return 0;
+		if (result != MSGQ_RETRY) {
+			return result;
 		}
-		result = 0;
-	} else if (timeout == K_NO_WAIT) {
-		/* don't wait for a message to become available */
-		result = -ENOMSG;
-	} else {
-		/* wait for get message success or timeout */
-		_current->base.swap_data = data;
-		return _pend_current_thread(key, &q->wait_q, timeout);
 	}
 
 	irq_unlock(key);
@@ -245,24 +442,204 @@ Z_SYSCALL_HANDLER(k_msgq_get, msgq_p, data, timeout)
 }
 #endif
 
+int _impl_k_msgq_put_claim(struct k_msgq *q, void **data, s32_t timeout)
+{
+	__ASSERT(!_is_in_isr() || timeout == K_NO_WAIT, "");
+
+	s64_t end = msgq_deadline(timeout);
+	unsigned int key = irq_lock();
+	int result;
+
+	for (;;) {
+		if ((q->flags & K_MSGQ_FLAG_PUT_CLAIM) != 0) {
+			if (timeout == K_NO_WAIT) {
+				result = -EBUSY;
+				break;
+			}
+			result = msgq_wait(q, &key, &msgq_put_busy,
+					   &timeout, end);
+		} else if (q->used_msgs < q->max_msgs) {
+			q->flags |= K_MSGQ_FLAG_PUT_CLAIM;
+			*data = q->write_ptr;
+			result = 0;
+			break;
+		} else if (timeout == K_NO_WAIT) {
+			result = -ENOMSG;
+			break;
+		} else {
+			/* wait to be handed a slot by msgq_take_writer() */
+			result = msgq_wait(q, &key, NULL, &timeout, end);
+			if (result == 0) {
+				*data = _current->base.swap_data;
+			}
+		}
+
+		if (result != MSGQ_RETRY) {
+			return result;
+		}
+	}
+
+	irq_unlock(key);
+
+	return result;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_msgq_put_claim, msgq_p, data, timeout)
+{
+	struct k_msgq *q = (struct k_msgq *)msgq_p;
+
+	Z_OOPS(Z_SYSCALL_OBJ(q, K_OBJ_MSGQ));
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(data, sizeof(void *)));
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(q->buffer_start,
+				      q->buffer_end - q->buffer_start));
+
+	return _impl_k_msgq_put_claim(q, (void **)data, timeout);
+}
+#endif
+
+void _impl_k_msgq_put_finish(struct k_msgq *q)
+{
+	unsigned int key = irq_lock();
+	bool woken;
+
+	if ((q->flags & K_MSGQ_FLAG_PUT_CLAIM) == 0) {
+		irq_unlock(key);
+		return;
+	}
+
+	q->flags &= ~K_MSGQ_FLAG_PUT_CLAIM;
+
+	/* the claimed slot was free, so a thread waiting for it is a reader */
+	woken = msgq_give_reader(q, q->write_ptr);
+	if (!woken) {
+		msgq_write_done(q);
+	}
+
+	if (msgq_wake_busy(q, &msgq_put_busy)) {
+		woken = true;
+	}
+
+	if (woken) {
+		_reschedule(key);
+	} else {
+		irq_unlock(key);
+	}
+}
+
+int _impl_k_msgq_get_claim(struct k_msgq *q, void **data, s32_t timeout)
+{
+	__ASSERT(!_is_in_isr() || timeout == K_NO_WAIT, "");
+
+	s64_t end = msgq_deadline(timeout);
+	unsigned int key = irq_lock();
+	int result;
+
+	for (;;) {
+		if ((q->flags & K_MSGQ_FLAG_GET_CLAIM) != 0) {
+			if (timeout == K_NO_WAIT) {
+				result = -EBUSY;
+				break;
+			}
+			result = msgq_wait(q, &key, &msgq_get_busy,
+					   &timeout, end);
+		} else if (q->used_msgs > 0) {
+			q->flags |= K_MSGQ_FLAG_GET_CLAIM;
+			*data = q->read_ptr;
+			result = 0;
+			break;
+		} else if (timeout == K_NO_WAIT) {
+			result = -ENOMSG;
+			break;
+		} else {
+			/* wait to be handed a message by msgq_give_reader() */
+			result = msgq_wait(q, &key, NULL, &timeout, end);
+			if (result == 0) {
+				*data = _current->base.swap_data;
+			}
+		}
+
+		if (result != MSGQ_RETRY) {
+			return result;
+		}
+	}
+
+	irq_unlock(key);
+
+	return result;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_msgq_get_claim, msgq_p, data, timeout)
+{
+	struct k_msgq *q = (struct k_msgq *)msgq_p;
+
+	Z_OOPS(Z_SYSCALL_OBJ(q, K_OBJ_MSGQ));
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(data, sizeof(void *)));
+	Z_OOPS(Z_SYSCALL_MEMORY_READ(q->buffer_start,
+				     q->buffer_end - q->buffer_start));
+
+	return _impl_k_msgq_get_claim(q, (void **)data, timeout);
+}
+#endif
+
+void _impl_k_msgq_get_finish(struct k_msgq *q)
+{
+	unsigned int key = irq_lock();
+	bool woken;
+
+	if ((q->flags & K_MSGQ_FLAG_GET_CLAIM) == 0) {
+		irq_unlock(key);
+		return;
+	}
+
+	q->flags &= ~K_MSGQ_FLAG_GET_CLAIM;
+	msgq_read_done(q);
+
+	woken = msgq_take_writer(q);
+
+	if (msgq_wake_busy(q, &msgq_get_busy)) {
+		woken = true;
+	}
+
+	if (woken) {
+		_reschedule(key);
+	} else {
+		irq_unlock(key);
+	}
+}
+
 void _impl_k_msgq_purge(struct k_msgq *q)
 {
 	unsigned int key = irq_lock();
 	struct k_thread *pending_thread;
 
-	/* wake up any threads that are waiting to write */
+	/* wake up any threads that are waiting */
 	while ((pending_thread = _unpend_first_thread(&q->wait_q)) != NULL) {
 		_set_thread_return_value(pending_thread, -ENOMSG);
 		_ready_thread(pending_thread);
 	}
 
-	q->used_msgs = 0;
-	q->read_ptr = q->write_ptr;
+	/*
+	 * A message being read in place is kept for k_msgq_get_finish().
+	 * With a put claim open too, the slots at both ends are in use and
+	 * the messages between them can't be dropped, so they are kept too.
+	 */
+	if ((q->flags & K_MSGQ_FLAG_GET_CLAIM) == 0) {
+		q->used_msgs = 0;
+		q->read_ptr = q->write_ptr;
+	} else if ((q->flags & K_MSGQ_FLAG_PUT_CLAIM) == 0) {
+		q->used_msgs = 0;
+		q->write_ptr = q->read_ptr;
+		msgq_write_done(q);
+	}
 
 	_reschedule(key);
 }
 
 #ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER1_SIMPLE_VOID(k_msgq_put_finish, K_OBJ_MSGQ, struct k_msgq *);
+Z_SYSCALL_HANDLER1_SIMPLE_VOID(k_msgq_get_finish, K_OBJ_MSGQ, struct k_msgq *);
 Z_SYSCALL_HANDLER1_SIMPLE_VOID(k_msgq_purge, K_OBJ_MSGQ, struct k_msgq *);
 Z_SYSCALL_HANDLER1_SIMPLE(k_msgq_num_free_get, K_OBJ_MSGQ, struct k_msgq *);
 Z_SYSCALL_HANDLER1_SIMPLE(k_msgq_num_used_get, K_OBJ_MSGQ, struct k_msgq *);
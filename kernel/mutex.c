@@ -114,14 +114,9 @@ static void adjust_owner_prio(struct k_mutex *mutex, s32_t new_prio)
 	}
 }
 
-int _impl_k_mutex_lock(struct k_mutex *mutex, s32_t timeout)
+/* must be called with interrupts locked */
+static bool mutex_try_lock(struct k_mutex *mutex)
 {
-	int new_prio;
-	u32_t key;
-
-	sys_trace_void(SYS_TRACE_ID_MUTEX_LOCK);
-	_sched_lock();
-
 	if (likely((mutex->lock_count == 0U) || (mutex->owner == _current))) {
 
 		RECORD_STATE_CHANGE();
@@ -137,6 +132,69 @@ int _impl_k_mutex_lock(struct k_mutex *mutex, s32_t timeout)
 			_current, mutex, mutex->lock_count,
 			mutex->owner_orig_prio);
 
+		return true;
+	}
+
+	return false;
+}
+
+#ifdef CONFIG_MUTEX_ADAPTIVE_SPIN
+static inline struct k_thread *owner_peek(struct k_mutex *mutex)
+{
+	return *(struct k_thread * volatile *)&mutex->owner;
+}
+
+/*
+ * Busy-wait for a mutex whose owner is running on another CPU, as it will
+ * likely release it before we could even finish blocking. Called and
+ * returns with interrupts locked; gives up as soon as the owner stops
+ * running, e.g. because it blocked while holding the mutex, so the caller
+ * can pend with priority inheritance as usual.
+ */
+static bool mutex_spin(struct k_mutex *mutex, u32_t *key)
+{
+	int spins = 0;
+
+	while (spins < CONFIG_MUTEX_ADAPTIVE_SPIN_LIMIT) {
+		struct k_thread *owner = mutex->owner;
+
+		if (!_is_thread_running(owner)) {
+			return false;
+		}
+
+		/* Poll without the lock until the owner changes */
+		irq_unlock(*key);
+		do {
+			spins++;
+		} while (owner_peek(mutex) == owner &&
+			 _is_thread_running(owner) &&
+			 spins < CONFIG_MUTEX_ADAPTIVE_SPIN_LIMIT);
+		*key = irq_lock();
+
+		/* Released, unless it was handed to a waiter or taken by
+		 * another CPU first, in which case we look at the new owner
+		 */
+		if (mutex_try_lock(mutex)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+#endif /* CONFIG_MUTEX_ADAPTIVE_SPIN */
+
+int _impl_k_mutex_lock(struct k_mutex *mutex, s32_t timeout)
+{
+	int new_prio;
+	u32_t key;
+
+	sys_trace_void(SYS_TRACE_ID_MUTEX_LOCK);
+	_sched_lock();
+
+	key = irq_lock();
+
+	if (likely(mutex_try_lock(mutex))) {
+		irq_unlock(key);
 		k_sched_unlock();
 		sys_trace_end_call(SYS_TRACE_ID_MUTEX_LOCK);
 
@@ -146,16 +204,25 @@ int _impl_k_mutex_lock(struct k_mutex *mutex, s32_t timeout)
 	RECORD_CONFLICT();
 
 	if (unlikely(timeout == (s32_t)K_NO_WAIT)) {
+		irq_unlock(key);
 		k_sched_unlock();
 		sys_trace_end_call(SYS_TRACE_ID_MUTEX_LOCK);
 		return -EBUSY;
 	}
 
+#ifdef CONFIG_MUTEX_ADAPTIVE_SPIN
+	if (mutex_spin(mutex, &key)) {
+		irq_unlock(key);
+		k_sched_unlock();
+		sys_trace_end_call(SYS_TRACE_ID_MUTEX_LOCK);
+
+		return 0;
+	}
+#endif
+
 	new_prio = new_prio_for_inheritance(_current->base.prio,
 					    mutex->owner->base.prio);
 
-	key = irq_lock();
-
 	K_DEBUG("adjusting prio up on mutex %p\n", mutex);
 
 	if (_is_prio_higher(new_prio, mutex->owner->base.prio)) {
@@ -219,16 +286,20 @@ void _impl_k_mutex_unlock(struct k_mutex *mutex)
 
 	RECORD_STATE_CHANGE();
 
+	/* Lockers on other CPUs may take the mutex as soon as the count
+	 * drops to zero, so only do that with interrupts locked
+	 */
+	key = irq_lock();
+
 	mutex->lock_count--;
 
 	K_DEBUG("mutex %p lock_count: %d\n", mutex, mutex->lock_count);
 
 	if (mutex->lock_count != 0U) {
+		irq_unlock(key);
 		goto k_mutex_unlock_return;
 	}
 
-	key = irq_lock();
-
 	adjust_owner_prio(mutex, mutex->owner_orig_prio);
 
 	new_owner = _unpend_first_thread(&mutex->wait_q);
@@ -239,19 +310,17 @@ void _impl_k_mutex_unlock(struct k_mutex *mutex)
 		mutex, new_owner, new_owner ? new_owner->base.prio : -1000);
 
 	if (new_owner != NULL) {
-		_ready_thread(new_owner);
-
-		irq_unlock(key);
-
-		_set_thread_return_value(new_owner, 0);
-
 		/*
 		 * new owner is already of higher or equal prio than first
 		 * waiter since the wait queue is priority-based: no need to
-		 * ajust its priority
+		 * ajust its priority. It owns the mutex from here on, before
+		 * lockers on other CPUs can see it.
 		 */
 		mutex->lock_count++;
 		mutex->owner_orig_prio = new_owner->base.prio;
+
+		_set_thread_return_value(new_owner, 0);
+		_ready_thread(new_owner);
 	}
 
 	irq_unlock(key);
@@ -447,6 +447,18 @@ int _k_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 
 	key = irq_lock();
 
+	/* The data would go into the space handed to the claimant */
+	if ((pipe->flags & K_PIPE_FLAG_PUT_CLAIM) != 0) {
+		irq_unlock(key);
+		*bytes_written = 0;
+#if (CONFIG_NUM_PIPE_ASYNC_MSGS > 0)
+		if (async_desc != NULL) {
+			pipe_async_finish(async_desc);
+		}
+#endif
+		return -EBUSY;
+	}
+
 	/*
 	 * Create a list of "working readers" into which the data will be
 	 * directly copied.
@@ -591,6 +603,13 @@ int _impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 
 	key = irq_lock();
 
+	/* The data would be taken from under the claimant */
+	if ((pipe->flags & K_PIPE_FLAG_GET_CLAIM) != 0) {
+		irq_unlock(key);
+		*bytes_read = 0;
+		return -EBUSY;
+	}
+
 	/*
 	 * Create a list of "working readers" into which the data will be
 	 * directly copied.
@@ -765,6 +784,294 @@ Z_SYSCALL_HANDLER(k_pipe_put, pipe, data, bytes_to_write, bytes_written_p,
 }
 #endif
 
+/*
+ * Wait for space (@a put) or data in the pipe's buffer before a claim.
+ *
+ * The thread waits with a zero byte request, which the other side always
+ * completes, and readies, as soon as it has made room in or added data to
+ * the buffer. Another thread may have claimed it in the meantime, so the
+ * claim is checked again on every wake up. Called and returns with
+ * interrupts locked.
+ */
+static int pipe_claim_wait(struct k_pipe *pipe, bool put,
+			   unsigned int *key, s32_t timeout)
+{
+	u8_t claim = put ? K_PIPE_FLAG_PUT_CLAIM : K_PIPE_FLAG_GET_CLAIM;
+	struct k_pipe_desc pipe_desc;
+	s64_t end = 0;
+
+	if (timeout > 0) {
+		end = z_tick_get() + _ms_to_ticks(timeout);
+	}
+
+	pipe_desc.buffer = NULL;
+	pipe_desc.bytes_to_xfer = 0;
+
+	for (;;) {
+		if ((pipe->flags & claim) != 0) {
+			return -EBUSY;
+		}
+
+		if (put ? pipe->bytes_used < pipe->size :
+			  pipe->bytes_used > 0) {
+			break;
+		}
+
+		if (timeout == K_NO_WAIT) {
+			return -EIO;
+		}
+
+		if (timeout != K_FOREVER) {
+			s64_t left = end - z_tick_get();
+
+			if (left <= 0) {
+				return -EAGAIN;
+			}
+			timeout = __ticks_to_ms(left);
+		}
+
+		_current->base.swap_data = &pipe_desc;
+		(void)_pend_current_thread(*key, put ? &pipe->wait_q.writers :
+					   &pipe->wait_q.readers, timeout);
+		*key = irq_lock();
+	}
+
+	return 0;
+}
+
+int _impl_k_pipe_put_claim(struct k_pipe *pipe, void **data, size_t *bytes,
+			   s32_t timeout)
+{
+	unsigned int key;
+	int ret;
+
+	if (pipe->size == 0) {
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+
+	ret = pipe_claim_wait(pipe, true, &key, timeout);
+	if (ret == 0) {
+		*bytes = min(*bytes, min(pipe->size - pipe->bytes_used,
+					 pipe->size - pipe->write_index));
+		*data = pipe->buffer + pipe->write_index;
+		pipe->flags |= K_PIPE_FLAG_PUT_CLAIM;
+	}
+
+	irq_unlock(key);
+
+	return ret;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_pipe_put_claim, pipe, data, bytes, timeout)
+{
+	struct k_pipe *p = (struct k_pipe *)pipe;
+
+	Z_OOPS(Z_SYSCALL_OBJ(p, K_OBJ_PIPE));
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(data, sizeof(void *)));
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(bytes, sizeof(size_t)));
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(p->buffer, p->size));
+
+	return _impl_k_pipe_put_claim(p, (void **)data, (size_t *)bytes,
+				      timeout);
+}
+#endif
+
+void _impl_k_pipe_put_finish(struct k_pipe *pipe, size_t bytes)
+{
+	struct k_thread    *reader;
+	struct k_pipe_desc *desc;
+	sys_dlist_t    xfer_list;
+	unsigned int   key;
+	size_t         bytes_copied;
+
+	key = irq_lock();
+
+	if ((pipe->flags & K_PIPE_FLAG_PUT_CLAIM) == 0) {
+		irq_unlock(key);
+		return;
+	}
+
+	__ASSERT(bytes <= min(pipe->size - pipe->bytes_used,
+			      pipe->size - pipe->write_index), "");
+
+	pipe->flags &= ~K_PIPE_FLAG_PUT_CLAIM;
+	pipe->bytes_used += bytes;
+	pipe->write_index += bytes;
+	if (pipe->write_index == pipe->size) {
+		pipe->write_index = 0;
+	}
+
+	/*
+	 * Readers only wait on an empty pipe, so any waiting reader can
+	 * take its data straight out of what was just written.
+	 */
+	(void)pipe_xfer_prepare(&xfer_list, &reader, &pipe->wait_q.readers,
+				 0, pipe->bytes_used, 0, K_FOREVER);
+
+	_sched_lock();
+	irq_unlock(key);
+
+	struct k_thread *thread = (struct k_thread *)
+				  sys_dlist_get(&xfer_list);
+	while (thread != NULL) {
+		desc = (struct k_pipe_desc *)thread->base.swap_data;
+		bytes_copied = pipe_buffer_get(pipe, desc->buffer,
+						desc->bytes_to_xfer);
+
+		desc->buffer        += bytes_copied;
+		desc->bytes_to_xfer -= bytes_copied;
+
+		pipe_thread_ready(thread);
+
+		thread = (struct k_thread *)sys_dlist_get(&xfer_list);
+	}
+
+	if (reader != NULL) {
+		desc = (struct k_pipe_desc *)reader->base.swap_data;
+		bytes_copied = pipe_buffer_get(pipe, desc->buffer,
+						desc->bytes_to_xfer);
+
+		desc->buffer        += bytes_copied;
+		desc->bytes_to_xfer -= bytes_copied;
+	}
+
+	k_sched_unlock();
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_pipe_put_finish, pipe, bytes)
+{
+	struct k_pipe *p = (struct k_pipe *)pipe;
+
+	Z_OOPS(Z_SYSCALL_OBJ(p, K_OBJ_PIPE));
+	Z_OOPS(Z_SYSCALL_VERIFY(bytes <= min(p->size - p->bytes_used,
+					     p->size - p->write_index)));
+
+	_impl_k_pipe_put_finish(p, bytes);
+	return 0;
+}
+#endif
+
+int _impl_k_pipe_get_claim(struct k_pipe *pipe, void **data, size_t *bytes,
+			   s32_t timeout)
+{
+	unsigned int key;
+	int ret;
+
+	if (pipe->size == 0) {
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+
+	ret = pipe_claim_wait(pipe, false, &key, timeout);
+	if (ret == 0) {
+		*bytes = min(*bytes, min(pipe->bytes_used,
+					 pipe->size - pipe->read_index));
+		*data = pipe->buffer + pipe->read_index;
+		pipe->flags |= K_PIPE_FLAG_GET_CLAIM;
+	}
+
+	irq_unlock(key);
+
+	return ret;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_pipe_get_claim, pipe, data, bytes, timeout)
+{
+	struct k_pipe *p = (struct k_pipe *)pipe;
+
+	Z_OOPS(Z_SYSCALL_OBJ(p, K_OBJ_PIPE));
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(data, sizeof(void *)));
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(bytes, sizeof(size_t)));
+	Z_OOPS(Z_SYSCALL_MEMORY_READ(p->buffer, p->size));
+
+	return _impl_k_pipe_get_claim(p, (void **)data, (size_t *)bytes,
+				      timeout);
+}
+#endif
+
+void _impl_k_pipe_get_finish(struct k_pipe *pipe, size_t bytes)
+{
+	struct k_thread    *writer;
+	struct k_pipe_desc *desc;
+	sys_dlist_t    xfer_list;
+	unsigned int   key;
+	size_t         bytes_copied;
+
+	key = irq_lock();
+
+	if ((pipe->flags & K_PIPE_FLAG_GET_CLAIM) == 0) {
+		irq_unlock(key);
+		return;
+	}
+
+	__ASSERT(bytes <= min(pipe->bytes_used,
+			      pipe->size - pipe->read_index), "");
+
+	pipe->flags &= ~K_PIPE_FLAG_GET_CLAIM;
+	pipe->bytes_used -= bytes;
+	pipe->read_index += bytes;
+	if (pipe->read_index == pipe->size) {
+		pipe->read_index = 0;
+	}
+
+	/*
+	 * Writers only wait on a full pipe: let them refill the space that
+	 * was just freed.
+	 */
+	(void)pipe_xfer_prepare(&xfer_list, &writer, &pipe->wait_q.writers,
+				 0, pipe->size - pipe->bytes_used, 0,
+				 K_FOREVER);
+
+	_sched_lock();
+	irq_unlock(key);
+
+	struct k_thread *thread = (struct k_thread *)
+				  sys_dlist_get(&xfer_list);
+	while (thread != NULL) {
+		desc = (struct k_pipe_desc *)thread->base.swap_data;
+		bytes_copied = pipe_buffer_put(pipe, desc->buffer,
+						desc->bytes_to_xfer);
+
+		desc->buffer         += bytes_copied;
+		desc->bytes_to_xfer  -= bytes_copied;
+
+		pipe_thread_ready(thread);
+
+		thread = (struct k_thread *)sys_dlist_get(&xfer_list);
+	}
+
+	if (writer != NULL) {
+		desc = (struct k_pipe_desc *)writer->base.swap_data;
+		bytes_copied = pipe_buffer_put(pipe, desc->buffer,
+						desc->bytes_to_xfer);
+
+		desc->buffer         += bytes_copied;
+		desc->bytes_to_xfer  -= bytes_copied;
+	}
+
+	k_sched_unlock();
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_pipe_get_finish, pipe, bytes)
+{
+	struct k_pipe *p = (struct k_pipe *)pipe;
+
+	Z_OOPS(Z_SYSCALL_OBJ(p, K_OBJ_PIPE));
+	Z_OOPS(Z_SYSCALL_VERIFY(bytes <= min(p->bytes_used,
+					     p->size - p->read_index)));
+
+	_impl_k_pipe_get_finish(p, bytes);
+	return 0;
+}
+#endif
+
 #if (CONFIG_NUM_PIPE_ASYNC_MSGS > 0)
 void k_pipe_block_put(struct k_pipe *pipe, struct k_mem_block *block,
 		      size_t bytes_to_write, struct k_sem *sem)
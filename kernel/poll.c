@@ -25,6 +25,13 @@
 #include <misc/util.h>
 #include <misc/__assert.h>
 
+/* Which of its set's lists a struct k_poll_set_event is linked in */
+enum {
+	_POLL_SET_LIST_NONE,
+	_POLL_SET_LIST_READY,
+	_POLL_SET_LIST_REPORTED,
+};
+
 void k_poll_event_init(struct k_poll_event *event, u32_t type,
 		       int mode, void *obj)
 {
@@ -74,21 +81,32 @@ static inline int is_condition_met(struct k_poll_event *event, u32_t *state)
 	return 0;
 }
 
+/* Events of poll sets have no thread of their own */
+static inline bool is_set_event(struct k_poll_event *event)
+{
+	return (event->poller != NULL) && (event->poller->thread == NULL);
+}
+
+/* Events of k_poll() callers are kept in thread priority order, ahead of
+ * any poll set events, which are kept at the back of the list
+ */
 static inline void add_event(sys_dlist_t *events, struct k_poll_event *event,
 			     struct _poller *poller)
 {
 	struct k_poll_event *pending;
 
 	pending = (struct k_poll_event *)sys_dlist_peek_tail(events);
-	if ((pending == NULL) ||
-		_is_t1_higher_prio_than_t2(pending->poller->thread,
-		poller->thread)) {
+	if ((pending == NULL) || (poller->thread == NULL) ||
+		(!is_set_event(pending) &&
+		 _is_t1_higher_prio_than_t2(pending->poller->thread,
+					    poller->thread))) {
 		sys_dlist_append(events, &event->_node);
 		return;
 	}
 
 	SYS_DLIST_FOR_EACH_CONTAINER(events, pending, _node) {
-		if (_is_t1_higher_prio_than_t2(poller->thread,
+		if (is_set_event(pending) ||
+		    _is_t1_higher_prio_than_t2(poller->thread,
 					       pending->poller->thread)) {
 			sys_dlist_insert_before(events, &pending->_node,
 						&event->_node);
@@ -356,14 +374,60 @@ ready_event:
 	return 0;
 }
 
-void _handle_obj_poll_events(sys_dlist_t *events, u32_t state)
+/* must be called with interrupts locked */
+static void signal_set_event(struct k_poll_event *event, u32_t state)
+{
+	struct k_poll_set *set = CONTAINER_OF(event->poller,
+					      struct k_poll_set, poller);
+	struct k_poll_set_event *sev = CONTAINER_OF(event,
+						    struct k_poll_set_event,
+						    event);
+	struct k_thread *thread;
+
+	event->state |= state;
+
+	if (sev->_list != _POLL_SET_LIST_READY) {
+		if (sev->_list == _POLL_SET_LIST_REPORTED) {
+			sys_dlist_remove(&sev->_ready_node);
+		}
+		sys_dlist_append(&set->ready, &sev->_ready_node);
+		sev->_list = _POLL_SET_LIST_READY;
+	}
+
+	thread = _unpend_first_thread(&set->wait_q);
+	if (thread != NULL) {
+		_set_thread_return_value(thread, 0);
+		_ready_thread(thread);
+	}
+}
+
+/* must be called with interrupts locked */
+static int signal_first_event(sys_dlist_t *events, u32_t state)
 {
 	struct k_poll_event *poll_event;
 
-	poll_event = (struct k_poll_event *)sys_dlist_get(events);
-	if (poll_event != NULL) {
-		(void) signal_poll_event(poll_event, state);
+	poll_event = (struct k_poll_event *)sys_dlist_peek_head(events);
+	if (poll_event == NULL) {
+		return 0;
 	}
+
+	sys_dlist_remove(&poll_event->_node);
+
+	if (is_set_event(poll_event)) {
+		/* Set events stay registered.  Requeue at the back, so that
+		 * sets polling the same object take turns.
+		 */
+		sys_dlist_append(events, &poll_event->_node);
+		signal_set_event(poll_event, state);
+		return 0;
+	}
+
+	return signal_poll_event(poll_event, state);
+}
+
+void _handle_obj_poll_events(sys_dlist_t *events, u32_t state)
+{
+	(void)signal_first_event(events, state);
 }
 
 void _impl_k_poll_signal_init(struct k_poll_signal *signal)
@@ -406,18 +470,17 @@ Z_SYSCALL_HANDLER(k_poll_signal_check, signal, signaled, result)
 int _impl_k_poll_signal_raise(struct k_poll_signal *signal, int result)
 {
 	unsigned int key = irq_lock();
-	struct k_poll_event *poll_event;
 
 	signal->result = result;
 	signal->signaled = 1;
 
-	poll_event = (struct k_poll_event *)sys_dlist_get(&signal->poll_events);
-	if (poll_event == NULL) {
+	if (sys_dlist_is_empty(&signal->poll_events)) {
 		irq_unlock(key);
 		return 0;
 	}
 
-	int rc = signal_poll_event(poll_event, K_POLL_STATE_SIGNALED);
+	int rc = signal_first_event(&signal->poll_events,
+				    K_POLL_STATE_SIGNALED);
 
 	_reschedule(key);
 	return rc;
@@ -433,3 +496,132 @@ Z_SYSCALL_HANDLER1_SIMPLE_VOID(k_poll_signal_reset, K_OBJ_POLL_SIGNAL,
 			       struct k_poll_signal *);
 #endif
 
+void k_poll_set_init(struct k_poll_set *set)
+{
+	set->poller.thread = NULL;
+	set->poller.is_polling = 0;
+	sys_dlist_init(&set->ready);
+	sys_dlist_init(&set->reported);
+	_waitq_init(&set->wait_q);
+}
+
+int k_poll_set_add(struct k_poll_set *set, struct k_poll_set_event *event)
+{
+	struct k_poll_event *e = &event->event;
+	unsigned int key = irq_lock();
+	u32_t state;
+
+	__ASSERT(e->poller == NULL, "event already registered\n");
+
+	e->state = K_POLL_STATE_NOT_READY;
+	event->_list = _POLL_SET_LIST_NONE;
+	(void)register_event(e, &set->poller);
+
+	if (is_condition_met(e, &state)) {
+		signal_set_event(e, state);
+		_reschedule(key);
+	} else {
+		irq_unlock(key);
+	}
+
+	return 0;
+}
+
+void k_poll_set_remove(struct k_poll_set *set, struct k_poll_set_event *event)
+{
+	unsigned int key = irq_lock();
+
+	ARG_UNUSED(set);
+	__ASSERT(event->event.poller == &set->poller, "event not in set\n");
+
+	clear_event_registration(&event->event);
+	if (event->_list != _POLL_SET_LIST_NONE) {
+		sys_dlist_remove(&event->_ready_node);
+		event->_list = _POLL_SET_LIST_NONE;
+	}
+
+	irq_unlock(key);
+}
+
+/* must be called with interrupts locked */
+static int collect_ready_events(struct k_poll_set *set,
+				struct k_poll_set_event **ready, int max)
+{
+	int n = 0;
+
+	while ((n < max) && !sys_dlist_is_empty(&set->ready)) {
+		struct k_poll_set_event *sev;
+		struct k_poll_event *e;
+		u32_t state;
+
+		sev = CONTAINER_OF(sys_dlist_get(&set->ready),
+				   struct k_poll_set_event, _ready_node);
+		e = &sev->event;
+
+		/* The object may have been taken since it triggered, so
+		 * only report what still holds, plus a cancellation
+		 */
+		e->state &= K_POLL_STATE_CANCELLED;
+		if (is_condition_met(e, &state)) {
+			e->state |= state;
+		}
+
+		if (e->state == K_POLL_STATE_NOT_READY) {
+			sev->_list = _POLL_SET_LIST_NONE;
+			continue;
+		}
+
+		sys_dlist_append(&set->reported, &sev->_ready_node);
+		sev->_list = _POLL_SET_LIST_REPORTED;
+		ready[n++] = sev;
+	}
+
+	return n;
+}
+
+int k_poll_set_wait(struct k_poll_set *set, struct k_poll_set_event **ready,
+		    int max, s32_t timeout)
+{
+	__ASSERT(!_is_in_isr(), "");
+	__ASSERT(ready != NULL, "NULL ready\n");
+	__ASSERT(max > 0, "zero max\n");
+
+	u32_t start = k_uptime_get_32();
+	unsigned int key = irq_lock();
+	sys_dnode_t *node;
+	int n;
+
+	/* Give the events reported last time another look, that is what
+	 * makes reporting level-triggered
+	 */
+	while ((node = sys_dlist_get(&set->reported)) != NULL) {
+		struct k_poll_set_event *sev;
+
+		sev = CONTAINER_OF(node, struct k_poll_set_event, _ready_node);
+		sev->event.state = K_POLL_STATE_NOT_READY;
+		sys_dlist_append(&set->ready, &sev->_ready_node);
+		sev->_list = _POLL_SET_LIST_READY;
+	}
+
+	while ((n = collect_ready_events(set, ready, max)) == 0) {
+		s32_t remaining = timeout;
+
+		if (timeout != K_FOREVER) {
+			remaining = timeout - (s32_t)(k_uptime_get_32() - start);
+			if (remaining <= 0) {
+				irq_unlock(key);
+				return -EAGAIN;
+			}
+		}
+
+		if (_pend_current_thread(key, &set->wait_q, remaining) != 0) {
+			return -EAGAIN;
+		}
+
+		key = irq_lock();
+	}
+
+	irq_unlock(key);
+
+	return n;
+}
@@ -249,12 +249,38 @@ void k_queue_append_list(struct k_queue *queue, void *head, void *tail)
 
 #else
 	sys_sflist_append_list(&queue->data_q, head, tail);
-	handle_poll_events(queue, K_POLL_STATE_DATA_AVAILABLE);
+
+	/* Signal one poller per item, as many as appending the items
+	 * one at a time would have woken
+	 */
+	while ((head != NULL) && !sys_dlist_is_empty(&queue->poll_events)) {
+		handle_poll_events(queue, K_POLL_STATE_DATA_AVAILABLE);
+		head = *(void **)head;
+	}
 #endif /* !CONFIG_POLL */
 
 	_reschedule(key);
 }
 
+void k_queue_append_batch(struct k_queue *queue, void **items, size_t count)
+{
+	__ASSERT(items != NULL || count == 0, "invalid items");
+
+	if (count == 0) {
+		return;
+	}
+
+	/* Chain the items outside of the irq lock, so that only the
+	 * splice and the wakeups are done with interrupts locked
+	 */
+	for (size_t i = 0; i < count - 1; i++) {
+		*(void **)items[i] = items[i + 1];
+	}
+	*(void **)items[count - 1] = NULL;
+
+	k_queue_append_list(queue, items[0], items[count - 1]);
+}
+
 void k_queue_merge_slist(struct k_queue *queue, sys_slist_t *list)
 {
 	__ASSERT(!sys_slist_is_empty(list), "list must not be empty");
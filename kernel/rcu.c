@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Read-copy-update grace periods
+ *
+ * Readers disable preemption, so a read-side critical section runs start
+ * to end on one CPU, and count their sections in per-CPU fields nobody
+ * else writes: rcu_nest is the current nesting depth and rcu_seq counts
+ * completed outermost sections. A grace period has elapsed for a CPU once
+ * it was seen outside any section, or once rcu_seq moved on from the value
+ * seen when the grace period started.
+ *
+ * On a uniprocessor system a thread can only run k_rcu_synchronize() when
+ * no other thread is in a read-side section, so there is nothing to wait
+ * for.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <ksched.h>
+
+void k_rcu_read_lock(void)
+{
+	struct _cpu *cpu;
+
+	if (!_is_in_isr()) {
+		_sched_lock();
+	}
+
+	cpu = _current_cpu;
+
+	__atomic_store_n(&cpu->rcu_nest, cpu->rcu_nest + 1, __ATOMIC_RELAXED);
+
+	/* k_rcu_synchronize() on another CPU must see the section started
+	 * before any of its reads happen: order this store before them
+	 */
+	if (cpu->rcu_nest == 1) {
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	}
+}
+
+void k_rcu_read_unlock(void)
+{
+	struct _cpu *cpu = _current_cpu;
+
+	__ASSERT(cpu->rcu_nest > 0, "not in an RCU read-side section");
+
+	/* the reads done in the section complete before it is seen ended */
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	__atomic_store_n(&cpu->rcu_nest, cpu->rcu_nest - 1, __ATOMIC_RELAXED);
+
+	if (cpu->rcu_nest == 0) {
+		__atomic_store_n(&cpu->rcu_seq, cpu->rcu_seq + 1,
+				 __ATOMIC_RELEASE);
+	}
+
+	if (!_is_in_isr()) {
+		k_sched_unlock();
+	}
+}
+
+void k_rcu_synchronize(void)
+{
+	__ASSERT(!_is_in_isr(), "");
+	__ASSERT(_current_cpu->rcu_nest == 0,
+		 "grace period wait inside an RCU read-side section");
+
+#if CONFIG_MP_NUM_CPUS > 1
+	u32_t seq[CONFIG_MP_NUM_CPUS];
+	bool busy[CONFIG_MP_NUM_CPUS];
+
+	/* order the updater's K_RCU_ASSIGN() before sampling the readers */
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct _cpu *cpu = &_kernel.cpus[i];
+
+		seq[i] = __atomic_load_n(&cpu->rcu_seq, __ATOMIC_ACQUIRE);
+		busy[i] = __atomic_load_n(&cpu->rcu_nest,
+					  __ATOMIC_ACQUIRE) != 0;
+	}
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct _cpu *cpu = &_kernel.cpus[i];
+
+		while (busy[i] && __atomic_load_n(&cpu->rcu_seq,
+						  __ATOMIC_ACQUIRE) == seq[i]) {
+			/* read-side sections are short and non-preemptible */
+			k_sleep(1);
+		}
+	}
+#endif
+}
@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Reader/writer locks
+ *
+ * Any number of readers or a single writer may hold a k_rwlock. Writers
+ * are preferred: once one waits, new readers queue behind it, so a steady
+ * stream of readers cannot starve writers. Ownership is handed over
+ * directly on unlock, to the first waiting writer or else to all waiting
+ * readers at once.
+ *
+ * The writer is subject to priority inheritance like a k_mutex owner.
+ * Readers are only counted, not tracked, so they cannot be boosted.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <wait_q.h>
+#include <ksched.h>
+#include <errno.h>
+#include <syscall_handler.h>
+
+void _impl_k_rwlock_init(struct k_rwlock *rwlock)
+{
+	_waitq_init(&rwlock->read_q);
+	_waitq_init(&rwlock->write_q);
+	rwlock->writer = NULL;
+	rwlock->readers = 0;
+	rwlock->writer_orig_prio = K_LOWEST_THREAD_PRIO;
+
+	_k_object_init(rwlock);
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_rwlock_init, rwlock)
+{
+	Z_OOPS(Z_SYSCALL_OBJ_INIT(rwlock, K_OBJ_RWLOCK));
+	_impl_k_rwlock_init((struct k_rwlock *)rwlock);
+
+	return 0;
+}
+#endif
+
+/* must be called with interrupts locked */
+static void writer_prio_set(struct k_rwlock *rwlock, int prio)
+{
+	if (rwlock->writer->base.prio != prio) {
+		_thread_priority_set(rwlock->writer, prio);
+	}
+}
+
+/* Raise the writer to the priority of the calling thread, if higher, as
+ * it is about to wait. Must be called with interrupts locked.
+ */
+static void writer_prio_inherit(struct k_rwlock *rwlock)
+{
+	int prio;
+
+	if (rwlock->writer == NULL) {
+		return;
+	}
+
+	prio = _get_new_prio_with_ceiling(_current->base.prio);
+	if (_is_prio_higher(prio, rwlock->writer->base.prio)) {
+		writer_prio_set(rwlock, prio);
+	}
+}
+
+/* Recompute the writer's priority from the remaining waiters, after one
+ * gave up. Must be called with interrupts locked.
+ */
+static void writer_prio_update(struct k_rwlock *rwlock)
+{
+	int prio = rwlock->writer_orig_prio;
+	struct k_thread *waiter;
+
+	if (rwlock->writer == NULL) {
+		return;
+	}
+
+	/* wait queues are in priority order */
+	waiter = _waitq_head(&rwlock->write_q);
+	if (waiter != NULL) {
+		int new_prio = _get_new_prio_with_ceiling(waiter->base.prio);
+
+		prio = _is_prio_higher(new_prio, prio) ? new_prio : prio;
+	}
+
+	waiter = _waitq_head(&rwlock->read_q);
+	if (waiter != NULL) {
+		int new_prio = _get_new_prio_with_ceiling(waiter->base.prio);
+
+		prio = _is_prio_higher(new_prio, prio) ? new_prio : prio;
+	}
+
+	writer_prio_set(rwlock, prio);
+}
+
+/* must be called with interrupts locked */
+static void grant_write(struct k_rwlock *rwlock, struct k_thread *thread)
+{
+	rwlock->writer = thread;
+	rwlock->writer_orig_prio = thread->base.prio;
+
+	_ready_thread(thread);
+	_set_thread_return_value(thread, 0);
+
+	/* waiting readers may have a higher priority than any writer */
+	writer_prio_update(rwlock);
+}
+
+/* must be called with interrupts locked */
+static bool grant_read_all(struct k_rwlock *rwlock)
+{
+	struct k_thread *thread;
+	bool woken = false;
+
+	while ((thread = _unpend_first_thread(&rwlock->read_q)) != NULL) {
+		rwlock->readers++;
+		_ready_thread(thread);
+		_set_thread_return_value(thread, 0);
+		woken = true;
+	}
+
+	return woken;
+}
+
+int _impl_k_rwlock_read_lock(struct k_rwlock *rwlock, s32_t timeout)
+{
+	u32_t key = irq_lock();
+	int ret;
+
+	if (likely(rwlock->writer == NULL &&
+		   _waitq_head(&rwlock->write_q) == NULL)) {
+		rwlock->readers++;
+		irq_unlock(key);
+		return 0;
+	}
+
+	if (unlikely(timeout == (s32_t)K_NO_WAIT)) {
+		irq_unlock(key);
+		return -EBUSY;
+	}
+
+	writer_prio_inherit(rwlock);
+
+	ret = _pend_current_thread(key, &rwlock->read_q, timeout);
+	if (ret != 0) {
+		/* timed out */
+		key = irq_lock();
+		writer_prio_update(rwlock);
+		irq_unlock(key);
+	}
+
+	return ret;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_rwlock_read_lock, rwlock, timeout)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(rwlock, K_OBJ_RWLOCK));
+	return _impl_k_rwlock_read_lock((struct k_rwlock *)rwlock,
+					(s32_t)timeout);
+}
+#endif
+
+void _impl_k_rwlock_read_unlock(struct k_rwlock *rwlock)
+{
+	u32_t key = irq_lock();
+	struct k_thread *thread;
+
+	__ASSERT(rwlock->readers > 0, "rwlock not held for reading");
+
+	rwlock->readers--;
+	if (rwlock->readers == 0) {
+		thread = _unpend_first_thread(&rwlock->write_q);
+		if (thread != NULL) {
+			grant_write(rwlock, thread);
+			_reschedule(key);
+			return;
+		}
+	}
+
+	irq_unlock(key);
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_rwlock_read_unlock, rwlock)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(rwlock, K_OBJ_RWLOCK));
+	Z_OOPS(Z_SYSCALL_VERIFY(((struct k_rwlock *)rwlock)->readers > 0));
+	_impl_k_rwlock_read_unlock((struct k_rwlock *)rwlock);
+	return 0;
+}
+#endif
+
+int _impl_k_rwlock_write_lock(struct k_rwlock *rwlock, s32_t timeout)
+{
+	u32_t key = irq_lock();
+	int ret;
+
+	__ASSERT(rwlock->writer != _current, "rwlock is not recursive");
+
+	if (likely(rwlock->writer == NULL && rwlock->readers == 0)) {
+		rwlock->writer = _current;
+		rwlock->writer_orig_prio = _current->base.prio;
+		irq_unlock(key);
+		return 0;
+	}
+
+	if (unlikely(timeout == (s32_t)K_NO_WAIT)) {
+		irq_unlock(key);
+		return -EBUSY;
+	}
+
+	writer_prio_inherit(rwlock);
+
+	ret = _pend_current_thread(key, &rwlock->write_q, timeout);
+	if (ret != 0) {
+		/* timed out: readers queued behind us only because of the
+		 * writer preference may go ahead now
+		 */
+		key = irq_lock();
+		if (rwlock->writer == NULL &&
+		    _waitq_head(&rwlock->write_q) == NULL &&
+		    grant_read_all(rwlock)) {
+			_reschedule(key);
+		} else {
+			writer_prio_update(rwlock);
+			irq_unlock(key);
+		}
+	}
+
+	return ret;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_rwlock_write_lock, rwlock, timeout)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(rwlock, K_OBJ_RWLOCK));
+	return _impl_k_rwlock_write_lock((struct k_rwlock *)rwlock,
+					 (s32_t)timeout);
+}
+#endif
+
+void _impl_k_rwlock_write_unlock(struct k_rwlock *rwlock)
+{
+	u32_t key = irq_lock();
+	struct k_thread *thread;
+
+	__ASSERT(rwlock->writer == _current, "rwlock not held for writing");
+
+	writer_prio_set(rwlock, rwlock->writer_orig_prio);
+	rwlock->writer = NULL;
+
+	thread = _unpend_first_thread(&rwlock->write_q);
+	if (thread != NULL) {
+		grant_write(rwlock, thread);
+	} else {
+		(void)grant_read_all(rwlock);
+	}
+
+	_reschedule(key);
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_rwlock_write_unlock, rwlock)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(rwlock, K_OBJ_RWLOCK));
+	Z_OOPS(Z_SYSCALL_VERIFY(((struct k_rwlock *)rwlock)->writer ==
+				_current));
+	_impl_k_rwlock_write_unlock((struct k_rwlock *)rwlock);
+	return 0;
+}
+#endif
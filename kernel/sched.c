@@ -25,6 +25,13 @@
 #define _priq_run_add		_priq_mq_add
 #define _priq_run_remove	_priq_mq_remove
 #define _priq_run_best		_priq_mq_best
+#elif defined(CONFIG_SCHED_BITMAP)
+#define _priq_run_add		_priq_bm_add
+#define _priq_run_remove	_priq_bm_remove
+#define _priq_run_best		_priq_bm_best
+
+/* Bitmap bits are numbered from the MSB, see struct _priq_bm */
+#define BM_BIT(n) (0x80000000U >> (n))
 #endif
 
 #if defined(CONFIG_WAITQ_SCALABLE)
@@ -142,6 +149,230 @@ static int should_preempt(struct k_thread *th, int preempt_ok)
 	return 0;
 }
 
+#ifndef CONFIG_SCHED_PER_CPU_RUNQ
+
+static ALWAYS_INLINE void runq_add(struct k_thread *thread)
+{
+	_priq_run_add(&_kernel.ready_q.runq, thread);
+	_mark_thread_as_queued(thread);
+}
+
+static ALWAYS_INLINE void runq_remove(struct k_thread *thread)
+{
+	if (_is_thread_queued(thread)) {
+		_priq_run_remove(&_kernel.ready_q.runq, thread);
+		_mark_thread_as_not_queued(thread);
+	}
+}
+
+static ALWAYS_INLINE struct k_thread *runq_best(void)
+{
+	return _priq_run_best(&_kernel.ready_q.runq);
+}
+
+#else /* CONFIG_SCHED_PER_CPU_RUNQ */
+
+/* Locking rules for per-CPU ready queues: a CPU's queue, and the
+ * queued/runq_cpu fields of the threads in it, are protected by that
+ * CPU's ready_q_lock.  It nests inside sched_lock, and the only place
+ * holding two of them (steal_work()) takes them in CPU index order.
+ */
+
+#if CONFIG_MP_NUM_CPUS > 8
+#error Per-CPU ready queues support at most 8 CPUs
+#endif
+
+static inline bool cpu_allowed(struct k_thread *thread, int cpu)
+{
+#ifdef CONFIG_SCHED_CPU_MASK
+	return (thread->base.cpu_mask & BIT(cpu)) != 0;
+#else
+	ARG_UNUSED(thread);
+	ARG_UNUSED(cpu);
+	return true;
+#endif
+}
+
+/* The queue a thread joins when it becomes ready: the CPU it last ran
+ * on if allowed (its cache is likely still warm there), otherwise the
+ * least loaded CPU it may run on.  NULL if its mask allows no CPU.
+ */
+static struct _cpu *home_cpu(struct k_thread *thread)
+{
+	struct _cpu *best = NULL;
+
+	if (cpu_allowed(thread, thread->base.cpu)) {
+		return &_kernel.cpus[thread->base.cpu];
+	}
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct _cpu *cpu = &_kernel.cpus[i];
+
+		if (cpu_allowed(thread, i) &&
+		    (best == NULL || cpu->ready_count < best->ready_count)) {
+			best = cpu;
+		}
+	}
+
+	return best;
+}
+
+/* Must be called with cpu->ready_q_lock held */
+static void cpu_runq_add(struct _cpu *cpu, struct k_thread *thread)
+{
+	_priq_run_add(&cpu->ready_q.runq, thread);
+	thread->base.runq_cpu = cpu->id;
+	_mark_thread_as_queued(thread);
+	cpu->ready_count++;
+}
+
+/* Must be called with cpu->ready_q_lock held */
+static void cpu_runq_remove(struct _cpu *cpu, struct k_thread *thread)
+{
+	_priq_run_remove(&cpu->ready_q.runq, thread);
+	_mark_thread_as_not_queued(thread);
+	cpu->ready_count--;
+}
+
+static void runq_add(struct k_thread *thread)
+{
+	struct _cpu *cpu = home_cpu(thread);
+
+	if (cpu != NULL) {
+		k_spinlock_key_t key = k_spin_lock(&cpu->ready_q_lock);
+
+		cpu_runq_add(cpu, thread);
+		k_spin_unlock(&cpu->ready_q_lock, key);
+	}
+}
+
+static void runq_remove(struct k_thread *thread)
+{
+	/* The thread can be stolen onto another CPU's queue until we
+	 * hold the lock of the queue it is actually in
+	 */
+	while (_is_thread_queued(thread)) {
+		struct _cpu *cpu = &_kernel.cpus[thread->base.runq_cpu];
+		k_spinlock_key_t key = k_spin_lock(&cpu->ready_q_lock);
+		bool found = _is_thread_queued(thread) &&
+			thread->base.runq_cpu == cpu->id;
+
+		if (found) {
+			cpu_runq_remove(cpu, thread);
+		}
+		k_spin_unlock(&cpu->ready_q_lock, key);
+
+		if (found) {
+			break;
+		}
+	}
+}
+
+/* Must be called with _current_cpu->ready_q_lock held */
+static ALWAYS_INLINE struct k_thread *runq_best(void)
+{
+	return _priq_run_best(&_current_cpu->ready_q.runq);
+}
+
+/* Best thread in a CPU's queue that may run on CPU "id" */
+static struct k_thread *runq_best_for(struct _cpu *cpu, int id)
+{
+#ifndef CONFIG_SCHED_CPU_MASK
+	ARG_UNUSED(id);
+	return _priq_run_best(&cpu->ready_q.runq);
+#else
+	struct k_thread *t;
+
+#if defined(CONFIG_SCHED_DUMB)
+	SYS_DLIST_FOR_EACH_CONTAINER(&cpu->ready_q.runq, t, base.qnode_dlist) {
+		if (cpu_allowed(t, id)) {
+			return t;
+		}
+	}
+#elif defined(CONFIG_SCHED_SCALABLE)
+	RB_FOR_EACH_CONTAINER(&cpu->ready_q.runq.tree, t, base.qnode_rb) {
+		if (cpu_allowed(t, id)) {
+			return t;
+		}
+	}
+#elif defined(CONFIG_SCHED_MULTIQ)
+	u32_t bits = cpu->ready_q.runq.bitmask;
+
+	while (bits) {
+		int i = __builtin_ctz(bits);
+
+		bits &= ~(1 << i);
+		SYS_DLIST_FOR_EACH_CONTAINER(&cpu->ready_q.runq.queues[i],
+					     t, base.qnode_dlist) {
+			if (cpu_allowed(t, id)) {
+				return t;
+			}
+		}
+	}
+#elif defined(CONFIG_SCHED_BITMAP)
+	struct _priq_bm *pq = &cpu->ready_q.runq;
+
+	for (int w = 0; w < _PRIQ_BM_WORDS; w++) {
+		u32_t bits = pq->words[w];
+
+		while (bits) {
+			int b = __builtin_clz(bits);
+
+			bits &= ~BM_BIT(b);
+			SYS_DLIST_FOR_EACH_CONTAINER(&pq->queues[w * 32 + b],
+						     t, base.qnode_dlist) {
+				if (cpu_allowed(t, id)) {
+					return t;
+				}
+			}
+		}
+	}
+#endif
+	return NULL;
+#endif
+}
+
+/* Called by a CPU with nothing of its own to run: moves the best
+ * thread it may run from the busiest sibling's queue onto its own.
+ * Must be called without holding any ready queue lock.
+ */
+static void steal_work(struct _cpu *cpu)
+{
+	struct _cpu *victim = NULL;
+	struct _cpu *lo, *hi;
+	k_spinlock_key_t lo_key, hi_key;
+	struct k_thread *th;
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct _cpu *c = &_kernel.cpus[i];
+
+		if (c != cpu && c->ready_count > 0 &&
+		    (victim == NULL || c->ready_count > victim->ready_count)) {
+			victim = c;
+		}
+	}
+
+	if (victim == NULL) {
+		return;
+	}
+
+	lo = cpu->id < victim->id ? cpu : victim;
+	hi = cpu->id < victim->id ? victim : cpu;
+	lo_key = k_spin_lock(&lo->ready_q_lock);
+	hi_key = k_spin_lock(&hi->ready_q_lock);
+
+	th = runq_best_for(victim, cpu->id);
+	if (th != NULL) {
+		cpu_runq_remove(victim, th);
+		cpu_runq_add(cpu, th);
+	}
+
+	k_spin_unlock(&hi->ready_q_lock, hi_key);
+	k_spin_unlock(&lo->ready_q_lock, lo_key);
+}
+
+#endif /* CONFIG_SCHED_PER_CPU_RUNQ */
+
 static struct k_thread *next_up(void)
 {
 #ifndef CONFIG_SMP
@@ -151,7 +382,7 @@ static struct k_thread *next_up(void)
 	 * responsible for putting it back in _Swap and ISR return!),
 	 * which makes this choice simple.
 	 */
-	struct k_thread *th = _priq_run_best(&_kernel.ready_q.runq);
+	struct k_thread *th = runq_best();
 
 	return th ? th : _current_cpu->idle_thread;
 #else
@@ -165,11 +396,29 @@ static struct k_thread *next_up(void)
 	 * "ready", it means "is _current already added back to the
 	 * queue such that we don't want to re-add it".
 	 */
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
+	/* Called with sched_lock held, so the state of _current can't
+	 * change under us.  Only this CPU's queue is looked at, under
+	 * its own lock.  If it has nothing but the idle thread to
+	 * offer, see whether a sibling has work to spare first.
+	 */
+	struct _cpu *cpu = _current_cpu;
+	k_spinlock_key_t key;
+
+	if (cpu->ready_count == 0 &&
+	    (_is_idle(_current) ||
+	     _is_thread_prevented_from_running(_current))) {
+		steal_work(cpu);
+	}
+
+	key = k_spin_lock(&cpu->ready_q_lock);
+#endif
+
 	int queued = _is_thread_queued(_current);
 	int active = !_is_thread_prevented_from_running(_current);
 
 	/* Choose the best thread that is not current */
-	struct k_thread *th = _priq_run_best(&_kernel.ready_q.runq);
+	struct k_thread *th = runq_best();
 	if (th == NULL) {
 		th = _current_cpu->idle_thread;
 	}
@@ -185,6 +434,20 @@ static struct k_thread *next_up(void)
 		}
 	}
 
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
+	/* Put _current back into the queue */
+	if (th != _current && active && !_is_idle(_current) && !queued) {
+		cpu_runq_add(cpu, _current);
+	}
+
+	/* Take the new _current out of the queue */
+	if (_is_thread_queued(th)) {
+		__ASSERT_NO_MSG(th->base.runq_cpu == cpu->id);
+		cpu_runq_remove(cpu, th);
+	}
+
+	k_spin_unlock(&cpu->ready_q_lock, key);
+#else
 	/* Put _current back into the queue */
 	if (th != _current && active && !_is_idle(_current) && !queued) {
 		_priq_run_add(&_kernel.ready_q.runq, _current);
@@ -196,6 +459,7 @@ static struct k_thread *next_up(void)
 		_priq_run_remove(&_kernel.ready_q.runq, th);
 	}
 	_mark_thread_as_not_queued(th);
+#endif
 
 	return th;
 #endif
@@ -280,8 +544,7 @@ static void update_cache(int preempt_ok)
 void _add_thread_to_ready_q(struct k_thread *thread)
 {
 	LOCKED(&sched_lock) {
-		_priq_run_add(&_kernel.ready_q.runq, thread);
-		_mark_thread_as_queued(thread);
+		runq_add(thread);
 		update_cache(0);
 	}
 }
@@ -289,9 +552,8 @@ void _add_thread_to_ready_q(struct k_thread *thread)
 void _move_thread_to_end_of_prio_q(struct k_thread *thread)
 {
 	LOCKED(&sched_lock) {
-		_priq_run_remove(&_kernel.ready_q.runq, thread);
-		_priq_run_add(&_kernel.ready_q.runq, thread);
-		_mark_thread_as_queued(thread);
+		runq_remove(thread);
+		runq_add(thread);
 		update_cache(thread == _current);
 	}
 }
@@ -300,8 +562,7 @@ void _remove_thread_from_ready_q(struct k_thread *thread)
 {
 	LOCKED(&sched_lock) {
 		if (_is_thread_queued(thread)) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
-			_mark_thread_as_not_queued(thread);
+			runq_remove(thread);
 			update_cache(thread == _current);
 		}
 	}
@@ -415,9 +676,9 @@ void _thread_priority_set(struct k_thread *thread, int prio)
 		need_sched = _is_thread_ready(thread);
 
 		if (need_sched) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
+			runq_remove(thread);
 			thread->base.prio = prio;
-			_priq_run_add(&_kernel.ready_q.runq, thread);
+			runq_add(thread);
 			update_cache(1);
 		} else {
 			thread->base.prio = prio;
@@ -511,17 +772,18 @@ void *_get_next_switch_handle(void *interrupted)
 #ifdef CONFIG_TRACING
 			sys_trace_thread_switched_out();
 #endif
+			z_sched_usage_switch();
 			_current = th;
 #ifdef CONFIG_TRACING
 			sys_trace_thread_switched_in();
 #endif
 		}
 	}
-
 #else
 #ifdef CONFIG_TRACING
 	sys_trace_thread_switched_out();
 #endif
+	z_sched_usage_switch();
 	_current = _get_next_ready_thread();
 #ifdef CONFIG_TRACING
 	sys_trace_thread_switched_in();
@@ -657,6 +919,69 @@ struct k_thread *_priq_mq_best(struct _priq_mq *pq)
 			    struct k_thread, base.qnode_dlist);
 }
 
+#ifdef CONFIG_SCHED_BITMAP
+static void bm_insert(sys_dlist_t *l, struct k_thread *thread)
+{
+#ifdef CONFIG_SCHED_DEADLINE
+	struct k_thread *t;
+
+	/* Everything in the list has the same priority, so only the
+	 * deadlines need comparing, and the difference between two
+	 * of them orders them without reading the clock
+	 */
+	SYS_DLIST_FOR_EACH_CONTAINER(l, t, base.qnode_dlist) {
+		if ((int)(thread->base.prio_deadline -
+			  t->base.prio_deadline) < 0) {
+			sys_dlist_insert_before(l, &t->base.qnode_dlist,
+						&thread->base.qnode_dlist);
+			return;
+		}
+	}
+#endif
+
+	sys_dlist_append(l, &thread->base.qnode_dlist);
+}
+
+void _priq_bm_add(struct _priq_bm *pq, struct k_thread *thread)
+{
+	int i = thread->base.prio - K_HIGHEST_THREAD_PRIO;
+
+	__ASSERT_NO_MSG(!_is_idle(thread));
+
+	bm_insert(&pq->queues[i], thread);
+	pq->words[i / 32] |= BM_BIT(i % 32);
+	pq->top |= BM_BIT(i / 32);
+}
+
+void _priq_bm_remove(struct _priq_bm *pq, struct k_thread *thread)
+{
+	int i = thread->base.prio - K_HIGHEST_THREAD_PRIO;
+
+	__ASSERT_NO_MSG(!_is_idle(thread));
+
+	sys_dlist_remove(&thread->base.qnode_dlist);
+	if (sys_dlist_is_empty(&pq->queues[i])) {
+		pq->words[i / 32] &= ~BM_BIT(i % 32);
+		if (!pq->words[i / 32]) {
+			pq->top &= ~BM_BIT(i / 32);
+		}
+	}
+}
+
+struct k_thread *_priq_bm_best(struct _priq_bm *pq)
+{
+	if (!pq->top) {
+		return NULL;
+	}
+
+	int w = __builtin_clz(pq->top);
+	sys_dlist_t *l = &pq->queues[w * 32 + __builtin_clz(pq->words[w])];
+
+	return CONTAINER_OF(sys_dlist_peek_head(l),
+			    struct k_thread, base.qnode_dlist);
+}
+#endif /* CONFIG_SCHED_BITMAP */
+
 int _unpend_all(_wait_q_t *waitq)
 {
 	int need_sched = 0;
@@ -671,23 +996,34 @@ int _unpend_all(_wait_q_t *waitq)
 	return need_sched;
 }
 
-void _sched_init(void)
+static void init_ready_q(struct _ready_q *rq)
 {
 #ifdef CONFIG_SCHED_DUMB
-	sys_dlist_init(&_kernel.ready_q.runq);
+	sys_dlist_init(&rq->runq);
 #endif
 
 #ifdef CONFIG_SCHED_SCALABLE
-	_kernel.ready_q.runq = (struct _priq_rb) {
+	rq->runq = (struct _priq_rb) {
 		.tree = {
 			.lessthan_fn = _priq_rb_lessthan,
 		}
 	};
 #endif
 
-#ifdef CONFIG_SCHED_MULTIQ
-	for (int i = 0; i < ARRAY_SIZE(_kernel.ready_q.runq.queues); i++) {
-		sys_dlist_init(&_kernel.ready_q.runq.queues[i]);
+#if defined(CONFIG_SCHED_MULTIQ) || defined(CONFIG_SCHED_BITMAP)
+	for (int i = 0; i < ARRAY_SIZE(rq->runq.queues); i++) {
+		sys_dlist_init(&rq->runq.queues[i]);
+	}
+#endif
+}
+
+void _sched_init(void)
+{
+	init_ready_q(&_kernel.ready_q);
+
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		init_ready_q(&_kernel.cpus[i].ready_q);
 	}
 #endif
 
@@ -746,8 +1082,8 @@ void _impl_k_thread_deadline_set(k_tid_t tid, int deadline)
 	LOCKED(&sched_lock) {
 		th->base.prio_deadline = k_cycle_get_32() + deadline;
 		if (_is_thread_queued(th)) {
-			_priq_run_remove(&_kernel.ready_q.runq, th);
-			_priq_run_add(&_kernel.ready_q.runq, th);
+			runq_remove(th);
+			runq_add(th);
 		}
 	}
 }
@@ -768,14 +1104,59 @@ Z_SYSCALL_HANDLER(k_thread_deadline_set, thread_p, deadline)
 #endif
 #endif
 
+#ifdef CONFIG_SCHED_CPU_MASK
+static int cpu_mask_mod(k_tid_t t, u32_t enable_mask, u32_t disable_mask)
+{
+	int ret = 0;
+
+	/* The mask is only consulted when the thread is queued, so it
+	 * can't be changed under a thread that is runnable right now
+	 */
+	LOCKED(&sched_lock) {
+		if (_is_thread_prevented_from_running(t)) {
+			t->base.cpu_mask |= enable_mask;
+			t->base.cpu_mask &= ~disable_mask;
+		} else {
+			ret = -EINVAL;
+		}
+	}
+
+	return ret;
+}
+
+int k_thread_cpu_mask_clear(k_tid_t thread)
+{
+	return cpu_mask_mod(thread, 0, 0xffffffff);
+}
+
+int k_thread_cpu_mask_enable_all(k_tid_t thread)
+{
+	return cpu_mask_mod(thread, 0xffffffff, 0);
+}
+
+int k_thread_cpu_mask_enable(k_tid_t thread, int cpu)
+{
+	__ASSERT(cpu >= 0 && cpu < CONFIG_MP_NUM_CPUS, "invalid CPU %d", cpu);
+
+	return cpu_mask_mod(thread, BIT(cpu), 0);
+}
+
+int k_thread_cpu_mask_disable(k_tid_t thread, int cpu)
+{
+	__ASSERT(cpu >= 0 && cpu < CONFIG_MP_NUM_CPUS, "invalid CPU %d", cpu);
+
+	return cpu_mask_mod(thread, 0, BIT(cpu));
+}
+#endif
+
 void _impl_k_yield(void)
 {
 	__ASSERT(!_is_in_isr(), "");
 
 	if (!_is_idle(_current)) {
 		LOCKED(&sched_lock) {
-			_priq_run_remove(&_kernel.ready_q.runq, _current);
-			_priq_run_add(&_kernel.ready_q.runq, _current);
+			runq_remove(_current);
+			runq_add(_current);
 			update_cache(1);
 		}
 	}
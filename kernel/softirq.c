@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Deferred interrupt handling
+ *
+ * Each CPU has a queue of raised deferred interrupts per level, drained
+ * by a cooperative thread of its own. Level 0 threads have the highest
+ * priority, so latency critical work is never stuck behind slow work
+ * raised at a lower level, or behind the system workqueue.
+ *
+ * Handlers are given a budget. One that uses all of it goes back to the
+ * tail of its queue, so handlers of the same level take turns. Once a
+ * thread has used CONFIG_SOFTIRQ_BUDGET units of work in a row it sleeps
+ * for a tick, so lower priority threads get to run. Devices then have to
+ * hold on to their data, or drop it, before the kernel spends any memory
+ * on it.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <init.h>
+#include <misc/__assert.h>
+#include <errno.h>
+#include <limits.h>
+
+#define PRIO(level) K_PRIO_COOP(CONFIG_SOFTIRQ_PRIORITY + (level))
+
+BUILD_ASSERT_MSG(CONFIG_SOFTIRQ_PRIORITY + K_SOFTIRQ_LEVELS <=
+		 CONFIG_NUM_COOP_PRIORITIES,
+		 "not enough cooperative priorities for all softirq levels");
+
+struct softirq_queue {
+	sys_slist_t list;
+	struct k_sem sem;
+	struct k_thread thread;
+};
+
+static struct softirq_queue queues[CONFIG_MP_NUM_CPUS][K_SOFTIRQ_LEVELS];
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks,
+				   CONFIG_MP_NUM_CPUS * K_SOFTIRQ_LEVELS,
+				   CONFIG_SOFTIRQ_STACK_SIZE);
+
+int k_softirq_raise(struct k_softirq *softirq)
+{
+	struct softirq_queue *q;
+	unsigned int key;
+
+	__ASSERT(softirq->level < K_SOFTIRQ_LEVELS, "invalid softirq level");
+
+	if (atomic_test_and_set_bit(softirq->flags,
+				    K_SOFTIRQ_STATE_PENDING)) {
+		return -EALREADY;
+	}
+
+	key = irq_lock();
+	q = &queues[_current_cpu->id][softirq->level];
+	sys_slist_append(&q->list, &softirq->node);
+	irq_unlock(key);
+
+	k_sem_give(&q->sem);
+
+	return 0;
+}
+
+static void softirq_main(void *p1, void *p2, void *p3)
+{
+	struct softirq_queue *q = p1;
+	int budget = CONFIG_SOFTIRQ_BUDGET;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		struct k_softirq *softirq;
+		sys_snode_t *node;
+		unsigned int key;
+		int quota, done;
+
+		if (k_sem_take(&q->sem, K_NO_WAIT) != 0) {
+			/* out of work, start afresh next time */
+			budget = CONFIG_SOFTIRQ_BUDGET;
+			k_sem_take(&q->sem, K_FOREVER);
+		}
+
+		key = irq_lock();
+		node = sys_slist_get(&q->list);
+		irq_unlock(key);
+
+		if (node == NULL) {
+			continue;
+		}
+
+		softirq = CONTAINER_OF(node, struct k_softirq, node);
+
+		/* Clear the pending state first, so that an interrupt
+		 * arriving while the handler runs raises it again
+		 */
+		atomic_clear_bit(softirq->flags, K_SOFTIRQ_STATE_PENDING);
+
+		quota = min(budget, CONFIG_SOFTIRQ_HANDLER_BUDGET);
+		done = softirq->handler(softirq, quota);
+		if (done >= quota) {
+			(void)k_softirq_raise(softirq);
+		}
+
+		budget -= max(done, 1);
+		if (budget <= 0) {
+			/* let lower priority threads run */
+			budget = CONFIG_SOFTIRQ_BUDGET;
+			k_sleep(1);
+		}
+	}
+}
+
+static int softirq_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	for (int cpu = 0; cpu < CONFIG_MP_NUM_CPUS; cpu++) {
+		for (int level = 0; level < K_SOFTIRQ_LEVELS; level++) {
+			struct softirq_queue *q = &queues[cpu][level];
+			int i = cpu * K_SOFTIRQ_LEVELS + level;
+
+			sys_slist_init(&q->list);
+			k_sem_init(&q->sem, 0, UINT_MAX);
+
+			(void)k_thread_create(&q->thread, stacks[i],
+					      K_THREAD_STACK_SIZEOF(stacks[i]),
+					      softirq_main, q, NULL, NULL,
+					      PRIO(level), 0, K_FOREVER);
+#ifdef CONFIG_SCHED_CPU_MASK
+			(void)k_thread_cpu_mask_clear(&q->thread);
+			(void)k_thread_cpu_mask_enable(&q->thread, cpu);
+#endif
+			k_thread_name_set(&q->thread, "softirq");
+			k_thread_start(&q->thread);
+		}
+	}
+
+	return 0;
+}
+
+SYS_INIT(softirq_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Thread stack high-water marks
+ *
+ * Thread stacks are painted with 0xaa when threads are created. The paint
+ * at the bottom of a stack that was never overwritten is the part of it
+ * the thread has not used yet; once overwritten it stays that way, so the
+ * high-water mark found by a scan can only grow until the thread is
+ * created again.
+ *
+ * The idle thread scans the stack of one thread every time it runs, going
+ * round the list of threads. A scan stops at the first word of paint that
+ * was overwritten and never looks past the previous high-water mark, so
+ * its cost is the part of the stack still unused. Interrupts are only
+ * locked to pick the thread and to record the result, not for the scan.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <kernel_internal.h>
+#include <misc/stack.h>
+#include <errno.h>
+
+/*
+ * Called and returns with interrupts locked, which are unlocked for the
+ * scan itself. The thread may exit or be created again meanwhile: the
+ * result is only recorded if it still has the same stack, and it never
+ * lowers the high-water mark.
+ */
+static void stack_watermark_update(struct k_thread *thread,
+				   unsigned int *key)
+{
+	struct _thread_stack_info *info = &thread->stack_info;
+	u32_t start = info->start;
+	size_t size = info->size;
+	size_t max_used = info->max_used;
+	size_t unused;
+
+	if (size == 0) {
+		return;
+	}
+
+	irq_unlock(*key);
+	unused = stack_unused_space_get((char *)start, size - max_used);
+	*key = irq_lock();
+
+	if (info->start == start && info->size == size &&
+	    info->max_used < size - unused) {
+		info->max_used = size - unused;
+	}
+}
+
+void z_stack_watermark_idle(void)
+{
+	/* index of the next thread to scan in _kernel.threads */
+	static unsigned int next;
+	struct k_thread *thread;
+	unsigned int key, i;
+
+	key = irq_lock();
+
+	thread = _kernel.threads;
+	for (i = 0; i < next && thread != NULL; i++) {
+		thread = thread->next_thread;
+	}
+
+	if (thread == NULL) {
+		/* wrap around, threads may have exited since last time */
+		thread = _kernel.threads;
+		next = 0;
+	}
+
+	if (thread != NULL) {
+		next++;
+		stack_watermark_update(thread, &key);
+	}
+
+	irq_unlock(key);
+}
+
+int k_thread_stack_usage_get(k_tid_t thread,
+			     struct k_thread_stack_usage *usage)
+{
+	unsigned int key;
+
+	if (thread == NULL || usage == NULL) {
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+	stack_watermark_update(thread, &key);
+	usage->size = thread->stack_info.size;
+	usage->max_used = thread->stack_info.max_used;
+	irq_unlock(key);
+
+	return 0;
+}
@@ -16,6 +16,14 @@
 
 K_THREAD_STACK_DEFINE(sys_work_q_stack, CONFIG_SYSTEM_WORKQUEUE_STACK_SIZE);
 
+#if CONFIG_SYSTEM_WORKQUEUE_THREADS > 1
+#define EXTRA_THREADS (CONFIG_SYSTEM_WORKQUEUE_THREADS - 1)
+
+static K_THREAD_STACK_ARRAY_DEFINE(extra_stacks, EXTRA_THREADS,
+				   CONFIG_SYSTEM_WORKQUEUE_STACK_SIZE);
+static struct k_thread extra_threads[EXTRA_THREADS];
+#endif
+
 struct k_work_q k_sys_work_q;
 
 static int k_sys_work_q_init(struct device *dev)
@@ -28,6 +36,17 @@ static int k_sys_work_q_init(struct device *dev)
 		       CONFIG_SYSTEM_WORKQUEUE_PRIORITY);
 	k_thread_name_set(&k_sys_work_q.thread, "sysworkq");
 
+#if CONFIG_SYSTEM_WORKQUEUE_THREADS > 1
+	for (int i = 0; i < EXTRA_THREADS; i++) {
+		k_work_q_worker_add(&k_sys_work_q, &extra_threads[i],
+				    extra_stacks[i],
+				    K_THREAD_STACK_SIZEOF(extra_stacks[i]),
+				    CONFIG_SYSTEM_WORKQUEUE_PRIORITY,
+				    K_WORK_Q_ANY_CPU);
+		k_thread_name_set(&extra_threads[i], "sysworkq");
+	}
+#endif
+
 	return 0;
 }
 
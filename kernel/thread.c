@@ -665,6 +665,16 @@ void _init_thread_base(struct _thread_base *thread_base, int priority,
 
 	thread_base->sched_locked = 0;
 
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
+	thread_base->cpu = 0;
+	thread_base->runq_cpu = 0;
+	thread_base->queued = 0;
+#endif
+
+#ifdef CONFIG_SCHED_CPU_MASK
+	thread_base->cpu_mask = BIT_MASK(CONFIG_MP_NUM_CPUS);
+#endif
+
 	/* swap_data does not need to be initialized */
 
 	_init_thread_timeout(thread_base);
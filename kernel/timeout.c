@@ -17,8 +17,6 @@
 
 static u64_t curr_tick;
 
-static sys_dlist_t timeout_list = SYS_DLIST_STATIC_INIT(&timeout_list);
-
 static struct k_spinlock timeout_lock;
 
 static bool can_wait_forever;
@@ -30,6 +28,123 @@ static int announce_remaining;
 int z_clock_hw_cycles_per_sec = CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC;
 #endif
 
+static s32_t elapsed(void)
+{
+	return announce_remaining == 0 ? z_clock_elapsed() : 0;
+}
+
+#ifdef CONFIG_TIMEOUT_QUEUE_SCALABLE
+
+/* Pending timeouts live in a red/black tree sorted by absolute expiry
+ * tick.  Timeouts expiring on the same tick are kept in insertion
+ * order via order_key, exactly as the delta list would have them.
+ */
+
+static bool timeout_lessthan(struct rbnode *a, struct rbnode *b);
+
+static struct rbtree timeout_tree = {
+	.lessthan_fn = timeout_lessthan,
+};
+
+static u32_t next_order_key;
+
+static bool timeout_lessthan(struct rbnode *a, struct rbnode *b)
+{
+	struct _timeout *ta = CONTAINER_OF(a, struct _timeout, node);
+	struct _timeout *tb = CONTAINER_OF(b, struct _timeout, node);
+
+	if (ta->tick != tb->tick) {
+		return ta->tick < tb->tick;
+	}
+
+	return ta->order_key < tb->order_key;
+}
+
+static struct _timeout *first(void)
+{
+	struct rbnode *n = rb_get_min(&timeout_tree);
+
+	return n == NULL ? NULL : CONTAINER_OF(n, struct _timeout, node);
+}
+
+/* Ticks from curr_tick until the timeout expires */
+static s32_t head_ticks(struct _timeout *t)
+{
+	return t->tick > curr_tick ? (s32_t)(t->tick - curr_tick) : 0;
+}
+
+static void insert_timeout(struct _timeout *to, s32_t ticks)
+{
+	struct _timeout *t;
+
+	to->dticks = ticks;
+	to->tick = curr_tick + elapsed() + ticks;
+	to->order_key = next_order_key++;
+
+	/* Renumber at wraparound, see _priq_rb_add() */
+	if (next_order_key == 0) {
+		RB_FOR_EACH_CONTAINER(&timeout_tree, t, node) {
+			t->order_key = next_order_key++;
+		}
+		to->order_key = next_order_key++;
+	}
+
+	rb_insert(&timeout_tree, &to->node);
+}
+
+static void remove_timeout(struct _timeout *t)
+{
+	rb_remove(&timeout_tree, &t->node);
+	t->dticks = _INACTIVE;
+
+	if (timeout_tree.root == NULL) {
+		next_order_key = 0;
+	}
+}
+
+/* Absolute ticks only move through curr_tick, nothing to adjust */
+static inline void consume_head_ticks(struct _timeout *t, s32_t ticks)
+{
+	ARG_UNUSED(t);
+	ARG_UNUSED(ticks);
+}
+
+static s32_t remaining_ticks(struct _timeout *to)
+{
+	return head_ticks(to);
+}
+
+#ifdef CONFIG_TIMER_COALESCING
+/* Ticks until the next wakeup is due.  Every timeout may be delayed
+ * by its slack, so this is the earliest expiry plus slack over all
+ * pending timeouts; the walk stops at the first timeout not due
+ * before that.  Anything due earlier expires in the same
+ * z_clock_announce() instead of needing a wakeup of its own.
+ */
+static s32_t wakeup_ticks(struct _timeout *head)
+{
+	struct _timeout *t;
+	s32_t ticks = INT_MAX;
+
+	ARG_UNUSED(head);
+
+	RB_FOR_EACH_CONTAINER(&timeout_tree, t, node) {
+		s32_t dt = head_ticks(t);
+
+		if (dt >= ticks) {
+			break;
+		}
+		ticks = min(ticks, dt + min(t->slack, INT_MAX - dt));
+	}
+
+	return ticks;
+}
+#endif
+
+#else /* CONFIG_TIMEOUT_QUEUE_DUMB */
+
+static sys_dlist_t timeout_list = SYS_DLIST_STATIC_INIT(&timeout_list);
+
 static struct _timeout *first(void)
 {
 	sys_dnode_t *t = sys_dlist_peek_head(&timeout_list);
@@ -44,6 +159,33 @@ static struct _timeout *next(struct _timeout *t)
 	return n == NULL ? NULL : CONTAINER_OF(n, struct _timeout, node);
 }
 
+static s32_t head_ticks(struct _timeout *t)
+{
+	return t->dticks;
+}
+
+static void insert_timeout(struct _timeout *to, s32_t ticks)
+{
+	struct _timeout *t;
+
+	to->dticks = ticks + elapsed();
+	for (t = first(); t != NULL; t = next(t)) {
+		__ASSERT(t->dticks >= 0, "");
+
+		if (t->dticks > to->dticks) {
+			t->dticks -= to->dticks;
+			sys_dlist_insert_before(&timeout_list,
+						&t->node, &to->node);
+			break;
+		}
+		to->dticks -= t->dticks;
+	}
+
+	if (t == NULL) {
+		sys_dlist_append(&timeout_list, &to->node);
+	}
+}
+
 static void remove_timeout(struct _timeout *t)
 {
 	if (next(t) != NULL) {
@@ -54,11 +196,58 @@ static void remove_timeout(struct _timeout *t)
 	t->dticks = _INACTIVE;
 }
 
-static s32_t elapsed(void)
+static inline void consume_head_ticks(struct _timeout *t, s32_t ticks)
 {
-	return announce_remaining == 0 ? z_clock_elapsed() : 0;
+	t->dticks -= ticks;
 }
 
+static s32_t remaining_ticks(struct _timeout *to)
+{
+	s32_t ticks = 0;
+
+	for (struct _timeout *t = first(); t != NULL; t = next(t)) {
+		ticks += t->dticks;
+		if (to == t) {
+			break;
+		}
+	}
+
+	return ticks;
+}
+
+#ifdef CONFIG_TIMER_COALESCING
+/* See the red/black tree version */
+static s32_t wakeup_ticks(struct _timeout *head)
+{
+	s32_t dt = 0, ticks = INT_MAX;
+
+	for (struct _timeout *t = head; t != NULL; t = next(t)) {
+		dt += t->dticks;
+		if (dt >= ticks) {
+			break;
+		}
+		ticks = min(ticks, dt + min(t->slack, INT_MAX - dt));
+	}
+
+	return ticks;
+}
+#endif
+
+#endif /* CONFIG_TIMEOUT_QUEUE_SCALABLE */
+
+#ifdef CONFIG_TIMER_COALESCING
+
+static struct k_wakeup_stats wakeup_stats;
+
+#else
+
+static inline s32_t wakeup_ticks(struct _timeout *head)
+{
+	return head_ticks(head);
+}
+
+#endif
+
 void _add_timeout(struct _timeout *to, _timeout_func_t fn, s32_t ticks)
 {
 	__ASSERT(to->dticks < 0, "");
@@ -66,24 +255,7 @@ void _add_timeout(struct _timeout *to, _timeout_func_t fn, s32_t ticks)
 	ticks = max(1, ticks);
 
 	LOCKED(&timeout_lock) {
-		struct _timeout *t;
-
-		to->dticks = ticks + elapsed();
-		for (t = first(); t != NULL; t = next(t)) {
-			__ASSERT(t->dticks >= 0, "");
-
-			if (t->dticks > to->dticks) {
-				t->dticks -= to->dticks;
-				sys_dlist_insert_before(&timeout_list,
-							&t->node, &to->node);
-				break;
-			}
-			to->dticks -= t->dticks;
-		}
-
-		if (t == NULL) {
-			sys_dlist_append(&timeout_list, &to->node);
-		}
+		insert_timeout(to, ticks);
 	}
 
 	z_clock_set_timeout(_get_next_timeout_expiry(), false);
@@ -112,12 +284,7 @@ s32_t z_timeout_remaining(struct _timeout *to)
 	}
 
 	LOCKED(&timeout_lock) {
-		for (struct _timeout *t = first(); t != NULL; t = next(t)) {
-			ticks += t->dticks;
-			if (to == t) {
-				break;
-			}
-		}
+		ticks = remaining_ticks(to);
 	}
 
 	return ticks;
@@ -126,6 +293,10 @@ s32_t z_timeout_remaining(struct _timeout *to)
 void z_clock_announce(s32_t ticks)
 {
 	struct _timeout *t = NULL;
+#ifdef CONFIG_TIMER_COALESCING
+	/* distinct ticks on which timeouts expired in this call */
+	u32_t expiries = 0;
+#endif
 
 #ifdef CONFIG_TIMESLICING
 	z_time_slice(ticks);
@@ -136,13 +307,20 @@ void z_clock_announce(s32_t ticks)
 		LOCKED(&timeout_lock) {
 			t = first();
 			if (t != NULL) {
-				if (t->dticks <= announce_remaining) {
-					announce_remaining -= t->dticks;
-					curr_tick += t->dticks;
+				s32_t dt = head_ticks(t);
+
+				if (dt <= announce_remaining) {
+#ifdef CONFIG_TIMER_COALESCING
+					if (dt > 0 || expiries == 0) {
+						expiries++;
+					}
+#endif
+					announce_remaining -= dt;
+					curr_tick += dt;
 					t->dticks = 0;
 					remove_timeout(t);
 				} else {
-					t->dticks -= announce_remaining;
+					consume_head_ticks(t, announce_remaining);
 					t = NULL;
 				}
 			}
@@ -158,6 +336,12 @@ void z_clock_announce(s32_t ticks)
 	LOCKED(&timeout_lock) {
 		curr_tick += announce_remaining;
 		announce_remaining = 0;
+#ifdef CONFIG_TIMER_COALESCING
+		if (expiries > 0) {
+			wakeup_stats.timer_wakeups++;
+			wakeup_stats.wakeups_saved += expiries - 1;
+		}
+#endif
 	}
 
 	z_clock_set_timeout(_get_next_timeout_expiry(), false);
@@ -171,7 +355,7 @@ s32_t _get_next_timeout_expiry(void)
 	LOCKED(&timeout_lock) {
 		struct _timeout *to = first();
 
-		ret = to == NULL ? maxw : max(0, to->dticks - elapsed());
+		ret = to == NULL ? maxw : max(0, wakeup_ticks(to) - elapsed());
 	}
 
 #ifdef CONFIG_TIMESLICING
@@ -182,6 +366,15 @@ s32_t _get_next_timeout_expiry(void)
 	return ret;
 }
 
+#ifdef CONFIG_TIMER_COALESCING
+void k_wakeup_stats_get(struct k_wakeup_stats *stats)
+{
+	LOCKED(&timeout_lock) {
+		*stats = wakeup_stats;
+	}
+}
+#endif
+
 int k_enable_sys_clock_always_on(void)
 {
 	int ret = !can_wait_forever;
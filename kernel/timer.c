@@ -230,6 +230,14 @@ Z_SYSCALL_HANDLER1_SIMPLE(k_timer_status_sync, K_OBJ_TIMER, struct k_timer *);
 Z_SYSCALL_HANDLER1_SIMPLE(k_timer_remaining_get, K_OBJ_TIMER, struct k_timer *);
 Z_SYSCALL_HANDLER1_SIMPLE(k_timer_user_data_get, K_OBJ_TIMER, struct k_timer *);
 
+Z_SYSCALL_HANDLER(k_timer_slack_set, timer, slack)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(timer, K_OBJ_TIMER));
+	Z_OOPS(Z_SYSCALL_VERIFY((s32_t)slack >= 0));
+	_impl_k_timer_slack_set((struct k_timer *)timer, (s32_t)slack);
+	return 0;
+}
+
 Z_SYSCALL_HANDLER(k_timer_user_data_set, timer, user_data)
 {
 	Z_OOPS(Z_SYSCALL_OBJ(timer, K_OBJ_TIMER));
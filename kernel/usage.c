@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <ksched.h>
+#include <init.h>
+#include <errno.h>
+
+/*
+ * Every CPU charges the cycles since its previous context switch to the
+ * outgoing thread when it switches threads. Architectures that dispatch
+ * interrupts through z_sched_usage_isr_enter()/exit() have the time spent
+ * in ISRs subtracted from that and accounted separately; elsewhere it is
+ * charged to the interrupted thread.
+ *
+ * Cycle counts are taken with k_cycle_get_32(), so a thread running for
+ * longer than a wrap of the cycle counter without a context switch is
+ * charged modulo the wrap.
+ */
+
+void z_sched_usage_switch(void)
+{
+	struct _cpu *cpu = _current_cpu;
+	u32_t now = k_cycle_get_32();
+	u32_t cycles = now - cpu->usage_start;
+	u32_t isr = (u32_t)(cpu->usage_isr - cpu->usage_isr_start);
+
+	_current->rt_stats.execution_cycles += cycles - isr;
+	cpu->usage_total += cycles;
+	cpu->usage_start = now;
+	cpu->usage_isr_start = cpu->usage_isr;
+}
+
+void z_sched_usage_isr_enter(struct z_isr_usage *usage)
+{
+	usage->start = k_cycle_get_32();
+	usage->isr = _current_cpu->usage_isr;
+}
+
+u32_t z_sched_usage_isr_exit(struct z_isr_usage *usage)
+{
+	struct _cpu *cpu = _current_cpu;
+	u32_t cycles = k_cycle_get_32() - usage->start;
+
+	/* nested ISRs already accounted for their own time */
+	cycles -= (u32_t)(cpu->usage_isr - usage->isr);
+	cpu->usage_isr += cycles;
+
+	return cycles;
+}
+
+int k_thread_runtime_stats_get(k_tid_t thread,
+			       struct k_thread_runtime_stats *stats)
+{
+	unsigned int key;
+
+	if (thread == NULL || stats == NULL) {
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+
+	/* An ISR must not restart the window it is being measured in */
+	if (thread == _current && !_is_in_isr()) {
+		z_sched_usage_switch();
+	}
+
+	*stats = thread->rt_stats;
+
+	irq_unlock(key);
+
+	return 0;
+}
+
+/* Sum the usage of all CPUs, including the time not yet charged on the
+ * calling CPU
+ */
+static void usage_sum(u64_t *total, u64_t *idle, u64_t *isr)
+{
+	struct _cpu *cpu;
+	unsigned int key;
+	u32_t pending;
+
+	*total = 0;
+	*idle = 0;
+	*isr = 0;
+
+	key = irq_lock();
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		cpu = &_kernel.cpus[i];
+		*total += cpu->usage_total;
+		*isr += cpu->usage_isr;
+		if (cpu->idle_thread != NULL) {
+			*idle += cpu->idle_thread->rt_stats.execution_cycles;
+		}
+	}
+
+	cpu = _current_cpu;
+	pending = k_cycle_get_32() - cpu->usage_start;
+	*total += pending;
+	if (_current == cpu->idle_thread) {
+		*idle += pending - (u32_t)(cpu->usage_isr -
+					   cpu->usage_isr_start);
+	}
+
+	irq_unlock(key);
+}
+
+int k_thread_runtime_stats_all_get(struct k_thread_runtime_stats *stats)
+{
+	u64_t idle, isr;
+
+	if (stats == NULL) {
+		return -EINVAL;
+	}
+
+	usage_sum(&stats->execution_cycles, &idle, &isr);
+
+	return 0;
+}
+
+/*
+ * Load averages are exponentially decaying averages of the utilization
+ * sampled every LOAD_PERIOD, kept in fixed point with FSHIFT fractional
+ * bits. LOAD_EXP holds e^(-5s/1min), e^(-5s/5min) and e^(-5s/15min).
+ */
+#define LOAD_PERIOD K_SECONDS(5)
+#define FSHIFT 11
+#define FIXED_1 (1 << FSHIFT)
+
+static const u32_t load_exp[3] = { 1884, 2014, 2037 };
+
+static struct {
+	u64_t total;
+	u64_t idle;
+	u64_t isr;
+	u32_t load[3];
+	u32_t last;
+	u32_t last_isr;
+} load;
+
+static struct k_timer load_timer;
+
+static u32_t fixed_ratio(u64_t part, u64_t whole)
+{
+	if (whole == 0) {
+		return 0;
+	}
+
+	return (u32_t)((part << FSHIFT) / whole);
+}
+
+static void load_sample(struct k_timer *timer)
+{
+	u64_t total, idle, isr;
+	u32_t util;
+
+	ARG_UNUSED(timer);
+
+	usage_sum(&total, &idle, &isr);
+
+	util = fixed_ratio((total - load.total) - (idle - load.idle),
+			   total - load.total);
+	load.last_isr = fixed_ratio(isr - load.isr, total - load.total);
+	load.last = util;
+
+	for (int i = 0; i < ARRAY_SIZE(load.load); i++) {
+		load.load[i] = (load.load[i] * load_exp[i] +
+				util * (FIXED_1 - load_exp[i]) +
+				FIXED_1 / 2) >> FSHIFT;
+	}
+
+	load.total = total;
+	load.idle = idle;
+	load.isr = isr;
+}
+
+static u32_t fixed_to_permille(u32_t x)
+{
+	return (x * 1000 + FIXED_1 / 2) >> FSHIFT;
+}
+
+void k_load_avg_get(struct k_load_avg *avg)
+{
+	unsigned int key = irq_lock();
+
+	for (int i = 0; i < ARRAY_SIZE(avg->load); i++) {
+		avg->load[i] = fixed_to_permille(load.load[i]);
+	}
+	avg->last = fixed_to_permille(load.last);
+	avg->isr = fixed_to_permille(load.last_isr);
+
+	irq_unlock(key);
+}
+
+static int init_load_avg(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	usage_sum(&load.total, &load.idle, &load.isr);
+
+	k_timer_init(&load_timer, load_sample, NULL);
+	k_timer_start(&load_timer, LOAD_PERIOD, LOAD_PERIOD);
+
+	return 0;
+}
+
+SYS_INIT(init_load_avg, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
@@ -36,6 +36,67 @@ extern u8_t _thread_idx_map[CONFIG_MAX_THREAD_BYTES];
 
 static void clear_perms_cb(struct _k_object *ko, void *ctx_ptr);
 
+#ifdef CONFIG_USERSPACE_OBJ_CACHE
+BUILD_ASSERT_MSG((CONFIG_USERSPACE_OBJ_CACHE_SIZE &
+		  (CONFIG_USERSPACE_OBJ_CACHE_SIZE - 1)) == 0,
+		 "USERSPACE_OBJ_CACHE_SIZE must be a power of two");
+
+u32_t z_object_cache_gen;
+
+static inline u32_t object_cache_gen_get(void)
+{
+	return z_object_cache_gen;
+}
+
+/* Remember that the calling thread passed the permission test on ko,
+ * unless something was revoked since gen was read before the test
+ */
+static void object_cache_add(struct _k_object *ko, u32_t gen)
+{
+	struct _thread_obj_cache *cache = &_current->obj_cache;
+	unsigned int slot = Z_OBJ_CACHE_SLOT(ko->name);
+	unsigned int key = irq_lock();
+
+	if (gen != z_object_cache_gen) {
+		irq_unlock(key);
+		return;
+	}
+
+	if (cache->gen != gen) {
+		(void)memset(cache->obj, 0, sizeof(cache->obj));
+		cache->gen = gen;
+	}
+
+	cache->obj[slot] = ko->name;
+	cache->ko[slot] = ko;
+	irq_unlock(key);
+}
+
+/* Drop all threads' cached objects. Permissions are never revoked on a
+ * fast path, so a global generation count beats tracking which threads
+ * cached what.
+ */
+static inline void object_cache_invalidate(void)
+{
+	z_object_cache_gen++;
+}
+#else
+static inline u32_t object_cache_gen_get(void)
+{
+	return 0;
+}
+
+static inline void object_cache_add(struct _k_object *ko, u32_t gen)
+{
+	ARG_UNUSED(ko);
+	ARG_UNUSED(gen);
+}
+
+static inline void object_cache_invalidate(void)
+{
+}
+#endif /* CONFIG_USERSPACE_OBJ_CACHE */
+
 const char *otype_to_str(enum k_objects otype)
 {
 	const char *ret;
@@ -270,6 +331,7 @@ void k_object_free(void *obj)
 	key = irq_lock();
 	dyn_obj = dyn_object_find(obj);
 	if (dyn_obj != NULL) {
+		object_cache_invalidate();
 		rb_remove(&obj_rb_tree, &dyn_obj->node);
 		sys_dlist_remove(&dyn_obj->obj_list);
 
@@ -409,6 +471,7 @@ void _thread_perms_clear(struct _k_object *ko, struct k_thread *thread)
 		unsigned int key = irq_lock();
 
 		sys_bitfield_clear_bit((mem_addr_t)&ko->perms, index);
+		object_cache_invalidate();
 		unref_check(ko);
 		irq_unlock(key);
 	}
@@ -420,6 +483,7 @@ static void clear_perms_cb(struct _k_object *ko, void *ctx_ptr)
 	unsigned int key = irq_lock();
 
 	sys_bitfield_clear_bit((mem_addr_t)&ko->perms, id);
+	object_cache_invalidate();
 	unref_check(ko);
 	irq_unlock(key);
 }
@@ -517,6 +581,8 @@ void k_object_access_all_grant(void *object)
 int _k_object_validate(struct _k_object *ko, enum k_objects otype,
 		       enum _obj_init_check init)
 {
+	u32_t gen;
+
 	if (unlikely((ko == NULL) ||
 		(otype != K_OBJ_ANY && ko->type != otype))) {
 		return -EBADF;
@@ -525,10 +591,13 @@ int _k_object_validate(struct _k_object *ko, enum k_objects otype,
 	/* Manipulation of any kernel objects by a user thread requires that
 	 * thread be granted access first, even for uninitialized objects
 	 */
+	gen = object_cache_gen_get();
 	if (unlikely(!thread_perms_test(ko))) {
 		return -EPERM;
 	}
 
+	object_cache_add(ko, gen);
+
 	/* Initialization state checks. _OBJ_INIT_ANY, we don't care */
 	if (likely(init == _OBJ_INIT_TRUE)) {
 		/* Object MUST be intialized */
@@ -578,6 +647,7 @@ void _k_object_recycle(void *object)
 
 	if (ko != NULL) {
 		(void)memset(ko->perms, 0, sizeof(ko->perms));
+		object_cache_invalidate();
 		_thread_perms_set(ko, k_current_get());
 		ko->flags |= K_OBJ_FLAG_INITIALIZED;
 	}
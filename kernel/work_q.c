@@ -18,6 +18,82 @@
 
 #define WORKQUEUE_THREAD_NAME	"workqueue"
 
+#ifdef CONFIG_WORKQUEUE_STATS
+static struct k_spinlock work_stats_lock;
+static struct k_work_handler_stats work_stats[CONFIG_WORKQUEUE_STATS_HANDLERS];
+
+static void work_stats_record(k_work_handler_t handler, u32_t cycles)
+{
+	k_spinlock_key_t key = k_spin_lock(&work_stats_lock);
+	struct k_work_handler_stats *victim = NULL;
+
+	for (int i = 0; i < ARRAY_SIZE(work_stats); i++) {
+		struct k_work_handler_stats *s = &work_stats[i];
+
+		if (s->handler == handler) {
+			s->count++;
+			s->total_cycles += cycles;
+			if (cycles > s->max_cycles) {
+				s->max_cycles = cycles;
+			}
+			goto out;
+		}
+
+		/* An empty slot is taken first, a full table evicts the
+		 * handler with the lowest max
+		 */
+		if (victim == NULL || (victim->handler != NULL &&
+				       (s->handler == NULL ||
+					s->max_cycles < victim->max_cycles))) {
+			victim = s;
+		}
+	}
+
+	if (victim->handler == NULL || cycles > victim->max_cycles) {
+		victim->handler = handler;
+		victim->count = 1;
+		victim->max_cycles = cycles;
+		victim->total_cycles = cycles;
+	}
+
+out:
+	k_spin_unlock(&work_stats_lock, key);
+}
+
+int k_work_handler_stats_get(struct k_work_handler_stats *stats, int max)
+{
+	k_spinlock_key_t key = k_spin_lock(&work_stats_lock);
+	int n = 0;
+
+	/* Insertion sort by max_cycles, slowest first */
+	for (int i = 0; i < ARRAY_SIZE(work_stats) && max > 0; i++) {
+		struct k_work_handler_stats *s = &work_stats[i];
+		int j;
+
+		if (s->handler == NULL) {
+			continue;
+		}
+
+		if (n < max) {
+			j = n++;
+		} else if (s->max_cycles > stats[max - 1].max_cycles) {
+			j = max - 1;
+		} else {
+			continue;
+		}
+
+		for (; j > 0 && stats[j - 1].max_cycles < s->max_cycles; j--) {
+			stats[j] = stats[j - 1];
+		}
+		stats[j] = *s;
+	}
+
+	k_spin_unlock(&work_stats_lock, key);
+
+	return n;
+}
+#endif /* CONFIG_WORKQUEUE_STATS */
+
 static void work_q_main(void *work_q_ptr, void *p2, void *p3)
 {
 	struct k_work_q *work_q = work_q_ptr;
@@ -39,7 +115,15 @@ static void work_q_main(void *work_q_ptr, void *p2, void *p3)
 		/* Reset pending state so it can be resubmitted by handler */
 		if (atomic_test_and_clear_bit(work->flags,
 					      K_WORK_STATE_PENDING)) {
+#ifdef CONFIG_WORKQUEUE_STATS
+			u32_t start = k_cycle_get_32();
+
+			handler(work);
+			/* work may be gone by now, only use the handler */
+			work_stats_record(handler, k_cycle_get_32() - start);
+#else
 			handler(work);
+#endif
 		}
 
 		/* Make sure we don't hog up the CPU if the FIFO never (or
@@ -60,6 +144,26 @@ void k_work_q_start(struct k_work_q *work_q, k_thread_stack_t *stack,
 	_k_object_init(work_q);
 }
 
+void k_work_q_worker_add(struct k_work_q *work_q, struct k_thread *thread,
+			 k_thread_stack_t *stack, size_t stack_size, int prio,
+			 int cpu)
+{
+	(void)k_thread_create(thread, stack, stack_size, work_q_main,
+			      work_q, 0, 0, prio, 0, K_FOREVER);
+
+#ifdef CONFIG_SCHED_CPU_MASK
+	if (cpu != K_WORK_Q_ANY_CPU) {
+		(void)k_thread_cpu_mask_clear(thread);
+		(void)k_thread_cpu_mask_enable(thread, cpu);
+	}
+#else
+	ARG_UNUSED(cpu);
+#endif
+
+	k_thread_name_set(thread, WORKQUEUE_THREAD_NAME);
+	k_thread_start(thread);
+}
+
 #ifdef CONFIG_SYS_CLOCK_EXISTS
 static void work_timeout(struct _timeout *t)
 {
@@ -0,0 +1,389 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <misc/heap.h>
+#include <misc/__assert.h>
+#include <misc/util.h>
+#include <string.h>
+
+/*
+ * Every block, free or used, starts with a header holding the address of
+ * the physically preceding block and its own size including the header.
+ * Sizes are multiples of SYS_HEAP_ALIGN, so the low bit of the size marks
+ * free blocks.  Free blocks additionally hold the links of their free
+ * list.  The heap ends with a zero sized used block, so that coalescing
+ * never needs a bounds check.
+ */
+struct blk {
+	struct blk *prev_phys;
+	size_t size_flags;
+	struct blk *next_free;
+	struct blk *prev_free;
+};
+
+#define BLK_FREE 1
+
+#define HDR_SIZE offsetof(struct blk, next_free)
+#define MIN_BLK_SIZE sizeof(struct blk)
+
+#define ALIGN_LOG2 (sizeof(void *) == 8 ? 4 : 3)
+
+/* Sizes below SMALL_SIZE are all in first level class 0, split linearly */
+#define FL_SHIFT (SYS_HEAP_SL_LOG2 + ALIGN_LOG2)
+#define SMALL_SIZE ((size_t)1 << FL_SHIFT)
+
+struct z_heap {
+	struct blk *first;
+	struct blk *end;
+	size_t free_bytes;
+	size_t allocated_bytes;
+	size_t max_allocated_bytes;
+	u32_t fl_bitmap;
+	int fl_count;
+	u32_t *sl_bitmap;
+	struct blk **heads;
+};
+
+static inline int flog2(size_t n)
+{
+	return (int)(8 * sizeof(long) - 1) - __builtin_clzl((unsigned long)n);
+}
+
+static inline size_t blk_size(struct blk *b)
+{
+	return b->size_flags & ~(size_t)BLK_FREE;
+}
+
+static inline bool blk_free(struct blk *b)
+{
+	return (b->size_flags & BLK_FREE) != 0;
+}
+
+static inline struct blk *next_phys(struct blk *b)
+{
+	return (struct blk *)((u8_t *)b + blk_size(b));
+}
+
+static inline struct blk *mem_to_blk(void *mem)
+{
+	return (struct blk *)((u8_t *)mem - HDR_SIZE);
+}
+
+static inline void *blk_to_mem(struct blk *b)
+{
+	return (u8_t *)b + HDR_SIZE;
+}
+
+/* Size class of a free block of the given size */
+static void mapping_insert(size_t size, int *fl, int *sl)
+{
+	if (size < SMALL_SIZE) {
+		*fl = 0;
+		*sl = size >> ALIGN_LOG2;
+	} else {
+		int l = flog2(size);
+
+		*fl = l - FL_SHIFT + 1;
+		*sl = (size >> (l - SYS_HEAP_SL_LOG2)) - SYS_HEAP_SL_COUNT;
+	}
+}
+
+/* Lowest size class in which every block is at least size bytes */
+static void mapping_search(size_t size, int *fl, int *sl)
+{
+	if (size >= SMALL_SIZE) {
+		size += ((size_t)1 << (flog2(size) - SYS_HEAP_SL_LOG2)) - 1;
+	}
+
+	mapping_insert(size, fl, sl);
+}
+
+static void free_list_add(struct z_heap *h, struct blk *b)
+{
+	int fl, sl, idx;
+
+	mapping_insert(blk_size(b), &fl, &sl);
+	idx = fl * SYS_HEAP_SL_COUNT + sl;
+
+	b->prev_free = NULL;
+	b->next_free = h->heads[idx];
+	if (b->next_free != NULL) {
+		b->next_free->prev_free = b;
+	}
+	h->heads[idx] = b;
+
+	h->fl_bitmap |= BIT(fl);
+	h->sl_bitmap[fl] |= BIT(sl);
+
+	b->size_flags |= BLK_FREE;
+	h->free_bytes += blk_size(b);
+}
+
+static void free_list_remove(struct z_heap *h, struct blk *b)
+{
+	int fl, sl, idx;
+
+	mapping_insert(blk_size(b), &fl, &sl);
+	idx = fl * SYS_HEAP_SL_COUNT + sl;
+
+	if (b->prev_free != NULL) {
+		b->prev_free->next_free = b->next_free;
+	} else {
+		h->heads[idx] = b->next_free;
+	}
+	if (b->next_free != NULL) {
+		b->next_free->prev_free = b->prev_free;
+	}
+
+	if (h->heads[idx] == NULL) {
+		h->sl_bitmap[fl] &= ~BIT(sl);
+		if (h->sl_bitmap[fl] == 0) {
+			h->fl_bitmap &= ~BIT(fl);
+		}
+	}
+
+	b->size_flags &= ~(size_t)BLK_FREE;
+	h->free_bytes -= blk_size(b);
+}
+
+static struct blk *find_free_blk(struct z_heap *h, size_t size)
+{
+	u32_t map;
+	int fl, sl;
+
+	mapping_search(size, &fl, &sl);
+	if (fl >= h->fl_count) {
+		return NULL;
+	}
+
+	map = h->sl_bitmap[fl] & (~0U << sl);
+	if (map == 0) {
+		/* nothing big enough in this power of two, take the
+		 * smallest class of the next non-empty one
+		 */
+		map = fl + 1 >= 32 ? 0 : h->fl_bitmap & (~0U << (fl + 1));
+		if (map == 0) {
+			return NULL;
+		}
+
+		fl = __builtin_ctz(map);
+		map = h->sl_bitmap[fl];
+	}
+
+	sl = __builtin_ctz(map);
+
+	return h->heads[fl * SYS_HEAP_SL_COUNT + sl];
+}
+
+void sys_heap_init(struct sys_heap *h, void *mem, size_t bytes)
+{
+	struct z_heap *z;
+	u8_t *start = (u8_t *)ROUND_UP(mem, SYS_HEAP_ALIGN);
+	u8_t *limit = (u8_t *)mem + bytes;
+	u8_t *p;
+	int fl_count;
+
+	/* Enough first level classes for a block spanning all of mem */
+	fl_count = max(flog2(bytes) - FL_SHIFT + 2, 1);
+	__ASSERT(fl_count <= 32, "heap too large");
+
+	z = (struct z_heap *)start;
+	p = start + sizeof(*z);
+	z->sl_bitmap = (u32_t *)p;
+	p += fl_count * sizeof(u32_t);
+	z->heads = (struct blk **)ROUND_UP(p, sizeof(void *));
+	p = (u8_t *)(z->heads + fl_count * SYS_HEAP_SL_COUNT);
+
+	z->first = (struct blk *)ROUND_UP(p, SYS_HEAP_ALIGN);
+	z->end = (struct blk *)ROUND_DOWN(limit - HDR_SIZE, SYS_HEAP_ALIGN);
+	__ASSERT((u8_t *)z->end >= (u8_t *)z->first + MIN_BLK_SIZE,
+		 "heap memory too small");
+
+	z->fl_count = fl_count;
+	z->fl_bitmap = 0;
+	z->free_bytes = 0;
+	z->allocated_bytes = 0;
+	z->max_allocated_bytes = 0;
+	(void)memset(z->sl_bitmap, 0, fl_count * sizeof(u32_t));
+	(void)memset(z->heads, 0,
+		     fl_count * SYS_HEAP_SL_COUNT * sizeof(struct blk *));
+
+	z->first->prev_phys = NULL;
+	z->first->size_flags = (u8_t *)z->end - (u8_t *)z->first;
+	z->end->prev_phys = z->first;
+	z->end->size_flags = 0;
+	free_list_add(z, z->first);
+
+	h->heap = z;
+	h->init_mem = mem;
+	h->init_bytes = bytes;
+}
+
+void *sys_heap_alloc(struct sys_heap *h, size_t bytes)
+{
+	struct z_heap *z = h->heap;
+	struct blk *b;
+	size_t size;
+
+	if (bytes == 0 || bytes > h->init_bytes) {
+		return NULL;
+	}
+
+	size = max(ROUND_UP(bytes + HDR_SIZE, SYS_HEAP_ALIGN), MIN_BLK_SIZE);
+
+	b = find_free_blk(z, size);
+	if (b == NULL) {
+		return NULL;
+	}
+
+	free_list_remove(z, b);
+
+	/* Split off the tail if it is big enough to be a block. The
+	 * block after b is used, as no two free blocks are adjacent, so
+	 * the tail needs no coalescing.
+	 */
+	if (blk_size(b) - size >= MIN_BLK_SIZE) {
+		struct blk *tail = (struct blk *)((u8_t *)b + size);
+
+		tail->prev_phys = b;
+		tail->size_flags = blk_size(b) - size;
+		next_phys(tail)->prev_phys = tail;
+		b->size_flags = size;
+		free_list_add(z, tail);
+	}
+
+	z->allocated_bytes += blk_size(b);
+	if (z->allocated_bytes > z->max_allocated_bytes) {
+		z->max_allocated_bytes = z->allocated_bytes;
+	}
+
+	return blk_to_mem(b);
+}
+
+void sys_heap_free(struct sys_heap *h, void *mem)
+{
+	struct z_heap *z = h->heap;
+	struct blk *b, *prev, *next;
+
+	if (mem == NULL) {
+		return;
+	}
+
+	__ASSERT(sys_heap_contains(h, mem), "pointer not from this heap");
+
+	b = mem_to_blk(mem);
+	__ASSERT(!blk_free(b), "double free");
+	z->allocated_bytes -= blk_size(b);
+
+	prev = b->prev_phys;
+	if (prev != NULL && blk_free(prev)) {
+		free_list_remove(z, prev);
+		prev->size_flags += blk_size(b);
+		b = prev;
+	}
+
+	next = next_phys(b);
+	if (blk_free(next)) {
+		free_list_remove(z, next);
+		b->size_flags += blk_size(next);
+	}
+
+	next_phys(b)->prev_phys = b;
+	free_list_add(z, b);
+}
+
+size_t sys_heap_usable_size(struct sys_heap *h, void *mem)
+{
+	ARG_UNUSED(h);
+
+	return blk_size(mem_to_blk(mem)) - HDR_SIZE;
+}
+
+void sys_heap_walk(struct sys_heap *h, sys_heap_walk_cb_t cb,
+		   void *user_data)
+{
+	struct z_heap *z = h->heap;
+
+	for (struct blk *b = z->first; b != z->end; b = next_phys(b)) {
+		cb(blk_to_mem(b), blk_size(b) - HDR_SIZE, !blk_free(b),
+		   user_data);
+	}
+}
+
+void sys_heap_stats_get(struct sys_heap *h, struct sys_heap_stats *stats)
+{
+	struct z_heap *z = h->heap;
+
+	stats->free_bytes = z->free_bytes;
+	stats->allocated_bytes = z->allocated_bytes;
+	stats->max_allocated_bytes = z->max_allocated_bytes;
+}
+
+bool sys_heap_validate(struct sys_heap *h)
+{
+	struct z_heap *z = h->heap;
+	struct blk *prev = NULL;
+	size_t free_bytes = 0, used_bytes = 0;
+	int free_blks = 0;
+
+	/* physical order: links, sizes and coalescing */
+	for (struct blk *b = z->first; b != z->end; b = next_phys(b)) {
+		if (b->prev_phys != prev || blk_size(b) < MIN_BLK_SIZE ||
+		    (blk_size(b) & (SYS_HEAP_ALIGN - 1)) != 0 ||
+		    next_phys(b) > z->end) {
+			return false;
+		}
+
+		if (blk_free(b)) {
+			if (prev != NULL && blk_free(prev)) {
+				return false;
+			}
+			free_bytes += blk_size(b);
+			free_blks++;
+		} else {
+			used_bytes += blk_size(b);
+		}
+
+		prev = b;
+	}
+
+	if (z->end->prev_phys != prev || free_bytes != z->free_bytes ||
+	    used_bytes != z->allocated_bytes) {
+		return false;
+	}
+
+	/* free lists: every free block on the list of its class */
+	for (int fl = 0; fl < z->fl_count; fl++) {
+		for (int sl = 0; sl < SYS_HEAP_SL_COUNT; sl++) {
+			struct blk *b = z->heads[fl * SYS_HEAP_SL_COUNT + sl];
+			bool bit = (z->sl_bitmap[fl] & BIT(sl)) != 0;
+
+			if (bit != (b != NULL)) {
+				return false;
+			}
+
+			for (prev = NULL; b != NULL; b = b->next_free) {
+				int bfl, bsl;
+
+				mapping_insert(blk_size(b), &bfl, &bsl);
+				if (!blk_free(b) || b->prev_free != prev ||
+				    bfl != fl || bsl != sl) {
+					return false;
+				}
+
+				free_blks--;
+				prev = b;
+			}
+		}
+
+		if (((z->fl_bitmap & BIT(fl)) != 0) !=
+		    (z->sl_bitmap[fl] != 0)) {
+			return false;
+		}
+	}
+
+	return free_blks == 0;
+}
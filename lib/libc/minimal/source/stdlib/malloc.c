@@ -9,12 +9,65 @@
 #include <init.h>
 #include <errno.h>
 #include <misc/mempool.h>
+#include <misc/heap.h>
 #include <string.h>
 
 #define LOG_LEVEL CONFIG_KERNEL_LOG_LEVEL
 #include <logging/log.h>
 LOG_MODULE_DECLARE(os);
 
+#if defined(CONFIG_MINIMAL_LIBC_MALLOC_TLSF)
+K_MUTEX_DEFINE(malloc_mutex);
+static char __aligned(SYS_HEAP_ALIGN) _GENERIC_SECTION(.data)
+	z_malloc_heap_mem[CONFIG_MINIMAL_LIBC_MALLOC_ARENA_SIZE];
+_GENERIC_SECTION(.data) struct sys_heap z_malloc_heap;
+
+void *malloc(size_t size)
+{
+	void *ret;
+
+	k_mutex_lock(&malloc_mutex, K_FOREVER);
+	ret = sys_heap_alloc(&z_malloc_heap, size);
+	k_mutex_unlock(&malloc_mutex);
+
+	if (ret == NULL) {
+		errno = ENOMEM;
+	}
+
+	return ret;
+}
+
+void free(void *ptr)
+{
+	if (ptr == NULL) {
+		return;
+	}
+
+	k_mutex_lock(&malloc_mutex, K_FOREVER);
+	sys_heap_free(&z_malloc_heap, ptr);
+	k_mutex_unlock(&malloc_mutex);
+}
+
+static size_t usable_size(void *ptr)
+{
+	return sys_heap_usable_size(&z_malloc_heap, ptr);
+}
+
+static int malloc_prepare(struct device *unused)
+{
+	ARG_UNUSED(unused);
+
+#ifdef CONFIG_USERSPACE
+	k_object_access_all_grant(&malloc_mutex);
+#endif
+	sys_heap_init(&z_malloc_heap, z_malloc_heap_mem,
+		      sizeof(z_malloc_heap_mem));
+
+	return 0;
+}
+
+SYS_INIT(malloc_prepare, APPLICATION, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+#else /* buddy allocator */
 #if (CONFIG_MINIMAL_LIBC_MALLOC_ARENA_SIZE > 0)
 K_MUTEX_DEFINE(malloc_mutex);
 SYS_MEM_POOL_DEFINE(z_malloc_mem_pool, &malloc_mutex, 16,
@@ -62,6 +115,26 @@ void free(void *ptr)
 	sys_mem_pool_free(ptr);
 }
 
+static size_t usable_size(void *ptr)
+{
+	struct sys_mem_pool_block *blk;
+	size_t block_size;
+
+	/* Stored right before the pointer passed to the user */
+	blk = (struct sys_mem_pool_block *)((char *)ptr - sizeof(*blk));
+
+	/* Determine size of previously allocated block by its level.
+	 * Most likely a bit larger than the original allocation
+	 */
+	block_size = _ALIGN4(blk->pool->base.max_sz);
+	for (int i = 1; i <= blk->level; i++) {
+		block_size = _ALIGN4(block_size / 4);
+	}
+
+	return block_size - sizeof(struct sys_mem_pool_block);
+}
+#endif /* CONFIG_MINIMAL_LIBC_MALLOC_TLSF */
+
 static bool size_t_mul_overflow(size_t a, size_t b, size_t *res)
 {
 #if __SIZEOF_SIZE_T__ == 4
@@ -94,30 +167,15 @@ void *calloc(size_t nmemb, size_t size)
 
 void *realloc(void *ptr, size_t requested_size)
 {
-	struct sys_mem_pool_block *blk;
-	size_t block_size, total_requested_size;
+	size_t block_size;
 	void *new_ptr;
 
 	if (requested_size == 0) {
 		return NULL;
 	}
 
-	/* Stored right before the pointer passed to the user */
-	blk = (struct sys_mem_pool_block *)((char *)ptr - sizeof(*blk));
-
-	/* Determine size of previously allocated block by its level.
-	 * Most likely a bit larger than the original allocation
-	 */
-	block_size = _ALIGN4(blk->pool->base.max_sz);
-	for (int i = 1; i <= blk->level; i++) {
-		block_size = _ALIGN4(block_size / 4);
-	}
-
-	/* We really need this much memory */
-	total_requested_size = requested_size +
-		sizeof(struct sys_mem_pool_block);
-
-	if (block_size >= total_requested_size) {
+	block_size = usable_size(ptr);
+	if (block_size >= requested_size) {
 		/* Existing block large enough, nothing to do */
 		return ptr;
 	}
@@ -127,7 +185,7 @@ void *realloc(void *ptr, size_t requested_size)
 		return NULL;
 	}
 
-	memcpy(new_ptr, ptr, block_size - sizeof(struct sys_mem_pool_block));
+	memcpy(new_ptr, ptr, block_size);
 	free(ptr);
 
 	return new_ptr;
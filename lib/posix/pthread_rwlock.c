@@ -11,8 +11,6 @@
 #define INITIALIZED 1
 #define NOT_INITIALIZED 0
 
-#define CONCURRENT_READER_LIMIT  (CONFIG_MAX_PTHREAD_COUNT + 1)
-
 s64_t timespec_to_timeoutms(const struct timespec *abstime);
 static u32_t read_lock_acquire(pthread_rwlock_t *rwlock, s32_t timeout);
 static u32_t write_lock_acquire(pthread_rwlock_t *rwlock, s32_t timeout);
@@ -25,11 +23,7 @@ static u32_t write_lock_acquire(pthread_rwlock_t *rwlock, s32_t timeout);
 int pthread_rwlock_init(pthread_rwlock_t *rwlock,
 			const pthread_rwlockattr_t *attr)
 {
-	k_sem_init(&rwlock->rd_sem, CONCURRENT_READER_LIMIT,
-		   CONCURRENT_READER_LIMIT);
-	k_sem_init(&rwlock->wr_sem, 1, 1);
-	k_sem_init(&rwlock->reader_active, 1, 1);
-	rwlock->wr_owner = NULL;
+	k_rwlock_init(&rwlock->lock);
 	rwlock->status = INITIALIZED;
 	return 0;
 }
@@ -45,7 +39,7 @@ int pthread_rwlock_destroy(pthread_rwlock_t *rwlock)
 		return EINVAL;
 	}
 
-	if (rwlock->wr_owner != NULL) {
+	if (rwlock->lock.writer != NULL || rwlock->lock.readers != 0) {
 		return EBUSY;
 	}
 
@@ -60,9 +54,6 @@ int pthread_rwlock_destroy(pthread_rwlock_t *rwlock)
 /**
  * @brief Lock a read-write lock object for reading.
  *
- * API behaviour is unpredictable if number of concurrent reader
- * lock held is greater than CONCURRENT_READER_LIMIT.
- *
  * See IEEE 1003.1
  */
 int pthread_rwlock_rdlock(pthread_rwlock_t *rwlock)
@@ -77,9 +68,6 @@ int pthread_rwlock_rdlock(pthread_rwlock_t *rwlock)
 /**
  * @brief Lock a read-write lock object for reading within specific time.
  *
- * API behaviour is unpredictable if number of concurrent reader
- * lock held is greater than CONCURRENT_READER_LIMIT.
- *
  * See IEEE 1003.1
  */
 int pthread_rwlock_timedrdlock(pthread_rwlock_t *rwlock,
@@ -105,9 +93,6 @@ int pthread_rwlock_timedrdlock(pthread_rwlock_t *rwlock,
 /**
  * @brief Lock a read-write lock object for reading immedately.
  *
- * API behaviour is unpredictable if number of concurrent reader
- * lock held is greater than CONCURRENT_READER_LIMIT.
- *
  * See IEEE 1003.1
  */
 int pthread_rwlock_tryrdlock(pthread_rwlock_t *rwlock)
@@ -122,8 +107,8 @@ int pthread_rwlock_tryrdlock(pthread_rwlock_t *rwlock)
 /**
  * @brief Lock a read-write lock object for writing.
  *
- * Write lock does not have priority over reader lock,
- * threads get lock based on priority.
+ * Writers waiting for the lock take precedence over new readers,
+ * and the writer holding the lock inherits the priority of waiters.
  *
  * See IEEE 1003.1
  */
@@ -139,8 +124,8 @@ int pthread_rwlock_wrlock(pthread_rwlock_t *rwlock)
 /**
  * @brief Lock a read-write lock object for writing within specific time.
  *
- * Write lock does not have priority over reader lock,
- * threads get lock based on priority.
+ * Writers waiting for the lock take precedence over new readers,
+ * and the writer holding the lock inherits the priority of waiters.
  *
  * See IEEE 1003.1
  */
@@ -167,8 +152,8 @@ int pthread_rwlock_timedwrlock(pthread_rwlock_t *rwlock,
 /**
  * @brief Lock a read-write lock object for writing immedately.
  *
- * Write lock does not have priority over reader lock,
- * threads get lock based on priority.
+ * Writers waiting for the lock take precedence over new readers,
+ * and the writer holding the lock inherits the priority of waiters.
  *
  * See IEEE 1003.1
  */
@@ -193,65 +178,32 @@ int pthread_rwlock_unlock(pthread_rwlock_t *rwlock)
 		return EINVAL;
 	}
 
-	if (k_current_get() == rwlock->wr_owner) {
-		/* Write unlock */
-		rwlock->wr_owner = NULL;
-		k_sem_give(&rwlock->reader_active);
-		k_sem_give(&rwlock->wr_sem);
+	if (k_current_get() == rwlock->lock.writer) {
+		k_rwlock_write_unlock(&rwlock->lock);
+	} else if (rwlock->lock.readers != 0) {
+		k_rwlock_read_unlock(&rwlock->lock);
 	} else {
-		/* Read unlock */
-		if (k_sem_count_get(&rwlock->rd_sem) ==
-				    (CONCURRENT_READER_LIMIT - 1)) {
-			/* Last read lock, unlock writer */
-			k_sem_give(&rwlock->reader_active);
-		}
-
-		k_sem_give(&rwlock->rd_sem);
+		return EPERM;
 	}
+
 	return 0;
 }
 
 
 static u32_t read_lock_acquire(pthread_rwlock_t *rwlock, s32_t timeout)
 {
-	u32_t ret = 0;
-
-	if (k_sem_take(&rwlock->wr_sem, timeout) == 0) {
-		k_sem_take(&rwlock->reader_active, K_NO_WAIT);
-		k_sem_take(&rwlock->rd_sem, K_NO_WAIT);
-		k_sem_give(&rwlock->wr_sem);
-	} else {
-		ret = EBUSY;
+	if (k_rwlock_read_lock(&rwlock->lock, timeout) != 0) {
+		return EBUSY;
 	}
 
-	return ret;
+	return 0;
 }
 
 static u32_t write_lock_acquire(pthread_rwlock_t *rwlock, s32_t timeout)
 {
-	u32_t ret = 0;
-	s64_t elapsed_time, st_time = k_uptime_get();
-
-	/* waiting for release of write lock */
-	if (k_sem_take(&rwlock->wr_sem, timeout) == 0) {
-		if (timeout > K_NO_WAIT) {
-			elapsed_time = k_uptime_get() - st_time;
-			timeout = timeout <= elapsed_time ? K_NO_WAIT :
-				  timeout - elapsed_time;
-		}
-
-		/* waiting for reader to complete operation */
-		if (k_sem_take(&rwlock->reader_active, timeout) == 0) {
-			rwlock->wr_owner = k_current_get();
-		} else {
-			k_sem_give(&rwlock->wr_sem);
-			ret = EBUSY;
-		}
-
-	} else {
-		ret = EBUSY;
+	if (k_rwlock_write_lock(&rwlock->lock, timeout) != 0) {
+		return EBUSY;
 	}
-	return ret;
-}
-
 
+	return 0;
+}
@@ -18,11 +18,13 @@ from elf_helper import ElfHelper, kobject_to_enum
 
 kobjects = {
     "k_alert": None,
+    "k_event": None,
     "k_msgq": None,
     "k_mutex": None,
     "k_pipe": None,
     "k_queue": None,
     "k_poll_signal": None,
+    "k_rwlock": None,
     "k_sem": None,
     "k_stack": None,
     "k_thread": None,
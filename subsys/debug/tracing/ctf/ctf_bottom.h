@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _CTF_BOTTOM_H
+#define _CTF_BOTTOM_H
+
+#include <zephyr/types.h>
+#include <stddef.h>
+
+/*
+ * The bottom layer of the CTF backend takes the event streams drained from
+ * the per-CPU ring buffers to wherever the trace is collected. Every CPU
+ * has its own stream; each stream is a plain sequence of events, without
+ * packet headers, as described by tsdl/metadata.in.
+ */
+
+/* Called once before the first write */
+void ctf_bottom_init(void);
+
+/* Append len bytes to the event stream of the given CPU */
+void ctf_bottom_write(int cpu, const void *data, size_t len);
+
+/* Drain all ring buffers to the bottom layer. Callers serialize. */
+void ctf_drain(void);
+
+#endif /* _CTF_BOTTOM_H */
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * CTF stream output for native_posix: every CPU's events go to a
+ * channel0_<cpu> file in a host directory, next to which the build places
+ * the trace's metadata file.
+ */
+
+#include <stdio.h>
+#include <zephyr.h>
+#include "soc.h"
+#include "cmdline.h" /* native_posix command line options header */
+#include "posix_trace.h"
+#include "ctf_bottom.h"
+
+static char *trace_dir = CTF_TRACE_DIR;
+
+static FILE *streams[CONFIG_MP_NUM_CPUS];
+
+void ctf_bottom_init(void)
+{
+	char path[256];
+
+	for (int cpu = 0; cpu < CONFIG_MP_NUM_CPUS; cpu++) {
+		snprintf(path, sizeof(path), "%s/channel0_%d", trace_dir, cpu);
+		streams[cpu] = fopen(path, "wb");
+		if (streams[cpu] == NULL) {
+			posix_print_warning("WARNING: could not open CTF "
+					    "stream %s\n", path);
+		}
+	}
+}
+
+void ctf_bottom_write(int cpu, const void *data, size_t len)
+{
+	if (streams[cpu] != NULL) {
+		fwrite(data, 1, len, streams[cpu]);
+	}
+}
+
+static void ctf_add_options(void)
+{
+	static struct args_struct_t ctf_options[] = {
+		/*
+		 * Fields:
+		 * manual, mandatory, switch,
+		 * option_name, var_name ,type,
+		 * destination, callback,
+		 * description
+		 */
+		{false, false, false,
+		"ctf-path", "path", 's',
+		(void *)&trace_dir, NULL,
+		"Directory the CTF event streams are written to, by default "
+		"the ctf directory of the build, which holds the metadata"},
+		ARG_TABLE_ENDMARKER
+	};
+
+	native_add_command_line_opts(ctf_options);
+}
+
+static void ctf_cleanup(void)
+{
+	/* No Zephyr thread runs anymore, write out what is left */
+	ctf_drain();
+
+	for (int cpu = 0; cpu < CONFIG_MP_NUM_CPUS; cpu++) {
+		if (streams[cpu] != NULL) {
+			fclose(streams[cpu]);
+			streams[cpu] = NULL;
+		}
+	}
+}
+
+NATIVE_TASK(ctf_add_options, PRE_BOOT_1, 12);
+NATIVE_TASK(ctf_cleanup, ON_EXIT, 98);
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * CTF stream output to a UART: the raw event stream of the (single) CPU
+ * is sent as is, to be captured on the host into a channel0_0 file next
+ * to the trace's metadata file.
+ */
+
+#include <zephyr.h>
+#include <device.h>
+#include <uart.h>
+#include <misc/__assert.h>
+#include "ctf_bottom.h"
+
+static struct device *uart;
+
+void ctf_bottom_init(void)
+{
+	uart = device_get_binding(CONFIG_TRACING_CTF_UART_DEV_NAME);
+	__ASSERT(uart != NULL, "CTF UART device not found");
+}
+
+void ctf_bottom_write(int cpu, const void *data, size_t len)
+{
+	const u8_t *p = data;
+
+	ARG_UNUSED(cpu);
+
+	if (uart == NULL) {
+		return;
+	}
+
+	while (len--) {
+		uart_poll_out(uart, *p++);
+	}
+}
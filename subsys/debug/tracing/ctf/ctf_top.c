@@ -0,0 +1,360 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <kernel_structs.h>
+#include <init.h>
+#include <atomic.h>
+#include <string.h>
+#include <tracing.h>
+#include "ctf_bottom.h"
+
+/*
+ * Events are written in the binary layout described by tsdl/metadata.in:
+ * a packed header holding a 32-bit cycle count timestamp and the event
+ * id, followed by the event's fields.
+ *
+ * Every CPU has its own ring buffer. It is only written by its CPU, with
+ * local interrupts locked so that ISRs do not interleave their events,
+ * and only read by the drain thread, which makes it a single producer
+ * single consumer queue: CPUs never take a lock shared with each other
+ * to record an event. When a ring is full new events are dropped and
+ * counted, and an events_lost record is written once there is room.
+ */
+
+#define RING_SIZE CONFIG_TRACING_CTF_BUFFER_SIZE
+#define RING_MASK (RING_SIZE - 1)
+
+BUILD_ASSERT_MSG((RING_SIZE & RING_MASK) == 0,
+		 "CTF ring buffer size must be a power of two");
+
+enum ctf_event_id {
+	CTF_EVENT_THREAD_SWITCHED_OUT = 0x10,
+	CTF_EVENT_THREAD_SWITCHED_IN,
+	CTF_EVENT_THREAD_PRIORITY_SET,
+	CTF_EVENT_THREAD_CREATE,
+	CTF_EVENT_THREAD_ABORT,
+	CTF_EVENT_THREAD_SUSPEND,
+	CTF_EVENT_THREAD_RESUME,
+	CTF_EVENT_THREAD_READY,
+	CTF_EVENT_THREAD_PEND,
+	CTF_EVENT_THREAD_INFO,
+	CTF_EVENT_ISR_ENTER,
+	CTF_EVENT_ISR_EXIT,
+	CTF_EVENT_ISR_EXIT_TO_SCHEDULER,
+	CTF_EVENT_IDLE,
+	CTF_EVENT_CALL_START,
+	CTF_EVENT_CALL_END,
+	CTF_EVENT_EVENTS_LOST,
+};
+
+struct ctf_event_header {
+	u32_t timestamp;
+	u8_t id;
+} __packed;
+
+/* Largest event, thread_info */
+#define CTF_EVENT_MAX_SIZE (sizeof(struct ctf_event_header) + 17)
+
+struct ctf_ring {
+	/* total bytes written, only updated by the owning CPU */
+	atomic_t head;
+	/* total bytes drained, only updated by the drain thread */
+	atomic_t tail;
+	/* events dropped since the last events_lost record */
+	u32_t lost;
+	/* events dropped in total */
+	u32_t lost_total;
+	u8_t data[RING_SIZE];
+};
+
+static struct ctf_ring rings[CONFIG_MP_NUM_CPUS];
+
+static bool bottom_ready;
+
+static void ring_put(struct ctf_ring *r, u32_t head, const void *ev,
+		     u32_t len)
+{
+	u32_t off = head & RING_MASK;
+	u32_t first = min(len, RING_SIZE - off);
+
+	memcpy(&r->data[off], ev, first);
+	memcpy(r->data, (const u8_t *)ev + first, len - first);
+}
+
+static void emit(u8_t id, const void *fields, u32_t len)
+{
+	u8_t ev[CTF_EVENT_MAX_SIZE];
+	struct ctf_event_header *hdr = (struct ctf_event_header *)ev;
+	struct ctf_ring *r;
+	u32_t head, space;
+	unsigned int key;
+
+	/* Only the local CPU writes its ring, so masking local interrupts
+	 * is enough even on SMP.
+	 */
+	key = _arch_irq_lock();
+
+	r = &rings[_current_cpu->id];
+	head = (u32_t)atomic_get(&r->head);
+	space = RING_SIZE - (head - (u32_t)atomic_get(&r->tail));
+
+	hdr->timestamp = k_cycle_get_32();
+
+	if (r->lost != 0) {
+		u32_t lost_len = sizeof(*hdr) + sizeof(u32_t);
+
+		if (space < lost_len + sizeof(*hdr) + len) {
+			r->lost++;
+			r->lost_total++;
+			_arch_irq_unlock(key);
+			return;
+		}
+
+		hdr->id = CTF_EVENT_EVENTS_LOST;
+		memcpy(ev + sizeof(*hdr), &r->lost, sizeof(u32_t));
+		ring_put(r, head, ev, lost_len);
+		head += lost_len;
+		r->lost = 0;
+	} else if (space < sizeof(*hdr) + len) {
+		r->lost++;
+		r->lost_total++;
+		_arch_irq_unlock(key);
+		return;
+	}
+
+	hdr->id = id;
+	if (len != 0) {
+		memcpy(ev + sizeof(*hdr), fields, len);
+	}
+	ring_put(r, head, ev, sizeof(*hdr) + len);
+
+	/* publish the event to the drain thread */
+	atomic_set(&r->head, head + sizeof(*hdr) + len);
+
+	_arch_irq_unlock(key);
+}
+
+static void emit_thread(u8_t id, struct k_thread *thread)
+{
+	u32_t tid = (u32_t)(uintptr_t)thread;
+
+	emit(id, &tid, sizeof(tid));
+}
+
+static void emit_thread_prio(u8_t id, struct k_thread *thread)
+{
+	struct {
+		u32_t thread;
+		s8_t prio;
+	} __packed fields = {
+		.thread = (u32_t)(uintptr_t)thread,
+		.prio = thread->base.prio,
+	};
+
+	emit(id, &fields, sizeof(fields));
+}
+
+void ctf_thread_switched_out(void)
+{
+	emit_thread(CTF_EVENT_THREAD_SWITCHED_OUT, k_current_get());
+}
+
+void ctf_thread_switched_in(void)
+{
+	emit_thread(CTF_EVENT_THREAD_SWITCHED_IN, k_current_get());
+}
+
+void ctf_thread_priority_set(struct k_thread *thread)
+{
+	emit_thread_prio(CTF_EVENT_THREAD_PRIORITY_SET, thread);
+}
+
+void ctf_thread_create(struct k_thread *thread)
+{
+	emit_thread_prio(CTF_EVENT_THREAD_CREATE, thread);
+}
+
+void ctf_thread_abort(struct k_thread *thread)
+{
+	emit_thread(CTF_EVENT_THREAD_ABORT, thread);
+}
+
+void ctf_thread_suspend(struct k_thread *thread)
+{
+	emit_thread(CTF_EVENT_THREAD_SUSPEND, thread);
+}
+
+void ctf_thread_resume(struct k_thread *thread)
+{
+	emit_thread(CTF_EVENT_THREAD_RESUME, thread);
+}
+
+void ctf_thread_ready(struct k_thread *thread)
+{
+	emit_thread(CTF_EVENT_THREAD_READY, thread);
+}
+
+void ctf_thread_pend(struct k_thread *thread)
+{
+	emit_thread(CTF_EVENT_THREAD_PEND, thread);
+}
+
+void ctf_thread_info(struct k_thread *thread)
+{
+	struct {
+		u32_t thread;
+		s8_t prio;
+		u32_t entry;
+		u32_t stack_start;
+		u32_t stack_size;
+	} __packed fields = {
+		.thread = (u32_t)(uintptr_t)thread,
+		.prio = thread->base.prio,
+#ifdef CONFIG_THREAD_MONITOR
+		.entry = (u32_t)(uintptr_t)thread->entry.pEntry,
+#endif
+#ifdef CONFIG_THREAD_STACK_INFO
+		.stack_start = thread->stack_info.start,
+		.stack_size = thread->stack_info.size,
+#endif
+	};
+
+	BUILD_ASSERT(sizeof(struct ctf_event_header) + sizeof(fields) <=
+		     CTF_EVENT_MAX_SIZE);
+
+	emit(CTF_EVENT_THREAD_INFO, &fields, sizeof(fields));
+}
+
+void ctf_isr_enter(void)
+{
+	emit(CTF_EVENT_ISR_ENTER, NULL, 0);
+}
+
+void ctf_isr_exit(void)
+{
+	emit(CTF_EVENT_ISR_EXIT, NULL, 0);
+}
+
+void ctf_isr_exit_to_scheduler(void)
+{
+	emit(CTF_EVENT_ISR_EXIT_TO_SCHEDULER, NULL, 0);
+}
+
+void ctf_idle(void)
+{
+	emit(CTF_EVENT_IDLE, NULL, 0);
+}
+
+void ctf_call_start(u32_t id)
+{
+	emit(CTF_EVENT_CALL_START, &id, sizeof(id));
+}
+
+void ctf_call_end(u32_t id)
+{
+	emit(CTF_EVENT_CALL_END, &id, sizeof(id));
+}
+
+void z_sys_trace_idle(void)
+{
+	sys_trace_idle();
+}
+
+void z_sys_trace_isr_enter(void)
+{
+	sys_trace_isr_enter();
+}
+
+void z_sys_trace_isr_exit_to_scheduler(void)
+{
+	sys_trace_isr_exit_to_scheduler();
+}
+
+void z_sys_trace_thread_switched_in(void)
+{
+	sys_trace_thread_switched_in();
+}
+
+void z_sys_trace_thread_switched_out(void)
+{
+	sys_trace_thread_switched_out();
+}
+
+void ctf_stats_get(struct ctf_stats *stats)
+{
+	stats->bytes = 0;
+	stats->lost = 0;
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		stats->bytes += (u32_t)atomic_get(&rings[i].head);
+		stats->lost += rings[i].lost_total;
+	}
+}
+
+static void ring_drain(int cpu)
+{
+	struct ctf_ring *r = &rings[cpu];
+	u32_t tail = (u32_t)atomic_get(&r->tail);
+	u32_t head = (u32_t)atomic_get(&r->head);
+
+	while (tail != head) {
+		u32_t off = tail & RING_MASK;
+		u32_t len = min(head - tail, RING_SIZE - off);
+
+		ctf_bottom_write(cpu, &r->data[off], len);
+		tail += len;
+		atomic_set(&r->tail, tail);
+	}
+}
+
+void ctf_drain(void)
+{
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		ring_drain(i);
+	}
+}
+
+K_MUTEX_DEFINE(ctf_drain_lock);
+
+void ctf_flush(void)
+{
+	if (!bottom_ready) {
+		return;
+	}
+
+	k_mutex_lock(&ctf_drain_lock, K_FOREVER);
+	ctf_drain();
+	k_mutex_unlock(&ctf_drain_lock);
+}
+
+static void ctf_drain_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		ctf_flush();
+		k_sleep(CONFIG_TRACING_CTF_DRAIN_PERIOD);
+	}
+}
+
+K_THREAD_DEFINE(ctf_drain_tid, CONFIG_TRACING_CTF_THREAD_STACK_SIZE,
+		ctf_drain_thread, NULL, NULL, NULL,
+		K_LOWEST_APPLICATION_THREAD_PRIO, 0, K_NO_WAIT);
+
+static int ctf_init(struct device *arg)
+{
+	ARG_UNUSED(arg);
+
+	ctf_bottom_init();
+	bottom_ready = true;
+
+	return 0;
+}
+
+SYS_INIT(ctf_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef _TRACE_CTF_H
+#define _TRACE_CTF_H
+#include <kernel.h>
+
+void ctf_thread_switched_out(void);
+void ctf_thread_switched_in(void);
+void ctf_thread_priority_set(struct k_thread *thread);
+void ctf_thread_create(struct k_thread *thread);
+void ctf_thread_abort(struct k_thread *thread);
+void ctf_thread_suspend(struct k_thread *thread);
+void ctf_thread_resume(struct k_thread *thread);
+void ctf_thread_ready(struct k_thread *thread);
+void ctf_thread_pend(struct k_thread *thread);
+void ctf_thread_info(struct k_thread *thread);
+void ctf_isr_enter(void);
+void ctf_isr_exit(void);
+void ctf_isr_exit_to_scheduler(void);
+void ctf_idle(void);
+void ctf_call_start(u32_t id);
+void ctf_call_end(u32_t id);
+
+/**
+ * @brief CTF backend statistics
+ */
+struct ctf_stats {
+	/* bytes of event data written to the ring buffers */
+	u32_t bytes;
+	/* events dropped because a ring buffer was full */
+	u32_t lost;
+};
+
+/**
+ * @brief Get the CTF backend statistics
+ *
+ * Sums the statistics of the ring buffers of all CPUs.
+ *
+ * @param stats Filled in with the statistics
+ */
+void ctf_stats_get(struct ctf_stats *stats);
+
+/**
+ * @brief Write out all buffered events
+ *
+ * Drains the ring buffers of all CPUs to the stream output from the
+ * calling thread, instead of waiting for the drain thread to do it.
+ */
+void ctf_flush(void);
+
+#define sys_trace_thread_switched_out() ctf_thread_switched_out()
+
+#define sys_trace_thread_switched_in() ctf_thread_switched_in()
+
+#define sys_trace_thread_priority_set(thread) ctf_thread_priority_set(thread)
+
+#define sys_trace_thread_create(thread)		\
+	do {					\
+		ctf_thread_create(thread);	\
+		ctf_thread_info(thread);	\
+	} while (0)
+
+#define sys_trace_thread_abort(thread) ctf_thread_abort(thread)
+
+#define sys_trace_thread_suspend(thread) ctf_thread_suspend(thread)
+
+#define sys_trace_thread_resume(thread) ctf_thread_resume(thread)
+
+#define sys_trace_thread_ready(thread) ctf_thread_ready(thread)
+
+#define sys_trace_thread_pend(thread) ctf_thread_pend(thread)
+
+#define sys_trace_thread_info(thread) ctf_thread_info(thread)
+
+#define sys_trace_isr_enter() ctf_isr_enter()
+
+#define sys_trace_isr_exit() ctf_isr_exit()
+
+#define sys_trace_isr_exit_to_scheduler() ctf_isr_exit_to_scheduler()
+
+#define sys_trace_void(id) ctf_call_start(id)
+
+#define sys_trace_idle() ctf_idle()
+
+#define sys_trace_end_call(id) ctf_call_end(id)
+
+#endif /* _TRACE_CTF_H */
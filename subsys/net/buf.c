@@ -94,6 +94,62 @@ static u8_t *generic_data_ref(struct net_buf *buf, u8_t *data)
 	return data;
 }
 
+#if defined(CONFIG_NET_BUF_VAR_POOL_TLSF)
+static u8_t *var_heap_data_alloc(struct net_buf *buf, size_t *size,
+				 s32_t timeout)
+{
+	struct net_buf_pool *buf_pool = net_buf_pool_get(buf->pool_id);
+	struct net_buf_pool_var_heap *var = buf_pool->alloc->alloc_data;
+	unsigned int key;
+	u8_t *ref_count;
+
+	ARG_UNUSED(timeout);
+
+	key = irq_lock();
+
+	/* The heap lives in the pool's own memory, set it up on first use */
+	if (var->heap.heap == NULL) {
+		sys_heap_init(&var->heap, var->mem, var->size);
+	}
+
+	/* Reserve extra space for the ref-count (u8_t) */
+	ref_count = sys_heap_alloc(&var->heap, 1 + *size);
+
+	irq_unlock(key);
+
+	if (!ref_count) {
+		return NULL;
+	}
+
+	*ref_count = 1;
+
+	/* Return pointer to the byte following the ref count */
+	return ref_count + 1;
+}
+
+static void var_heap_data_unref(struct net_buf *buf, u8_t *data)
+{
+	struct net_buf_pool *buf_pool = net_buf_pool_get(buf->pool_id);
+	struct net_buf_pool_var_heap *var = buf_pool->alloc->alloc_data;
+	unsigned int key;
+	u8_t *ref_count;
+
+	ref_count = data - 1;
+	if (--(*ref_count)) {
+		return;
+	}
+
+	key = irq_lock();
+	sys_heap_free(&var->heap, ref_count);
+	irq_unlock(key);
+}
+
+const struct net_buf_data_cb net_buf_var_heap_cb = {
+	.alloc = var_heap_data_alloc,
+	.ref   = generic_data_ref,
+	.unref = var_heap_data_unref,
+};
+#else
 static u8_t *mem_pool_data_alloc(struct net_buf *buf, size_t *size,
 				 s32_t timeout)
 {
@@ -139,6 +195,7 @@ const struct net_buf_data_cb net_buf_var_cb = {
 	.ref   = generic_data_ref,
 	.unref = mem_pool_data_unref,
 };
+#endif /* CONFIG_NET_BUF_VAR_POOL_TLSF */
 
 static u8_t *fixed_data_alloc(struct net_buf *buf, size_t *size, s32_t timeout)
 {
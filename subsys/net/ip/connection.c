@@ -46,303 +46,95 @@
 
 static struct net_conn conns[CONFIG_NET_MAX_CONN];
 
-#if defined(CONFIG_NET_CONN_CACHE)
+BUILD_ASSERT_MSG((CONFIG_NET_CONN_HASH_SIZE &
+		  (CONFIG_NET_CONN_HASH_SIZE - 1)) == 0,
+		 "NET_CONN_HASH_SIZE must be a power of two");
 
-/* Cache the connection so that we do not have to go
- * through the full list of connections when receiving
- * a network packet. The cache contains an index to
- * corresponding entry in conns array.
+/* Received packets are matched against the connections of at most three
+ * lists, rather than against every connection:
  *
- * Hash value is constructed like this:
+ * - connections with a remote address and port and a local port, in a
+ *   hash table by protocol, remote address and both ports
+ * - other connections with a local port, like listening ones, in a hash
+ *   table by protocol and local port
+ * - all the other connections, in a single list
  *
- *   bit      description
- *   0  - 3   bits from remote port
- *   4  - 7   bits from local port
- *   8  - 18  bits from remote address
- *   19 - 29  bits from local address
- *   30       family
- *   31       protocol
+ * A packet looks up the connected table first, then the other two, and
+ * goes to the most specific connection that matches it, as before.
  */
-struct conn_hash {
-	u32_t value;
-	s32_t idx;
-};
+static sys_slist_t conn_connected[CONFIG_NET_CONN_HASH_SIZE];
+static sys_slist_t conn_bound[CONFIG_NET_CONN_HASH_SIZE];
+static sys_slist_t conn_unbound;
 
-struct conn_hash_neg {
-	u32_t value;
-};
-
-/** Connection cache */
-static struct conn_hash conn_cache[CONFIG_NET_MAX_CONN];
-
-/** Negative cache, we definitely do not have a connection
- * to these hosts.
+/* Protects conns[] and the lists. Held across the callback of the
+ * connection a packet goes to, which may unregister connections.
  */
-static struct conn_hash_neg conn_cache_neg[CONFIG_NET_MAX_CONN];
+static K_MUTEX_DEFINE(conn_lock);
 
-#define TAKE_BIT(val, bit, max, used)				\
-	(((val & BIT(bit)) >> bit) << (max - used))
+#define CONN_RANK_CONNECTED (NET_RANK_LOCAL_PORT | NET_RANK_REMOTE_PORT | \
+			     NET_RANK_REMOTE_SPEC_ADDR)
 
-static inline u8_t ports_to_hash(u16_t remote_port,
-				    u16_t local_port)
+/* Ports are in network byte order, as in the packets */
+static inline u32_t conn_hash(u8_t proto, u32_t addr, u16_t remote_port,
+			      u16_t local_port)
 {
-	/* Note that we do not convert port value to network byte order */
-	return (remote_port & BIT(0)) |
-		((remote_port & BIT(4)) >> 3) |
-		((remote_port & BIT(8)) >> 6) |
-		((remote_port & BIT(15)) >> 12) |
-		(((local_port & BIT(0)) |
-		  ((local_port & BIT(4)) >> 3) |
-		  ((local_port & BIT(8)) >> 6) |
-		  ((local_port & BIT(15)) >> 12)) << 4);
-}
+	u32_t hash = (addr ^ ((u32_t)remote_port << 16 | local_port)) + proto;
 
-static inline u16_t ipv6_to_hash(struct in6_addr *addr)
-{
-	/* There is 11 bits available for IPv6 address */
-	/* Use more bits from the lower part of address space */
-	return
-		/* Take 3 bits from higher values */
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[0]), 31, 11, 1) |
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[0]), 15, 11, 2) |
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[0]), 7, 11, 3) |
-
-		/* Take 2 bits from higher middle values */
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[1]), 31, 11, 4) |
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[1]), 15, 11, 5) |
-
-		/* Take 2 bits from lower middle values */
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[2]), 31, 11, 6) |
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[2]), 15, 11, 7) |
-
-		/* Take 4 bits from lower values */
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[3]), 31, 11, 8) |
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[3]), 15, 11, 9) |
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[3]), 7, 11, 10) |
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[3]), 0, 11, 11);
-}
-
-static inline u16_t ipv4_to_hash(struct in_addr *addr)
-{
-	/* There is 11 bits available for IPv4 address */
-	/* Use more bits from the lower part of address space */
-	return
-		TAKE_BIT(addr->s_addr, 31, 11, 1) |
-		TAKE_BIT(addr->s_addr, 27, 11, 2) |
-		TAKE_BIT(addr->s_addr, 21, 11, 3) |
-		TAKE_BIT(addr->s_addr, 17, 11, 4) |
-		TAKE_BIT(addr->s_addr, 14, 11, 5) |
-		TAKE_BIT(addr->s_addr, 11, 11, 6) |
-		TAKE_BIT(addr->s_addr, 8, 11, 7) |
-		TAKE_BIT(addr->s_addr, 5, 11, 8) |
-		TAKE_BIT(addr->s_addr, 3, 11, 9) |
-		TAKE_BIT(addr->s_addr, 2, 11, 10) |
-		TAKE_BIT(addr->s_addr, 0, 11, 11);
+	/* Fibonacci hashing, the high bits are the well mixed ones */
+	return ((hash * 2654435761U) >> 16) & (CONFIG_NET_CONN_HASH_SIZE - 1);
 }
 
-/* Return either the first free position in the cache (idx < 0) or
- * the existing cached position (idx >= 0)
- */
-static s32_t check_hash(enum net_ip_protocol proto,
-			  sa_family_t family,
-			  void *remote_addr,
-			  void *local_addr,
-			  u16_t remote_port,
-			  u16_t local_port,
-			  u32_t *cache_value)
+static inline u32_t addr_hash(sa_family_t family, const void *addr)
 {
-	int i, free_pos = -1;
-	u32_t value = 0;
-
-	value = ports_to_hash(remote_port, local_port);
-
-#if defined(CONFIG_NET_UDP)
-	if (proto == IPPROTO_UDP) {
-		value |= BIT(31);
-	}
-#endif
-
-#if defined(CONFIG_NET_TCP)
-	if (proto == IPPROTO_TCP) {
-		value &= ~BIT(31);
-	}
-#endif
-
 #if defined(CONFIG_NET_IPV6)
 	if (family == AF_INET6) {
-		value |= BIT(30);
-		value |= ipv6_to_hash((struct in6_addr *)remote_addr) << 8;
-		value |= ipv6_to_hash((struct in6_addr *)local_addr) << 19;
-	}
-#endif
+		const struct in6_addr *addr6 = addr;
 
-#if defined(CONFIG_NET_IPV4)
-	if (family == AF_INET) {
-		value &= ~BIT(30);
-		value |= ipv4_to_hash((struct in_addr *)remote_addr) << 8;
-		value |= ipv4_to_hash((struct in_addr *)local_addr) << 19;
+		return UNALIGNED_GET(&addr6->s6_addr32[0]) ^
+			UNALIGNED_GET(&addr6->s6_addr32[1]) ^
+			UNALIGNED_GET(&addr6->s6_addr32[2]) ^
+			UNALIGNED_GET(&addr6->s6_addr32[3]);
 	}
 #endif
 
-	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
-		if (conn_cache[i].value == value) {
-			return i;
-		}
-
-		if (conn_cache[i].idx < 0 && free_pos < 0) {
-			free_pos = i;
-		}
-	}
-
-	if (free_pos >= 0) {
-		conn_cache[free_pos].value = value;
-		return free_pos;
-	}
-
-	*cache_value = value;
-
-	return -ENOENT;
-}
-
-static inline s32_t get_conn(enum net_ip_protocol proto,
-			     sa_family_t family,
-			     struct net_pkt *pkt,
-			     u32_t *cache_value)
-{
-	struct net_udp_hdr hdr, *udp_hdr;
-
-	udp_hdr = net_udp_get_hdr(pkt, &hdr);
-	if (!udp_hdr) {
-		return NET_DROP;
-	}
-
 #if defined(CONFIG_NET_IPV4)
 	if (family == AF_INET) {
-		return check_hash(proto, family,
-				  &NET_IPV4_HDR(pkt)->src,
-				  &NET_IPV4_HDR(pkt)->dst,
-				  udp_hdr->src_port,
-				  udp_hdr->dst_port,
-				  cache_value);
-	}
-#endif
-
-#if defined(CONFIG_NET_IPV6)
-	if (family == AF_INET6) {
-		return check_hash(proto, family,
-				  &NET_IPV6_HDR(pkt)->src,
-				  &NET_IPV6_HDR(pkt)->dst,
-				  udp_hdr->src_port,
-				  udp_hdr->dst_port,
-				  cache_value);
+		return UNALIGNED_GET(&((const struct in_addr *)addr)->s_addr);
 	}
 #endif
 
-	return -1;
+	return 0;
 }
 
-static inline void cache_add_neg(u32_t cache_value)
+/* The list a connection belongs in */
+static sys_slist_t *conn_list(struct net_conn *conn)
 {
-	int i;
+	u16_t remote_port = net_sin(&conn->remote_addr)->sin_port;
+	u16_t local_port = net_sin(&conn->local_addr)->sin_port;
+	const void *remote = NULL;
 
-	for (i = 0; i < CONFIG_NET_MAX_CONN && cache_value > 0; i++) {
-		if (conn_cache_neg[i].value) {
-			continue;
+	if ((conn->rank & CONN_RANK_CONNECTED) == CONN_RANK_CONNECTED) {
+#if defined(CONFIG_NET_IPV6)
+		if (conn->remote_addr.sa_family == AF_INET6) {
+			remote = &net_sin6(&conn->remote_addr)->sin6_addr;
 		}
-
-		NET_DBG("Add to neg cache value 0x%x", cache_value);
-
-		conn_cache_neg[i].value = cache_value;
-		break;
-	}
-}
-
-static inline bool cache_check_neg(u32_t cache_value)
-{
-	int i;
-
-	for (i = 0; i < CONFIG_NET_MAX_CONN && cache_value > 0; i++) {
-		if (conn_cache_neg[i].value == cache_value) {
-			NET_DBG("Cache neg [%d] value 0x%x found",
-				i, cache_value);
-			return true;
+#endif
+#if defined(CONFIG_NET_IPV4)
+		if (conn->remote_addr.sa_family == AF_INET) {
+			remote = &net_sin(&conn->remote_addr)->sin_addr;
 		}
+#endif
+		return &conn_connected[conn_hash(conn->proto,
+				addr_hash(conn->remote_addr.sa_family, remote),
+				remote_port, local_port)];
 	}
 
-	return false;
-}
-
-static void cache_clear(void)
-{
-	int i;
-
-	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
-		conn_cache[i].idx = -1;
-		conn_cache_neg[i].value = 0;
-	}
-}
-
-static inline enum net_verdict cache_check(enum net_ip_protocol proto,
-					   struct net_pkt *pkt,
-					   u32_t *cache_value,
-					   s32_t *pos)
-{
-	*pos = get_conn(proto, net_pkt_family(pkt), pkt, cache_value);
-	if (*pos >= 0) {
-		if (conn_cache[*pos].idx >= 0) {
-			/* Connection is in the cache */
-			struct net_conn *conn;
-			struct net_udp_hdr hdr, *udp_hdr;
-
-			udp_hdr = net_udp_get_hdr(pkt, &hdr);
-			if (!udp_hdr) {
-				return NET_CONTINUE;
-			}
-
-			conn = &conns[conn_cache[*pos].idx];
-
-			NET_DBG("Cache %s listener for pkt %p src port %u "
-				"dst port %u family %d cache[%d] 0x%x",
-				net_proto2str(proto), pkt,
-				ntohs(udp_hdr->src_port),
-				ntohs(udp_hdr->dst_port),
-				net_pkt_family(pkt), *pos,
-				conn_cache[*pos].value);
-
-			return conn->cb(conn, pkt, conn->user_data);
-		}
-	} else if (*cache_value > 0) {
-		if (cache_check_neg(*cache_value)) {
-			NET_DBG("Drop by cache");
-			return NET_DROP;
-		}
+	if (conn->rank & NET_RANK_LOCAL_PORT) {
+		return &conn_bound[conn_hash(conn->proto, 0, 0, local_port)];
 	}
 
-	return NET_CONTINUE;
-}
-
-static inline void cache_remove(struct net_conn *conn)
-{
-	int i;
-
-	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
-		if (conn_cache[i].idx < 0 ||
-		    conn_cache[i].idx >= CONFIG_NET_MAX_CONN) {
-			continue;
-		}
-
-		if (&conns[conn_cache[i].idx] == conn) {
-			conn_cache[i].idx = -1;
-			break;
-		}
-	}
+	return &conn_unbound;
 }
-#else
-#define cache_clear(...)
-#define cache_add_neg(...)
-#define cache_check(...) NET_CONTINUE
-#define cache_remove(...)
-#endif /* CONFIG_NET_CONN_CACHE */
 
 int net_conn_unregister(struct net_conn_handle *handle)
 {
@@ -352,17 +144,22 @@ int net_conn_unregister(struct net_conn_handle *handle)
 		return -EINVAL;
 	}
 
+	k_mutex_lock(&conn_lock, K_FOREVER);
+
 	if (!(conn->flags & NET_CONN_IN_USE)) {
+		k_mutex_unlock(&conn_lock);
 		return -ENOENT;
 	}
 
-	cache_remove(conn);
+	sys_slist_find_and_remove(conn_list(conn), &conn->node);
 
 	NET_DBG("[%zu] connection handler %p removed",
 		conn - conns, conn);
 
 	(void)memset(conn, 0, sizeof(*conn));
 
+	k_mutex_unlock(&conn_lock);
+
 	return 0;
 }
 
@@ -375,7 +172,10 @@ int net_conn_change_callback(struct net_conn_handle *handle,
 		return -EINVAL;
 	}
 
+	k_mutex_lock(&conn_lock, K_FOREVER);
+
 	if (!(conn->flags & NET_CONN_IN_USE)) {
+		k_mutex_unlock(&conn_lock);
 		return -ENOENT;
 	}
 
@@ -385,6 +185,8 @@ int net_conn_change_callback(struct net_conn_handle *handle,
 	conn->cb = cb;
 	conn->user_data = user_data;
 
+	k_mutex_unlock(&conn_lock);
+
 	return 0;
 }
 
@@ -549,14 +351,14 @@ static int find_conn_handler(enum net_ip_protocol proto,
 	return -ENOENT;
 }
 
-int net_conn_register(enum net_ip_protocol proto,
-		      const struct sockaddr *remote_addr,
-		      const struct sockaddr *local_addr,
-		      u16_t remote_port,
-		      u16_t local_port,
-		      net_conn_cb_t cb,
-		      void *user_data,
-		      struct net_conn_handle **handle)
+static int conn_register(enum net_ip_protocol proto,
+			 const struct sockaddr *remote_addr,
+			 const struct sockaddr *local_addr,
+			 u16_t remote_port,
+			 u16_t local_port,
+			 net_conn_cb_t cb,
+			 void *user_data,
+			 struct net_conn_handle **handle)
 {
 	int i;
 	u8_t rank = 0;
@@ -672,8 +474,7 @@ int net_conn_register(enum net_ip_protocol proto,
 		conns[i].rank = rank;
 		conns[i].proto = proto;
 
-		/* Cache needs to be cleared if new entries are added. */
-		cache_clear();
+		sys_slist_append(conn_list(&conns[i]), &conns[i].node);
 
 		if (NET_LOG_LEVEL >= LOG_LEVEL_DBG) {
 			char dst[NET_IPV6_ADDR_LEN];
@@ -703,6 +504,25 @@ int net_conn_register(enum net_ip_protocol proto,
 	return -ENOENT;
 }
 
+int net_conn_register(enum net_ip_protocol proto,
+		      const struct sockaddr *remote_addr,
+		      const struct sockaddr *local_addr,
+		      u16_t remote_port,
+		      u16_t local_port,
+		      net_conn_cb_t cb,
+		      void *user_data,
+		      struct net_conn_handle **handle)
+{
+	int ret;
+
+	k_mutex_lock(&conn_lock, K_FOREVER);
+	ret = conn_register(proto, remote_addr, local_addr, remote_port,
+			    local_port, cb, user_data, handle);
+	k_mutex_unlock(&conn_lock);
+
+	return ret;
+}
+
 static bool check_addr(struct net_pkt *pkt,
 		       struct sockaddr *addr,
 		       bool is_remote)
@@ -798,25 +618,99 @@ static bool is_invalid_packet(struct net_pkt *pkt,
 	return my_src_addr && (src_port == dst_port);
 }
 
-enum net_verdict net_conn_input(enum net_ip_protocol proto, struct net_pkt *pkt)
+/* Whether the stack has to verify the checksum, neither the interface for
+ * all of its packets nor the driver for this one having done it
+ */
+static inline bool need_rx_chksum(struct net_pkt *pkt)
 {
-	int i, best_match = -1;
-	s16_t best_rank = -1;
-	u16_t src_port, dst_port;
-	u16_t chksum;
-	struct net_if *pkt_iface = net_pkt_iface(pkt);
+	return net_if_need_calc_rx_checksum(net_pkt_iface(pkt)) &&
+		!net_pkt_chksum_ok(pkt);
+}
+
+static bool conn_match(struct net_conn *conn, enum net_ip_protocol proto,
+		       struct net_pkt *pkt, u16_t src_port, u16_t dst_port)
+{
+	if (conn->proto != proto) {
+		return false;
+	}
+
+	if (net_sin(&conn->remote_addr)->sin_port) {
+		if (net_sin(&conn->remote_addr)->sin_port != src_port) {
+			return false;
+		}
+	}
+
+	if (net_sin(&conn->local_addr)->sin_port) {
+		if (net_sin(&conn->local_addr)->sin_port != dst_port) {
+			return false;
+		}
+	}
+
+	if (conn->flags & NET_CONN_REMOTE_ADDR_SET) {
+		if (!check_addr(pkt, &conn->remote_addr, true)) {
+			return false;
+		}
+	}
+
+	if (conn->flags & NET_CONN_LOCAL_ADDR_SET) {
+		if (!check_addr(pkt, &conn->local_addr, false)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Update best with the most specific connection of list matching pkt */
+static void conn_find_best(sys_slist_t *list, enum net_ip_protocol proto,
+			   struct net_pkt *pkt, u16_t src_port,
+			   u16_t dst_port, struct net_conn **best)
+{
+	struct net_conn *conn;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(list, conn, node) {
+		/* If we have an existing best_match, and that one
+		 * specifies a remote port, then we've matched to a
+		 * LISTENING connection that should not override.
+		 */
+		if (*best && net_sin(&(*best)->remote_addr)->sin_port) {
+			return;
+		}
 
-#if defined(CONFIG_NET_CONN_CACHE)
-	enum net_verdict verdict;
-	u32_t cache_value = 0;
-	s32_t pos;
+		if (!conn_match(conn, proto, pkt, src_port, dst_port)) {
+			continue;
+		}
 
-	verdict = cache_check(proto, pkt, &cache_value, &pos);
-	if (verdict != NET_CONTINUE) {
-		return verdict;
+		if (!*best || (*best)->rank < conn->rank) {
+			*best = conn;
+		}
+	}
+}
+
+static u32_t pkt_remote_hash(struct net_pkt *pkt)
+{
+#if defined(CONFIG_NET_IPV6)
+	if (net_pkt_family(pkt) == AF_INET6) {
+		return addr_hash(AF_INET6, &NET_IPV6_HDR(pkt)->src);
+	}
+#endif
+
+#if defined(CONFIG_NET_IPV4)
+	if (net_pkt_family(pkt) == AF_INET) {
+		return addr_hash(AF_INET, &NET_IPV4_HDR(pkt)->src);
 	}
 #endif
 
+	return 0;
+}
+
+enum net_verdict net_conn_input(enum net_ip_protocol proto, struct net_pkt *pkt)
+{
+	struct net_conn *best_match = NULL;
+	u16_t src_port, dst_port;
+	u16_t chksum;
+	struct net_if *pkt_iface = net_pkt_iface(pkt);
+
 	/* This is only used for getting source and destination ports.
 	 * Because both TCP and UDP header have these in the same
 	 * location, we can check them both using the UDP struct.
@@ -876,57 +770,17 @@ enum net_verdict net_conn_input(enum net_ip_protocol proto, struct net_pkt *pkt)
 			net_pkt_family(pkt), ntohs(chksum), data_len);
 	}
 
-	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
-		if (!(conns[i].flags & NET_CONN_IN_USE)) {
-			continue;
-		}
-
-		if (conns[i].proto != proto) {
-			continue;
-		}
-
-		if (net_sin(&conns[i].remote_addr)->sin_port) {
-			if (net_sin(&conns[i].remote_addr)->sin_port !=
-			    src_port) {
-				continue;
-			}
-		}
-
-		if (net_sin(&conns[i].local_addr)->sin_port) {
-			if (net_sin(&conns[i].local_addr)->sin_port !=
-			    dst_port) {
-				continue;
-			}
-		}
-
-		if (conns[i].flags & NET_CONN_REMOTE_ADDR_SET) {
-			if (!check_addr(pkt, &conns[i].remote_addr, true)) {
-				continue;
-			}
-		}
-
-		if (conns[i].flags & NET_CONN_LOCAL_ADDR_SET) {
-			if (!check_addr(pkt, &conns[i].local_addr, false)) {
-				continue;
-			}
-		}
-
-		/* If we have an existing best_match, and that one
-		 * specifies a remote port, then we've matched to a
-		 * LISTENING connection that should not override.
-		 */
-		if (best_match >= 0 &&
-		    net_sin(&conns[best_match].remote_addr)->sin_port) {
-			continue;
-		}
+	k_mutex_lock(&conn_lock, K_FOREVER);
 
-		if (best_rank < conns[i].rank) {
-			best_rank = conns[i].rank;
-			best_match = i;
-		}
-	}
+	conn_find_best(&conn_connected[conn_hash(proto, pkt_remote_hash(pkt),
+						 src_port, dst_port)],
+		       proto, pkt, src_port, dst_port, &best_match);
+	conn_find_best(&conn_bound[conn_hash(proto, 0, 0, dst_port)],
+		       proto, pkt, src_port, dst_port, &best_match);
+	conn_find_best(&conn_unbound, proto, pkt, src_port, dst_port,
+		       &best_match);
 
-	if (best_match >= 0) {
+	if (best_match) {
 
 		/* If packet has a listener configured, then check also the
 		 * protocol checksum if that checking is enabled.
@@ -934,7 +788,7 @@ enum net_verdict net_conn_input(enum net_ip_protocol proto, struct net_pkt *pkt)
 		 */
 		if (IS_ENABLED(CONFIG_NET_UDP_CHECKSUM) &&
 		    proto == IPPROTO_UDP &&
-		    net_if_need_calc_rx_checksum(net_pkt_iface(pkt))) {
+		    need_rx_chksum(pkt)) {
 			u16_t chksum_calc;
 
 			net_udp_set_chksum(pkt, pkt->frags);
@@ -945,12 +799,13 @@ enum net_verdict net_conn_input(enum net_ip_protocol proto, struct net_pkt *pkt)
 				NET_DBG("UDP checksum mismatch "
 					"expected 0x%04x got 0x%04x, dropping packet.",
 					ntohs(chksum_calc), ntohs(chksum));
+				k_mutex_unlock(&conn_lock);
 				goto drop;
 			}
 
 		} else if (IS_ENABLED(CONFIG_NET_TCP_CHECKSUM) &&
 			   proto == IPPROTO_TCP &&
-			   net_if_need_calc_rx_checksum(net_pkt_iface(pkt))) {
+			   need_rx_chksum(pkt)) {
 			u16_t chksum_calc;
 
 			net_tcp_set_chksum(pkt, pkt->frags);
@@ -962,42 +817,33 @@ enum net_verdict net_conn_input(enum net_ip_protocol proto, struct net_pkt *pkt)
 				NET_DBG("TCP checksum mismatch "
 					"expected 0x%04x got 0x%04x, dropping packet.",
 					ntohs(chksum_calc), ntohs(chksum));
+				k_mutex_unlock(&conn_lock);
 				goto drop;
 			}
 		}
 
-#if defined(CONFIG_NET_CONN_CACHE)
-		NET_DBG("[%d] match found cb %p ud %p rank 0x%02x cache 0x%x",
-			best_match,
-			conns[best_match].cb,
-			conns[best_match].user_data,
-			conns[best_match].rank,
-			pos < 0 ? 0 : conn_cache[pos].value);
+		NET_DBG("[%zu] match found cb %p ud %p rank 0x%02x",
+			best_match - conns,
+			best_match->cb,
+			best_match->user_data,
+			best_match->rank);
 
-		if (pos >= 0) {
-			conn_cache[pos].idx = best_match;
-		}
-#else
-		NET_DBG("[%d] match found cb %p ud %p rank 0x%02x",
-			best_match,
-			conns[best_match].cb,
-			conns[best_match].user_data,
-			conns[best_match].rank);
-#endif /* CONFIG_NET_CONN_CACHE */
-
-		if (conns[best_match].cb(&conns[best_match], pkt,
-			     conns[best_match].user_data) == NET_DROP) {
+		if (best_match->cb(best_match, pkt,
+				   best_match->user_data) == NET_DROP) {
+			k_mutex_unlock(&conn_lock);
 			goto drop;
 		}
 
+		k_mutex_unlock(&conn_lock);
+
 		net_stats_update_per_proto_recv(pkt_iface, proto);
 
 		return NET_OK;
 	}
 
-	NET_DBG("No match found.");
+	k_mutex_unlock(&conn_lock);
 
-	cache_add_neg(cache_value);
+	NET_DBG("No match found.");
 
 #if defined(CONFIG_NET_IPV6)
 	/* If the destination address is multicast address,
@@ -1032,6 +878,8 @@ void net_conn_foreach(net_conn_foreach_cb_t cb, void *user_data)
 {
 	int i;
 
+	k_mutex_lock(&conn_lock, K_FOREVER);
+
 	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
 		if (!(conns[i].flags & NET_CONN_IN_USE)) {
 			continue;
@@ -1039,17 +887,18 @@ void net_conn_foreach(net_conn_foreach_cb_t cb, void *user_data)
 
 		cb(&conns[i], user_data);
 	}
+
+	k_mutex_unlock(&conn_lock);
 }
 
 void net_conn_init(void)
 {
-#if defined(CONFIG_NET_CONN_CACHE)
-	do {
-		int i;
+	int i;
 
-		for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
-			conn_cache[i].idx = -1;
-		}
-	} while (0);
-#endif /* CONFIG_NET_CONN_CACHE */
+	for (i = 0; i < CONFIG_NET_CONN_HASH_SIZE; i++) {
+		sys_slist_init(&conn_connected[i]);
+		sys_slist_init(&conn_bound[i]);
+	}
+
+	sys_slist_init(&conn_unbound);
 }
@@ -1159,6 +1159,8 @@ int net_dhcpv4_init(void)
 	}
 
 	k_delayed_work_init(&timeout_work, dhcpv4_timeout);
+	/* Renewal and retransmission times are in whole seconds */
+	k_delayed_work_slack_set(&timeout_work, MSEC_PER_SEC / 10);
 
 	return 0;
 }
@@ -2753,5 +2753,9 @@ void net_ipv6_nbr_init(void)
 	net_icmpv6_register_handler(&ra_input_handler);
 	k_delayed_work_init(&ipv6_nd_reachable_timer,
 			    ipv6_nd_reachable_timeout);
+	/* Reachable time is randomized by RFC 4861 anyway, expiring
+	 * a little late to share a wakeup is harmless.
+	 */
+	k_delayed_work_slack_set(&ipv6_nd_reachable_timer, MSEC_PER_SEC / 10);
 #endif
 }
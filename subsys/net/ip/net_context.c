@@ -1331,6 +1331,51 @@ static int get_context_priority(struct net_context *context,
 #endif
 }
 
+static int set_context_tcp_congestion(struct net_context *context,
+				      const void *value, size_t len)
+{
+	char name[16];
+
+	if (net_context_get_ip_proto(context) != IPPROTO_TCP) {
+		return -EOPNOTSUPP;
+	}
+
+	if (len == 0 || len >= sizeof(name)) {
+		return -EINVAL;
+	}
+
+	memcpy(name, value, len);
+	name[len] = '\0';
+
+	return net_tcp_set_cc(context, name);
+}
+
+static int get_context_tcp_congestion(struct net_context *context,
+				      void *value, size_t *len)
+{
+	const char *name;
+	size_t name_len;
+
+	if (net_context_get_ip_proto(context) != IPPROTO_TCP) {
+		return -EOPNOTSUPP;
+	}
+
+	name = net_tcp_get_cc(context);
+	if (!name) {
+		return -EPROTOTYPE;
+	}
+
+	name_len = strlen(name) + 1;
+	if (!len || *len < name_len) {
+		return -EINVAL;
+	}
+
+	memcpy(value, name, name_len);
+	*len = name_len;
+
+	return 0;
+}
+
 int net_context_set_option(struct net_context *context,
 			   enum net_context_option option,
 			   const void *value, size_t len)
@@ -1347,6 +1392,9 @@ int net_context_set_option(struct net_context *context,
 	case NET_OPT_PRIORITY:
 		ret = set_context_priority(context, value, len);
 		break;
+	case NET_OPT_TCP_CONGESTION:
+		ret = set_context_tcp_congestion(context, value, len);
+		break;
 	}
 
 	return ret;
@@ -1368,6 +1416,9 @@ int net_context_get_option(struct net_context *context,
 	case NET_OPT_PRIORITY:
 		ret = get_context_priority(context, value, len);
 		break;
+	case NET_OPT_TCP_CONGESTION:
+		ret = get_context_tcp_congestion(context, value, len);
+		break;
 	}
 
 	return ret;
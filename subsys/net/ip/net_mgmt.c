@@ -32,7 +32,10 @@ struct mgmt_event_wait {
 	struct net_if *iface;
 };
 
-static K_SEM_DEFINE(network_event, 0, UINT_MAX);
+/* posted when events are queued, the thread then handles all of them */
+#define MGMT_EVENTS_QUEUED BIT(0)
+
+static K_EVENT_DEFINE(mgmt_events);
 static K_SEM_DEFINE(net_mgmt_lock, 1, 1);
 
 NET_STACK_DEFINE(MGMT, mgmt_stack, CONFIG_NET_MGMT_EVENT_STACK_SIZE,
@@ -225,33 +228,32 @@ static void mgmt_thread(void)
 	struct mgmt_event_entry *mgmt_event;
 
 	while (1) {
-		k_sem_take(&network_event, K_FOREVER);
-		k_sem_take(&net_mgmt_lock, K_FOREVER);
+		k_event_wait(&mgmt_events, MGMT_EVENTS_QUEUED, true,
+			     K_FOREVER);
 
 		NET_DBG("Handling events, forwarding it relevantly");
 
-		mgmt_event = mgmt_pop_event();
-		if (!mgmt_event) {
-			/* System is over-loaded?
-			 * At this point we have most probably notified
-			 * more events than we could handle
-			 */
-			NET_DBG("Some event got probably lost (%u)",
-				k_sem_count_get(&network_event));
-
-			k_sem_init(&network_event, 0, UINT_MAX);
-			k_sem_give(&net_mgmt_lock);
-
-			continue;
-		}
+		/* Events queued from now on post again, so handling all
+		 * the queued ones cannot miss any. An event overwritten
+		 * in a full queue is simply not handled.
+		 */
+		while (1) {
+			k_sem_take(&net_mgmt_lock, K_FOREVER);
+
+			mgmt_event = mgmt_pop_event();
+			if (!mgmt_event) {
+				k_sem_give(&net_mgmt_lock);
+				break;
+			}
 
-		mgmt_run_callbacks(mgmt_event);
+			mgmt_run_callbacks(mgmt_event);
 
-		mgmt_clean_event(mgmt_event);
+			mgmt_clean_event(mgmt_event);
 
-		k_sem_give(&net_mgmt_lock);
+			k_sem_give(&net_mgmt_lock);
 
-		k_yield();
+			k_yield();
+		}
 	}
 }
 
@@ -339,7 +341,7 @@ void net_mgmt_event_notify_with_info(u32_t mgmt_event, struct net_if *iface,
 			NET_MGMT_GET_COMMAND(mgmt_event));
 
 		mgmt_push_event(mgmt_event, iface, info, length);
-		k_sem_give(&network_event);
+		k_event_post(&mgmt_events, MGMT_EVENTS_QUEUED);
 	}
 }
 
@@ -173,6 +173,29 @@ static inline u16_t net_calc_chksum_tcp(struct net_pkt *pkt)
 	return net_calc_chksum(pkt, IPPROTO_TCP);
 }
 
+/* Update a checksum, in network byte order, for a 16 bit aligned field
+ * of the data it covers changing from old to new, in host byte order.
+ * This is eqn. 3 of RFC 1624, and saves summing all the data again when
+ * rewriting a header.
+ */
+static inline u16_t net_chksum_update_16(u16_t chksum, u16_t old, u16_t new)
+{
+	u32_t sum;
+
+	sum = (u16_t)~ntohs(chksum) + (u16_t)~old + new;
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+
+	return htons((u16_t)~sum);
+}
+
+static inline u16_t net_chksum_update_32(u16_t chksum, u32_t old, u32_t new)
+{
+	chksum = net_chksum_update_16(chksum, old >> 16, new >> 16);
+
+	return net_chksum_update_16(chksum, old & 0xffff, new & 0xffff);
+}
+
 static inline char *net_sprint_ll_addr(const u8_t *ll, u8_t ll_len)
 {
 	static char buf[sizeof("xx:xx:xx:xx:xx:xx:xx:xx")];
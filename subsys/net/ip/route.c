@@ -16,6 +16,7 @@
 #include <limits.h>
 #include <zephyr/types.h>
 #include <misc/slist.h>
+#include <misc/dlist.h>
 
 #include <net/net_pkt.h>
 #include <net/net_core.h>
@@ -37,7 +38,43 @@
 /* We keep track of the routes in a separate list so that we can remove
  * the oldest routes (at tail) if needed.
  */
-static sys_slist_t routes;
+static sys_dlist_t routes = SYS_DLIST_STATIC_INIT(&routes);
+
+/* Routes are looked up in a path compressed binary trie per interface.
+ * Each node stands for a prefix and holds the route to it, if there is
+ * one, or else is there only to branch. A node that only branches has
+ * two children, so there are always fewer of those than routes.
+ */
+struct route_node {
+	struct route_node *child[2];
+	struct net_route_entry *route;
+	struct in6_addr prefix;
+	u8_t len;
+};
+
+struct route_trie {
+	struct net_if *iface;
+	struct route_node *root;
+};
+
+static struct route_node route_nodes[2 * CONFIG_NET_MAX_ROUTES];
+static struct route_node *route_nodes_free;
+static struct route_trie route_tries[CONFIG_NET_IF_MAX_IPV6_COUNT];
+
+#if defined(CONFIG_NET_ROUTE_CACHE)
+BUILD_ASSERT_MSG((CONFIG_NET_ROUTE_CACHE_SIZE &
+		  (CONFIG_NET_ROUTE_CACHE_SIZE - 1)) == 0,
+		 "NET_ROUTE_CACHE_SIZE must be a power of two");
+
+/* Last route found for a destination, in a slot chosen by its hash */
+struct route_cache_entry {
+	struct net_if *iface;
+	struct net_route_entry *route;
+	struct in6_addr dst;
+};
+
+static struct route_cache_entry route_cache[CONFIG_NET_ROUTE_CACHE_SIZE];
+#endif
 
 static void net_route_nexthop_remove(struct net_nbr *nbr)
 {
@@ -232,6 +269,292 @@ static int nbr_nexthop_put(struct net_nbr *nbr)
 	return 0;
 }
 
+static inline int addr_bit(const struct in6_addr *addr, u8_t bit)
+{
+	return (addr->s6_addr[bit / 8] >> (7 - bit % 8)) & 1;
+}
+
+/* Number of leading bits a and b have in common, up to max. The first
+ * from bits are already known to be the same.
+ */
+static u8_t common_prefix_len(const struct in6_addr *a,
+			      const struct in6_addr *b,
+			      u8_t from, u8_t max)
+{
+	u8_t len;
+	int i;
+
+	for (i = from / 8, len = i * 8; len < max; i++, len += 8) {
+		u8_t diff = a->s6_addr[i] ^ b->s6_addr[i];
+
+		if (diff) {
+			len += 8 - find_msb_set(diff);
+			break;
+		}
+	}
+
+	return min(len, max);
+}
+
+static struct route_node *route_node_alloc(const struct in6_addr *prefix,
+					   u8_t len,
+					   struct net_route_entry *route)
+{
+	struct route_node *node = route_nodes_free;
+
+	if (!node) {
+		return NULL;
+	}
+
+	route_nodes_free = node->child[0];
+
+	node->child[0] = NULL;
+	node->child[1] = NULL;
+	node->route = route;
+	node->len = len;
+	net_ipaddr_copy(&node->prefix, prefix);
+
+	return node;
+}
+
+static void route_node_free(struct route_node *node)
+{
+	node->child[0] = route_nodes_free;
+	route_nodes_free = node;
+}
+
+static struct route_trie *route_trie_get(struct net_if *iface, bool create)
+{
+	struct route_trie *unused = NULL;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(route_tries); i++) {
+		if (route_tries[i].iface == iface) {
+			return &route_tries[i];
+		}
+
+		if (!route_tries[i].iface && !unused) {
+			unused = &route_tries[i];
+		}
+	}
+
+	if (create && unused) {
+		unused->iface = iface;
+		return unused;
+	}
+
+	return NULL;
+}
+
+static int route_trie_add(struct route_trie *trie,
+			  struct net_route_entry *route)
+{
+	struct route_node **link = &trie->root;
+	struct route_node *node, *leaf, *branch;
+	u8_t len = route->prefix_len;
+	u8_t common = 0;
+
+	while ((node = *link) != NULL) {
+		common = common_prefix_len(&node->prefix, &route->addr,
+					   common, min(node->len, len));
+		if (common < node->len) {
+			break;
+		}
+
+		if (node->len == len) {
+			if (node->route) {
+				return -EALREADY;
+			}
+
+			node->route = route;
+			return 0;
+		}
+
+		link = &node->child[addr_bit(&route->addr, node->len)];
+	}
+
+	leaf = route_node_alloc(&route->addr, len, route);
+	if (!leaf) {
+		return -ENOMEM;
+	}
+
+	if (!node) {
+		*link = leaf;
+		return 0;
+	}
+
+	/* The new prefix covers the node, or the two part ways */
+	if (common == len) {
+		leaf->child[addr_bit(&node->prefix, len)] = node;
+		*link = leaf;
+		return 0;
+	}
+
+	branch = route_node_alloc(&route->addr, common, NULL);
+	if (!branch) {
+		route_node_free(leaf);
+		return -ENOMEM;
+	}
+
+	branch->child[addr_bit(&node->prefix, common)] = node;
+	branch->child[addr_bit(&route->addr, common)] = leaf;
+	*link = branch;
+
+	return 0;
+}
+
+static void route_trie_del(struct route_trie *trie,
+			   struct net_route_entry *route)
+{
+	struct route_node **link = &trie->root, **parent_link = NULL;
+	struct route_node *node, *parent = NULL;
+
+	while ((node = *link) != NULL && node->route != route) {
+		if (node->len >= route->prefix_len) {
+			return;
+		}
+
+		parent_link = link;
+		parent = node;
+		link = &node->child[addr_bit(&route->addr, node->len)];
+	}
+
+	if (!node) {
+		return;
+	}
+
+	node->route = NULL;
+
+	if (node->child[0] && node->child[1]) {
+		/* Still needed to branch */
+		return;
+	}
+
+	*link = node->child[0] ? node->child[0] : node->child[1];
+	route_node_free(node);
+
+	/* The parent may be left with a single child and nothing else */
+	if (parent && !parent->route &&
+	    !(parent->child[0] && parent->child[1])) {
+		*parent_link = parent->child[0] ? parent->child[0] :
+			parent->child[1];
+		route_node_free(parent);
+	}
+
+	if (!trie->root) {
+		trie->iface = NULL;
+	}
+}
+
+/* Route for exactly the given prefix */
+static struct net_route_entry *route_trie_find(struct route_trie *trie,
+					       struct in6_addr *addr,
+					       u8_t len)
+{
+	struct route_node *node = trie->root;
+	u8_t common = 0;
+
+	while (node && node->len <= len) {
+		common = common_prefix_len(&node->prefix, addr, common,
+					   node->len);
+		if (common < node->len) {
+			break;
+		}
+
+		if (node->len == len) {
+			return node->route;
+		}
+
+		node = node->child[addr_bit(addr, node->len)];
+	}
+
+	return NULL;
+}
+
+/* Route with the longest prefix matching dst */
+static struct net_route_entry *route_trie_lookup(struct route_trie *trie,
+						 struct in6_addr *dst)
+{
+	struct route_node *node = trie->root;
+	struct net_route_entry *found = NULL;
+	u8_t common = 0;
+
+	while (node) {
+		common = common_prefix_len(&node->prefix, dst, common,
+					   node->len);
+		if (common < node->len) {
+			break;
+		}
+
+		if (node->route) {
+			found = node->route;
+		}
+
+		if (node->len == 128) {
+			break;
+		}
+
+		node = node->child[addr_bit(dst, node->len)];
+	}
+
+	return found;
+}
+
+#if defined(CONFIG_NET_ROUTE_CACHE)
+static struct route_cache_entry *route_cache_slot(struct in6_addr *dst)
+{
+	u32_t hash = dst->s6_addr32[0] ^ dst->s6_addr32[1] ^
+		dst->s6_addr32[2] ^ dst->s6_addr32[3];
+
+	return &route_cache[((hash * 2654435761U) >> 16) &
+			    (CONFIG_NET_ROUTE_CACHE_SIZE - 1)];
+}
+
+static struct net_route_entry *route_cache_get(struct net_if *iface,
+					       struct in6_addr *dst)
+{
+	struct route_cache_entry *entry = route_cache_slot(dst);
+
+	if (entry->route && entry->iface == iface &&
+	    net_ipv6_addr_cmp(&entry->dst, dst)) {
+		return entry->route;
+	}
+
+	return NULL;
+}
+
+static void route_cache_set(struct net_if *iface, struct in6_addr *dst,
+			    struct net_route_entry *route)
+{
+	struct route_cache_entry *entry = route_cache_slot(dst);
+
+	entry->iface = iface;
+	entry->route = route;
+	net_ipaddr_copy(&entry->dst, dst);
+}
+
+static void route_cache_flush(void)
+{
+	memset(route_cache, 0, sizeof(route_cache));
+}
+#else
+static inline struct net_route_entry *route_cache_get(struct net_if *iface,
+						      struct in6_addr *dst)
+{
+	return NULL;
+}
+
+static inline void route_cache_set(struct net_if *iface,
+				   struct in6_addr *dst,
+				   struct net_route_entry *route)
+{
+}
+
+static inline void route_cache_flush(void)
+{
+}
+#endif /* CONFIG_NET_ROUTE_CACHE */
+
 
 #define net_route_info(str, route, dst)					\
 	if (NET_LOG_LEVEL >= LOG_LEVEL_DBG) {				\
@@ -248,40 +571,38 @@ static int nbr_nexthop_put(struct net_nbr *nbr)
 /* Route was accessed, so place it in front of the routes list */
 static inline void update_route_access(struct net_route_entry *route)
 {
-	sys_slist_find_and_remove(&routes, &route->node);
-	sys_slist_prepend(&routes, &route->node);
+	sys_dlist_remove(&route->node);
+	sys_dlist_prepend(&routes, &route->node);
 }
 
 struct net_route_entry *net_route_lookup(struct net_if *iface,
 					 struct in6_addr *dst)
 {
-	struct net_route_entry *route, *found = NULL;
-	u8_t longest_match = 0;
+	struct net_route_entry *route, *found;
 	int i;
 
-	for (i = 0; i < CONFIG_NET_MAX_ROUTES && longest_match < 128; i++) {
-		struct net_nbr *nbr = get_nbr(i);
-
-		if (!nbr->ref) {
-			continue;
-		}
+	found = route_cache_get(iface, dst);
+	if (found) {
+		update_route_access(found);
+		return found;
+	}
 
-		if (iface && nbr->iface != iface) {
+	for (i = 0; i < ARRAY_SIZE(route_tries); i++) {
+		if (!route_tries[i].iface ||
+		    (iface && route_tries[i].iface != iface)) {
 			continue;
 		}
 
-		route = net_route_data(nbr);
-
-		if (route->prefix_len >= longest_match &&
-		    net_ipv6_is_prefix((u8_t *)dst,
-				       (u8_t *)&route->addr,
-				       route->prefix_len)) {
+		route = route_trie_lookup(&route_tries[i], dst);
+		if (route &&
+		    (!found || route->prefix_len > found->prefix_len)) {
 			found = route;
-			longest_match = route->prefix_len;
 		}
 	}
 
 	if (found) {
+		route_cache_set(iface, dst, found);
+
 		net_route_info("Found", found, dst);
 
 		update_route_access(found);
@@ -290,6 +611,25 @@ struct net_route_entry *net_route_lookup(struct net_if *iface,
 	return found;
 }
 
+static void route_event_notify(u32_t mgmt_event,
+			       struct net_route_entry *route,
+			       struct in6_addr *nexthop)
+{
+#if defined(CONFIG_NET_MGMT_EVENT_INFO)
+	struct net_event_ipv6_route info;
+
+	net_ipaddr_copy(&info.addr, &route->addr);
+	net_ipaddr_copy(&info.nexthop, nexthop);
+	info.prefix_len = route->prefix_len;
+
+	net_mgmt_event_notify_with_info(mgmt_event, route->iface,
+					(void *)&info,
+					sizeof(struct net_event_ipv6_route));
+#else
+	net_mgmt_event_notify(mgmt_event, route->iface);
+#endif
+}
+
 struct net_route_entry *net_route_add(struct net_if *iface,
 				      struct in6_addr *addr,
 				      u8_t prefix_len,
@@ -299,9 +639,7 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	struct net_nbr *nbr, *nbr_nexthop, *tmp;
 	struct net_route_nexthop *nexthop_route;
 	struct net_route_entry *route;
-#if defined(CONFIG_NET_MGMT_EVENT_INFO)
-       struct net_event_ipv6_route info;
-#endif
+	struct route_trie *trie;
 
 	NET_ASSERT(addr);
 	NET_ASSERT(iface);
@@ -328,7 +666,13 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 		log_strdup(net_sprint_ll_addr(nexthop_lladdr->addr,
 					      nexthop_lladdr->len)));
 
-	route = net_route_lookup(iface, addr);
+	trie = route_trie_get(iface, true);
+	if (!trie) {
+		NET_ERR("No routing table available for iface %p", iface);
+		return NULL;
+	}
+
+	route = route_trie_find(trie, addr, prefix_len);
 	if (route) {
 		/* Update nexthop if not the same */
 		struct in6_addr *nexthop_addr;
@@ -342,15 +686,35 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 		NET_DBG("Old route to %s found",
 			log_strdup(net_sprint_ipv6_addr(nexthop_addr)));
 
-		net_route_del(route);
+		/* Switch it to the new nexthop in place, the old route
+		 * stays as it is if that can't be done.
+		 */
+		tmp = get_nexthop_route();
+		if (!tmp) {
+			NET_ERR("No nexthop route available!");
+			return NULL;
+		}
+
+		route_event_notify(NET_EVENT_IPV6_ROUTE_DEL, route,
+				   nexthop_addr);
+
+		SYS_SLIST_FOR_EACH_CONTAINER(&route->nexthop, nexthop_route,
+					     node) {
+			if (nexthop_route->nbr) {
+				nbr_nexthop_put(nexthop_route->nbr);
+			}
+		}
+
+		sys_dlist_remove(&route->node);
+		nexthop_route = net_nexthop_data(tmp);
+
+		goto set_nexthop;
 	}
 
 	nbr = nbr_new(iface, addr, prefix_len);
 	if (!nbr) {
 		/* Remove the oldest route and try again */
-		sys_snode_t *last = sys_slist_peek_tail(&routes);
-
-		sys_slist_find_and_remove(&routes, last);
+		sys_dnode_t *last = sys_dlist_peek_tail(&routes);
 
 		route = CONTAINER_OF(last,
 				     struct net_route_entry,
@@ -396,7 +760,19 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	route = net_route_data(nbr);
 	route->iface = iface;
 
-	sys_slist_prepend(&routes, &route->node);
+	/* Deleting a route above may have released the table */
+	trie = route_trie_get(iface, true);
+	if (!trie || route_trie_add(trie, route) < 0) {
+		NET_ERR("Cannot add route to routing table!");
+		net_nbr_unref(tmp);
+		nbr_free(nbr);
+		return NULL;
+	}
+
+set_nexthop:
+	route_cache_flush();
+
+	sys_dlist_prepend(&routes, &route->node);
 
 	tmp = nbr_nexthop_get(iface, nexthop);
 
@@ -409,17 +785,7 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 
 	net_route_info("Added", route, addr);
 
-#if defined(CONFIG_NET_MGMT_EVENT_INFO)
-	net_ipaddr_copy(&info.addr, addr);
-	net_ipaddr_copy(&info.nexthop, nexthop);
-	info.prefix_len = prefix_len;
-
-	net_mgmt_event_notify_with_info(NET_EVENT_IPV6_ROUTE_ADD,
-					iface, (void *) &info,
-					sizeof(struct net_event_ipv6_route));
-#else
-	net_mgmt_event_notify(NET_EVENT_IPV6_ROUTE_ADD, iface);
-#endif
+	route_event_notify(NET_EVENT_IPV6_ROUTE_ADD, route, nexthop);
 
 	return route;
 }
@@ -428,34 +794,29 @@ int net_route_del(struct net_route_entry *route)
 {
 	struct net_nbr *nbr;
 	struct net_route_nexthop *nexthop_route;
-#if defined(CONFIG_NET_MGMT_EVENT_INFO)
-       struct net_event_ipv6_route info;
-#endif
+	struct route_trie *trie;
 
 	if (!route) {
 		return -EINVAL;
 	}
 
-#if defined(CONFIG_NET_MGMT_EVENT_INFO)
-	net_ipaddr_copy(&info.addr, &route->addr);
-	info.prefix_len = route->prefix_len;
-	net_ipaddr_copy(&info.nexthop,
-			net_route_get_nexthop(route));
-
-	net_mgmt_event_notify_with_info(NET_EVENT_IPV6_ROUTE_DEL,
-					route->iface, (void *) &info,
-					sizeof(struct net_event_ipv6_route));
-#else
-	net_mgmt_event_notify(NET_EVENT_IPV6_ROUTE_DEL, route->iface);
-#endif
-
-	sys_slist_find_and_remove(&routes, &route->node);
+	route_event_notify(NET_EVENT_IPV6_ROUTE_DEL, route,
+			   net_route_get_nexthop(route));
 
 	nbr = net_route_get_nbr(route);
 	if (!nbr) {
 		return -ENOENT;
 	}
 
+	sys_dlist_remove(&route->node);
+
+	trie = route_trie_get(route->iface, false);
+	if (trie) {
+		route_trie_del(trie, route);
+	}
+
+	route_cache_flush();
+
 	net_route_info("Deleted", route, &route->addr);
 
 	SYS_SLIST_FOR_EACH_CONTAINER(&route->nexthop, nexthop_route, node) {
@@ -822,6 +1183,12 @@ int net_route_packet(struct net_pkt *pkt, struct in6_addr *nexthop)
 
 void net_route_init(void)
 {
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(route_nodes); i++) {
+		route_node_free(&route_nodes[i]);
+	}
+
 	NET_DBG("Allocated %d routing entries (%zu bytes)",
 		CONFIG_NET_MAX_ROUTES, sizeof(net_route_entries_pool));
 
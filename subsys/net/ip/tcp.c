@@ -38,6 +38,7 @@
 #define ALLOC_TIMEOUT K_MSEC(500)
 
 static int net_tcp_queue_pkt(struct net_context *context, struct net_pkt *pkt);
+static void tcp_send_queued(struct net_tcp *tcp);
 
 /*
  * Each TCP connection needs to be tracked by net_context, so
@@ -52,9 +53,27 @@ static struct tcp_backlog_entry {
 	u32_t send_ack;
 	struct k_delayed_work ack_timer;
 	struct sockaddr remote;
-	u16_t send_mss;
+	struct net_tcp_options opts;
 } tcp_backlog[CONFIG_NET_TCP_BACKLOG_SIZE];
 
+static const struct net_tcp_cc * const tcp_cc[] = {
+	&net_tcp_cc_newreno,
+#if defined(CONFIG_NET_TCP_CC_CUBIC)
+	&net_tcp_cc_cubic,
+#endif
+};
+
+#if defined(CONFIG_NET_TCP_CC_DEFAULT_CUBIC)
+#define TCP_CC_DEFAULT (&net_tcp_cc_cubic)
+#else
+#define TCP_CC_DEFAULT (&net_tcp_cc_newreno)
+#endif
+
+/* Our receive window never grows over 64 kB, so it needs no scaling.
+ * Offering the option still lets the peer scale its own window.
+ */
+#define RECV_WINDOW_SCALE 0
+
 #if defined(CONFIG_NET_TCP_ACK_TIMEOUT)
 #define ACK_TIMEOUT CONFIG_NET_TCP_ACK_TIMEOUT
 #else
@@ -161,8 +180,7 @@ static void net_tcp_trace(struct net_pkt *pkt, struct net_tcp *tcp)
 
 static inline u32_t retry_timeout(const struct net_tcp *tcp)
 {
-	return ((u32_t)1 << tcp->retry_timeout_shift) *
-				CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT;
+	return ((u32_t)1 << tcp->retry_timeout_shift) * tcp->rto;
 }
 
 #define is_6lo_technology(pkt)						\
@@ -205,13 +223,78 @@ static void abort_connection(struct net_tcp *tcp)
 	net_context_unref(ctx);
 }
 
+/* Sequence space taken by a segment, SYN and FIN count for one each */
+static u32_t tcp_seg_len(struct net_pkt *pkt, struct net_tcp_hdr *tcp_hdr)
+{
+	u32_t len = net_pkt_appdatalen(pkt);
+
+	if (tcp_hdr->flags & NET_TCP_SYN) {
+		len++;
+	}
+
+	if (tcp_hdr->flags & NET_TCP_FIN) {
+		len++;
+	}
+
+	return len;
+}
+
+static u32_t tcp_pkt_seq(struct net_pkt *pkt)
+{
+	struct net_tcp_hdr hdr, *tcp_hdr;
+
+	tcp_hdr = net_tcp_get_hdr(pkt, &hdr);
+	if (!tcp_hdr) {
+		return 0;
+	}
+
+	return sys_get_be32(tcp_hdr->seq);
+}
+
+/* Send again a segment that was transmitted before. */
+static void tcp_retransmit(struct net_tcp *tcp, struct net_pkt *pkt)
+{
+	if (net_pkt_queued(pkt)) {
+		NET_DBG("[%p] pkt %p still queued for sending", tcp, pkt);
+		return;
+	}
+
+	/* The reference the driver releases when done with the first
+	 * transmission is gone already, take a new one.
+	 */
+	do_ref_if_needed(tcp, pkt);
+	net_pkt_set_sent(pkt, false);
+
+	if (!is_6lo_technology(pkt)) {
+		net_pkt_set_queued(pkt, true);
+	}
+
+	/* Karn's algorithm, an ACK for it would not tell which copy it
+	 * is for.
+	 */
+	tcp->flags &= ~NET_TCP_RTT_TIMING;
+
+	if (net_tcp_send_pkt(pkt) < 0 && !is_6lo_technology(pkt)) {
+		NET_DBG("retry %u: [%p] pkt %p send failed",
+			tcp->retry_timeout_shift, tcp, pkt);
+		net_pkt_set_queued(pkt, false);
+		net_pkt_unref(pkt);
+	} else {
+		NET_DBG("retry %u: [%p] sent pkt %p",
+			tcp->retry_timeout_shift, tcp, pkt);
+		if (IS_ENABLED(CONFIG_NET_STATISTICS_TCP) &&
+		    !is_6lo_technology(pkt)) {
+			net_stats_update_tcp_seg_rexmit(net_pkt_iface(pkt));
+		}
+	}
+}
+
 static void tcp_retry_expired(struct k_work *work)
 {
 	struct net_tcp *tcp = CONTAINER_OF(work, struct net_tcp, retry_timer);
-	struct net_pkt *pkt;
 
-	/* Double the retry period for exponential backoff and resend
-	 * the first (only the first!) unack'd packet.
+	/* Double the retry period for exponential backoff and start
+	 * over from the first unack'd packet.
 	 */
 	if (!sys_slist_is_empty(&tcp->sent_list)) {
 		tcp->retry_timeout_shift++;
@@ -223,29 +306,32 @@ static void tcp_retry_expired(struct k_work *work)
 
 		k_delayed_work_submit(&tcp->retry_timer, retry_timeout(tcp));
 
-		pkt = CONTAINER_OF(sys_slist_peek_head(&tcp->sent_list),
-				   struct net_pkt, sent_list);
-
-		if (net_pkt_sent(pkt)) {
-			do_ref_if_needed(tcp, pkt);
-			net_pkt_set_sent(pkt, false);
+		/* RFC 5681 3.1: the window is lost, slow start again from
+		 * one segment. Lower ssthresh only the first time the
+		 * segment times out.
+		 */
+		if (tcp->retry_timeout_shift == 1) {
+			tcp->ssthresh = tcp->cc->ssthresh(tcp);
 		}
 
-		net_pkt_set_queued(pkt, true);
+		tcp->cwnd = tcp->send_mss;
+		tcp->dupacks = 0;
+		tcp->flags &= ~NET_TCP_IN_RECOVERY;
 
-		if (net_tcp_send_pkt(pkt) < 0 && !is_6lo_technology(pkt)) {
-			NET_DBG("retry %u: [%p] pkt %p send failed",
-				tcp->retry_timeout_shift, tcp, pkt);
-			net_pkt_unref(pkt);
-		} else {
-			NET_DBG("retry %u: [%p] sent pkt %p",
-				tcp->retry_timeout_shift, tcp, pkt);
-			if (IS_ENABLED(CONFIG_NET_STATISTICS_TCP) &&
-			    !is_6lo_technology(pkt)) {
-				net_stats_update_tcp_seg_rexmit(
-							net_pkt_iface(pkt));
-			}
-		}
+		/* The duplicate ACKs the segments resent below may cause
+		 * must not trigger fast retransmit (RFC 6582 4).
+		 */
+		tcp->recover = tcp->send_max;
+		tcp->send_nxt = tcp->send_una;
+
+#if defined(CONFIG_NET_TCP_SACK)
+		/* RFC 2018 8: the peer may have discarded what it reported
+		 * holding.
+		 */
+		(void)memset(tcp->sacked, 0, sizeof(tcp->sacked));
+#endif
+
+		tcp_send_queued(tcp);
 	} else if (CONFIG_NET_TCP_TIME_WAIT_DELAY != 0) {
 		if (tcp->fin_sent && tcp->fin_rcvd) {
 			NET_DBG("[%p] Closing connection (context %p)",
@@ -282,6 +368,12 @@ struct net_tcp *net_tcp_alloc(struct net_context *context)
 	tcp_context[i].recv_wnd = min(NET_TCP_MAX_WIN, NET_TCP_BUF_MAX_LEN);
 	tcp_context[i].send_mss = NET_TCP_DEFAULT_MSS;
 
+	tcp_context[i].send_una = tcp_context[i].send_seq;
+	tcp_context[i].send_nxt = tcp_context[i].send_seq;
+	tcp_context[i].send_max = tcp_context[i].send_seq;
+	tcp_context[i].rto = CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT;
+	tcp_context[i].cc = TCP_CC_DEFAULT;
+
 	tcp_context[i].accept_cb = NULL;
 
 	k_delayed_work_init(&tcp_context[i].retry_timer, tcp_retry_expired);
@@ -310,6 +402,34 @@ static void timewait_timer_cancel(struct net_tcp *tcp)
 	k_delayed_work_cancel(&tcp->timewait_timer);
 }
 
+/* Drop a segment taken off sent_list */
+static void tcp_sent_pkt_unref(struct net_tcp *tcp, struct net_pkt *pkt)
+{
+	/* Never sent, the reference for the driver is still held */
+	if (!is_6lo_technology(pkt) &&
+	    net_tcp_seq_cmp(tcp_pkt_seq(pkt), tcp->send_max) >= 0) {
+		net_pkt_unref(pkt);
+	}
+
+	net_pkt_unref(pkt);
+}
+
+#if defined(CONFIG_NET_TCP_SACK)
+static void tcp_ooo_flush(struct net_tcp *tcp)
+{
+	struct net_pkt *pkt;
+	struct net_pkt *tmp;
+
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&tcp->ooo_list, pkt, tmp,
+					  sent_list) {
+		sys_slist_remove(&tcp->ooo_list, NULL, &pkt->sent_list);
+		net_pkt_unref(pkt);
+	}
+
+	tcp->ooo_count = 0;
+}
+#endif
+
 int net_tcp_release(struct net_tcp *tcp)
 {
 	struct net_pkt *pkt;
@@ -323,9 +443,13 @@ int net_tcp_release(struct net_tcp *tcp)
 	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&tcp->sent_list, pkt, tmp,
 					  sent_list) {
 		sys_slist_remove(&tcp->sent_list, NULL, &pkt->sent_list);
-		net_pkt_unref(pkt);
+		tcp_sent_pkt_unref(tcp, pkt);
 	}
 
+#if defined(CONFIG_NET_TCP_SACK)
+	tcp_ooo_flush(tcp);
+#endif
+
 	retry_timer_cancel(tcp);
 	k_sem_reset(&tcp->connect_wait);
 
@@ -517,22 +641,88 @@ u32_t net_tcp_get_recv_wnd(const struct net_tcp *tcp)
 	return tcp->recv_wnd;
 }
 
-int net_tcp_prepare_segment(struct net_tcp *tcp, u8_t flags,
-			    void *options, size_t optlen,
-			    const struct sockaddr_ptr *local,
-			    const struct sockaddr *remote,
-			    struct net_pkt **send_pkt)
+/* Write the timestamps option, after two NOPs or the SACK permitted
+ * option which fill the same space.
+ */
+static u8_t tcp_put_timestamps(struct net_tcp *tcp, u8_t *buf,
+			       bool sack_perm)
 {
-	u32_t seq;
-	u16_t wnd;
+	if (sack_perm) {
+		buf[0] = NET_TCP_SACK_PERM_OPT;
+		buf[1] = NET_TCP_SACK_PERM_SIZE;
+	} else {
+		buf[0] = NET_TCP_NOP_OPT;
+		buf[1] = NET_TCP_NOP_OPT;
+	}
+
+	buf[2] = NET_TCP_TIMESTAMP_OPT;
+	buf[3] = NET_TCP_TIMESTAMP_SIZE;
+	sys_put_be32(k_uptime_get_32(), buf + 4);
+	sys_put_be32(tcp->ts_recent, buf + 8);
+
+	return 2 + NET_TCP_TIMESTAMP_SIZE;
+}
+
+/* Build a segment starting at sequence number @a seq. The sequence
+ * numbers of the connection are left alone: allocating the segment may
+ * block, and the application may queue data meanwhile.
+ */
+static int tcp_prepare_segment_seq(struct net_tcp *tcp, u8_t flags,
+				   void *options, size_t optlen,
+				   const struct sockaddr_ptr *local,
+				   const struct sockaddr *remote,
+				   u32_t seq, struct net_pkt **send_pkt)
+{
+	u8_t opts[NET_TCP_MAX_OPT_LEN];
 	struct tcp_segment segment = { 0 };
-	int status;
+	u32_t wnd;
 
 	if (!local) {
 		local = &tcp->context->local;
 	}
 
-	seq = tcp->send_seq;
+	/* RFC 7323 3.2: once negotiated, timestamps are in every segment
+	 * but a reset. A SYN has them among its own options.
+	 */
+	if ((tcp->flags & NET_TCP_TS_OK) &&
+	    !(flags & (NET_TCP_SYN | NET_TCP_RST))) {
+		u8_t len = tcp_put_timestamps(tcp, opts, false);
+
+		NET_ASSERT(len + optlen <= sizeof(opts));
+
+		if (optlen) {
+			memcpy(opts + len, options, optlen);
+		}
+
+		options = opts;
+		optlen += len;
+	}
+
+	/* The window of a SYN is never scaled */
+	wnd = net_tcp_get_recv_wnd(tcp);
+	if (!(flags & NET_TCP_SYN)) {
+		wnd >>= tcp->recv_wscale;
+	}
+
+	segment.src_addr = (struct sockaddr_ptr *)local;
+	segment.dst_addr = remote;
+	segment.seq = seq;
+	segment.ack = tcp->send_ack;
+	segment.flags = flags;
+	segment.wnd = min(wnd, UINT16_MAX);
+	segment.options = options;
+	segment.optlen = optlen;
+
+	return prepare_segment(tcp, &segment, *send_pkt, send_pkt);
+}
+
+int net_tcp_prepare_segment(struct net_tcp *tcp, u8_t flags,
+			    void *options, size_t optlen,
+			    const struct sockaddr_ptr *local,
+			    const struct sockaddr *remote,
+			    struct net_pkt **send_pkt)
+{
+	int status;
 
 	if (flags & NET_TCP_ACK) {
 		if (net_tcp_get_state(tcp) == NET_TCP_FIN_WAIT_1) {
@@ -562,7 +752,6 @@ int net_tcp_prepare_segment(struct net_tcp *tcp, u8_t flags,
 		 * have ACK set.
 		 */
 		flags |= NET_TCP_ACK;
-		seq++;
 
 		if (net_tcp_get_state(tcp) == NET_TCP_ESTABLISHED ||
 		    net_tcp_get_state(tcp) == NET_TCP_SYN_RCVD) {
@@ -570,23 +759,16 @@ int net_tcp_prepare_segment(struct net_tcp *tcp, u8_t flags,
 		}
 	}
 
-	wnd = net_tcp_get_recv_wnd(tcp);
-
-	segment.src_addr = (struct sockaddr_ptr *)local;
-	segment.dst_addr = remote;
-	segment.seq = tcp->send_seq;
-	segment.ack = tcp->send_ack;
-	segment.flags = flags;
-	segment.wnd = wnd;
-	segment.options = options;
-	segment.optlen = optlen;
-
-	status = prepare_segment(tcp, &segment, *send_pkt, send_pkt);
+	status = tcp_prepare_segment_seq(tcp, flags, options, optlen, local,
+					 remote, tcp->send_seq, send_pkt);
 	if (status < 0) {
 		return status;
 	}
 
-	tcp->send_seq = seq;
+	/* The FIN takes a sequence number, after any data queued */
+	if (flags & NET_TCP_FIN) {
+		tcp->send_seq++;
+	}
 
 	return 0;
 }
@@ -636,59 +818,561 @@ u16_t net_tcp_get_recv_mss(const struct net_tcp *tcp)
 			 */
 			return net_if_get_mtu(iface) - NET_IPV4TCPH_LEN;
 		}
-#else
-		return 0;
-#endif /* CONFIG_NET_IPV4 */
-	}
-#if defined(CONFIG_NET_IPV6)
-	else if (family == AF_INET6) {
-		struct net_if *iface = net_context_get_iface(tcp->context);
-		int mss = 0;
+#else
+		return 0;
+#endif /* CONFIG_NET_IPV4 */
+	}
+#if defined(CONFIG_NET_IPV6)
+	else if (family == AF_INET6) {
+		struct net_if *iface = net_context_get_iface(tcp->context);
+		int mss = 0;
+
+		if (iface && net_if_get_mtu(iface) >= NET_IPV6TCPH_LEN) {
+			/* Detect MSS based on interface MTU minus "TCP,IP
+			 * header size"
+			 */
+			mss = net_if_get_mtu(iface) - NET_IPV6TCPH_LEN;
+		}
+
+		if (mss < NET_IPV6_MTU) {
+			mss = NET_IPV6_MTU;
+		}
+
+		return mss;
+	}
+#endif /* CONFIG_NET_IPV6 */
+
+	return 0;
+}
+
+static void net_tcp_set_syn_opt(struct net_tcp *tcp, u8_t *options,
+				u8_t *optionlen)
+{
+	/* A SYN offers all the options we support, a SYN-ACK only the
+	 * ones the peer offered as well.
+	 */
+	bool syn_ack = net_tcp_get_state(tcp) == NET_TCP_SYN_RCVD;
+	bool ws = IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE) &&
+		(!syn_ack || tcp->wscale_ok);
+	bool sack = IS_ENABLED(CONFIG_NET_TCP_SACK) &&
+		(!syn_ack || (tcp->flags & NET_TCP_SACK_OK));
+	bool ts = IS_ENABLED(CONFIG_NET_TCP_TIMESTAMPS) &&
+		(!syn_ack || (tcp->flags & NET_TCP_TS_OK));
+	u32_t recv_mss;
+
+	*optionlen = 0;
+
+	if (syn_ack || !(tcp->flags & NET_TCP_RECV_MSS_SET)) {
+		recv_mss = net_tcp_get_recv_mss(tcp);
+		tcp->flags |= NET_TCP_RECV_MSS_SET;
+	} else {
+		recv_mss = 0;
+	}
+
+	recv_mss |= (NET_TCP_MSS_OPT << 24) | (NET_TCP_MSS_SIZE << 16);
+	UNALIGNED_PUT(htonl(recv_mss),
+		      (u32_t *)(options + *optionlen));
+
+	*optionlen += NET_TCP_MSS_SIZE;
+
+	if (ts) {
+		*optionlen += tcp_put_timestamps(tcp, options + *optionlen,
+						 sack);
+	} else if (sack) {
+		options[(*optionlen)++] = NET_TCP_NOP_OPT;
+		options[(*optionlen)++] = NET_TCP_NOP_OPT;
+		options[(*optionlen)++] = NET_TCP_SACK_PERM_OPT;
+		options[(*optionlen)++] = NET_TCP_SACK_PERM_SIZE;
+	}
+
+	if (ws) {
+		options[(*optionlen)++] = NET_TCP_NOP_OPT;
+		options[(*optionlen)++] = NET_TCP_WINDOW_SCALE_OPT;
+		options[(*optionlen)++] = NET_TCP_WINDOW_SCALE_SIZE;
+		options[(*optionlen)++] = RECV_WINDOW_SCALE;
+	}
+}
+
+/* Take the options the peer sent in its SYN or SYN-ACK */
+static void tcp_set_options(struct net_tcp *tcp,
+			    const struct net_tcp_options *opts)
+{
+	tcp->send_mss = opts->mss;
+
+	tcp->flags &= ~(NET_TCP_SACK_OK | NET_TCP_TS_OK);
+	tcp->wscale_ok = 0;
+	tcp->send_wscale = 0;
+	tcp->recv_wscale = 0;
+
+	if (IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE) && opts->window_scale_ok) {
+		tcp->wscale_ok = 1;
+		tcp->send_wscale = min(opts->window_scale,
+				       NET_TCP_MAX_WINDOW_SCALE);
+		tcp->recv_wscale = RECV_WINDOW_SCALE;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_TCP_SACK) && opts->sack_perm) {
+		tcp->flags |= NET_TCP_SACK_OK;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_TCP_TIMESTAMPS) && opts->ts_ok) {
+		tcp->flags |= NET_TCP_TS_OK;
+		tcp->ts_recent = opts->tsval;
+	}
+}
+
+#if defined(CONFIG_NET_TCP_SACK)
+
+/* Get the range of contiguous data starting at *pkt in the out of order
+ * queue, and move *pkt past it.
+ */
+static void tcp_ooo_block(struct net_pkt **pkt,
+			  struct net_tcp_sack_block *block)
+{
+	block->start = tcp_pkt_seq(*pkt);
+	block->end = block->start + net_pkt_appdatalen(*pkt);
+
+	while ((*pkt = SYS_SLIST_PEEK_NEXT_CONTAINER(*pkt, sent_list))) {
+		u32_t seq = tcp_pkt_seq(*pkt);
+		u32_t end = seq + net_pkt_appdatalen(*pkt);
+
+		if (net_tcp_seq_greater(seq, block->end)) {
+			break;
+		}
+
+		if (net_tcp_seq_greater(end, block->end)) {
+			block->end = end;
+		}
+	}
+}
+
+/* Write a SACK option for the out of order data we hold. The block with
+ * the latest segment received goes first (RFC 2018 4).
+ */
+static u8_t tcp_put_sack(struct net_tcp *tcp, u8_t *buf, int max_blocks)
+{
+	struct net_tcp_sack_block blocks[NET_TCP_MAX_SACK];
+	struct net_tcp_sack_block block;
+	struct net_pkt *pkt;
+	int i, n = 0;
+
+	pkt = SYS_SLIST_PEEK_HEAD_CONTAINER(&tcp->ooo_list, pkt, sent_list);
+	while (pkt) {
+		tcp_ooo_block(&pkt, &block);
+
+		if (net_tcp_seq_cmp(block.start, tcp->ooo_last) <= 0 &&
+		    net_tcp_seq_greater(block.end, tcp->ooo_last)) {
+			if (n == max_blocks) {
+				n--;
+			}
+
+			memmove(&blocks[1], &blocks[0], n * sizeof(block));
+			blocks[0] = block;
+			n++;
+		} else if (n < max_blocks) {
+			blocks[n++] = block;
+		}
+	}
+
+	if (!n) {
+		return 0;
+	}
+
+	buf[0] = NET_TCP_NOP_OPT;
+	buf[1] = NET_TCP_NOP_OPT;
+	buf[2] = NET_TCP_SACK_OPT;
+	buf[3] = 2 + n * NET_TCP_SACK_BLOCK_SIZE;
+
+	for (i = 0; i < n; i++) {
+		sys_put_be32(blocks[i].start,
+			     buf + 4 + i * NET_TCP_SACK_BLOCK_SIZE);
+		sys_put_be32(blocks[i].end,
+			     buf + 8 + i * NET_TCP_SACK_BLOCK_SIZE);
+	}
+
+	return 4 + n * NET_TCP_SACK_BLOCK_SIZE;
+}
+
+/* Record the blocks the peer reports holding, merged so that the
+ * scoreboard never has overlapping ones. A free slot has start == end.
+ */
+static void tcp_sack_update(struct net_tcp *tcp,
+			    const struct net_tcp_options *opts)
+{
+	int i, j;
+
+	for (i = 0; i < opts->sack_count; i++) {
+		struct net_tcp_sack_block block = opts->sack[i];
+		struct net_tcp_sack_block *slot = NULL;
+
+		if (!net_tcp_seq_greater(block.end, block.start) ||
+		    !net_tcp_seq_greater(block.end, tcp->send_una) ||
+		    net_tcp_seq_greater(block.end, tcp->send_max)) {
+			continue;
+		}
+
+		if (net_tcp_seq_greater(tcp->send_una, block.start)) {
+			block.start = tcp->send_una;
+		}
+
+		for (j = 0; j < NET_TCP_MAX_SACK; j++) {
+			struct net_tcp_sack_block *sacked = &tcp->sacked[j];
+
+			if (sacked->start != sacked->end) {
+				if (net_tcp_seq_greater(sacked->start,
+							block.end) ||
+				    net_tcp_seq_greater(block.start,
+							sacked->end)) {
+					continue;
+				}
+
+				/* Absorb it in the new block */
+				if (net_tcp_seq_greater(block.start,
+							sacked->start)) {
+					block.start = sacked->start;
+				}
+
+				if (net_tcp_seq_greater(sacked->end,
+							block.end)) {
+					block.end = sacked->end;
+				}
+
+				sacked->start = sacked->end;
+			}
+
+			if (!slot) {
+				slot = sacked;
+			}
+		}
+
+		if (!slot) {
+			/* Forget the lowest block, the next cumulative ACK
+			 * is the most likely to cover it.
+			 */
+			slot = &tcp->sacked[0];
+			for (j = 1; j < NET_TCP_MAX_SACK; j++) {
+				if (net_tcp_seq_greater(slot->start,
+							tcp->sacked[j].start)) {
+					slot = &tcp->sacked[j];
+				}
+			}
+		}
+
+		*slot = block;
+	}
+}
+
+/* Drop what the cumulative ACK covers from the scoreboard */
+static void tcp_sack_trim(struct net_tcp *tcp)
+{
+	int i;
+
+	for (i = 0; i < NET_TCP_MAX_SACK; i++) {
+		struct net_tcp_sack_block *sacked = &tcp->sacked[i];
+
+		if (!net_tcp_seq_greater(sacked->end, tcp->send_una)) {
+			sacked->start = sacked->end;
+		} else if (net_tcp_seq_greater(tcp->send_una,
+					       sacked->start)) {
+			sacked->start = tcp->send_una;
+		}
+	}
+}
+
+static bool tcp_is_sacked(struct net_tcp *tcp, u32_t seq, u32_t end)
+{
+	int i;
+
+	for (i = 0; i < NET_TCP_MAX_SACK; i++) {
+		struct net_tcp_sack_block *sacked = &tcp->sacked[i];
+
+		if (sacked->start != sacked->end &&
+		    net_tcp_seq_cmp(sacked->start, seq) <= 0 &&
+		    net_tcp_seq_cmp(end, sacked->end) <= 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* End of the highest data the peer reports holding */
+static u32_t tcp_sack_high(struct net_tcp *tcp)
+{
+	u32_t high = tcp->send_una;
+	int i;
+
+	for (i = 0; i < NET_TCP_MAX_SACK; i++) {
+		if (net_tcp_seq_greater(tcp->sacked[i].end, high)) {
+			high = tcp->sacked[i].end;
+		}
+	}
+
+	return high;
+}
+#else
+#define tcp_sack_update(...)
+#define tcp_sack_trim(...)
+#define tcp_is_sacked(...) false
+#define tcp_sack_high(tcp) ((tcp)->send_una)
+#endif /* CONFIG_NET_TCP_SACK */
+
+/* Transmit the segments from send_nxt on that the congestion window
+ * and the peer's window allow: new data, or data sent already when
+ * going back after a retransmission timeout. One segment may always be
+ * in flight, which also probes a closed peer window.
+ */
+static void tcp_send_queued(struct net_tcp *tcp)
+{
+	struct net_pkt *pkt;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp->sent_list, pkt, sent_list) {
+		struct net_tcp_hdr hdr, *tcp_hdr;
+		u32_t seq, len, flight;
+
+		tcp_hdr = net_tcp_get_hdr(pkt, &hdr);
+		if (!tcp_hdr) {
+			continue;
+		}
+
+		seq = sys_get_be32(tcp_hdr->seq);
+		len = tcp_seg_len(pkt, tcp_hdr);
+
+		if (net_tcp_seq_greater(tcp->send_nxt, seq)) {
+			continue;
+		}
+
+		flight = net_tcp_flight_size(tcp);
+		if (flight && flight + len > min(tcp->cwnd, tcp->send_wnd)) {
+			break;
+		}
+
+		if (net_tcp_seq_greater(tcp->send_max, seq)) {
+			tcp_retransmit(tcp, pkt);
+			tcp->send_nxt = seq + len;
+			continue;
+		}
+
+		if (!(tcp->flags & NET_TCP_RTT_TIMING)) {
+			tcp->flags |= NET_TCP_RTT_TIMING;
+			tcp->rtt_seq = seq + len;
+			tcp->rtt_time = k_uptime_get_32();
+		}
+
+		tcp->send_nxt = seq + len;
+		tcp->send_max = tcp->send_nxt;
+
+		NET_DBG("[%p] Sending pkt %p (%zd bytes)", tcp, pkt,
+			net_pkt_get_len(pkt));
+
+		if (!is_6lo_technology(pkt)) {
+			net_pkt_set_queued(pkt, true);
+		}
+
+		if (net_tcp_send_pkt(pkt) < 0 && !is_6lo_technology(pkt)) {
+			/* The retransmission timer takes it from here */
+			NET_DBG("[%p] pkt %p not sent", tcp, pkt);
+			net_pkt_set_queued(pkt, false);
+			net_pkt_unref(pkt);
+			break;
+		}
+	}
+}
+
+/* Retransmit the first segment past high_rxt that the peer does not
+ * hold. With holes_only, only if the peer holds data above it.
+ */
+static void tcp_retransmit_next(struct net_tcp *tcp, bool holes_only)
+{
+	u32_t high = tcp_sack_high(tcp);
+	struct net_pkt *pkt;
+
+	if (net_tcp_seq_greater(tcp->send_una, tcp->high_rxt)) {
+		tcp->high_rxt = tcp->send_una;
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp->sent_list, pkt, sent_list) {
+		struct net_tcp_hdr hdr, *tcp_hdr;
+		u32_t seq, end;
+
+		tcp_hdr = net_tcp_get_hdr(pkt, &hdr);
+		if (!tcp_hdr) {
+			continue;
+		}
+
+		seq = sys_get_be32(tcp_hdr->seq);
+		end = seq + tcp_seg_len(pkt, tcp_hdr);
+
+		if (net_tcp_seq_cmp(seq, tcp->send_nxt) >= 0 ||
+		    (holes_only && !net_tcp_seq_greater(high, seq))) {
+			break;
+		}
+
+		if (!net_tcp_seq_greater(end, tcp->high_rxt) ||
+		    tcp_is_sacked(tcp, seq, end)) {
+			continue;
+		}
+
+		tcp_retransmit(tcp, pkt);
+		tcp->high_rxt = end;
+
+		return;
+	}
+}
+
+/* RFC 6298 2, with srtt kept in 1/8 ms and rttvar in 1/4 ms */
+static void tcp_rtt_update(struct net_tcp *tcp, u32_t rtt)
+{
+	rtt = max(rtt, 1);
+
+	if (!tcp->srtt) {
+		tcp->srtt = rtt << 3;
+		tcp->rttvar = rtt << 1;
+	} else {
+		s32_t delta = rtt - (tcp->srtt >> 3);
+
+		tcp->srtt += delta;
+		if (delta < 0) {
+			delta = -delta;
+		}
+
+		tcp->rttvar += delta - (tcp->rttvar >> 2);
+	}
+
+	tcp->rto = (tcp->srtt >> 3) + tcp->rttvar;
+	tcp->rto = max(min(tcp->rto, NET_TCP_MAX_RTO), NET_TCP_MIN_RTO);
+
+	NET_DBG("[%p] rtt %u srtt %u rto %u", tcp, rtt, tcp->srtt >> 3,
+		tcp->rto);
+}
+
+/* Update the send side on an acceptable ACK: RTT, congestion window,
+ * fast retransmit and recovery (RFC 5681, RFC 6582), then send what
+ * the windows now allow.
+ */
+static void tcp_ack_update(struct net_tcp *tcp, struct net_tcp_hdr *tcp_hdr,
+			   const struct net_tcp_options *opts, u32_t data_len)
+{
+	u32_t ack = sys_get_be32(tcp_hdr->ack);
+	u32_t wnd = (u32_t)sys_get_be16(tcp_hdr->wnd) << tcp->send_wscale;
+	bool same_wnd = wnd == tcp->send_wnd;
+
+	if (net_tcp_seq_greater(tcp->send_una, ack) ||
+	    net_tcp_seq_greater(ack, tcp->send_max)) {
+		return;
+	}
+
+	tcp->send_wnd = wnd;
+	tcp_sack_update(tcp, opts);
+
+	if (net_tcp_seq_greater(ack, tcp->send_una)) {
+		u32_t acked = ack - tcp->send_una;
+
+		tcp->send_una = ack;
+		tcp->dupacks = 0;
+
+		/* A late ACK for what was sent before a timeout */
+		if (net_tcp_seq_greater(ack, tcp->send_nxt)) {
+			tcp->send_nxt = ack;
+		}
+
+		if ((tcp->flags & NET_TCP_TS_OK) && opts->tsecr) {
+			tcp_rtt_update(tcp, k_uptime_get_32() - opts->tsecr);
+		} else if ((tcp->flags & NET_TCP_RTT_TIMING) &&
+			   !net_tcp_seq_greater(tcp->rtt_seq, ack)) {
+			tcp->flags &= ~NET_TCP_RTT_TIMING;
+			tcp_rtt_update(tcp, k_uptime_get_32() - tcp->rtt_time);
+		}
 
-		if (iface && net_if_get_mtu(iface) >= NET_IPV6TCPH_LEN) {
-			/* Detect MSS based on interface MTU minus "TCP,IP
-			 * header size"
+		tcp_sack_trim(tcp);
+
+		if (!(tcp->flags & NET_TCP_IN_RECOVERY)) {
+			tcp->cc->ack(tcp, acked);
+		} else if (!net_tcp_seq_greater(tcp->recover, ack)) {
+			/* Full ACK, leave fast recovery */
+			tcp->flags &= ~NET_TCP_IN_RECOVERY;
+			tcp->cwnd = min(tcp->ssthresh,
+					max(net_tcp_flight_size(tcp),
+					    tcp->send_mss) + tcp->send_mss);
+		} else {
+			/* Partial ACK, the next hole was lost too. Deflate
+			 * the window by what was acked.
 			 */
-			mss = net_if_get_mtu(iface) - NET_IPV6TCPH_LEN;
-		}
+			tcp_retransmit_next(tcp, false);
 
-		if (mss < NET_IPV6_MTU) {
-			mss = NET_IPV6_MTU;
+			tcp->cwnd -= min(acked, tcp->cwnd);
+			if (acked >= tcp->send_mss) {
+				tcp->cwnd += tcp->send_mss;
+			}
 		}
+	} else if (!data_len && same_wnd && net_tcp_flight_size(tcp) &&
+		   !(tcp_hdr->flags & (NET_TCP_SYN | NET_TCP_FIN))) {
+		tcp->dupacks++;
 
-		return mss;
+		if (tcp->flags & NET_TCP_IN_RECOVERY) {
+			/* Each duplicate ACK is a segment that left the
+			 * network.
+			 */
+			tcp->cwnd += tcp->send_mss;
+
+			if (tcp->flags & NET_TCP_SACK_OK) {
+				tcp_retransmit_next(tcp, true);
+			}
+		} else if (tcp->dupacks == 3 &&
+			   net_tcp_seq_greater(ack, tcp->recover)) {
+			NET_DBG("[%p] fast retransmit at %u", tcp, ack);
+
+			tcp->ssthresh = tcp->cc->ssthresh(tcp);
+			tcp->recover = tcp->send_max;
+			tcp->flags |= NET_TCP_IN_RECOVERY;
+			tcp->cwnd = tcp->ssthresh + 3 * tcp->send_mss;
+			tcp->high_rxt = tcp->send_una;
+
+			tcp_retransmit_next(tcp, false);
+		}
 	}
-#endif /* CONFIG_NET_IPV6 */
 
-	return 0;
+	tcp_send_queued(tcp);
 }
 
-static void net_tcp_set_syn_opt(struct net_tcp *tcp, u8_t *options,
-				u8_t *optionlen)
+/* Set up the send side of a connection just established. The initial
+ * window is the one of RFC 3390.
+ */
+static void tcp_established_init(struct net_tcp *tcp, u32_t wnd)
 {
-	u32_t recv_mss;
+	u32_t mss = tcp->send_mss;
 
-	*optionlen = 0;
+	tcp->send_una = tcp->send_seq;
+	tcp->send_nxt = tcp->send_seq;
+	tcp->send_max = tcp->send_seq;
+	tcp->recover = tcp->send_seq - 1;
+	tcp->high_rxt = tcp->send_seq;
+	tcp->send_wnd = wnd;
 
-	if (!(tcp->flags & NET_TCP_RECV_MSS_SET)) {
-		recv_mss = net_tcp_get_recv_mss(tcp);
-		tcp->flags |= NET_TCP_RECV_MSS_SET;
-	} else {
-		recv_mss = 0;
-	}
+	tcp->cwnd = min(4 * mss, max(2 * mss, 4380));
+	tcp->ssthresh = UINT32_MAX;
+	tcp->cc->init(tcp);
+}
 
-	recv_mss |= (NET_TCP_MSS_OPT << 24) | (NET_TCP_MSS_SIZE << 16);
-	UNALIGNED_PUT(htonl(recv_mss),
-		      (u32_t *)(options + *optionlen));
+/* Queue the FIN|ACK of a passive close, which also moves to LAST_ACK */
+static void tcp_queue_fin_ack(struct net_tcp *tcp,
+			      const struct sockaddr *remote)
+{
+	struct net_pkt *pkt = NULL;
 
-	*optionlen += NET_TCP_MSS_SIZE;
+	if (net_tcp_prepare_segment(tcp, NET_TCP_ACK, NULL, 0, NULL, remote,
+				    &pkt) || !pkt) {
+		return;
+	}
+
+	net_tcp_queue_pkt(tcp->context, pkt);
 }
 
 int net_tcp_prepare_ack(struct net_tcp *tcp, const struct sockaddr *remote,
 			struct net_pkt **pkt)
 {
-	u8_t options[NET_TCP_MAX_OPT_SIZE];
-	u8_t optionlen;
+	u8_t options[NET_TCP_MAX_OPT_LEN];
+	u8_t optionlen = 0;
 
 	switch (net_tcp_get_state(tcp)) {
 	case NET_TCP_SYN_RCVD:
@@ -700,16 +1384,56 @@ int net_tcp_prepare_ack(struct net_tcp *tcp, const struct sockaddr *remote,
 		return net_tcp_prepare_segment(tcp, NET_TCP_SYN | NET_TCP_ACK,
 					       options, optionlen, NULL, remote,
 					       pkt);
-	case NET_TCP_FIN_WAIT_1:
 	case NET_TCP_LAST_ACK:
+		/* Our FIN is still queued behind data, see below */
+		if (tcp->send_nxt != tcp->send_seq) {
+			return tcp_prepare_segment_seq(tcp, NET_TCP_ACK,
+						       NULL, 0, NULL, remote,
+						       tcp->send_nxt, pkt);
+		}
+
+		/* Fall through */
+	case NET_TCP_FIN_WAIT_1:
 		/* In the FIN_WAIT_1 and LAST_ACK states acknowledgment must
 		 * be with the FIN flag.
 		 */
 		return net_tcp_prepare_segment(tcp, NET_TCP_FIN | NET_TCP_ACK,
 					       0, 0, NULL, remote, pkt);
 	default:
-		return net_tcp_prepare_segment(tcp, NET_TCP_ACK, 0, 0, NULL,
-					       remote, pkt);
+#if defined(CONFIG_NET_TCP_SACK)
+		/* Timestamps take 12 of the 40 option bytes, leaving room
+		 * for 3 SACK blocks
+		 */
+		if ((tcp->flags & NET_TCP_SACK_OK) &&
+		    !sys_slist_is_empty(&tcp->ooo_list)) {
+			optionlen = tcp_put_sack(tcp, options,
+						 (tcp->flags & NET_TCP_TS_OK) ?
+						 NET_TCP_MAX_SACK - 1 :
+						 NET_TCP_MAX_SACK);
+		}
+#endif
+
+		/* Queued data may still be waiting for the congestion
+		 * window, acknowledge from the next sequence number
+		 * actually sent. In CLOSE_WAIT our FIN, which would go
+		 * with this ACK otherwise, is queued behind that data
+		 * and sent, and resent, like it.
+		 */
+		if ((net_tcp_get_state(tcp) == NET_TCP_ESTABLISHED ||
+		     net_tcp_get_state(tcp) == NET_TCP_CLOSE_WAIT) &&
+		    tcp->send_nxt != tcp->send_seq) {
+			if (net_tcp_get_state(tcp) == NET_TCP_CLOSE_WAIT) {
+				tcp_queue_fin_ack(tcp, remote);
+			}
+
+			return tcp_prepare_segment_seq(tcp, NET_TCP_ACK,
+						       options, optionlen,
+						       NULL, remote,
+						       tcp->send_nxt, pkt);
+		}
+
+		return net_tcp_prepare_segment(tcp, NET_TCP_ACK, options,
+					       optionlen, NULL, remote, pkt);
 	}
 
 	return -EINVAL;
@@ -862,11 +1586,49 @@ static int net_tcp_queue_pkt(struct net_context *context, struct net_pkt *pkt)
 	return 0;
 }
 
+/* Refresh the timestamps of a segment built earlier, so that the peer
+ * echoes the time of this transmission. They come first among the
+ * options when present, see net_tcp_prepare_segment().
+ */
+static void tcp_update_timestamps(struct net_tcp *tcp, struct net_pkt *pkt,
+				  struct net_tcp_hdr *tcp_hdr)
+{
+	u16_t offset = net_pkt_ip_hdr_len(pkt) + net_pkt_ipv6_ext_len(pkt) +
+		       sizeof(struct net_tcp_hdr);
+	u8_t opts[2 + NET_TCP_TIMESTAMP_SIZE];
+	u32_t tsval, tsecr;
+	u16_t pos;
+
+	if (NET_TCP_HDR_LEN(tcp_hdr) < sizeof(struct net_tcp_hdr) +
+	    sizeof(opts)) {
+		return;
+	}
+
+	if (!net_frag_read(pkt->frags, offset, &pos, sizeof(opts), opts) ||
+	    opts[2] != NET_TCP_TIMESTAMP_OPT ||
+	    opts[3] != NET_TCP_TIMESTAMP_SIZE) {
+		return;
+	}
+
+	tsval = k_uptime_get_32();
+	tsecr = tcp->ts_recent;
+
+	tcp_hdr->chksum = net_chksum_update_32(tcp_hdr->chksum,
+					       sys_get_be32(opts + 4), tsval);
+	tcp_hdr->chksum = net_chksum_update_32(tcp_hdr->chksum,
+					       sys_get_be32(opts + 8), tsecr);
+
+	sys_put_be32(tsval, opts + 4);
+	sys_put_be32(tsecr, opts + 8);
+	net_pkt_write(pkt, pkt->frags, offset + 4, &pos, 8, opts + 4,
+		      ALLOC_TIMEOUT);
+}
+
 int net_tcp_send_pkt(struct net_pkt *pkt)
 {
 	struct net_context *ctx = net_pkt_context(pkt);
 	struct net_tcp_hdr hdr, *tcp_hdr;
-	bool calc_chksum = false;
+	u32_t ack;
 
 	tcp_hdr = net_tcp_get_hdr(pkt, &hdr);
 	if (!tcp_hdr) {
@@ -874,9 +1636,14 @@ int net_tcp_send_pkt(struct net_pkt *pkt)
 		return -EMSGSIZE;
 	}
 
-	if (sys_get_be32(tcp_hdr->ack) != ctx->tcp->send_ack) {
+	/* The checksum is updated for the fields rewritten here, rather
+	 * than computed again over the whole segment.
+	 */
+	ack = sys_get_be32(tcp_hdr->ack);
+	if (ack != ctx->tcp->send_ack) {
 		sys_put_be32(ctx->tcp->send_ack, tcp_hdr->ack);
-		calc_chksum = true;
+		tcp_hdr->chksum = net_chksum_update_32(tcp_hdr->chksum, ack,
+						       ctx->tcp->send_ack);
 	}
 
 	/* The data stream code always sets this flag, because
@@ -886,12 +1653,16 @@ int net_tcp_send_pkt(struct net_pkt *pkt)
 	 */
 	if (ctx->tcp->sent_ack != ctx->tcp->send_ack &&
 		(tcp_hdr->flags & NET_TCP_ACK) == 0) {
+		u16_t old = (tcp_hdr->offset << 8) | tcp_hdr->flags;
+
 		tcp_hdr->flags |= NET_TCP_ACK;
-		calc_chksum = true;
+		tcp_hdr->chksum = net_chksum_update_16(tcp_hdr->chksum, old,
+						       old | NET_TCP_ACK);
 	}
 
-	if (calc_chksum) {
-		net_tcp_set_chksum(pkt, pkt->frags);
+	if ((ctx->tcp->flags & NET_TCP_TS_OK) &&
+	    !(tcp_hdr->flags & NET_TCP_SYN)) {
+		tcp_update_timestamps(ctx->tcp, pkt, tcp_hdr);
 	}
 
 	if (tcp_hdr->flags & NET_TCP_FIN) {
@@ -979,35 +1750,8 @@ static void restart_timer(struct net_tcp *tcp)
 int net_tcp_send_data(struct net_context *context, net_context_send_cb_t cb,
 		      void *token, void *user_data)
 {
-	struct net_pkt *pkt;
-
-	/* For now, just send all queued data synchronously.  Need to
-	 * add window handling and retry/ACK logic.
-	 */
-	SYS_SLIST_FOR_EACH_CONTAINER(&context->tcp->sent_list, pkt, sent_list) {
-		/* Do not resend packets that were sent by expire timer */
-		if (net_pkt_queued(pkt)) {
-			NET_DBG("[%p] Skipping pkt %p because it was already "
-				"sent.", context->tcp, pkt);
-			continue;
-		}
-
-		if (!net_pkt_sent(pkt)) {
-			int ret;
-
-			NET_DBG("[%p] Sending pkt %p (%zd bytes)", context->tcp,
-				pkt, net_pkt_get_len(pkt));
-
-			ret = net_tcp_send_pkt(pkt);
-			if (ret < 0 && !is_6lo_technology(pkt)) {
-				NET_DBG("[%p] pkt %p not sent (%d)",
-					context->tcp, pkt, ret);
-				net_pkt_unref(pkt);
-			}
-
-			net_pkt_set_queued(pkt, true);
-		}
-	}
+	/* What the windows do not allow now goes out as ACKs come */
+	tcp_send_queued(context->tcp);
 
 	/* Just make the callback synchronously even if it didn't
 	 * go over the wire.  In theory it would be nice to track
@@ -1030,7 +1774,10 @@ bool net_tcp_ack_received(struct net_context *ctx, u32_t ack)
 	struct net_pkt *pkt;
 	bool valid_ack = false;
 
-	if (net_tcp_seq_greater(ack, ctx->tcp->send_seq)) {
+	/* Data queued may not have been sent yet, the ACK can only cover
+	 * what was.
+	 */
+	if (net_tcp_seq_greater(ack, ctx->tcp->send_max)) {
 		NET_ERR("ctx %p: ACK for unsent data", ctx);
 		net_stats_update_tcp_seg_ackerr(net_context_get_iface(ctx));
 		/* RFC 793 doesn't say that invalid ack sequence is an error
@@ -1059,17 +1806,7 @@ bool net_tcp_ack_received(struct net_context *ctx, u32_t ack)
 			continue;
 		}
 
-		seq_len = net_pkt_appdatalen(pkt);
-
-		/* Each of SYN and FIN flags are counted
-		 * as one sequence number.
-		 */
-		if (tcp_hdr->flags & NET_TCP_SYN) {
-			seq_len += 1;
-		}
-		if (tcp_hdr->flags & NET_TCP_FIN) {
-			seq_len += 1;
-		}
+		seq_len = tcp_seg_len(pkt, tcp_hdr);
 
 		/* Last sequence number in this packet. */
 		last_seq = sys_get_be32(tcp_hdr->seq) + seq_len - 1;
@@ -1093,7 +1830,7 @@ bool net_tcp_ack_received(struct net_context *ctx, u32_t ack)
 		}
 
 		sys_slist_remove(list, NULL, head);
-		net_pkt_unref(pkt);
+		tcp_sent_pkt_unref(tcp, pkt);
 		valid_ack = true;
 	}
 
@@ -1392,6 +2129,7 @@ int net_tcp_parse_opts(struct net_pkt *pkt, int opt_totlen,
 		  + net_pkt_ipv6_ext_len(pkt)
 		  + sizeof(struct net_tcp_hdr);
 	u8_t opt, optlen;
+	int i;
 
 	/* TODO: this should be done for each TCP pkt, on reception */
 	if (pos + opt_totlen > net_pkt_get_len(pkt)) {
@@ -1443,6 +2181,44 @@ int net_tcp_parse_opts(struct net_pkt *pkt, int opt_totlen,
 			frag = net_frag_read_be16(frag, pos, &pos,
 						  &opts->mss);
 			break;
+		case NET_TCP_WINDOW_SCALE_OPT:
+			if (optlen != 1) {
+				goto error;
+			}
+			frag = net_frag_read_u8(frag, pos, &pos,
+						&opts->window_scale);
+			opts->window_scale_ok = true;
+			break;
+		case NET_TCP_SACK_PERM_OPT:
+			if (optlen != 0) {
+				goto error;
+			}
+			opts->sack_perm = true;
+			break;
+		case NET_TCP_SACK_OPT:
+			if (!optlen || optlen % NET_TCP_SACK_BLOCK_SIZE ||
+			    optlen > NET_TCP_MAX_SACK *
+				     NET_TCP_SACK_BLOCK_SIZE) {
+				goto error;
+			}
+			opts->sack_count = optlen / NET_TCP_SACK_BLOCK_SIZE;
+			for (i = 0; i < opts->sack_count; i++) {
+				frag = net_frag_read_be32(frag, pos, &pos,
+							  &opts->sack[i].start);
+				frag = net_frag_read_be32(frag, pos, &pos,
+							  &opts->sack[i].end);
+			}
+			break;
+		case NET_TCP_TIMESTAMP_OPT:
+			if (optlen != 8) {
+				goto error;
+			}
+			frag = net_frag_read_be32(frag, pos, &pos,
+						  &opts->tsval);
+			frag = net_frag_read_be32(frag, pos, &pos,
+						  &opts->tsecr);
+			opts->ts_ok = true;
+			break;
 		default:
 			frag = net_frag_skip(frag, pos, &pos, optlen);
 			break;
@@ -1500,10 +2276,8 @@ static void queue_fin(struct net_context *ctx)
 
 	net_tcp_queue_pkt(ctx, pkt);
 
-	ret = net_tcp_send_pkt(pkt);
-	if (ret < 0) {
-		net_pkt_unref(pkt);
-	}
+	/* It goes out after the data queued before it */
+	tcp_send_queued(ctx->tcp);
 }
 
 int net_tcp_put(struct net_context *context)
@@ -1557,6 +2331,45 @@ int net_tcp_update_recv_wnd(struct net_context *context, s32_t delta)
 	return 0;
 }
 
+int net_tcp_set_cc(struct net_context *context, const char *name)
+{
+	struct net_tcp *tcp = context->tcp;
+	int i;
+
+	if (!tcp) {
+		NET_ERR("context->tcp == NULL");
+		return -EPROTOTYPE;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(tcp_cc); i++) {
+		if (strcmp(tcp_cc[i]->name, name)) {
+			continue;
+		}
+
+		tcp->cc = tcp_cc[i];
+
+		/* Switching over on a live connection starts the new
+		 * algorithm from the current window.
+		 */
+		if (net_tcp_get_state(tcp) >= NET_TCP_ESTABLISHED) {
+			tcp->cc->init(tcp);
+		}
+
+		return 0;
+	}
+
+	return -ENOENT;
+}
+
+const char *net_tcp_get_cc(struct net_context *context)
+{
+	if (!context->tcp) {
+		return NULL;
+	}
+
+	return context->tcp->cc->name;
+}
+
 static int send_reset(struct net_context *context, struct sockaddr *local,
 		      struct sockaddr *remote);
 
@@ -1641,7 +2454,7 @@ static int tcp_backlog_find(struct net_pkt *pkt, int *empty_slot)
 }
 
 static int tcp_backlog_syn(struct net_pkt *pkt, struct net_context *context,
-			   u16_t send_mss)
+			   const struct net_tcp_options *opts)
 {
 	int empty_slot = -1;
 	int ret;
@@ -1667,7 +2480,7 @@ static int tcp_backlog_syn(struct net_pkt *pkt, struct net_context *context,
 
 	tcp_backlog[empty_slot].send_seq = context->tcp->send_seq;
 	tcp_backlog[empty_slot].send_ack = context->tcp->send_ack;
-	tcp_backlog[empty_slot].send_mss = send_mss;
+	tcp_backlog[empty_slot].opts = *opts;
 
 	k_delayed_work_init(&tcp_backlog[empty_slot].ack_timer,
 			    backlog_ack_timeout);
@@ -1701,7 +2514,7 @@ static int tcp_backlog_ack(struct net_pkt *pkt, struct net_context *context)
 		sizeof(struct sockaddr));
 	context->tcp->send_seq = tcp_backlog[r].send_seq + 1;
 	context->tcp->send_ack = tcp_backlog[r].send_ack;
-	context->tcp->send_mss = tcp_backlog[r].send_mss;
+	tcp_set_options(context->tcp, &tcp_backlog[r].opts);
 
 	k_delayed_work_cancel(&tcp_backlog[r].ack_timer);
 	(void)memset(&tcp_backlog[r], 0, sizeof(struct tcp_backlog_entry));
@@ -1753,7 +2566,13 @@ static void handle_ack_timeout(struct k_work *work)
 	NET_DBG("Did not receive ACK in %dms while in %s", ACK_TIMEOUT,
 		net_tcp_state_str(net_tcp_get_state(tcp)));
 
-	if (net_tcp_get_state(tcp) == NET_TCP_LAST_ACK) {
+	if (net_tcp_get_state(tcp) == NET_TCP_LAST_ACK &&
+	    !sys_slist_is_empty(&tcp->sent_list)) {
+		/* Our FIN went behind data, the retransmission timer
+		 * gives up on the peer if it stops acknowledging.
+		 */
+		k_delayed_work_submit(&tcp->ack_timer, ACK_TIMEOUT);
+	} else if (net_tcp_get_state(tcp) == NET_TCP_LAST_ACK) {
 		/* We did not receive the last ACK on time. We can only
 		 * close the connection at this point. We will not send
 		 * anything to peer in this last state, but will go directly
@@ -1876,12 +2695,10 @@ static inline int send_syn_segment(struct net_context *context,
 {
 	struct net_pkt *pkt = NULL;
 	int ret;
-	u8_t options[NET_TCP_MAX_OPT_SIZE];
-	u8_t optionlen = 0;
+	u8_t options[NET_TCP_MAX_OPT_LEN];
+	u8_t optionlen;
 
-	if (flags == NET_TCP_SYN) {
-		net_tcp_set_syn_opt(context->tcp, options, &optionlen);
-	}
+	net_tcp_set_syn_opt(context->tcp, options, &optionlen);
 
 	ret = net_tcp_prepare_segment(context->tcp, flags, options, optionlen,
 				      local, remote, &pkt);
@@ -1899,6 +2716,10 @@ static inline int send_syn_segment(struct net_context *context,
 
 	context->tcp->send_seq++;
 
+	context->tcp->send_una = context->tcp->send_seq;
+	context->tcp->send_nxt = context->tcp->send_seq;
+	context->tcp->send_max = context->tcp->send_seq;
+
 	return ret;
 }
 
@@ -1969,6 +2790,128 @@ static int send_reset(struct net_context *context,
 	return ret;
 }
 
+#if defined(CONFIG_NET_TCP_SACK)
+/* The segment that fills a hole, and the traffic of the other
+ * connections, need RX packets too.
+ */
+static bool tcp_ooo_rx_short(void)
+{
+	struct k_mem_slab *rx;
+
+	net_pkt_get_info(&rx, NULL, NULL, NULL);
+
+	return k_mem_slab_num_free_get(rx) < CONFIG_NET_PKT_RX_COUNT / 4;
+}
+
+/* Hold a segment received past a hole, sorted by sequence number, until
+ * the hole is filled. The peer learns about it from the SACK option.
+ */
+static bool tcp_ooo_queue(struct net_tcp *tcp, struct net_pkt *pkt,
+			  struct net_tcp_hdr *tcp_hdr, u16_t data_len)
+{
+	u32_t seq = sys_get_be32(tcp_hdr->seq);
+	struct net_pkt *cur, *prev = NULL;
+
+	if (!data_len ||
+	    (NET_TCP_FLAGS(tcp_hdr) & (NET_TCP_SYN | NET_TCP_FIN |
+				       NET_TCP_RST)) ||
+	    net_tcp_seq_greater(seq + data_len,
+				tcp->send_ack + net_tcp_get_recv_wnd(tcp)) ||
+	    tcp->ooo_count >= CONFIG_NET_TCP_MAX_OOO_SEGMENTS) {
+		return false;
+	}
+
+	/* Give back what is held too, RFC 2018 8 lets the receiver
+	 * discard SACKed data, the peer sends it again.
+	 */
+	if (tcp_ooo_rx_short()) {
+		NET_DBG("[%p] RX packets short, dropping %u held segments",
+			tcp, tcp->ooo_count);
+		tcp_ooo_flush(tcp);
+		return false;
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp->ooo_list, cur, sent_list) {
+		u32_t cur_seq = tcp_pkt_seq(cur);
+
+		if (cur_seq == seq) {
+			return false;
+		}
+
+		if (net_tcp_seq_greater(cur_seq, seq)) {
+			break;
+		}
+
+		prev = cur;
+	}
+
+	sys_slist_insert(&tcp->ooo_list, prev ? &prev->sent_list : NULL,
+			 &pkt->sent_list);
+	tcp->ooo_last = seq;
+	tcp->ooo_count++;
+
+	return true;
+}
+
+/* Deliver the held segments the stream has caught up with */
+static void tcp_ooo_deliver(struct net_conn *conn, struct net_tcp *tcp)
+{
+	struct net_pkt *pkt;
+
+	while ((pkt = SYS_SLIST_PEEK_HEAD_CONTAINER(&tcp->ooo_list, pkt,
+						    sent_list))) {
+		u32_t seq = tcp_pkt_seq(pkt);
+		u16_t len = net_pkt_appdatalen(pkt);
+
+		if (net_tcp_seq_greater(seq, tcp->send_ack)) {
+			break;
+		}
+
+		sys_slist_remove(&tcp->ooo_list, NULL, &pkt->sent_list);
+		tcp->ooo_count--;
+
+		/* Overlapping what was delivered already, the peer will
+		 * send the rest again.
+		 */
+		if (seq != tcp->send_ack || len > net_tcp_get_recv_wnd(tcp)) {
+			net_pkt_unref(pkt);
+			continue;
+		}
+
+		if (net_context_packet_received(conn, pkt,
+						tcp->recv_user_data) ==
+		    NET_DROP) {
+			net_pkt_unref(pkt);
+		}
+
+		tcp->send_ack += len;
+	}
+}
+#else
+#define tcp_ooo_queue(...) false
+#define tcp_ooo_deliver(...)
+#endif /* CONFIG_NET_TCP_SACK */
+
+/* Parse the options of a segment once the connection is established,
+ * where only the ones of SACK and timestamps matter.
+ */
+static int tcp_established_opts(struct net_tcp *tcp, struct net_pkt *pkt,
+				struct net_tcp_hdr *tcp_hdr,
+				struct net_tcp_options *opts)
+{
+	int opt_totlen = NET_TCP_HDR_LEN(tcp_hdr) -
+			 sizeof(struct net_tcp_hdr);
+
+	(void)memset(opts, 0, sizeof(*opts));
+
+	if (!opt_totlen ||
+	    !(tcp->flags & (NET_TCP_SACK_OK | NET_TCP_TS_OK))) {
+		return 0;
+	}
+
+	return net_tcp_parse_opts(pkt, opt_totlen, opts);
+}
+
 /* This is called when we receive data after the connection has been
  * established. The core TCP logic is located here.
  *
@@ -1980,9 +2923,11 @@ NET_CONN_CB(tcp_established)
 {
 	struct net_context *context = (struct net_context *)user_data;
 	struct net_tcp_hdr hdr, *tcp_hdr;
+	struct net_tcp_options tcp_opts;
 	enum net_verdict ret = NET_OK;
 	u8_t tcp_flags;
 	u16_t data_len;
+	u32_t seq;
 
 	NET_ASSERT(context && context->tcp);
 
@@ -2000,9 +2945,16 @@ NET_CONN_CB(tcp_established)
 	net_tcp_print_recv_info("DATA", pkt, tcp_hdr->src_port);
 
 	tcp_flags = NET_TCP_FLAGS(tcp_hdr);
+	seq = sys_get_be32(tcp_hdr->seq);
+
+	net_pkt_set_appdata_values(pkt, IPPROTO_TCP);
+	data_len = net_pkt_appdatalen(pkt);
+
+	if (tcp_established_opts(context->tcp, pkt, tcp_hdr, &tcp_opts) < 0) {
+		return NET_DROP;
+	}
 
-	if (net_tcp_seq_cmp(sys_get_be32(tcp_hdr->seq),
-			    context->tcp->send_ack) < 0) {
+	if (net_tcp_seq_cmp(seq, context->tcp->send_ack) < 0) {
 		/* Peer sent us packet we've already seen. Apparently,
 		 * our ack was lost.
 		 */
@@ -2015,13 +2967,26 @@ resend_ack:
 		return NET_DROP;
 	}
 
-	if (net_tcp_seq_cmp(sys_get_be32(tcp_hdr->seq),
-			    context->tcp->send_ack) > 0) {
-		/* Don't try to reorder packets.  If it doesn't
-		 * match the next segment exactly, drop and wait for
-		 * retransmit
+	if (net_tcp_seq_cmp(seq, context->tcp->send_ack) > 0) {
+		/* Hold it if there is room, and tell the peer about the
+		 * hole right away with a duplicate ACK (RFC 5681 4.2).
 		 */
-		return NET_DROP;
+		if (tcp_ooo_queue(context->tcp, pkt, tcp_hdr, data_len)) {
+			ret = NET_OK;
+		} else {
+			ret = NET_DROP;
+		}
+
+		send_ack(context, &conn->remote_addr, true);
+
+		return ret;
+	}
+
+	/* RFC 7323 4.3 */
+	if (tcp_opts.ts_ok &&
+	    net_tcp_seq_cmp(seq, context->tcp->sent_ack) <= 0 &&
+	    net_tcp_seq_cmp(tcp_opts.tsval, context->tcp->ts_recent) >= 0) {
+		context->tcp->ts_recent = tcp_opts.tsval;
 	}
 
 	/*
@@ -2056,6 +3021,8 @@ resend_ack:
 			return NET_DROP;
 		}
 
+		tcp_ack_update(context->tcp, tcp_hdr, &tcp_opts, data_len);
+
 		/* TCP state might be changed after maintaining the sent pkt
 		 * list, e.g., an ack of FIN is received.
 		 */
@@ -2065,7 +3032,8 @@ resend_ack:
 			/* Active close: step to FIN_WAIT_2 */
 			net_tcp_change_state(context->tcp, NET_TCP_FIN_WAIT_2);
 		} else if (net_tcp_get_state(context->tcp)
-			   == NET_TCP_LAST_ACK) {
+			   == NET_TCP_LAST_ACK &&
+			   sys_slist_is_empty(&context->tcp->sent_list)) {
 			/* Passive close: step to CLOSED */
 			net_tcp_change_state(context->tcp, NET_TCP_CLOSED);
 			/* Release the pkt before clean up */
@@ -2097,9 +3065,6 @@ resend_ack:
 		context->tcp->fin_rcvd = 1;
 	}
 
-	net_pkt_set_appdata_values(pkt, IPPROTO_TCP);
-
-	data_len = net_pkt_appdatalen(pkt);
 	if (data_len > net_tcp_get_recv_wnd(context->tcp)) {
 		/* In case we have zero window, we should still accept
 		 * Zero Window Probes from peer, which per convention
@@ -2133,6 +3098,8 @@ resend_ack:
 	context->tcp->send_ack += data_len;
 	if (tcp_flags & NET_TCP_FIN) {
 		context->tcp->send_ack += 1;
+	} else if (data_len > 0) {
+		tcp_ooo_deliver(conn, context->tcp);
 	}
 
 	send_ack(context, &conn->remote_addr, false);
@@ -2219,6 +3186,15 @@ NET_CONN_CB(tcp_synack_received)
 		 */
 		struct sockaddr local_addr;
 		struct sockaddr remote_addr;
+		struct net_tcp_options tcp_opts = {
+			.mss = NET_TCP_DEFAULT_MSS,
+		};
+
+		if (net_tcp_parse_opts(pkt, NET_TCP_HDR_LEN(tcp_hdr) -
+				       sizeof(struct net_tcp_hdr),
+				       &tcp_opts) < 0) {
+			return NET_DROP;
+		}
 
 		if (net_pkt_get_src_addr(
 			pkt, &remote_addr, sizeof(remote_addr)) < 0) {
@@ -2248,6 +3224,11 @@ NET_CONN_CB(tcp_synack_received)
 			return NET_DROP;
 		}
 
+		/* The window of a SYN-ACK is never scaled */
+		tcp_set_options(context->tcp, &tcp_opts);
+		tcp_established_init(context->tcp,
+				     sys_get_be16(tcp_hdr->wnd));
+
 		net_tcp_change_state(context->tcp, NET_TCP_ESTABLISHED);
 		net_context_set_state(context, NET_CONTEXT_CONNECTED);
 
@@ -2391,9 +3372,10 @@ NET_CONN_CB(tcp_syn_rcvd)
 		context->tcp->send_ack =
 			sys_get_be32(tcp_hdr->seq) + 1;
 
-		/* Get MSS from TCP options here*/
+		/* The SYN-ACK answers the options of the SYN */
+		tcp_set_options(tcp, &tcp_opts);
 
-		r = tcp_backlog_syn(pkt, context, tcp_opts.mss);
+		r = tcp_backlog_syn(pkt, context, &tcp_opts);
 		if (r < 0) {
 			if (r == -EADDRINUSE) {
 				NET_DBG("TCP connection already exists");
@@ -2505,6 +3487,14 @@ NET_CONN_CB(tcp_syn_rcvd)
 		 */
 		new_context->tcp->state = NET_TCP_ESTABLISHED;
 
+		/* The accepted connection uses the congestion control
+		 * set on the listening one.
+		 */
+		new_context->tcp->cc = tcp->cc;
+		tcp_established_init(new_context->tcp,
+				     (u32_t)sys_get_be16(tcp_hdr->wnd) <<
+				     new_context->tcp->send_wscale);
+
 		net_context_set_state(new_context, NET_CONTEXT_CONNECTED);
 
 		if (new_context->remote.sa_family == AF_INET) {
@@ -2649,3 +3639,42 @@ int net_tcp_connect(struct net_context *context,
 
 	return 0;
 }
+
+#if defined(CONFIG_NET_TEST)
+void net_tcp_set_options(struct net_tcp *tcp,
+			 const struct net_tcp_options *opts)
+{
+	tcp_set_options(tcp, opts);
+}
+
+void net_tcp_ack_update(struct net_tcp *tcp, struct net_tcp_hdr *tcp_hdr,
+			const struct net_tcp_options *opts, u32_t data_len)
+{
+	tcp_ack_update(tcp, tcp_hdr, opts, data_len);
+}
+
+void net_tcp_rtt_update(struct net_tcp *tcp, u32_t rtt)
+{
+	tcp_rtt_update(tcp, rtt);
+}
+
+#if defined(CONFIG_NET_TCP_SACK)
+bool net_tcp_ooo_queue(struct net_tcp *tcp, struct net_pkt *pkt)
+{
+	struct net_tcp_hdr hdr, *tcp_hdr;
+
+	tcp_hdr = net_tcp_get_hdr(pkt, &hdr);
+	if (!tcp_hdr) {
+		return false;
+	}
+
+	return tcp_ooo_queue(tcp, pkt, tcp_hdr, net_pkt_appdatalen(pkt));
+}
+
+void net_tcp_ooo_deliver(struct net_context *context)
+{
+	tcp_ooo_deliver((struct net_conn *)context->conn_handler,
+			context->tcp);
+}
+#endif /* CONFIG_NET_TCP_SACK */
+#endif /* CONFIG_NET_TEST */
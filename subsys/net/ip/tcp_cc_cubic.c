@@ -0,0 +1,167 @@
+/** @file
+ * @brief TCP CUBIC congestion control
+ *
+ * After a loss the window follows W(t) = C * (t - K)^3 + W_max (RFC 8312),
+ * so it climbs back quickly to where the loss happened, slowly around it,
+ * and probes faster again beyond it. The growth is never slower than
+ * what NewReno would do on the same path.
+ */
+
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define LOG_MODULE_NAME net_tcp_cubic
+#define NET_LOG_LEVEL CONFIG_NET_TCP_LOG_LEVEL
+
+#include <kernel.h>
+#include <string.h>
+#include <misc/util.h>
+
+#include "tcp_internal.h"
+
+/* Multiplicative decrease factor, 0.7, in 1/1024 */
+#define BETA 717
+
+/* Additive increase of the NewReno estimate, 3 * (1 - BETA) / (1 + BETA),
+ * in 1/1024 segments per window
+ */
+#define ALPHA 542
+
+/* Do not extrapolate the cubic function further than this, in ms */
+#define MAX_DELTA 100000
+
+struct cubic {
+	/* Window before the last reduction */
+	u32_t w_max;
+	/* Window the cubic function is centered on */
+	u32_t origin;
+	/* Start of the congestion avoidance epoch, 0 when there is none */
+	u32_t epoch;
+	/* Time to get back to origin, in ms */
+	u32_t k;
+	/* Window NewReno would have */
+	u32_t w_est;
+	/* Bytes acked since w_est last grew */
+	u32_t acked;
+};
+
+BUILD_ASSERT(sizeof(struct cubic) <=
+	     sizeof(((struct net_tcp *)0)->cc_data));
+
+#define cubic(tcp) ((struct cubic *)(tcp)->cc_data)
+
+static u32_t cube_root(u64_t a)
+{
+	u32_t lo = 0, hi = 1 << 21;
+
+	while (lo < hi) {
+		u32_t mid = (lo + hi + 1) / 2;
+
+		if ((u64_t)mid * mid * mid <= a) {
+			lo = mid;
+		} else {
+			hi = mid - 1;
+		}
+	}
+
+	return lo;
+}
+
+static void cubic_init(struct net_tcp *tcp)
+{
+	(void)memset(cubic(tcp), 0, sizeof(struct cubic));
+}
+
+static void cubic_epoch_start(struct net_tcp *tcp, u32_t now)
+{
+	struct cubic *c = cubic(tcp);
+
+	c->epoch = now ? now : 1;
+	c->w_est = tcp->cwnd;
+	c->acked = 0;
+
+	if (tcp->cwnd < c->w_max) {
+		/* K = cbrt((W_max - cwnd) / C) seconds, with C = 0.4
+		 * and the windows in segments
+		 */
+		c->k = cube_root((u64_t)(c->w_max - tcp->cwnd) *
+				 2500000000ULL / tcp->send_mss);
+		c->origin = c->w_max;
+	} else {
+		c->k = 0;
+		c->origin = tcp->cwnd;
+	}
+}
+
+static u32_t cubic_target(struct net_tcp *tcp, u32_t now)
+{
+	struct cubic *c = cubic(tcp);
+	s64_t delta, offset, target;
+
+	/* Where the window should be one round trip from now */
+	delta = (s64_t)(now - c->epoch) + (tcp->srtt >> 3) - c->k;
+	delta = max(min(delta, MAX_DELTA), -MAX_DELTA);
+
+	/* C * delta^3 segments, with C = 0.4 and delta in ms */
+	offset = delta * delta * delta / 1000 * 4 * tcp->send_mss / 10000000;
+	target = max((s64_t)c->origin + offset, 0);
+
+	/* RFC 8312 4.1, at most 1.5 * cwnd */
+	return min(target, (s64_t)tcp->cwnd + tcp->cwnd / 2);
+}
+
+static void cubic_ack(struct net_tcp *tcp, u32_t acked)
+{
+	struct cubic *c = cubic(tcp);
+	u32_t now = k_uptime_get_32();
+	u32_t target;
+
+	if (tcp->cwnd < tcp->ssthresh) {
+		tcp->cwnd += min(acked, 2 * tcp->send_mss);
+		return;
+	}
+
+	if (!c->epoch) {
+		cubic_epoch_start(tcp, now);
+	}
+
+	/* NewReno friendly region, RFC 8312 4.2 */
+	c->acked += acked;
+	if (c->acked >= tcp->cwnd) {
+		c->acked -= tcp->cwnd;
+		c->w_est += tcp->send_mss * ALPHA / 1024;
+	}
+
+	target = max(cubic_target(tcp, now), c->w_est);
+	if (target > tcp->cwnd) {
+		tcp->cwnd += (u64_t)(target - tcp->cwnd) * acked / tcp->cwnd;
+	}
+}
+
+static u32_t cubic_ssthresh(struct net_tcp *tcp)
+{
+	struct cubic *c = cubic(tcp);
+
+	c->epoch = 0;
+
+	/* Fast convergence, RFC 8312 4.6: leave room to a new flow by
+	 * not going back all the way if the window was still shrinking
+	 */
+	if (tcp->cwnd < c->w_max) {
+		c->w_max = (u64_t)tcp->cwnd * (1024 + BETA) / 2048;
+	} else {
+		c->w_max = tcp->cwnd;
+	}
+
+	return max((u64_t)tcp->cwnd * BETA / 1024, 2 * (u32_t)tcp->send_mss);
+}
+
+const struct net_tcp_cc net_tcp_cc_cubic = {
+	.name = "cubic",
+	.init = cubic_init,
+	.ack = cubic_ack,
+	.ssthresh = cubic_ssthresh,
+};
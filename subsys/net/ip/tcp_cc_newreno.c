@@ -0,0 +1,60 @@
+/** @file
+ * @brief TCP NewReno congestion control
+ *
+ * Slow start and congestion avoidance of RFC 5681, counting the bytes
+ * acknowledged as in RFC 3465. The fast recovery part of NewReno is
+ * common to all the algorithms and lives in tcp.c.
+ */
+
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define LOG_MODULE_NAME net_tcp_newreno
+#define NET_LOG_LEVEL CONFIG_NET_TCP_LOG_LEVEL
+
+#include <kernel.h>
+#include <misc/util.h>
+
+#include "tcp_internal.h"
+
+/* Bytes acknowledged since cwnd last grew in congestion avoidance */
+#define bytes_acked(tcp) ((tcp)->cc_data[0])
+
+static void newreno_init(struct net_tcp *tcp)
+{
+	bytes_acked(tcp) = 0;
+}
+
+static void newreno_ack(struct net_tcp *tcp, u32_t acked)
+{
+	if (tcp->cwnd < tcp->ssthresh) {
+		/* Slow start, with a limit of L = 2 * SMSS per ACK */
+		tcp->cwnd += min(acked, 2 * tcp->send_mss);
+		return;
+	}
+
+	/* Congestion avoidance, one SMSS per window of data acked */
+	bytes_acked(tcp) += acked;
+	if (bytes_acked(tcp) >= tcp->cwnd) {
+		bytes_acked(tcp) -= tcp->cwnd;
+		tcp->cwnd += tcp->send_mss;
+	}
+}
+
+static u32_t newreno_ssthresh(struct net_tcp *tcp)
+{
+	bytes_acked(tcp) = 0;
+
+	/* RFC 5681, equation (4) */
+	return max(net_tcp_flight_size(tcp) / 2, 2 * (u32_t)tcp->send_mss);
+}
+
+const struct net_tcp_cc net_tcp_cc_newreno = {
+	.name = "newreno",
+	.init = newreno_init,
+	.ack = newreno_ack,
+	.ssthresh = newreno_ssthresh,
+};
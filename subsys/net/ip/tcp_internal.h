@@ -29,7 +29,11 @@ extern "C" {
 /** Is this TCP context/socket used or not */
 #define NET_TCP_IN_USE BIT(0)
 
-/* BIT(1), BIT(2) are unused and available */
+/** SACK was negotiated at connection setup */
+#define NET_TCP_SACK_OK BIT(1)
+
+/** Timestamps were negotiated at connection setup */
+#define NET_TCP_TS_OK BIT(2)
 
 /** Is the socket shutdown for read/write */
 #define NET_TCP_IS_SHUTDOWN BIT(3)
@@ -40,6 +44,12 @@ extern "C" {
 /** MSS option has been set already */
 #define NET_TCP_RECV_MSS_SET BIT(5)
 
+/** Lost segments are being resent, see net_tcp.recover */
+#define NET_TCP_IN_RECOVERY BIT(6)
+
+/** A segment is being timed for a round trip time sample */
+#define NET_TCP_RTT_TIMING BIT(7)
+
 /*
  * TCP connection states
  */
@@ -83,23 +93,57 @@ enum net_tcp_state {
 /* Maximal value of the sequence number */
 #define NET_TCP_MAX_SEQ   0xffffffff
 
-#define NET_TCP_MAX_OPT_SIZE  8
+/* Room for the options of a data segment, i.e. the timestamps */
+#define NET_TCP_MAX_OPT_SIZE  12
+
+/* Room for the options of any segment */
+#define NET_TCP_MAX_OPT_LEN   40
 
 /* TCP Option codes */
 #define NET_TCP_END_OPT          0
 #define NET_TCP_NOP_OPT          1
 #define NET_TCP_MSS_OPT          2
 #define NET_TCP_WINDOW_SCALE_OPT 3
+#define NET_TCP_SACK_PERM_OPT    4
+#define NET_TCP_SACK_OPT         5
+#define NET_TCP_TIMESTAMP_OPT    8
 
 /* TCP Option sizes */
 #define NET_TCP_END_SIZE          1
 #define NET_TCP_NOP_SIZE          1
 #define NET_TCP_MSS_SIZE          4
 #define NET_TCP_WINDOW_SCALE_SIZE 3
+#define NET_TCP_SACK_PERM_SIZE    2
+#define NET_TCP_SACK_BLOCK_SIZE   8
+#define NET_TCP_TIMESTAMP_SIZE    10
+
+/* RFC 7323 2.3 "the shift count must be limited to 14" */
+#define NET_TCP_MAX_WINDOW_SCALE 14
+
+/* Max number of SACK blocks in an option, and on the scoreboard */
+#define NET_TCP_MAX_SACK 4
+
+/* Bounds of the retransmission timeout, in milliseconds */
+#define NET_TCP_MIN_RTO 200
+#define NET_TCP_MAX_RTO 60000
+
+/** Range of sequence numbers [start, end) */
+struct net_tcp_sack_block {
+	u32_t start;
+	u32_t end;
+};
 
 /** Parsed TCP option values for net_tcp_parse_opts()  */
 struct net_tcp_options {
 	u16_t mss;
+	u8_t window_scale;
+	u8_t sack_count;
+	bool window_scale_ok;
+	bool sack_perm;
+	bool ts_ok;
+	u32_t tsval;
+	u32_t tsecr;
+	struct net_tcp_sack_block sack[NET_TCP_MAX_SACK];
 };
 
 /* Max received bytes to buffer internally */
@@ -109,6 +153,41 @@ struct net_tcp_options {
 #define NET_TCP_MAX_SEG_LIFETIME 60
 
 struct net_context;
+struct net_tcp;
+
+/** Words of private state of a congestion control algorithm */
+#define NET_TCP_CC_DATA_SIZE 6
+
+/**
+ * Congestion control algorithm. Loss detection and recovery are the same
+ * for all of them, an algorithm only decides how the congestion window
+ * grows and how much it shrinks on loss.
+ */
+struct net_tcp_cc {
+	/** Name used to select the algorithm, see NET_OPT_TCP_CONGESTION */
+	const char *name;
+
+	/** Set up the private state once the connection is established,
+	 * cwnd and ssthresh have their initial values already.
+	 */
+	void (*init)(struct net_tcp *tcp);
+
+	/** Grow cwnd when @a acked new bytes are acknowledged outside of
+	 * loss recovery.
+	 */
+	void (*ack)(struct net_tcp *tcp, u32_t acked);
+
+	/** Loss was detected, return the new slow start threshold. */
+	u32_t (*ssthresh)(struct net_tcp *tcp);
+};
+
+/** NewReno, RFC 5681 and RFC 6582 */
+extern const struct net_tcp_cc net_tcp_cc_newreno;
+
+#if defined(CONFIG_NET_TCP_CC_CUBIC)
+/** CUBIC, RFC 8312 */
+extern const struct net_tcp_cc net_tcp_cc_cubic;
+#endif
 
 struct net_tcp {
 	/** Network context back pointer. */
@@ -141,6 +220,66 @@ struct net_tcp {
 	/** Last ACK value sent */
 	u32_t sent_ack;
 
+	/** Oldest unacknowledged sequence number */
+	u32_t send_una;
+
+	/** Next sequence number to transmit */
+	u32_t send_nxt;
+
+	/** Sequence number after the last one ever transmitted, ahead of
+	 * send_nxt while resending after a retransmission timeout.
+	 */
+	u32_t send_max;
+
+	/** Send window advertised by the peer, in bytes */
+	u32_t send_wnd;
+
+	/** Congestion window, in bytes */
+	u32_t cwnd;
+
+	/** Slow start threshold, in bytes */
+	u32_t ssthresh;
+
+	/** Value of send_max when loss recovery started */
+	u32_t recover;
+
+	/** Segments below this have been resent during recovery */
+	u32_t high_rxt;
+
+	/** Smoothed round trip time, in 1/8 milliseconds */
+	u32_t srtt;
+
+	/** Round trip time variation, in 1/4 milliseconds */
+	u32_t rttvar;
+
+	/** Retransmission timeout, in milliseconds */
+	u32_t rto;
+
+	/** End of the segment being timed, and when it was sent */
+	u32_t rtt_seq;
+	u32_t rtt_time;
+
+	/** Timestamp to echo to the peer */
+	u32_t ts_recent;
+
+	/** Congestion control algorithm and its private state */
+	const struct net_tcp_cc *cc;
+	u32_t cc_data[NET_TCP_CC_DATA_SIZE];
+
+#if defined(CONFIG_NET_TCP_SACK)
+	/** Ranges above send_una the peer reported as received */
+	struct net_tcp_sack_block sacked[NET_TCP_MAX_SACK];
+
+	/** Out of order segments received, in sequence number order */
+	sys_slist_t ooo_list;
+
+	/** Sequence number of the latest out of order segment */
+	u32_t ooo_last;
+
+	/** Number of segments in ooo_list */
+	u8_t ooo_count;
+#endif
+
 	/** Accept callback to be called when the connection has been
 	 * established.
 	 */
@@ -161,6 +300,13 @@ struct net_tcp {
 	 */
 	u16_t send_mss;
 
+	/** Window scale shift of the peer, and of our side */
+	u8_t send_wscale;
+	u8_t recv_wscale;
+
+	/** Duplicate ACKs received in a row */
+	u8_t dupacks;
+
 	/** Current retransmit period */
 	u32_t retry_timeout_shift : 5;
 	/** Flags for the TCP */
@@ -171,8 +317,10 @@ struct net_tcp {
 	u32_t fin_sent : 1;
 	/* An inbound FIN packet has been received */
 	u32_t fin_rcvd : 1;
+	/* Window scaling was negotiated at connection setup */
+	u32_t wscale_ok : 1;
 	/** Remaining bits in this u32_t */
-	u32_t _padding : 13;
+	u32_t _padding : 12;
 };
 
 typedef void (*net_tcp_cb_t)(struct net_tcp *tcp, void *user_data);
@@ -184,6 +332,18 @@ static inline bool net_tcp_is_used(struct net_tcp *tcp)
 	return tcp->flags & NET_TCP_IN_USE;
 }
 
+/**
+ * @brief Bytes sent and not acknowledged yet
+ *
+ * @param tcp TCP context
+ *
+ * @return Flight size in bytes
+ */
+static inline u32_t net_tcp_flight_size(const struct net_tcp *tcp)
+{
+	return tcp->send_nxt - tcp->send_una;
+}
+
 /**
  * @brief Register a callback to be called when TCP packet
  * is received corresponding to received packet.
@@ -424,8 +584,7 @@ u16_t net_tcp_get_chksum(struct net_pkt *pkt, struct net_buf *frag);
 /**
  * @brief Parse TCP options from network packet.
  *
- * Parse TCP options, returning MSS value (as that the only one we
- * handle so far).
+ * Parse the MSS, window scale, SACK and timestamp options.
  *
  * @param pkt Network packet
  * @param opt_totlen Total length of options to parse
@@ -494,6 +653,26 @@ int net_tcp_listen(struct net_context *context);
  */
 int net_tcp_update_recv_wnd(struct net_context *context, s32_t delta);
 
+/**
+ * @brief Select the congestion control algorithm of a connection
+ *
+ * @param context Network context
+ * @param name Name of the algorithm, e.g. "newreno" or "cubic"
+ *
+ * @return 0 on success, -ENOENT if no such algorithm is built in,
+ *         -EPROTOTYPE if there is no TCP context
+ */
+int net_tcp_set_cc(struct net_context *context, const char *name);
+
+/**
+ * @brief Get the congestion control algorithm of a connection
+ *
+ * @param context Network context
+ *
+ * @return Name of the algorithm, NULL if there is no TCP context
+ */
+const char *net_tcp_get_cc(struct net_context *context);
+
 /**
  * @brief Initialize TCP parts of a context
  *
@@ -733,6 +912,22 @@ static inline int net_tcp_update_recv_wnd(struct net_context *context,
 	return -EPROTONOSUPPORT;
 }
 
+static inline int net_tcp_set_cc(struct net_context *context,
+				 const char *name)
+{
+	ARG_UNUSED(context);
+	ARG_UNUSED(name);
+
+	return -EPROTONOSUPPORT;
+}
+
+static inline const char *net_tcp_get_cc(struct net_context *context)
+{
+	ARG_UNUSED(context);
+
+	return NULL;
+}
+
 static inline int net_tcp_get(struct net_context *context)
 {
 	ARG_UNUSED(context);
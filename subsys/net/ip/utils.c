@@ -390,31 +390,92 @@ int net_addr_pton(sa_family_t family, const char *src,
 	return 0;
 }
 
-static u16_t calc_chksum(u16_t sum, const u8_t *ptr, u16_t len)
+typedef u16_t __may_alias chksum_u16_t;
+typedef u32_t __may_alias chksum_u32_t;
+
+/* Add with the end around carry of one's complement sums */
+static inline u16_t chksum_add(u16_t sum, u16_t val)
 {
-	u16_t tmp;
-	const u8_t *end;
+	sum += val;
+	if (sum < val) {
+		sum++;
+	}
+
+	return sum;
+}
 
-	end = ptr + len - 1;
+/* One's complement sum of the 16 bit words of a block, as they are in
+ * memory, i.e. in network byte order. The block is summed 32 bits at a
+ * time into a 64 bit accumulator, which no packet can overflow, and the
+ * sum is folded to 16 bits at the end.
+ */
+static u16_t chksum_block(const u8_t *ptr, u16_t len)
+{
+	const chksum_u32_t *ptr32;
+	bool odd = false;
+	u64_t acc = 0;
 
-	while (ptr < end) {
-		tmp = (ptr[0] << 8) + ptr[1];
-		sum += tmp;
-		if (sum < tmp) {
-			sum++;
-		}
+	if (len == 0) {
+		return 0;
+	}
+
+	/* Sum a block at an odd address as if it started one byte earlier
+	 * with a zero. This byte swaps the sum, so swap it back at the end.
+	 */
+	if ((uintptr_t)ptr & 1) {
+		acc = htons(*ptr);
+		odd = true;
+		ptr++;
+		len--;
+	}
+
+	if (((uintptr_t)ptr & 2) && len >= 2) {
+		acc += *(const chksum_u16_t *)ptr;
 		ptr += 2;
+		len -= 2;
 	}
 
-	if (ptr == end) {
-		tmp = ptr[0] << 8;
-		sum += tmp;
-		if (sum < tmp) {
-			sum++;
-		}
+	ptr32 = (const chksum_u32_t *)ptr;
+
+	for (; len >= 16; len -= 16) {
+		acc += ptr32[0];
+		acc += ptr32[1];
+		acc += ptr32[2];
+		acc += ptr32[3];
+		ptr32 += 4;
 	}
 
-	return sum;
+	for (; len >= 4; len -= 4) {
+		acc += *ptr32++;
+	}
+
+	ptr = (const u8_t *)ptr32;
+
+	if (len >= 2) {
+		acc += *(const chksum_u16_t *)ptr;
+		ptr += 2;
+		len -= 2;
+	}
+
+	if (len) {
+		acc += htons(*ptr << 8);
+	}
+
+	acc = (acc & 0xffffffff) + (acc >> 32);
+	acc = (acc & 0xffffffff) + (acc >> 32);
+	acc = (acc & 0xffff) + (acc >> 16);
+	acc = (acc & 0xffff) + (acc >> 16);
+
+	if (odd) {
+		acc = __bswap_16((u16_t)acc);
+	}
+
+	return (u16_t)acc;
+}
+
+static u16_t calc_chksum(u16_t sum, const u8_t *ptr, u16_t len)
+{
+	return chksum_add(sum, ntohs(chksum_block(ptr, len)));
 }
 
 static inline u16_t calc_chksum_pkt(u16_t sum, struct net_pkt *pkt,
@@ -423,7 +484,9 @@ static inline u16_t calc_chksum_pkt(u16_t sum, struct net_pkt *pkt,
 	u16_t proto_len = net_pkt_ip_hdr_len(pkt) +
 		net_pkt_ipv6_ext_len(pkt);
 	struct net_buf *frag;
+	bool odd = false;
 	u16_t offset;
+	u16_t part;
 	s16_t len;
 	u8_t *ptr;
 
@@ -442,26 +505,21 @@ static inline u16_t calc_chksum_pkt(u16_t sum, struct net_pkt *pkt,
 	len = frag->len - offset;
 
 	while (frag) {
-		sum = calc_chksum(sum, ptr, len);
+		part = ntohs(chksum_block(ptr, len));
+
+		/* Fragments starting at an odd offset of the data have
+		 * their bytes the other way around in the checksum words
+		 */
+		sum = chksum_add(sum, odd ? __bswap_16(part) : part);
+		odd ^= len & 1;
+
 		frag = frag->frags;
 		if (!frag) {
 			break;
 		}
 
 		ptr = frag->data;
-
-		/* Do we need to take first byte from next fragment */
-		if (len % 2) {
-			u16_t tmp = *ptr;
-			sum += tmp;
-			if (sum < tmp) {
-				sum++;
-			}
-			len = frag->len - 1;
-			ptr++;
-		} else {
-			len = frag->len;
-		}
+		len = frag->len;
 	}
 
 	return sum;
@@ -380,5 +380,5 @@ static int init_net_app(struct device *device)
 	return ret;
 }
 
-SYS_INIT(init_net_app, APPLICATION, CONFIG_NET_CONFIG_INIT_PRIO);
+SYS_INIT_PARALLEL(init_net_app, APPLICATION, CONFIG_NET_CONFIG_INIT_PRIO);
 #endif /* CONFIG_NET_CONFIG_AUTO_INIT */
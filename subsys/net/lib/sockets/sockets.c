@@ -822,6 +822,22 @@ Z_SYSCALL_HANDLER(zsock_poll, fds, nfds, timeout)
 }
 #endif
 
+int zsock_poll_set_add(struct k_poll_set *set, struct k_poll_set_event *event,
+		       int sock)
+{
+	struct net_context *ctx = sock_to_net_ctx(sock);
+
+	if (ctx == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	k_poll_event_init(&event->event, K_POLL_TYPE_FIFO_DATA_AVAILABLE,
+			  K_POLL_MODE_NOTIFY_ONLY, &ctx->recv_q);
+
+	return k_poll_set_add(set, event);
+}
+
 int _impl_zsock_inet_pton(sa_family_t family, const char *src, void *dst)
 {
 	if (net_addr_pton(family, src, dst) == 0) {
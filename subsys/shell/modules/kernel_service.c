@@ -12,6 +12,7 @@
 #include <misc/reboot.h>
 #include <misc/stack.h>
 #include <string.h>
+#include <stdlib.h>
 #include <device.h>
 
 static int cmd_kernel_version(const struct shell *shell,
@@ -98,10 +99,19 @@ static void shell_stack_dump(const struct k_thread *thread, void *user_data)
 	unsigned int pcnt, unused = 0;
 	unsigned int size = thread->stack_info.size;
 	const char *tname;
+#if defined(CONFIG_STACK_WATERMARK)
+	struct k_thread_stack_usage usage;
+#endif
 
 	tname = k_thread_name_get((struct k_thread *)thread);
+#if defined(CONFIG_STACK_WATERMARK)
+	/* only scans the part of the stack not known to be used yet */
+	k_thread_stack_usage_get((k_tid_t)thread, &usage);
+	unused = usage.size - usage.max_used;
+#else
 	unused = stack_unused_space_get((char *)thread->stack_info.start,
 					size);
+#endif
 
 	/* Calculate the real size reserved for the stack */
 	pcnt = ((size - unused) * 100) / size;
@@ -123,6 +133,211 @@ static int cmd_kernel_stacks(const struct shell *shell,
 }
 #endif
 
+#if defined(CONFIG_MEM_SLAB_STATS)
+extern struct k_mem_slab _k_mem_slab_list_start[];
+extern struct k_mem_slab _k_mem_slab_list_end[];
+
+static int cmd_kernel_slabs(const struct shell *shell,
+			    size_t argc, char **argv)
+{
+	struct k_mem_slab *slab;
+	struct k_mem_slab_stats stats;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "%-10s %6s %6s %6s %6s %10s %10s\r\n",
+		      "slab", "size", "blocks", "used", "max", "exhausted",
+		      "shared");
+
+	for (slab = _k_mem_slab_list_start; slab < _k_mem_slab_list_end;
+	     slab++) {
+		k_mem_slab_stats_get(slab, &stats);
+		shell_fprintf(shell, SHELL_NORMAL,
+			      "%p %6u %6u %6u %6u %10u %10u\r\n",
+			      slab, (u32_t)slab->block_size, slab->num_blocks,
+			      k_mem_slab_num_used_get(slab), stats.max_used,
+			      stats.num_exhausted, stats.num_shared);
+	}
+
+	return 0;
+}
+#endif
+
+#if defined(CONFIG_WORKQUEUE_STATS)
+static int cmd_kernel_work(const struct shell *shell,
+			   size_t argc, char **argv)
+{
+	struct k_work_handler_stats stats[CONFIG_WORKQUEUE_STATS_HANDLERS];
+	int n;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	n = k_work_handler_stats_get(stats, ARRAY_SIZE(stats));
+
+	shell_fprintf(shell, SHELL_NORMAL, "%-10s %10s %10s %10s\r\n",
+		      "handler", "runs", "max us", "avg us");
+
+	for (int i = 0; i < n; i++) {
+		u64_t avg = stats[i].total_cycles / stats[i].count;
+		u32_t max_us = SYS_CLOCK_HW_CYCLES_TO_NS64(
+			stats[i].max_cycles) / NSEC_PER_USEC;
+		u32_t avg_us = SYS_CLOCK_HW_CYCLES_TO_NS64(avg) /
+			NSEC_PER_USEC;
+
+		shell_fprintf(shell, SHELL_NORMAL, "%p %10u %10u %10u\r\n",
+			      (void *)stats[i].handler, stats[i].count,
+			      max_us, avg_us);
+	}
+
+	return 0;
+}
+#endif
+
+#if defined(CONFIG_TIMER_COALESCING)
+static int cmd_kernel_wakeups(const struct shell *shell,
+			      size_t argc, char **argv)
+{
+	struct k_wakeup_stats stats;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	k_wakeup_stats_get(&stats);
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "Timer wakeups: %u, saved by coalescing: %u\r\n",
+		      stats.timer_wakeups, stats.wakeups_saved);
+
+	return 0;
+}
+#endif
+
+#if defined(CONFIG_THREAD_RUNTIME_STATS) && defined(CONFIG_THREAD_MONITOR)
+#define TOP_MAX_THREADS 32
+
+struct top_sample {
+	struct {
+		const struct k_thread *thread;
+		u64_t cycles;
+	} threads[TOP_MAX_THREADS];
+	int count;
+	u64_t total;
+};
+
+static struct top_sample top_samples[2];
+
+static void top_collect(const struct k_thread *thread, void *user_data)
+{
+	struct top_sample *sample = user_data;
+	struct k_thread_runtime_stats stats;
+
+	if (sample->count == TOP_MAX_THREADS) {
+		return;
+	}
+
+	k_thread_runtime_stats_get((k_tid_t)thread, &stats);
+	sample->threads[sample->count].thread = thread;
+	sample->threads[sample->count].cycles = stats.execution_cycles;
+	sample->count++;
+}
+
+static void top_take(struct top_sample *sample)
+{
+	struct k_thread_runtime_stats stats;
+
+	sample->count = 0;
+	k_thread_foreach(top_collect, sample);
+	k_thread_runtime_stats_all_get(&stats);
+	sample->total = stats.execution_cycles;
+}
+
+static void top_print(const struct shell *shell, struct top_sample *prev,
+		      struct top_sample *cur)
+{
+	u64_t elapsed = cur->total - prev->total;
+	struct k_load_avg avg;
+
+	k_load_avg_get(&avg);
+
+	/* cursor home, clear screen */
+	shell_fprintf(shell, SHELL_NORMAL, "\033[H\033[2J");
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "Uptime: %u ms, load: %u.%u%% %u.%u%% %u.%u%%, "
+		      "isr: %u.%u%%\r\n\n",
+		      k_uptime_get_32(),
+		      avg.load[0] / 10, avg.load[0] % 10,
+		      avg.load[1] / 10, avg.load[1] % 10,
+		      avg.load[2] / 10, avg.load[2] % 10,
+		      avg.isr / 10, avg.isr % 10);
+	shell_fprintf(shell, SHELL_NORMAL, "%-10s %-16s %5s %6s %10s\r\n",
+		      "thread", "name", "prio", "cpu %", "time ms");
+
+	for (int i = 0; i < cur->count; i++) {
+		const struct k_thread *thread = cur->threads[i].thread;
+		u64_t cycles = cur->threads[i].cycles;
+		u64_t delta = cycles;
+		const char *tname;
+		u32_t permille;
+
+		for (int j = 0; j < prev->count; j++) {
+			if (prev->threads[j].thread == thread) {
+				delta -= prev->threads[j].cycles;
+				break;
+			}
+		}
+
+		permille = elapsed ? (u32_t)(delta * 1000 / elapsed) : 0;
+		tname = k_thread_name_get((struct k_thread *)thread);
+
+		shell_fprintf(shell, SHELL_NORMAL,
+			      "%p %-16s %5d %4u.%u %10u\r\n",
+			      thread, tname ? tname : "NA", thread->base.prio,
+			      permille / 10, permille % 10,
+			      (u32_t)(cycles * MSEC_PER_SEC /
+				      sys_clock_hw_cycles_per_sec()));
+	}
+}
+
+static int cmd_kernel_top(const struct shell *shell,
+			  size_t argc, char **argv)
+{
+	struct top_sample *prev = &top_samples[0];
+	struct top_sample *cur = &top_samples[1];
+	int count = 10;
+	int interval = 1000;
+
+	if (argc > 1) {
+		count = strtol(argv[1], NULL, 10);
+	}
+	if (argc > 2) {
+		interval = strtol(argv[2], NULL, 10);
+	}
+	if (count <= 0 || interval <= 0) {
+		shell_fprintf(shell, SHELL_ERROR,
+			      "Usage: kernel top [count] [interval ms]\r\n");
+		return -EINVAL;
+	}
+
+	top_take(prev);
+
+	while (count--) {
+		struct top_sample *tmp;
+
+		k_sleep(interval);
+		top_take(cur);
+		top_print(shell, prev, cur);
+
+		tmp = prev;
+		prev = cur;
+		cur = tmp;
+	}
+
+	return 0;
+}
+#endif
+
 #if defined(CONFIG_REBOOT)
 static int cmd_kernel_reboot_warm(const struct shell *shell,
 				  size_t argc, char **argv)
@@ -158,13 +373,27 @@ SHELL_CREATE_STATIC_SUBCMD_SET(sub_kernel)
 #if defined(CONFIG_REBOOT)
 	SHELL_CMD(reboot, &sub_kernel_reboot, "Reboot.", NULL),
 #endif
+#if defined(CONFIG_MEM_SLAB_STATS)
+	SHELL_CMD(slabs, NULL, "List memory slab usage.", cmd_kernel_slabs),
+#endif
 #if defined(CONFIG_INIT_STACKS) && defined(CONFIG_THREAD_MONITOR) \
 				&& defined(CONFIG_THREAD_STACK_INFO)
 	SHELL_CMD(stacks, NULL, "List threads stack usage.", cmd_kernel_stacks),
 	SHELL_CMD(threads, NULL, "List kernel threads.", cmd_kernel_threads),
+#endif
+#if defined(CONFIG_THREAD_RUNTIME_STATS) && defined(CONFIG_THREAD_MONITOR)
+	SHELL_CMD(top, NULL,
+		  "Thread CPU usage: [count] [interval ms].",
+		  cmd_kernel_top),
 #endif
 	SHELL_CMD(uptime, NULL, "Kernel uptime.", cmd_kernel_uptime),
 	SHELL_CMD(version, NULL, "Kernel version.", cmd_kernel_version),
+#if defined(CONFIG_TIMER_COALESCING)
+	SHELL_CMD(wakeups, NULL, "Timer wakeup statistics.", cmd_kernel_wakeups),
+#endif
+#if defined(CONFIG_WORKQUEUE_STATS)
+	SHELL_CMD(work, NULL, "List slowest work handlers.", cmd_kernel_work),
+#endif
 	SHELL_SUBCMD_SET_END /* Array terminated. */
 };
 
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ *
+ * @brief Benchmark harness
+ *
+ * Collects timing samples of an operation and reports their minimum,
+ * mean, standard deviation, percentiles and maximum, as a table or as
+ * JSON or CSV lines that scripts can track over time.
+ */
+
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <zephyr.h>
+#include <test_asm_inline_gcc.h>
+
+#ifdef CONFIG_BENCH_CLOCK_HOST
+#include <native_perf.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup bench Benchmark harness
+ * @ingroup all_tests
+ * @{
+ */
+
+/**
+ * @brief Timestamp, or time between two timestamps, in clock counts
+ *
+ * The clock is 32 bits wide, the difference of two timestamps is correct
+ * as long as less than 2^32 counts separate them.
+ */
+typedef u32_t bench_time_t;
+
+/**
+ * @brief A benchmark
+ *
+ * Holds the samples of one measured operation. Define one with
+ * BENCH_DEFINE().
+ */
+struct bench {
+	/** name to report the results under */
+	const char *name;
+	/** sample storage */
+	bench_time_t *samples;
+	/** number of samples to collect */
+	u32_t size;
+	/** number of samples collected */
+	u32_t count;
+	/** number of samples to discard before collecting any */
+	u32_t warmup;
+	/** number of samples discarded so far */
+	u32_t discarded;
+	/** number of operations each sample measures */
+	u32_t ops;
+};
+
+/**
+ * @brief Results of a benchmark, in nanoseconds per operation
+ */
+struct bench_stats {
+	u32_t count;
+	u32_t min;
+	u32_t mean;
+	u32_t stddev;
+	u32_t p50;
+	u32_t p90;
+	u32_t p99;
+	u32_t max;
+};
+
+/**
+ * @brief Statically define and initialize a benchmark
+ *
+ * @param _name Name of the benchmark, also reported with the results.
+ * @param _size Number of samples to collect.
+ * @param _warmup Number of samples to discard first.
+ * @param _ops Number of operations each sample measures.
+ */
+#define BENCH_DEFINE(_name, _size, _warmup, _ops)			\
+	static bench_time_t _CONCAT(_name, _samples)[_size];		\
+	static struct bench _name = {					\
+		.name = #_name,						\
+		.samples = _CONCAT(_name, _samples),			\
+		.size = (_size),					\
+		.warmup = (_warmup),					\
+		.ops = (_ops),						\
+	}
+
+/**
+ * @brief Read the benchmark clock
+ *
+ * The clock is the kernel's hardware cycle counter, or on native_posix
+ * optionally the host performance counter, which unlike the simulated
+ * cycle counter follows the time code takes to run.
+ *
+ * @return Timestamp
+ */
+static inline bench_time_t bench_time_get(void)
+{
+	/* keep the clock read from moving across the measured code */
+	timestamp_serialize();
+
+#ifdef CONFIG_BENCH_CLOCK_HOST
+	return (bench_time_t)native_perf_counter_get();
+#else
+	return k_cycle_get_32();
+#endif
+}
+
+/**
+ * @brief Convert clock counts to nanoseconds
+ *
+ * @param t Clock counts
+ *
+ * @return Nanoseconds
+ */
+u64_t bench_time_to_ns(u64_t t);
+
+/**
+ * @brief Discard the samples of a benchmark
+ *
+ * @param b Benchmark
+ */
+void bench_reset(struct bench *b);
+
+/**
+ * @brief Add a sample to a benchmark
+ *
+ * The time it takes to read the clock is deducted from the sample. Samples
+ * beyond the size of the benchmark are ignored.
+ *
+ * @param b Benchmark
+ * @param t Time between two bench_time_get() timestamps
+ *
+ * @return true if the benchmark needs more samples
+ */
+bool bench_sample_add(struct bench *b, bench_time_t t);
+
+/**
+ * @brief Operation measured by bench_run()
+ *
+ * @param arg Argument given to bench_run()
+ */
+typedef void (*bench_fn_t)(void *arg);
+
+/**
+ * @brief Collect all the samples of a benchmark
+ *
+ * Each sample times @a ops calls of @a fn, including the call overhead.
+ *
+ * @param b Benchmark
+ * @param fn Operation to measure
+ * @param arg Argument to pass to @a fn
+ */
+void bench_run(struct bench *b, bench_fn_t fn, void *arg);
+
+/**
+ * @brief Compute the results of a benchmark
+ *
+ * Sorts the samples of the benchmark.
+ *
+ * @param b Benchmark
+ * @param stats Results
+ *
+ * @retval 0 on success
+ * @retval -ENODATA if the benchmark has no sample
+ */
+int bench_stats_get(struct bench *b, struct bench_stats *stats);
+
+/**
+ * @brief Print the results of a benchmark
+ *
+ * Prints them in the format selected with CONFIG_BENCH_OUTPUT_*. The
+ * first report also prints a header describing the columns.
+ *
+ * @param b Benchmark
+ */
+void bench_report(struct bench *b);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BENCH_H__ */
@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <bench.h>
+#include <tc_util.h>
+#include <errno.h>
+
+/* reads of the clock used to find out how long a read takes */
+#define CALIBRATION_READS 16
+
+#if defined(CONFIG_BENCH_CLOCK_HOST)
+#define CLOCK_NAME "host"
+#else
+#define CLOCK_NAME "cycle"
+#endif
+
+/* time to read the clock, deducted from every sample */
+static bench_time_t overhead;
+static bool calibrated;
+
+#if !defined(CONFIG_BENCH_OUTPUT_JSON)
+static bool header_printed;
+#endif
+
+static void calibrate(void)
+{
+	bench_time_t t;
+
+	overhead = UINT32_MAX;
+	for (int i = 0; i < CALIBRATION_READS; i++) {
+		t = bench_time_get();
+		t = bench_time_get() - t;
+		overhead = min(overhead, t);
+	}
+
+	calibrated = true;
+}
+
+u64_t bench_time_to_ns(u64_t t)
+{
+#if defined(CONFIG_BENCH_CLOCK_HOST)
+	return t * NSEC_PER_SEC / native_perf_counter_freq_get();
+#else
+	return SYS_CLOCK_HW_CYCLES_TO_NS64(t);
+#endif
+}
+
+void bench_reset(struct bench *b)
+{
+	b->count = 0;
+	b->discarded = 0;
+}
+
+bool bench_sample_add(struct bench *b, bench_time_t t)
+{
+	if (!calibrated) {
+		calibrate();
+	}
+
+	if (b->discarded < b->warmup) {
+		b->discarded++;
+	} else if (b->count < b->size) {
+		b->samples[b->count++] = t > overhead ? t - overhead : 0;
+	}
+
+	return b->count < b->size;
+}
+
+void bench_run(struct bench *b, bench_fn_t fn, void *arg)
+{
+	bench_time_t start;
+
+	do {
+		start = bench_time_get();
+		for (u32_t i = 0; i < b->ops; i++) {
+			fn(arg);
+		}
+	} while (bench_sample_add(b, bench_time_get() - start));
+}
+
+static void sort(bench_time_t *v, u32_t n)
+{
+	/* Shell sort, with Ciura's gaps */
+	static const u32_t gaps[] = { 701, 301, 132, 57, 23, 10, 4, 1 };
+
+	for (int g = 0; g < ARRAY_SIZE(gaps); g++) {
+		u32_t gap = gaps[g];
+
+		for (u32_t i = gap; i < n; i++) {
+			bench_time_t t = v[i];
+			u32_t j;
+
+			for (j = i; j >= gap && v[j - gap] > t; j -= gap) {
+				v[j] = v[j - gap];
+			}
+			v[j] = t;
+		}
+	}
+}
+
+static u32_t sqrt_u64(u64_t x)
+{
+	u64_t res = 0;
+	u64_t bit = 1ULL << 62;
+
+	while (bit > x) {
+		bit >>= 2;
+	}
+
+	while (bit != 0) {
+		if (x >= res + bit) {
+			x -= res + bit;
+			res = (res >> 1) + bit;
+		} else {
+			res >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return (u32_t)res;
+}
+
+/* nearest-rank percentile of sorted samples */
+static bench_time_t percentile(struct bench *b, u32_t p)
+{
+	u32_t rank = (p * b->count + 99) / 100;
+
+	return b->samples[max(rank, 1) - 1];
+}
+
+static u32_t to_ns(struct bench *b, u64_t t)
+{
+	return (u32_t)(bench_time_to_ns(t) / max(b->ops, 1));
+}
+
+int bench_stats_get(struct bench *b, struct bench_stats *stats)
+{
+	u64_t sum = 0, var = 0;
+	u32_t mean;
+
+	if (b->count == 0) {
+		return -ENODATA;
+	}
+
+	sort(b->samples, b->count);
+
+	for (u32_t i = 0; i < b->count; i++) {
+		sum += b->samples[i];
+	}
+	mean = (u32_t)(sum / b->count);
+
+	for (u32_t i = 0; i < b->count; i++) {
+		s64_t d = (s64_t)b->samples[i] - mean;
+
+		var += (u64_t)(d * d) / b->count;
+	}
+
+	stats->count = b->count;
+	stats->min = to_ns(b, b->samples[0]);
+	stats->mean = to_ns(b, mean);
+	stats->stddev = to_ns(b, sqrt_u64(var));
+	stats->p50 = to_ns(b, percentile(b, 50));
+	stats->p90 = to_ns(b, percentile(b, 90));
+	stats->p99 = to_ns(b, percentile(b, 99));
+	stats->max = to_ns(b, b->samples[b->count - 1]);
+
+	return 0;
+}
+
+void bench_report(struct bench *b)
+{
+	struct bench_stats s;
+
+	if (bench_stats_get(b, &s) != 0) {
+		TC_PRINT("%s: no samples\n", b->name);
+		return;
+	}
+
+#if defined(CONFIG_BENCH_OUTPUT_JSON)
+	TC_PRINT("{\"name\":\"%s\",\"clock\":\"" CLOCK_NAME "\","
+		 "\"unit\":\"ns\",\"samples\":%u,\"min\":%u,\"mean\":%u,"
+		 "\"stddev\":%u,\"p50\":%u,\"p90\":%u,\"p99\":%u,"
+		 "\"max\":%u}\n", b->name, s.count, s.min, s.mean, s.stddev,
+		 s.p50, s.p90, s.p99, s.max);
+#elif defined(CONFIG_BENCH_OUTPUT_CSV)
+	if (!header_printed) {
+		TC_PRINT("name,clock,unit,samples,min,mean,stddev,"
+			 "p50,p90,p99,max\n");
+		header_printed = true;
+	}
+	TC_PRINT("%s," CLOCK_NAME ",ns,%u,%u,%u,%u,%u,%u,%u,%u\n", b->name,
+		 s.count, s.min, s.mean, s.stddev, s.p50, s.p90, s.p99,
+		 s.max);
+#else
+	if (!header_printed) {
+		TC_PRINT("ns per operation, " CLOCK_NAME " clock\n");
+		TC_PRINT("%-28s %7s %8s %8s %8s %8s %8s %8s %8s\n", "name",
+			 "samples", "min", "mean", "stddev", "p50", "p90",
+			 "p99", "max");
+		header_printed = true;
+	}
+	TC_PRINT("%-28s %7u %8u %8u %8u %8u %8u %8u %8u\n", b->name,
+		 s.count, s.min, s.mean, s.stddev, s.p50, s.p90, s.p99,
+		 s.max);
+#endif
+}
@@ -0,0 +1,136 @@
+/* fifo_burst_b.c */
+
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "master.h"
+
+#ifdef FIFO_BURST_BENCH
+
+#define BURST_RCV_PRIO 5
+#define BURST_RCV_STACK_SIZE 1024
+
+struct burst_item {
+	void *fifo_reserved;
+	u32_t data;
+};
+
+static struct burst_item burst_items[FIFO_BURST_SIZE];
+static void *burst_ptrs[FIFO_BURST_SIZE];
+
+static struct k_thread burst_rcv;
+static K_THREAD_STACK_DEFINE(burst_rcv_stack, BURST_RCV_STACK_SIZE);
+
+/**
+ *
+ * @brief Drain DEMOFIFO, one burst at a time
+ *
+ * @return N/A
+ */
+static void burst_rcv_task(void *p1, void *p2, void *p3)
+{
+	int runs = (int)p1;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (int i = 0; i < runs * FIFO_BURST_SIZE; i++) {
+		k_fifo_get(&DEMOFIFO, K_FOREVER);
+	}
+}
+
+static void put_burst_single(void)
+{
+	for (int j = 0; j < FIFO_BURST_SIZE; j++) {
+		k_fifo_put(&DEMOFIFO, burst_ptrs[j]);
+	}
+}
+
+static void put_burst_batch(void)
+{
+	k_fifo_put_batch(&DEMOFIFO, burst_ptrs, FIFO_BURST_SIZE);
+}
+
+static void drain(void)
+{
+	while (k_fifo_get(&DEMOFIFO, K_NO_WAIT) != NULL) {
+	}
+}
+
+/**
+ *
+ * @brief Time NR_OF_FIFO_RUNS bursts, without and with a waiting receiver
+ *
+ * Results are reported per item.
+ *
+ * @return N/A
+ */
+static void burst_run(void (*put)(void), const char *how)
+{
+	u32_t et; /* elapsed time */
+	char label[64];
+	int i;
+
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
+		put();
+		drain();
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+
+	snprintf(label, sizeof(label), "%s and get", how);
+	PRINT_F(output_file, FORMAT, label,
+		SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et,
+					      NR_OF_FIFO_RUNS *
+					      FIFO_BURST_SIZE));
+
+	/* The receiver has higher priority, so it has drained each
+	 * burst before put() returns and the items can be reused.  It
+	 * exits once it has received every burst.
+	 */
+	k_thread_create(&burst_rcv, burst_rcv_stack,
+			K_THREAD_STACK_SIZEOF(burst_rcv_stack),
+			burst_rcv_task, (void *)NR_OF_FIFO_RUNS, NULL, NULL,
+			BURST_RCV_PRIO, 0, K_NO_WAIT);
+
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
+		put();
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+
+	snprintf(label, sizeof(label), "%s to waiting high pri task", how);
+	PRINT_F(output_file, FORMAT, label,
+		SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et,
+					      NR_OF_FIFO_RUNS *
+					      FIFO_BURST_SIZE));
+}
+
+/**
+ *
+ * @brief FIFO burst throughput test
+ *
+ * Enqueues bursts of FIFO_BURST_SIZE items, as a driver ISR receiving
+ * several packets at once would, first one k_fifo_put() per item and
+ * then with a single k_fifo_put_batch() per burst.
+ *
+ * @return N/A
+ */
+void fifo_burst_test(void)
+{
+	for (int i = 0; i < FIFO_BURST_SIZE; i++) {
+		burst_items[i].data = i;
+		burst_ptrs[i] = &burst_items[i];
+	}
+
+	PRINT_STRING(dashline, output_file);
+	burst_run(put_burst_single, "put " STRINGIFY(FIFO_BURST_SIZE)
+		  " items one by one in FIFO");
+	burst_run(put_burst_batch, "batch put " STRINGIFY(FIFO_BURST_SIZE)
+		  " items in FIFO");
+}
+
+#endif /* FIFO_BURST_BENCH */
@@ -44,6 +44,8 @@ K_MSGQ_DEFINE(DEMOQX4, 4, 500, 4);
 K_MSGQ_DEFINE(MB_COMM, 12, 1, 4);
 K_MSGQ_DEFINE(CH_COMM, 12, 1, 4);
 
+K_FIFO_DEFINE(DEMOFIFO);
+
 K_MEM_SLAB_DEFINE(MAP1, 16, 2, 4);
 
 K_SEM_DEFINE(SEM0, 0, 1);
@@ -134,6 +136,7 @@ void main(void)
 					 output_file);
 		PRINT_STRING(dashline, output_file);
 		queue_test();
+		fifo_burst_test();
 		sema_test();
 		mutex_test();
 		memorymap_test();
@@ -41,6 +41,7 @@
 		   CONFIG_SYS_CLOCK_TICKS_PER_SEC / 10 : 1)
 #define NR_OF_NOP_RUNS 10000
 #define NR_OF_FIFO_RUNS 500
+#define FIFO_BURST_SIZE 32
 #define NR_OF_SEMA_RUNS 500
 #define NR_OF_MUTEX_RUNS 1000
 #define NR_OF_POOL_RUNS 1000
@@ -102,6 +103,12 @@ extern void queue_test(void);
 #define queue_test dummy_test
 #endif
 
+#ifdef FIFO_BURST_BENCH
+extern void fifo_burst_test(void);
+#else
+#define fifo_burst_test dummy_test
+#endif
+
 #ifdef MUTEX_BENCH
 extern void mutex_test(void);
 #else
@@ -146,6 +153,7 @@ extern struct k_msgq DEMOQX1;
 extern struct k_msgq DEMOQX4;
 extern struct k_msgq MB_COMM;
 extern struct k_msgq CH_COMM;
+extern struct k_fifo DEMOFIFO;
 
 extern struct k_mbox MAILB1;
 
@@ -14,12 +14,53 @@
  *  2. From __start to main()
  *  3. From __start to task
  *  4. From __start to idle
+ *
+ * With CONFIG_BOOT_PROFILE, also how long each initialization level took,
+ * with two APPLICATION level functions that wait as long as a slow device
+ * would, to compare running them in turn and in parallel.
  */
 
 #include <zephyr.h>
+#include <init.h>
 
 #include <tc_util.h>
 
+#ifdef CONFIG_BOOT_PROFILE
+#define SLOW_INIT_MS 50
+
+static int slow_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	k_sleep(SLOW_INIT_MS);
+
+	return 0;
+}
+
+static int slow_init_2(struct device *dev)
+{
+	return slow_init(dev);
+}
+
+SYS_INIT_PARALLEL(slow_init, APPLICATION, 0);
+SYS_INIT_PARALLEL(slow_init_2, APPLICATION, 0);
+
+static void print_levels(void)
+{
+	static const char * const names[] = {
+		"PRE_KERNEL_1", "PRE_KERNEL_2", "POST_KERNEL", "APPLICATION"
+	};
+
+	for (int level = _SYS_INIT_LEVEL_PRE_KERNEL_1;
+	     level <= _SYS_INIT_LEVEL_APPLICATION; level++) {
+		u32_t cycles = sys_init_level_cycles_get(level);
+
+		TC_PRINT("%-14s: %u cycles, %u us\n", names[level], cycles,
+			 SYS_CLOCK_HW_CYCLES_TO_NS(cycles) / 1000);
+	}
+}
+#endif
+
 /* externs */
 extern u64_t __start_time_stamp;    /* timestamp when kernel begins executing */
 extern u64_t __main_time_stamp;     /* timestamp when main() begins executing */
@@ -72,6 +113,10 @@ void main(void)
 		 (u32_t)(s_idle_time_stamp & 0xFFFFFFFFULL),
 		 (u32_t)  (idle_us  & 0xFFFFFFFFULL));
 
+#ifdef CONFIG_BOOT_PROFILE
+	print_levels();
+#endif
+
 	TC_PRINT("Boot Time Measurement finished\n");
 
 	/* for sanity regression test utility. */
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Measure the frame rate of the native_posix Ethernet driver
+ *
+ * Builds a small and a full size frame once, and times the driver
+ * sending them to the host TAP interface over and over. The frames are
+ * broadcast with an EtherType for local experiments, which the host
+ * drops.
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <tc_util.h>
+#include <bench.h>
+#include <net/net_if.h>
+#include <net/net_pkt.h>
+#include <net/ethernet.h>
+
+#define SAMPLES 200
+#define FRAMES 16
+#define ETH_MTU 1500
+
+/* IEEE 802 local experimental EtherType 1 */
+#define ETH_PTYPE_EXP1 0x88b5
+
+BENCH_DEFINE(send_64, SAMPLES, 1, FRAMES);
+BENCH_DEFINE(send_1514, SAMPLES, 1, FRAMES);
+
+static u8_t payload[ETH_MTU];
+
+static struct net_if *iface;
+static const struct ethernet_api *api;
+static u32_t failed;
+
+static struct net_pkt *frame_get(size_t len)
+{
+	struct net_eth_hdr *hdr;
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_get_reserve_tx(sizeof(struct net_eth_hdr), K_FOREVER);
+
+	if (!net_pkt_append_all(pkt, len - sizeof(struct net_eth_hdr),
+				payload, K_FOREVER)) {
+		net_pkt_unref(pkt);
+		return NULL;
+	}
+
+	net_pkt_set_iface(pkt, iface);
+
+	hdr = NET_ETH_HDR(pkt);
+	(void)memset(&hdr->dst, 0xff, sizeof(hdr->dst));
+	memcpy(&hdr->src, net_if_get_link_addr(iface)->addr,
+	       sizeof(hdr->src));
+	hdr->type = htons(ETH_PTYPE_EXP1);
+
+	return pkt;
+}
+
+/* The driver lets go of the packets it sends, hold on to it */
+static void frame_send(void *arg)
+{
+	struct net_pkt *pkt = arg;
+
+	net_pkt_ref(pkt);
+
+	if (api->iface_api.send(iface, pkt) < 0) {
+		net_pkt_unref(pkt);
+		failed++;
+	}
+}
+
+static bool run(struct bench *b, size_t len)
+{
+	struct net_pkt *pkt;
+
+	pkt = frame_get(len);
+	if (!pkt) {
+		TC_PRINT("Cannot build a %zu byte frame\n", len);
+		return false;
+	}
+
+	failed = 0;
+	bench_run(b, frame_send, pkt);
+	net_pkt_unref(pkt);
+
+	if (failed) {
+		TC_PRINT("%u frames of %zu bytes not sent\n", failed, len);
+		return false;
+	}
+
+	bench_report(b);
+
+	return true;
+}
+
+void main(void)
+{
+	bool ok = true;
+
+	TC_START("native_posix Ethernet Transmit Benchmark");
+
+	iface = net_if_get_first_by_type(&NET_L2_GET_NAME(ETHERNET));
+	if (!iface || !net_if_is_up(iface)) {
+		TC_PRINT("No Ethernet interface, is zeth set up?\n");
+		TC_END_RESULT(TC_FAIL);
+		TC_END_REPORT(TC_FAIL);
+		return;
+	}
+
+	api = net_if_get_device(iface)->driver_api;
+
+	ok &= run(&send_64, 64);
+	ok &= run(&send_1514, ETH_MTU + sizeof(struct net_eth_hdr));
+
+	TC_END_RESULT(ok ? TC_PASS : TC_FAIL);
+	TC_END_REPORT(ok ? TC_PASS : TC_FAIL);
+}
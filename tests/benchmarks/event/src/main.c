@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Compare event objects with k_poll() on several poll signals
+ *
+ * A thread waits for any of 1 or MAX_CONDITIONS conditions, each one an
+ * event of an event object or a poll signal, and the benchmark measures
+ * how long it takes to wake it, and to signal and check a condition
+ * without waiting.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <bench.h>
+
+#define SAMPLES 1000
+#define MAX_CONDITIONS 8
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define WAITER_PRIO K_PRIO_PREEMPT(5)
+#define MAIN_PRIO K_PRIO_PREEMPT(10)
+
+BENCH_DEFINE(event_wake_1, SAMPLES, 1, 1);
+BENCH_DEFINE(poll_wake_1, SAMPLES, 1, 1);
+BENCH_DEFINE(event_wake_8, SAMPLES, 1, 1);
+BENCH_DEFINE(poll_wake_8, SAMPLES, 1, 1);
+BENCH_DEFINE(event_check_1, SAMPLES, 1, 1);
+BENCH_DEFINE(poll_check_1, SAMPLES, 1, 1);
+BENCH_DEFINE(event_check_8, SAMPLES, 1, 1);
+BENCH_DEFINE(poll_check_8, SAMPLES, 1, 1);
+
+static K_EVENT_DEFINE(event);
+static struct k_poll_signal signals[MAX_CONDITIONS];
+static struct k_poll_event poll_events[MAX_CONDITIONS];
+
+static K_SEM_DEFINE(done, 0, 1);
+static K_THREAD_STACK_DEFINE(stack, STACK_SIZE);
+static struct k_thread thread;
+
+static volatile bench_time_t start;
+static volatile bool finished;
+
+static void poll_setup(int n)
+{
+	for (int i = 0; i < n; i++) {
+		k_poll_signal_init(&signals[i]);
+		k_poll_event_init(&poll_events[i], K_POLL_TYPE_SIGNAL,
+				  K_POLL_MODE_NOTIFY_ONLY, &signals[i]);
+	}
+}
+
+/* reset the signaled conditions, so k_poll() waits for them again */
+static void poll_consume(int n)
+{
+	for (int i = 0; i < n; i++) {
+		if (poll_events[i].state != K_POLL_STATE_NOT_READY) {
+			k_poll_signal_reset(&signals[i]);
+			poll_events[i].state = K_POLL_STATE_NOT_READY;
+		}
+	}
+}
+
+static void event_waiter(void *p1, void *p2, void *p3)
+{
+	struct bench *b = p1;
+	u32_t mask = BIT_MASK(POINTER_TO_INT(p2));
+
+	ARG_UNUSED(p3);
+
+	do {
+		k_event_wait(&event, mask, true, K_FOREVER);
+	} while (bench_sample_add(b, bench_time_get() - start));
+
+	finished = true;
+	k_sem_give(&done);
+}
+
+static void poll_waiter(void *p1, void *p2, void *p3)
+{
+	struct bench *b = p1;
+	int n = POINTER_TO_INT(p2);
+
+	ARG_UNUSED(p3);
+
+	do {
+		k_poll(poll_events, n, K_FOREVER);
+		poll_consume(n);
+	} while (bench_sample_add(b, bench_time_get() - start));
+
+	finished = true;
+	k_sem_give(&done);
+}
+
+static void wake(struct bench *b, int n, bool poll)
+{
+	k_thread_entry_t waiter = poll ? poll_waiter : event_waiter;
+
+	k_event_init(&event);
+	poll_setup(n);
+	finished = false;
+
+	k_thread_create(&thread, stack, STACK_SIZE, waiter, b,
+			INT_TO_POINTER(n), NULL, WAITER_PRIO, 0, K_NO_WAIT);
+
+	/* the waiter runs as soon as a condition is signaled, and then
+	 * waits again before this thread goes on
+	 */
+	for (u32_t i = 0; !finished; i++) {
+		start = bench_time_get();
+		if (poll) {
+			k_poll_signal_raise(&signals[i % n], 0);
+		} else {
+			k_event_post(&event, BIT(i % n));
+		}
+	}
+
+	k_sem_take(&done, K_FOREVER);
+	bench_report(b);
+}
+
+static void check(struct bench *b, int n, bool poll)
+{
+	bench_time_t t;
+	u32_t i = 0;
+
+	k_event_init(&event);
+	poll_setup(n);
+
+	do {
+		t = bench_time_get();
+		if (poll) {
+			k_poll_signal_raise(&signals[i % n], 0);
+			k_poll(poll_events, n, K_NO_WAIT);
+			poll_consume(n);
+		} else {
+			k_event_post(&event, BIT(i % n));
+			k_event_wait(&event, BIT_MASK(n), true, K_NO_WAIT);
+		}
+		i++;
+	} while (bench_sample_add(b, bench_time_get() - t));
+
+	bench_report(b);
+}
+
+void main(void)
+{
+	TC_START("Event Benchmark");
+
+	k_thread_priority_set(k_current_get(), MAIN_PRIO);
+
+	wake(&event_wake_1, 1, false);
+	wake(&poll_wake_1, 1, true);
+	wake(&event_wake_8, MAX_CONDITIONS, false);
+	wake(&poll_wake_8, MAX_CONDITIONS, true);
+
+	check(&event_check_1, 1, false);
+	check(&poll_check_1, 1, true);
+	check(&event_check_8, MAX_CONDITIONS, false);
+	check(&poll_check_8, MAX_CONDITIONS, true);
+
+	TC_END_RESULT(TC_PASS);
+	TC_END_REPORT(TC_PASS);
+}
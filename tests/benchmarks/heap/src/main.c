@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Compare the buddy memory pool with the TLSF heap
+ *
+ * Both allocators get ARENA_SIZE bytes and the same pseudo-random
+ * sequence of requests, drawn from a size distribution modelled on
+ * network traffic.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <misc/heap.h>
+
+#define ARENA_SIZE 16384
+#define SLOTS 64
+#define ITERATIONS 4000
+
+K_MEM_POOL_DEFINE(bench_pool, 16, ARENA_SIZE / 4, 4, 4);
+
+static char __aligned(SYS_HEAP_ALIGN) heap_mem[ARENA_SIZE];
+static struct sys_heap heap;
+
+struct allocator {
+	const char *name;
+	void (*reset)(void);
+	void *(*alloc)(size_t size);
+	void (*free)(void *mem);
+};
+
+static void pool_reset(void)
+{
+	/* all blocks are freed at the end of each run, and merged back */
+}
+
+static void *pool_alloc(size_t size)
+{
+	return k_mem_pool_malloc(&bench_pool, size);
+}
+
+static void pool_free(void *mem)
+{
+	k_free(mem);
+}
+
+static void heap_reset(void)
+{
+	sys_heap_init(&heap, heap_mem, sizeof(heap_mem));
+}
+
+static void *heap_alloc(size_t size)
+{
+	unsigned int key = irq_lock();
+	void *mem = sys_heap_alloc(&heap, size);
+
+	irq_unlock(key);
+
+	return mem;
+}
+
+static void heap_free(void *mem)
+{
+	unsigned int key = irq_lock();
+
+	sys_heap_free(&heap, mem);
+	irq_unlock(key);
+}
+
+static const struct allocator allocators[] = {
+	{ "k_mem_pool", pool_reset, pool_alloc, pool_free },
+	{ "sys_heap", heap_reset, heap_alloc, heap_free },
+};
+
+static void *ptrs[SLOTS];
+static size_t sizes[SLOTS];
+
+static u32_t rand_state;
+
+static u32_t next_rand(void)
+{
+	rand_state = rand_state * 1103515245 + 12345;
+
+	return rand_state >> 8;
+}
+
+/* 60% control blocks, 30% medium payloads, 10% full frames */
+static size_t next_size(void)
+{
+	u32_t r = next_rand() % 100;
+
+	if (r < 60) {
+		return 8 + next_rand() % 57;
+	} else if (r < 90) {
+		return 64 + next_rand() % 449;
+	} else {
+		return 512 + next_rand() % 1025;
+	}
+}
+
+static void run(const struct allocator *a)
+{
+	u32_t alloc_cycles = 0, free_cycles = 0;
+	int allocs = 0, frees = 0, failures = 0;
+	size_t requested = 0;
+	int n;
+
+	a->reset();
+	rand_state = 12345;
+
+	/* Fill until the first failure */
+	for (n = 0; n < SLOTS; n++) {
+		sizes[n] = next_size();
+		ptrs[n] = a->alloc(sizes[n]);
+		if (ptrs[n] == NULL) {
+			break;
+		}
+		requested += sizes[n];
+	}
+
+	for (int i = n; i < SLOTS; i++) {
+		ptrs[i] = NULL;
+	}
+
+	/* Random churn */
+	for (int i = 0; i < ITERATIONS; i++) {
+		int slot = next_rand() % SLOTS;
+		u32_t start;
+
+		if (ptrs[slot] != NULL) {
+			start = k_cycle_get_32();
+			a->free(ptrs[slot]);
+			free_cycles += k_cycle_get_32() - start;
+			ptrs[slot] = NULL;
+			frees++;
+		} else {
+			size_t size = next_size();
+
+			start = k_cycle_get_32();
+			ptrs[slot] = a->alloc(size);
+			alloc_cycles += k_cycle_get_32() - start;
+			allocs++;
+			if (ptrs[slot] == NULL) {
+				failures++;
+			}
+		}
+	}
+
+	for (int i = 0; i < SLOTS; i++) {
+		if (ptrs[i] != NULL) {
+			a->free(ptrs[i]);
+		}
+	}
+
+	TC_PRINT("%-12s %5u%% %10u %10u %10d\n", a->name,
+		 (u32_t)(requested * 100 / ARENA_SIZE),
+		 alloc_cycles / max(allocs, 1), free_cycles / max(frees, 1),
+		 failures);
+}
+
+void main(void)
+{
+	TC_START("Heap Allocator Benchmark");
+
+	TC_PRINT("%d bytes, %d random allocs/frees over %d slots\n",
+		 ARENA_SIZE, ITERATIONS, SLOTS);
+	TC_PRINT("%-12s %6s %10s %10s %10s\n", "allocator", "fill",
+		 "alloc", "free", "failures");
+
+	for (int i = 0; i < ARRAY_SIZE(allocators); i++) {
+		run(&allocators[i]);
+	}
+
+	TC_END_RESULT(TC_PASS);
+	TC_END_REPORT(TC_PASS);
+}
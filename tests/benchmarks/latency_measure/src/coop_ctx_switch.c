@@ -17,67 +17,76 @@
  * stop and the average time of context switch is displayed.
  */
 
-#include "timestamp.h"
 #include "utils.h"
 
 #include <arch/cpu.h>
 
+/* context switches in each sample, two for each round */
+#define SWITCHES_PER_SAMPLE 100
+
 /* number of context switches */
-#define NCTXSWITCH   10000
+#define NCTXSWITCH   ((SAMPLES + 1) * SWITCHES_PER_SAMPLE)
 #ifndef STACKSIZE
 #define STACKSIZE    512
 #endif
 
+BENCH_DEFINE(coop_switch, SAMPLES, 1, SWITCHES_PER_SAMPLE);
+
 /* stack used by the threads */
 static K_THREAD_STACK_DEFINE(thread_one_stack, STACKSIZE);
 static K_THREAD_STACK_DEFINE(thread_two_stack, STACKSIZE);
 static struct k_thread thread_one_data;
 static struct k_thread thread_two_data;
 
-static u32_t timestamp;
-
 /* context switches counter */
 static volatile u32_t ctx_switch_counter;
 
 /* context switch balancer. Incremented by one thread, decremented by another*/
 static volatile int ctx_switch_balancer;
 
+/* set once thread one has all its samples */
+static volatile bool done;
+
 K_SEM_DEFINE(sync_sema, 0, 1);
 
 /**
  *
- * thread_onne
+ * thread_one
  *
- * Fiber makes all the test preparations: registers the interrupt handler,
- * gets the first timestamp and invokes the software interrupt.
+ * Fiber waits for thread two to start, then switches back and forth with
+ * it, taking one sample for every SWITCHES_PER_SAMPLE context switches.
  *
  * @return N/A
  */
 static void thread_one(void)
 {
+	bench_time_t start;
+
 	k_sem_take(&sync_sema, K_FOREVER);
-	timestamp = TIME_STAMP_DELTA_GET(0);
-	while (ctx_switch_counter < NCTXSWITCH) {
-		k_yield();
-		ctx_switch_counter++;
-		ctx_switch_balancer--;
-	}
-	timestamp = TIME_STAMP_DELTA_GET(timestamp);
+	do {
+		start = bench_time_get();
+		for (int i = 0; i < SWITCHES_PER_SAMPLE / 2; i++) {
+			k_yield();
+			ctx_switch_counter++;
+			ctx_switch_balancer--;
+		}
+	} while (bench_sample_add(&coop_switch, bench_time_get() - start));
+	done = true;
 }
 
 /**
  *
  * @brief Check the time when it gets executed after the semaphore
  *
- * Fiber starts, waits on semaphore. When the interrupt handler releases
- * the semaphore, thread  measures the time.
+ * Fiber starts, releases the semaphore thread one waits on, and switches
+ * back and forth with it until it is done.
  *
  * @return 0 on success
  */
 static void thread_two(void)
 {
 	k_sem_give(&sync_sema);
-	while (ctx_switch_counter < NCTXSWITCH) {
+	while (!done) {
 		k_yield();
 		ctx_switch_counter++;
 		ctx_switch_balancer++;
@@ -92,9 +101,11 @@ static void thread_two(void)
  */
 int coop_ctx_switch(void)
 {
-	PRINT_FORMAT(" 6 - Measure average context switch time between threads (coop)");
+	PRINT_TITLE(" 6 - Measure average context switch time between threads"
+		    " (coop)");
 	ctx_switch_counter = 0;
 	ctx_switch_balancer = 0;
+	done = false;
 
 	bench_test_start();
 	k_thread_create(&thread_one_data, thread_one_stack, STACKSIZE,
@@ -105,16 +116,16 @@ int coop_ctx_switch(void)
 			6, 0, K_NO_WAIT);
 
 	if (ctx_switch_balancer > 3 || ctx_switch_balancer < -3) {
-		PRINT_FORMAT(" Balance is %d. FAILED", ctx_switch_balancer);
+		TC_PRINT(" Balance is %d. FAILED\n", ctx_switch_balancer);
 	} else if (bench_test_end() != 0) {
 		error_count++;
 		PRINT_OVERFLOW_ERROR();
+	} else if (ctx_switch_counter < NCTXSWITCH) {
+		error_count++;
+		TC_PRINT(" Only %u context switches. FAILED\n",
+			 ctx_switch_counter);
 	} else {
-		PRINT_FORMAT(" Average context switch time is %u tcs = %u"
-			     " nsec",
-			     timestamp / ctx_switch_counter,
-			     SYS_CLOCK_HW_CYCLES_TO_NS_AVG(timestamp,
-							   ctx_switch_counter));
+		bench_report(&coop_switch);
 	}
 
 	return 0;
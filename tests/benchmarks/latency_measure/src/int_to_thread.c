@@ -14,7 +14,6 @@
  * handler back to the interrupted thread.
  */
 
-#include "timestamp.h"
 #include "utils.h"
 
 #include <arch/cpu.h>
@@ -22,13 +21,15 @@
 
 static volatile int flag_var;
 
-static u32_t timestamp;
+static bench_time_t timestamp;
+
+BENCH_DEFINE(isr_to_thread, SAMPLES, 1, 1);
 
 /**
  *
  * @brief Test ISR used to measure best case interrupt latency
  *
- * The interrupt handler gets the second timestamp.
+ * The interrupt handler gets the first timestamp.
  *
  * @return N/A
  */
@@ -37,27 +38,29 @@ static void latency_test_isr(void *unused)
 	ARG_UNUSED(unused);
 
 	flag_var = 1;
-	timestamp = TIME_STAMP_DELTA_GET(0);
+	timestamp = bench_time_get();
 }
 
 /**
  *
  * @brief Interrupt preparation function
  *
- * Function makes all the test preparations: registers the interrupt handler,
- * gets the first timestamp and invokes the software interrupt.
+ * Function invokes the software interrupt and, back from it, adds the time
+ * since the interrupt handler took its timestamp as a sample.
  *
- * @return N/A
+ * @return true if more samples are needed, false when done or on failure
  */
-static void make_int(void)
+static bool make_int(void)
 {
 	flag_var = 0;
 	irq_offload(latency_test_isr, NULL);
 	if (flag_var != 1) {
-		PRINT_FORMAT(" Flag variable has not changed. FAILED\n");
-	} else {
-		timestamp = TIME_STAMP_DELTA_GET(timestamp);
+		TC_PRINT(" Flag variable has not changed. FAILED\n");
+		error_count++;
+		return false;
 	}
+
+	return bench_sample_add(&isr_to_thread, bench_time_get() - timestamp);
 }
 
 /**
@@ -68,13 +71,14 @@ static void make_int(void)
  */
 int int_to_thread(void)
 {
-	PRINT_FORMAT(" 1 - Measure time to switch from ISR back to"
-		     " interrupted thread");
+	PRINT_TITLE(" 1 - Measure time to switch from ISR back to"
+		    " interrupted thread");
 	TICK_SYNCH();
-	make_int();
+	while (make_int()) {
+	}
+
 	if (flag_var == 1) {
-		PRINT_FORMAT(" switching time is %u tcs = %u nsec",
-			     timestamp, SYS_CLOCK_HW_CYCLES_TO_NS(timestamp));
+		bench_report(&isr_to_thread);
 	}
 	return 0;
 }
@@ -18,13 +18,13 @@
 #include <zephyr.h>
 #include <irq_offload.h>
 
-#include "timestamp.h"
 #include "utils.h"
 
 #include <arch/cpu.h>
 
-static u32_t timestamp;
+static bench_time_t timestamp;
 
+BENCH_DEFINE(isr_to_thread_resched, SAMPLES, 1, 1);
 
 K_SEM_DEFINE(INTSEMA, 0, 1);
 K_ALERT_DEFINE(EVENT0, NULL, 10);
@@ -33,7 +33,7 @@ K_ALERT_DEFINE(EVENT0, NULL, 10);
  *
  * @brief Test ISR used to measure best case interrupt latency
  *
- * The interrupt handler gets the second timestamp.
+ * The interrupt handler gets the first timestamp.
  *
  * @return N/A
  */
@@ -42,24 +42,24 @@ static void latency_test_isr(void *unused)
 	ARG_UNUSED(unused);
 
 	k_alert_send(&EVENT0);
-	timestamp = TIME_STAMP_DELTA_GET(0);
+	timestamp = bench_time_get();
 }
 
 /**
  *
  * @brief Software interrupt generating thread
  *
- * Lower priority thread that, when it starts, it waits for a semaphore. When
- * it gets it, released by the main thread, sets up the interrupt handler and
- * generates the software interrupt
+ * Lower priority thread that waits for a semaphore. Each time it gets it,
+ * released by the main thread, it generates the software interrupt.
  *
  * @return 0 on success
  */
 void int_thread(void)
 {
-	k_sem_take(&INTSEMA, K_FOREVER);
-	irq_offload(latency_test_isr, NULL);
-	k_thread_suspend(k_current_get());
+	while (true) {
+		k_sem_take(&INTSEMA, K_FOREVER);
+		irq_offload(latency_test_isr, NULL);
+	}
 }
 
 
@@ -75,13 +75,15 @@ K_THREAD_DEFINE(int_thread_id, 512,
  */
 int int_to_thread_evt(void)
 {
-	PRINT_FORMAT(" 2 - Measure time from ISR to executing a different thread"
-		     " (rescheduled)");
+	PRINT_TITLE(" 2 - Measure time from ISR to executing a different thread"
+		    " (rescheduled)");
 	TICK_SYNCH();
-	k_sem_give(&INTSEMA);
-	k_alert_recv(&EVENT0, K_FOREVER);
-	timestamp = TIME_STAMP_DELTA_GET(timestamp);
-	PRINT_FORMAT(" switch time is %u tcs = %u nsec",
-		     timestamp, SYS_CLOCK_HW_CYCLES_TO_NS(timestamp));
+	do {
+		k_sem_give(&INTSEMA);
+		k_alert_recv(&EVENT0, K_FOREVER);
+	} while (bench_sample_add(&isr_to_thread_resched,
+				  bench_time_get() - timestamp));
+
+	bench_report(&isr_to_thread_resched);
 	return 0;
 }
@@ -15,18 +15,23 @@
 
 #include <zephyr.h>
 
-#include "timestamp.h"
 #include "utils.h"
 
 #include <arch/cpu.h>
 
-/* the number of semaphore give/take cycles */
-#define N_TEST_SEMA 1000
+/* the number of semaphore give/take cycles in each sample */
+#define N_SEMA_PER_SAMPLE 10
+
+/* the number of mutex lock/unlock cycles in each sample */
+#define N_MUTEX_PER_SAMPLE 10
 
-/* the number of mutex lock/unlock cycles */
-#define N_TEST_MUTEX 1000
+/* the number of semaphore give/take cycles */
+#define N_TEST_SEMA (SAMPLES * N_SEMA_PER_SAMPLE)
 
-static u32_t timestamp;
+BENCH_DEFINE(sem_give, SAMPLES, 0, N_SEMA_PER_SAMPLE);
+BENCH_DEFINE(sem_take, SAMPLES, 0, N_SEMA_PER_SAMPLE);
+BENCH_DEFINE(mutex_lock, SAMPLES, 0, N_MUTEX_PER_SAMPLE);
+BENCH_DEFINE(mutex_unlock, SAMPLES, 0, N_MUTEX_PER_SAMPLE);
 
 K_SEM_DEFINE(lock_unlock_sema, 0, N_TEST_SEMA);
 K_MUTEX_DEFINE(TEST_MUTEX);
@@ -42,39 +47,34 @@ K_MUTEX_DEFINE(TEST_MUTEX);
  */
 int sema_lock_unlock(void)
 {
+	bench_time_t start;
 	int i;
 
-	PRINT_FORMAT(" 3 - Measure average time to signal a sema then test"
-		     " that sema");
+	PRINT_TITLE(" 3 - Measure average time to signal a sema then test"
+		    " that sema");
 	bench_test_start();
-	timestamp = TIME_STAMP_DELTA_GET(0);
-	for (i = 0; i < N_TEST_SEMA; i++) {
-		k_sem_give(&lock_unlock_sema);
-	}
-	timestamp = TIME_STAMP_DELTA_GET(timestamp);
+	do {
+		start = bench_time_get();
+		for (i = 0; i < N_SEMA_PER_SAMPLE; i++) {
+			k_sem_give(&lock_unlock_sema);
+		}
+	} while (bench_sample_add(&sem_give, bench_time_get() - start));
 	if (bench_test_end() == 0) {
-		PRINT_FORMAT(" Average semaphore signal time %u tcs = %u"
-			     " nsec",
-			     timestamp / N_TEST_SEMA,
-			     SYS_CLOCK_HW_CYCLES_TO_NS_AVG(timestamp,
-							   N_TEST_SEMA));
+		bench_report(&sem_give);
 	} else {
 		error_count++;
 		PRINT_OVERFLOW_ERROR();
 	}
 
 	bench_test_start();
-	timestamp = TIME_STAMP_DELTA_GET(0);
-	for (i = 0; i < N_TEST_SEMA; i++) {
-		k_sem_take(&lock_unlock_sema, K_FOREVER);
-	}
-	timestamp = TIME_STAMP_DELTA_GET(timestamp);
+	do {
+		start = bench_time_get();
+		for (i = 0; i < N_SEMA_PER_SAMPLE; i++) {
+			k_sem_take(&lock_unlock_sema, K_FOREVER);
+		}
+	} while (bench_sample_add(&sem_take, bench_time_get() - start));
 	if (bench_test_end() == 0) {
-		PRINT_FORMAT(" Average semaphore test time %u tcs = %u "
-			     "nsec",
-			     timestamp / N_TEST_SEMA,
-			     SYS_CLOCK_HW_CYCLES_TO_NS_AVG(timestamp,
-							   N_TEST_SEMA));
+		bench_report(&sem_take);
 	} else {
 		error_count++;
 		PRINT_OVERFLOW_ERROR();
@@ -93,25 +93,25 @@ int sema_lock_unlock(void)
  */
 int mutex_lock_unlock(void)
 {
+	bench_time_t start;
 	int i;
 
-	PRINT_FORMAT(" 4- Measure average time to lock a mutex then"
-		     " unlock that mutex");
-	timestamp = TIME_STAMP_DELTA_GET(0);
-	for (i = 0; i < N_TEST_MUTEX; i++) {
-		k_mutex_lock(&TEST_MUTEX, K_FOREVER);
-	}
-	timestamp = TIME_STAMP_DELTA_GET(timestamp);
-	PRINT_FORMAT(" Average time to lock the mutex %u tcs = %u nsec",
-		     timestamp / N_TEST_MUTEX,
-		     SYS_CLOCK_HW_CYCLES_TO_NS_AVG(timestamp, N_TEST_MUTEX));
-	timestamp = TIME_STAMP_DELTA_GET(0);
-	for (i = 0; i < N_TEST_MUTEX; i++) {
-		k_mutex_unlock(&TEST_MUTEX);
-	}
-	timestamp = TIME_STAMP_DELTA_GET(timestamp);
-	PRINT_FORMAT(" Average time to unlock the mutex %u tcs = %u nsec",
-		     timestamp / N_TEST_MUTEX,
-		     SYS_CLOCK_HW_CYCLES_TO_NS_AVG(timestamp, N_TEST_MUTEX));
+	PRINT_TITLE(" 4 - Measure average time to lock a mutex then"
+		    " unlock that mutex");
+	do {
+		start = bench_time_get();
+		for (i = 0; i < N_MUTEX_PER_SAMPLE; i++) {
+			k_mutex_lock(&TEST_MUTEX, K_FOREVER);
+		}
+	} while (bench_sample_add(&mutex_lock, bench_time_get() - start));
+	bench_report(&mutex_lock);
+
+	do {
+		start = bench_time_get();
+		for (i = 0; i < N_MUTEX_PER_SAMPLE; i++) {
+			k_mutex_unlock(&TEST_MUTEX);
+		}
+	} while (bench_sample_add(&mutex_unlock, bench_time_get() - start));
+	bench_report(&mutex_unlock);
 	return 0;
 }
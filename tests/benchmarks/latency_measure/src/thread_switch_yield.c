@@ -13,11 +13,17 @@
 
 #include <zephyr.h>
 #include <stdlib.h>
-#include <timestamp.h>  /* reading time */
-#include "utils.h"      /* PRINT () and other macros */
+#include "utils.h"      /* bench and other macros */
 
-/* context switch enough time so our measurement is precise */
-#define NB_OF_YIELD     1000
+/* yields of this routine in each sample, each one is two thread switches */
+#define YIELDS_PER_SAMPLE 10
+
+/* context switch enough time so our measurement is precise, one sample of
+ * warmup included
+ */
+#define NB_OF_YIELD     ((SAMPLES + 1) * YIELDS_PER_SAMPLE)
+
+BENCH_DEFINE(thread_yield, SAMPLES, 1, 2 * YIELDS_PER_SAMPLE);
 
 static u32_t helper_thread_iterations;
 
@@ -51,10 +57,10 @@ void thread_switch_yield(void)
 {
 	u32_t iterations = 0;
 	s32_t delta;
-	u32_t timestamp;
+	bench_time_t start;
 
-	PRINT_FORMAT(" 5 - Measure average context switch time between threads"
-		     " using (k_yield)");
+	PRINT_TITLE(" 5 - Measure average context switch time between threads"
+		    " using (k_yield)");
 
 	bench_test_start();
 
@@ -63,25 +69,20 @@ void thread_switch_yield(void)
 			yielding_thread, NULL, NULL, NULL,
 			Y_PRIORITY, 0, K_NO_WAIT);
 
-	/* get initial timestamp */
-	timestamp = TIME_STAMP_DELTA_GET(0);
-
-	/* loop until either helper or this routine reaches number of yields */
-	while (iterations < NB_OF_YIELD &&
-	       helper_thread_iterations < NB_OF_YIELD) {
-		k_yield();
-		iterations++;
-	}
-
-	/* get the number of cycles it took to do the test */
-	timestamp = TIME_STAMP_DELTA_GET(timestamp);
+	/* loop until the benchmark has all its samples */
+	do {
+		start = bench_time_get();
+		for (int i = 0; i < YIELDS_PER_SAMPLE; i++) {
+			k_yield();
+			iterations++;
+		}
+	} while (bench_sample_add(&thread_yield, bench_time_get() - start));
 
 	/* Ensure both helper and this routine were context switching back &
 	 * forth.
-	 * For execution to reach the line below, either this routine or helper
-	 * routine reached NB_OF_YIELD. The other loop must be at most one
-	 * iteration away from reaching NB_OF_YIELD if execute was switching
-	 * back and forth.
+	 * For execution to reach the line below, this routine reached
+	 * NB_OF_YIELD. The helper loop must be at most one iteration away
+	 * from reaching NB_OF_YIELD if execute was switching back and forth.
 	 */
 	delta = iterations - helper_thread_iterations;
 	if (bench_test_end() < 0) {
@@ -92,16 +93,9 @@ void thread_switch_yield(void)
 		 * called yield without the other having chance to execute
 		 */
 		error_count++;
-		PRINT_FORMAT(" Error, iteration:%u, helper iteration:%u",
-			     iterations, helper_thread_iterations);
+		TC_PRINT(" Error, iteration:%u, helper iteration:%u\n",
+			 iterations, helper_thread_iterations);
 	} else {
-		/* thread_yield is called (iterations + helper_thread_iterations)
-		 * times in total.
-		 */
-		PRINT_FORMAT(" Average thread context switch using "
-			     "yield %u tcs = %u nsec",
-			     timestamp / (iterations + helper_thread_iterations),
-			     SYS_CLOCK_HW_CYCLES_TO_NS_AVG(timestamp,
-							   (iterations + helper_thread_iterations)));
+		bench_report(&thread_yield);
 	}
 }
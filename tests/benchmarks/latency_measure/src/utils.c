@@ -13,9 +13,7 @@
 
 #include <zephyr.h>
 
-#include "timestamp.h"
 #include "utils.h"
 
-/* scratchpad for the string used to print on console */
-char tmp_string[TMP_STRING_SIZE];
-
+/* track number of errors */
+int error_count;
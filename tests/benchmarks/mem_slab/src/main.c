@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Measure memory slab alloc/free scaling
+ *
+ * Runs 1 to MAX_THREADS threads that all allocate and free blocks of the
+ * same memory slab, and reports for each number of threads the average
+ * cost of one k_mem_slab_alloc()/k_mem_slab_free() pair.  The threads
+ * yield after every burst, so that on a single CPU they interleave the
+ * way RX and TX threads sharing a packet slab do.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+
+#define ITERATIONS 1000
+#define BURST 4
+#define MAX_THREADS 4
+#define BLOCK_SIZE 32
+#define NUM_BLOCKS (2 * BURST * MAX_THREADS)
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define PRIO K_PRIO_PREEMPT(10)
+
+K_MEM_SLAB_DEFINE(bench_slab, BLOCK_SIZE, NUM_BLOCKS, 4);
+
+static struct k_thread threads[MAX_THREADS];
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, MAX_THREADS, STACK_SIZE);
+
+static K_SEM_DEFINE(done, 0, MAX_THREADS);
+
+static volatile int failures;
+
+static void worker(void *p1, void *p2, void *p3)
+{
+	void *blocks[BURST];
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (int i = 0; i < ITERATIONS / BURST; i++) {
+		for (int j = 0; j < BURST; j++) {
+			if (k_mem_slab_alloc(&bench_slab, &blocks[j],
+					     K_NO_WAIT) != 0) {
+				failures++;
+				blocks[j] = NULL;
+			}
+		}
+
+		for (int j = 0; j < BURST; j++) {
+			if (blocks[j] != NULL) {
+				k_mem_slab_free(&bench_slab, &blocks[j]);
+			}
+		}
+
+		k_yield();
+	}
+
+	k_sem_give(&done);
+}
+
+static u32_t run(int nthreads)
+{
+	u32_t start;
+
+	/* Keep everything from starting until all threads exist */
+	k_sched_lock();
+	for (int i = 0; i < nthreads; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE, worker,
+				NULL, NULL, NULL, PRIO, 0, K_NO_WAIT);
+	}
+	start = k_cycle_get_32();
+	k_sched_unlock();
+
+	for (int i = 0; i < nthreads; i++) {
+		k_sem_take(&done, K_FOREVER);
+	}
+
+	return (k_cycle_get_32() - start) / (nthreads * ITERATIONS);
+}
+
+void main(void)
+{
+	int status = TC_PASS;
+
+	TC_START("Memory Slab Benchmark");
+
+	TC_PRINT("CPUs: %d, per-CPU block caches: %s\n", CONFIG_MP_NUM_CPUS,
+		 IS_ENABLED(CONFIG_MEM_SLAB_CACHE) ? "yes" : "no");
+	TC_PRINT("%8s %14s  (cycles per alloc/free pair, avg of %d)\n",
+		 "threads", "alloc+free", ITERATIONS);
+
+	/* Stay out of the way of the threads being measured */
+	k_thread_priority_set(k_current_get(), K_PRIO_PREEMPT(14));
+
+	for (int n = 1; n <= MAX_THREADS; n++) {
+		TC_PRINT("%8d %14u\n", n, run(n));
+	}
+
+#ifdef CONFIG_MEM_SLAB_STATS
+	struct k_mem_slab_stats stats;
+
+	k_mem_slab_stats_get(&bench_slab, &stats);
+	TC_PRINT("slab stats: max used %u/%u, exhausted %u, shared list %u\n",
+		 stats.max_used, NUM_BLOCKS, stats.num_exhausted,
+		 stats.num_shared);
+#endif
+
+	/* The slab is sized so that no allocation may ever fail */
+	if (failures != 0 || k_mem_slab_num_used_get(&bench_slab) != 0) {
+		TC_PRINT("%d failed allocations, %u blocks leaked\n",
+			 failures, k_mem_slab_num_used_get(&bench_slab));
+		status = TC_FAIL;
+	}
+
+	TC_END_RESULT(status);
+	TC_END_REPORT(status);
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Measure k_mutex throughput under SMP contention
+ *
+ * One thread per CPU loops locking a shared mutex, holding it for a given
+ * number of cycles, unlocking it and working the same number of cycles
+ * outside of it. For each hold time the total number of lock/unlock pairs
+ * per second is reported, which shows how much a contended mutex costs
+ * compared to the critical section it protects.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+
+#if CONFIG_MP_NUM_CPUS < 2
+#error SMP benchmark requires at least two CPUs!
+#endif
+
+#define NUM_THREADS CONFIG_MP_NUM_CPUS
+#define RUN_MS 500
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define PRIO K_PRIO_PREEMPT(10)
+
+static const u32_t hold_cycles[] = { 0, 100, 1000, 10000, 100000 };
+
+static K_MUTEX_DEFINE(lock);
+static K_SEM_DEFINE(start, 0, NUM_THREADS);
+static K_SEM_DEFINE(done, 0, NUM_THREADS);
+
+static struct k_thread threads[NUM_THREADS];
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, NUM_THREADS, STACK_SIZE);
+
+static u32_t counts[NUM_THREADS];
+static volatile u32_t shared;
+
+static void work(u32_t cycles)
+{
+	u32_t start = k_cycle_get_32();
+
+	while (k_cycle_get_32() - start < cycles) {
+	}
+}
+
+static void locker(void *p1, void *p2, void *p3)
+{
+	u32_t *count = p1;
+	u32_t hold = (u32_t)p2;
+	u32_t end;
+
+	ARG_UNUSED(p3);
+
+	k_sem_take(&start, K_FOREVER);
+	end = k_uptime_get_32() + RUN_MS;
+
+	while ((s32_t)(end - k_uptime_get_32()) > 0) {
+		k_mutex_lock(&lock, K_FOREVER);
+		shared++;
+		work(hold);
+		k_mutex_unlock(&lock);
+
+		work(hold);
+		(*count)++;
+	}
+
+	k_sem_give(&done);
+}
+
+static u32_t run(u32_t hold)
+{
+	u32_t total = 0;
+
+	/* k_sched_lock() only keeps this CPU from switching threads, the
+	 * others would pick up new threads right away: hold them all on
+	 * a semaphore until every one of them exists
+	 */
+	for (int i = 0; i < NUM_THREADS; i++) {
+		counts[i] = 0;
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE, locker,
+				&counts[i], (void *)hold, NULL, PRIO, 0,
+				K_NO_WAIT);
+	}
+
+	for (int i = 0; i < NUM_THREADS; i++) {
+		k_sem_give(&start);
+	}
+
+	for (int i = 0; i < NUM_THREADS; i++) {
+		k_sem_take(&done, K_FOREVER);
+	}
+
+	for (int i = 0; i < NUM_THREADS; i++) {
+		total += counts[i];
+	}
+
+	return total * (MSEC_PER_SEC / RUN_MS);
+}
+
+void main(void)
+{
+	TC_START("SMP Mutex Contention Benchmark");
+
+	TC_PRINT("Adaptive spinning: %s, %d threads\n",
+		 IS_ENABLED(CONFIG_MUTEX_ADAPTIVE_SPIN) ? "on" : "off",
+		 NUM_THREADS);
+	TC_PRINT("%12s %14s\n", "hold cycles", "locks/s");
+
+	/* Stay out of the way of the threads being measured */
+	k_thread_priority_set(k_current_get(), K_PRIO_PREEMPT(14));
+
+	for (int i = 0; i < ARRAY_SIZE(hold_cycles); i++) {
+		TC_PRINT("%12u %14u\n", hold_cycles[i], run(hold_cycles[i]));
+	}
+
+	TC_END_RESULT(TC_PASS);
+	TC_END_REPORT(TC_PASS);
+}
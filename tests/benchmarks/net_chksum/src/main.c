@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Measure the network checksum throughput
+ *
+ * Times the checksum of UDP over IPv4 packets of several sizes, computed
+ * by the stack over network buffers and by a reference byte pair loop
+ * over a contiguous buffer, and the incremental update of a checksum.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <bench.h>
+#include <random/rand32.h>
+#include <net/net_pkt.h>
+#include <net/net_ip.h>
+
+#include "net_private.h"
+
+#define SAMPLES 200
+#define MAX_SIZE 1500
+
+BENCH_DEFINE(ref_64, SAMPLES, 1, 1);
+BENCH_DEFINE(pkt_64, SAMPLES, 1, 1);
+BENCH_DEFINE(ref_576, SAMPLES, 1, 1);
+BENCH_DEFINE(pkt_576, SAMPLES, 1, 1);
+BENCH_DEFINE(ref_1500, SAMPLES, 1, 1);
+BENCH_DEFINE(pkt_1500, SAMPLES, 1, 1);
+BENCH_DEFINE(update, SAMPLES, 1, 100);
+
+static u8_t data[MAX_SIZE];
+static volatile u16_t sink;
+
+struct ref_args {
+	const u8_t *ptr;
+	u16_t len;
+};
+
+/* The byte pair at a time checksum loop the stack used to have */
+static void ref_chksum(void *arg)
+{
+	struct ref_args *args = arg;
+	const u8_t *ptr = args->ptr;
+	const u8_t *end = ptr + args->len - 1;
+	u16_t sum = 0;
+	u16_t tmp;
+
+	while (ptr < end) {
+		tmp = (ptr[0] << 8) + ptr[1];
+		sum += tmp;
+		if (sum < tmp) {
+			sum++;
+		}
+		ptr += 2;
+	}
+
+	if (ptr == end) {
+		tmp = ptr[0] << 8;
+		sum += tmp;
+		if (sum < tmp) {
+			sum++;
+		}
+	}
+
+	sink = sum;
+}
+
+static void pkt_chksum(void *arg)
+{
+	sink = net_calc_chksum_udp(arg);
+}
+
+static void update_chksum(void *arg)
+{
+	u32_t *seq = arg;
+
+	sink = net_chksum_update_32(sink, *seq, *seq + 1);
+	(*seq)++;
+}
+
+static struct net_pkt *pkt_create(u16_t size)
+{
+	struct net_ipv4_hdr hdr = {
+		.vhl = 0x45,
+		.len = htons(size),
+		.ttl = 64,
+		.proto = IPPROTO_UDP,
+		.src = { { { 192, 0, 2, 1 } } },
+		.dst = { { { 192, 0, 2, 2 } } },
+	};
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_get_reserve_tx(0, K_FOREVER);
+
+	net_pkt_set_family(pkt, AF_INET);
+	net_pkt_set_ip_hdr_len(pkt, sizeof(hdr));
+
+	net_pkt_append_all(pkt, sizeof(hdr), (u8_t *)&hdr, K_FOREVER);
+	net_pkt_append_all(pkt, size - sizeof(hdr), data, K_FOREVER);
+
+	return pkt;
+}
+
+static void run(struct bench *ref, struct bench *b, u16_t size)
+{
+	struct ref_args args = {
+		.ptr = data,
+		.len = size - sizeof(struct net_ipv4_hdr),
+	};
+	struct net_pkt *pkt = pkt_create(size);
+
+	bench_run(ref, ref_chksum, &args);
+	bench_report(ref);
+
+	bench_run(b, pkt_chksum, pkt);
+	bench_report(b);
+
+	net_pkt_unref(pkt);
+}
+
+void main(void)
+{
+	u32_t seq = 0;
+
+	TC_START("Network Checksum Benchmark");
+
+	for (int i = 0; i < MAX_SIZE; i++) {
+		data[i] = sys_rand32_get();
+	}
+
+	run(&ref_64, &pkt_64, 64);
+	run(&ref_576, &pkt_576, 576);
+	run(&ref_1500, &pkt_1500, 1500);
+
+	bench_run(&update, update_chksum, &seq);
+	bench_report(&update);
+
+	TC_END_RESULT(TC_PASS);
+	TC_END_REPORT(TC_PASS);
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Measure the cost of finding the connection of a packet
+ *
+ * Registers 8, 64 and 512 connected UDP connections, from one remote host
+ * and as many remote ports, besides a listening connection, and times
+ * net_conn_input() for a packet of a connection and for one going to the
+ * listener.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <bench.h>
+#include <net/net_pkt.h>
+#include <net/net_ip.h>
+
+#include "connection.h"
+
+#define SAMPLES 200
+#define MAX_CONNS 512
+#define LOCAL_PORT 4242
+#define REMOTE_PORT_BASE 10000
+
+BENCH_DEFINE(connected_8, SAMPLES, 1, 1);
+BENCH_DEFINE(listener_8, SAMPLES, 1, 1);
+BENCH_DEFINE(connected_64, SAMPLES, 1, 1);
+BENCH_DEFINE(listener_64, SAMPLES, 1, 1);
+BENCH_DEFINE(connected_512, SAMPLES, 1, 1);
+BENCH_DEFINE(listener_512, SAMPLES, 1, 1);
+
+static struct net_conn_handle *handles[MAX_CONNS];
+static struct net_conn_handle *listener;
+
+static struct sockaddr_in local_addr = {
+	.sin_family = AF_INET,
+	.sin_addr = { { { 192, 0, 2, 1 } } },
+};
+
+static struct sockaddr_in remote_addr = {
+	.sin_family = AF_INET,
+	.sin_addr = { { { 192, 0, 2, 2 } } },
+};
+
+static volatile u32_t received;
+
+static enum net_verdict recv_cb(struct net_conn *conn, struct net_pkt *pkt,
+				void *user_data)
+{
+	ARG_UNUSED(conn);
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(user_data);
+
+	received++;
+
+	/* Keep the packet for the next sample */
+	return NET_OK;
+}
+
+static struct net_pkt *pkt_create(u16_t src_port)
+{
+	struct net_ipv4_hdr ip = {
+		.vhl = 0x45,
+		.len = htons(sizeof(struct net_ipv4_hdr) +
+			     sizeof(struct net_udp_hdr)),
+		.ttl = 64,
+		.proto = IPPROTO_UDP,
+	};
+	struct net_udp_hdr udp = {
+		.src_port = htons(src_port),
+		.dst_port = htons(LOCAL_PORT),
+		.len = htons(sizeof(struct net_udp_hdr)),
+	};
+	struct net_pkt *pkt;
+
+	net_ipaddr_copy(&ip.src, &remote_addr.sin_addr);
+	net_ipaddr_copy(&ip.dst, &local_addr.sin_addr);
+
+	pkt = net_pkt_get_reserve_rx(0, K_FOREVER);
+
+	net_pkt_set_family(pkt, AF_INET);
+	net_pkt_set_ip_hdr_len(pkt, sizeof(ip));
+
+	net_pkt_append_all(pkt, sizeof(ip), (u8_t *)&ip, K_FOREVER);
+	net_pkt_append_all(pkt, sizeof(udp), (u8_t *)&udp, K_FOREVER);
+
+	return pkt;
+}
+
+static void input(void *arg)
+{
+	net_conn_input(IPPROTO_UDP, arg);
+}
+
+static void run(struct bench *connected, struct bench *to_listener,
+		int nconns)
+{
+	static int registered;
+	struct net_pkt *pkt;
+
+	for (; registered < nconns; registered++) {
+		net_conn_register(IPPROTO_UDP,
+				  (struct sockaddr *)&remote_addr,
+				  (struct sockaddr *)&local_addr,
+				  REMOTE_PORT_BASE + registered, LOCAL_PORT,
+				  recv_cb, NULL, &handles[registered]);
+	}
+
+	pkt = pkt_create(REMOTE_PORT_BASE + nconns - 1);
+	bench_run(connected, input, pkt);
+	bench_report(connected);
+	net_pkt_unref(pkt);
+
+	pkt = pkt_create(REMOTE_PORT_BASE - 1);
+	bench_run(to_listener, input, pkt);
+	bench_report(to_listener);
+	net_pkt_unref(pkt);
+}
+
+void main(void)
+{
+	TC_START("Network Connection Lookup Benchmark");
+
+	net_conn_register(IPPROTO_UDP, NULL, (struct sockaddr *)&local_addr,
+			  0, LOCAL_PORT, recv_cb, NULL, &listener);
+
+	run(&connected_8, &listener_8, 8);
+	run(&connected_64, &listener_64, 64);
+	run(&connected_512, &listener_512, 512);
+
+	TC_PRINT("%u packets received\n", received);
+
+	TC_END_RESULT(TC_PASS);
+	TC_END_REPORT(TC_PASS);
+}
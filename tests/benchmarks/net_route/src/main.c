@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Measure the cost of the routing decision for a forwarded packet
+ *
+ * Fills the routing table of an interface with 16, 256 and 4096 routes, a
+ * mix of /48, /64 and /128 prefixes under a /16 one, and times
+ * net_route_get_info() for a destination of a single flow, and for
+ * destinations spread over all the routes.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <bench.h>
+#include <net/net_if.h>
+#include <net/net_ip.h>
+
+#include "ipv6.h"
+#include "route.h"
+
+#define SAMPLES 200
+#define MAX_ROUTES 4096
+#define SPREAD 64
+
+BENCH_DEFINE(flow_16, SAMPLES, 1, 1);
+BENCH_DEFINE(spread_16, SAMPLES, 1, SPREAD);
+BENCH_DEFINE(flow_256, SAMPLES, 1, 1);
+BENCH_DEFINE(spread_256, SAMPLES, 1, SPREAD);
+BENCH_DEFINE(flow_4096, SAMPLES, 1, 1);
+BENCH_DEFINE(spread_4096, SAMPLES, 1, SPREAD);
+
+static u8_t nexthop_mac[] = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x01 };
+static u8_t iface_mac[] = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x02 };
+
+static struct in6_addr nexthop_addr = { { { 0xfe, 0x80, 0, 0, 0, 0, 0, 0,
+					    0, 0, 0, 0, 0, 0, 0, 0x1 } } };
+
+static struct in6_addr covering_prefix = { { { 0x20, 0x01 } } };
+
+static struct in6_addr dst_addrs[MAX_ROUTES];
+static int nroutes;
+static int next_dst;
+static struct net_if *iface;
+
+static int bench_dev_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return 0;
+}
+
+static void bench_iface_init(struct net_if *iface)
+{
+	net_if_set_link_addr(iface, iface_mac, sizeof(iface_mac),
+			     NET_LINK_ETHERNET);
+}
+
+static int bench_send(struct net_if *iface, struct net_pkt *pkt)
+{
+	ARG_UNUSED(iface);
+
+	net_pkt_unref(pkt);
+
+	return 0;
+}
+
+static struct net_if_api bench_if_api = {
+	.init = bench_iface_init,
+	.send = bench_send,
+};
+
+NET_DEVICE_INIT(net_route_bench, "net_route_bench",
+		bench_dev_init, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+		&bench_if_api, DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), 127);
+
+/* Route i is 2001:db8:x:y::/64 with x and y scattered over the address
+ * space, every eighth one a /48 and every fourth one a /128. Its
+ * destination is host 1 in it.
+ */
+static void route_add(int i)
+{
+	struct in6_addr addr = { { { 0x20, 0x01, 0x0d, 0xb8 } } };
+	u32_t hash = (i + 1) * 2654435761U;
+	u8_t prefix_len = 64;
+
+	addr.s6_addr32[1] = htonl(hash);
+	addr.s6_addr[15] = 1;
+
+	if (i % 8 == 7) {
+		prefix_len = 48;
+	} else if (i % 4 == 3) {
+		prefix_len = 128;
+	}
+
+	net_ipaddr_copy(&dst_addrs[i], &addr);
+
+	if (!net_route_add(iface, &addr, prefix_len, &nexthop_addr)) {
+		TC_PRINT("Cannot add route %d\n", i);
+	}
+}
+
+static void route_get_info(void *arg)
+{
+	struct net_route_entry *route;
+	struct in6_addr *nexthop;
+
+	net_route_get_info(iface, arg, &route, &nexthop);
+}
+
+static void route_get_info_spread(void *arg)
+{
+	ARG_UNUSED(arg);
+
+	route_get_info(&dst_addrs[next_dst]);
+	next_dst = (next_dst + 1) % nroutes;
+}
+
+static void run(struct bench *flow, struct bench *spread, int n)
+{
+	for (; nroutes < n; nroutes++) {
+		route_add(nroutes);
+	}
+
+	bench_run(flow, route_get_info, &dst_addrs[n - 1]);
+	bench_report(flow);
+
+	next_dst = 0;
+	bench_run(spread, route_get_info_spread, NULL);
+	bench_report(spread);
+}
+
+void main(void)
+{
+	struct net_linkaddr lladdr = {
+		.addr = nexthop_mac,
+		.len = sizeof(nexthop_mac),
+		.type = NET_LINK_ETHERNET,
+	};
+
+	TC_START("IPv6 Route Lookup Benchmark");
+
+	iface = net_if_get_default();
+
+	if (!net_ipv6_nbr_add(iface, &nexthop_addr, &lladdr, false,
+			      NET_IPV6_NBR_STATE_REACHABLE)) {
+		TC_PRINT("Cannot add next hop neighbor\n");
+		TC_END_RESULT(TC_FAIL);
+		TC_END_REPORT(TC_FAIL);
+		return;
+	}
+
+	net_route_add(iface, &covering_prefix, 16, &nexthop_addr);
+
+	run(&flow_16, &spread_16, 16);
+	run(&flow_256, &spread_256, 256);
+	run(&flow_4096, &spread_4096, 4096);
+
+	TC_END_RESULT(TC_PASS);
+	TC_END_REPORT(TC_PASS);
+}
@@ -0,0 +1,386 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Measure TCP throughput over a lossy link
+ *
+ * A client and a server in the same stack talk over a dummy interface
+ * whose driver turns every packet around after a fixed delay, dropping
+ * some at random on the way. The client sends a fixed amount of data
+ * with each congestion control algorithm, at several loss rates, and the
+ * time the server takes to get all of it is reported.
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <tc_util.h>
+#include <net/net_if.h>
+#include <net/net_ip.h>
+#include <net/net_pkt.h>
+#include <net/net_context.h>
+
+#include "tcp_internal.h"
+
+#define TRANSFER (128 * 1024)
+#define CHUNK 1024
+
+/* Data the client may have sent that the server did not get yet, so that
+ * it does not take all the buffers the stack needs for ACKs.
+ */
+#define MAX_QUEUED (20 * 1024)
+
+/* Our receive window is small by default, the server opens it up to
+ * this so that the congestion window is what limits the sender.
+ */
+#define RECV_WINDOW (16 * 1024)
+
+#define ONE_WAY_DELAY_MS 5
+#define LINK_QUEUE 128
+#define SERVER_PORT 4242
+#define TRANSFER_TIMEOUT K_SECONDS(120)
+
+static u8_t iface_mac[] = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x01 };
+
+static struct in_addr local_addr = { { { 192, 0, 2, 1 } } };
+static struct in_addr peer_addr = { { { 192, 0, 2, 2 } } };
+static struct in_addr netmask = { { { 255, 255, 255, 0 } } };
+
+static struct {
+	struct net_pkt *pkt;
+	u32_t due;
+} link_queue[LINK_QUEUE];
+
+static u32_t link_head;
+static u32_t link_tail;
+static K_SEM_DEFINE(link_sem, 0, LINK_QUEUE);
+
+/* Loss rate in 1/1000, applied once a connection is established only,
+ * as handshakes are not retried.
+ */
+static u32_t loss;
+static u32_t rand_state;
+static u32_t dropped;
+
+static struct net_if *iface;
+static struct net_context *listen_ctx;
+static struct net_context *server_ctx;
+static volatile u32_t received;
+static K_SEM_DEFINE(accepted, 0, 1);
+static K_SEM_DEFINE(done, 0, 1);
+
+static u8_t chunk[CHUNK];
+
+static int bench_dev_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return 0;
+}
+
+static void bench_iface_init(struct net_if *iface)
+{
+	net_if_set_link_addr(iface, iface_mac, sizeof(iface_mac),
+			     NET_LINK_ETHERNET);
+}
+
+/* A deterministic sequence, so that runs are comparable */
+static bool link_lose(void)
+{
+	rand_state = rand_state * 1103515245 + 12345;
+
+	return ((rand_state >> 16) % 1000) < loss;
+}
+
+/* Everything is sent to the peer address. Swapping the addresses makes
+ * it a packet from the peer, with the checksums still valid.
+ */
+static int bench_send(struct net_if *iface, struct net_pkt *pkt)
+{
+	struct net_ipv4_hdr *hdr;
+	struct net_pkt *clone;
+	struct in_addr addr;
+	unsigned int key;
+
+	ARG_UNUSED(iface);
+
+	if (link_lose()) {
+		dropped++;
+		goto out;
+	}
+
+	clone = net_pkt_clone(pkt, K_NO_WAIT);
+	if (!clone) {
+		dropped++;
+		goto out;
+	}
+
+	hdr = NET_IPV4_HDR(clone);
+	net_ipaddr_copy(&addr, &hdr->src);
+	net_ipaddr_copy(&hdr->src, &hdr->dst);
+	net_ipaddr_copy(&hdr->dst, &addr);
+	net_pkt_set_context(clone, NULL);
+
+	key = irq_lock();
+
+	if (link_head - link_tail == LINK_QUEUE) {
+		irq_unlock(key);
+		net_pkt_unref(clone);
+		dropped++;
+		goto out;
+	}
+
+	link_queue[link_head % LINK_QUEUE].pkt = clone;
+	link_queue[link_head % LINK_QUEUE].due = k_uptime_get_32() +
+						 ONE_WAY_DELAY_MS;
+	link_head++;
+
+	irq_unlock(key);
+
+	k_sem_give(&link_sem);
+
+out:
+	net_pkt_unref(pkt);
+
+	return 0;
+}
+
+static struct net_if_api bench_if_api = {
+	.init = bench_iface_init,
+	.send = bench_send,
+};
+
+NET_DEVICE_INIT(net_tcp_bench, "net_tcp_bench",
+		bench_dev_init, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+		&bench_if_api, DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), 1500);
+
+static void link_main(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		struct net_pkt *pkt;
+		s32_t wait;
+
+		k_sem_take(&link_sem, K_FOREVER);
+
+		/* Only this thread moves the tail, no need to lock */
+		wait = link_queue[link_tail % LINK_QUEUE].due -
+		       k_uptime_get_32();
+		if (wait > 0) {
+			k_sleep(wait);
+		}
+
+		pkt = link_queue[link_tail % LINK_QUEUE].pkt;
+		link_tail++;
+
+		if (net_recv_data(iface, pkt) < 0) {
+			net_pkt_unref(pkt);
+		}
+	}
+}
+
+K_THREAD_DEFINE(link_thread, 1024, link_main, NULL, NULL, NULL,
+		K_PRIO_COOP(7), 0, K_NO_WAIT);
+
+static void server_recv(struct net_context *context, struct net_pkt *pkt,
+			int status, void *user_data)
+{
+	ARG_UNUSED(context);
+	ARG_UNUSED(status);
+	ARG_UNUSED(user_data);
+
+	if (!pkt) {
+		return;
+	}
+
+	received += net_pkt_appdatalen(pkt);
+	net_pkt_unref(pkt);
+
+	if (received == TRANSFER) {
+		k_sem_give(&done);
+	}
+}
+
+static void server_accept(struct net_context *context, struct sockaddr *addr,
+			  socklen_t addrlen, int status, void *user_data)
+{
+	ARG_UNUSED(addr);
+	ARG_UNUSED(addrlen);
+	ARG_UNUSED(user_data);
+
+	if (status) {
+		return;
+	}
+
+	server_ctx = context;
+
+	net_context_update_recv_wnd(context, RECV_WINDOW -
+				    net_tcp_get_recv_wnd(context->tcp));
+	net_context_recv(context, server_recv, K_NO_WAIT, NULL);
+
+	k_sem_give(&accepted);
+}
+
+static int server_start(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+		.sin_addr = local_addr,
+	};
+	int ret;
+
+	ret = net_context_get(AF_INET, SOCK_STREAM, IPPROTO_TCP, &listen_ctx);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = net_context_bind(listen_ctx, (struct sockaddr *)&addr,
+			       sizeof(addr));
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = net_context_listen(listen_ctx, 0);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return net_context_accept(listen_ctx, server_accept, K_NO_WAIT, NULL);
+}
+
+static int client_send(struct net_context *ctx)
+{
+	u32_t sent;
+
+	for (sent = 0; sent < TRANSFER; sent += CHUNK) {
+		struct net_pkt *pkt;
+
+		while (sent - received > MAX_QUEUED) {
+			k_sleep(1);
+		}
+
+		pkt = net_pkt_get_tx(ctx, K_FOREVER);
+		if (!net_pkt_append_all(pkt, CHUNK, chunk, K_FOREVER)) {
+			net_pkt_unref(pkt);
+			return -ENOMEM;
+		}
+
+		if (net_context_send(pkt, NULL, K_NO_WAIT, NULL, NULL) < 0) {
+			net_pkt_unref(pkt);
+			return -EIO;
+		}
+	}
+
+	return 0;
+}
+
+static bool run(const char *cc, u32_t loss_permille)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+		.sin_addr = peer_addr,
+	};
+	struct net_context *ctx;
+	u32_t start, elapsed;
+	bool ok = false;
+
+	loss = 0;
+	rand_state = 1;
+	dropped = 0;
+	received = 0;
+	k_sem_reset(&accepted);
+	k_sem_reset(&done);
+
+	if (net_context_get(AF_INET, SOCK_STREAM, IPPROTO_TCP, &ctx) < 0) {
+		TC_PRINT("Cannot get client context\n");
+		return false;
+	}
+
+	if (net_context_set_option(ctx, NET_OPT_TCP_CONGESTION, cc,
+				   strlen(cc)) < 0) {
+		TC_PRINT("Cannot use %s\n", cc);
+		goto out;
+	}
+
+	if (net_context_connect(ctx, (struct sockaddr *)&addr, sizeof(addr),
+				NULL, K_SECONDS(1), NULL) < 0 ||
+	    k_sem_take(&accepted, K_SECONDS(1))) {
+		TC_PRINT("Cannot connect\n");
+		goto out;
+	}
+
+	loss = loss_permille;
+	start = k_uptime_get_32();
+
+	if (client_send(ctx) < 0 || k_sem_take(&done, TRANSFER_TIMEOUT)) {
+		TC_PRINT("%-8s %3u.%u%% transfer failed at %u bytes\n", cc,
+			 loss_permille / 10, loss_permille % 10, received);
+		goto out;
+	}
+
+	elapsed = max(k_uptime_get_32() - start, 1);
+	loss = 0;
+
+	TC_PRINT("%-8s %3u.%u%% %8u %8u %8u\n", cc, loss_permille / 10,
+		 loss_permille % 10, elapsed, TRANSFER / elapsed, dropped);
+
+	ok = true;
+
+out:
+	loss = 0;
+	net_context_put(ctx);
+
+	if (server_ctx) {
+		net_context_put(server_ctx);
+		server_ctx = NULL;
+	}
+
+	/* let the connections go away */
+	k_sleep(K_SECONDS(2));
+
+	return ok;
+}
+
+void main(void)
+{
+	static const char * const ccs[] = { "newreno", "cubic" };
+	static const u32_t losses[] = { 0, 10, 50 };
+	bool ok = true;
+	int i, j;
+
+	TC_START("TCP Throughput over a Lossy Link Benchmark");
+
+	iface = net_if_get_default();
+
+	net_if_ipv4_addr_add(iface, &local_addr, NET_ADDR_MANUAL, 0);
+	net_if_ipv4_set_netmask(iface, &netmask);
+
+	if (server_start() < 0) {
+		TC_PRINT("Cannot start server\n");
+		TC_END_RESULT(TC_FAIL);
+		TC_END_REPORT(TC_FAIL);
+		return;
+	}
+
+	TC_PRINT("%u bytes, %u ms each way\n", TRANSFER, ONE_WAY_DELAY_MS);
+	TC_PRINT("%-8s %6s %8s %8s %8s\n", "cc", "loss", "ms", "kB/s",
+		 "dropped");
+
+	for (i = 0; i < ARRAY_SIZE(ccs); i++) {
+		for (j = 0; j < ARRAY_SIZE(losses); j++) {
+			ok &= run(ccs[i], losses[j]);
+		}
+	}
+
+	TC_END_RESULT(ok ? TC_PASS : TC_FAIL);
+	TC_END_REPORT(ok ? TC_PASS : TC_FAIL);
+}
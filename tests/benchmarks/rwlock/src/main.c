@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Measure read-side scaling of read-mostly locking
+ *
+ * Runs 1 to MAX_READERS reader threads, each summing a small shared table
+ * for RUN_MS milliseconds, and reports the total number of table lookups
+ * per second with the table protected by a k_mutex, a k_rwlock and RCU.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+
+#define MAX_READERS 4
+#define RUN_MS 500
+#define TABLE_SIZE 8
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define PRIO K_PRIO_PREEMPT(10)
+
+enum method {
+	METHOD_MUTEX,
+	METHOD_RWLOCK,
+	METHOD_RCU,
+	METHOD_COUNT
+};
+
+static const char * const method_names[METHOD_COUNT] = {
+	"k_mutex", "k_rwlock", "rcu"
+};
+
+struct table {
+	u32_t entry[TABLE_SIZE];
+};
+
+static struct table table_data;
+static struct table *table = &table_data;
+
+static K_MUTEX_DEFINE(mutex);
+static K_RWLOCK_DEFINE(rwlock);
+static K_SEM_DEFINE(done, 0, MAX_READERS);
+
+static struct k_thread threads[MAX_READERS];
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, MAX_READERS, STACK_SIZE);
+
+static u32_t counts[MAX_READERS];
+static volatile u32_t sink;
+
+static u32_t table_sum(struct table *t)
+{
+	u32_t sum = 0;
+
+	for (int i = 0; i < TABLE_SIZE; i++) {
+		sum += t->entry[i];
+	}
+
+	return sum;
+}
+
+static void reader(void *p1, void *p2, void *p3)
+{
+	u32_t *count = p1;
+	enum method method = (enum method)p2;
+	u32_t end = k_uptime_get_32() + RUN_MS;
+	u32_t sum = 0;
+
+	ARG_UNUSED(p3);
+
+	while ((s32_t)(end - k_uptime_get_32()) > 0) {
+		switch (method) {
+		case METHOD_MUTEX:
+			k_mutex_lock(&mutex, K_FOREVER);
+			sum += table_sum(table);
+			k_mutex_unlock(&mutex);
+			break;
+		case METHOD_RWLOCK:
+			k_rwlock_read_lock(&rwlock, K_FOREVER);
+			sum += table_sum(table);
+			k_rwlock_read_unlock(&rwlock);
+			break;
+		default:
+			k_rcu_read_lock();
+			sum += table_sum(K_RCU_DEREF(table));
+			k_rcu_read_unlock();
+			break;
+		}
+
+		(*count)++;
+	}
+
+	sink = sum;
+	k_sem_give(&done);
+}
+
+static u32_t run(int nreaders, enum method method)
+{
+	u32_t start, elapsed, total = 0;
+
+	start = k_uptime_get_32();
+
+	/* Keep everything from starting until all threads exist */
+	k_sched_lock();
+	for (int i = 0; i < nreaders; i++) {
+		counts[i] = 0;
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE, reader,
+				&counts[i], (void *)method, NULL, PRIO, 0,
+				K_NO_WAIT);
+	}
+	k_sched_unlock();
+
+	for (int i = 0; i < nreaders; i++) {
+		k_sem_take(&done, K_FOREVER);
+		total += counts[i];
+	}
+
+	/* Readers that did not get to run in parallel ran one after the
+	 * other, so rate over the time all of them took
+	 */
+	elapsed = k_uptime_get_32() - start;
+
+	return (u32_t)(((u64_t)total * MSEC_PER_SEC) / elapsed);
+}
+
+void main(void)
+{
+	TC_START("Reader Scaling Benchmark");
+
+	TC_PRINT("%d CPUs, lookups/s of a %d entry table\n",
+		 CONFIG_MP_NUM_CPUS, TABLE_SIZE);
+	TC_PRINT("%8s", "readers");
+	for (int m = 0; m < METHOD_COUNT; m++) {
+		TC_PRINT(" %12s", method_names[m]);
+	}
+	TC_PRINT("\n");
+
+	/* Stay out of the way of the threads being measured */
+	k_thread_priority_set(k_current_get(), K_PRIO_PREEMPT(14));
+
+	for (int n = 1; n <= MAX_READERS; n++) {
+		TC_PRINT("%8d", n);
+		for (int m = 0; m < METHOD_COUNT; m++) {
+			TC_PRINT(" %12u", run(n, m));
+		}
+		TC_PRINT("\n");
+	}
+
+	TC_END_RESULT(TC_PASS);
+	TC_END_REPORT(TC_PASS);
+}
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Measure SMP scheduler scaling
+ *
+ * Runs 1 to CONFIG_MP_NUM_CPUS pairs of threads concurrently and reports,
+ * for each number of pairs, the average cost of:
+ *  1. a k_yield() context switch between two threads of equal priority
+ *  2. a wakeup, from k_sem_give() until the woken higher priority
+ *     thread runs
+ *
+ * With CONFIG_SCHED_CPU_MASK each pair is pinned to its own CPU, so the
+ * numbers show how much CPUs get in each other's way when scheduling.
+ * Timestamps are only compared between threads of the same pair, since
+ * cycle counters are not necessarily synchronized between CPUs.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+
+#if CONFIG_MP_NUM_CPUS < 2
+#error SMP benchmark requires at least two CPUs!
+#endif
+
+#define ITERATIONS 1000
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define MAX_PAIRS CONFIG_MP_NUM_CPUS
+#define LOW_PRIO K_PRIO_PREEMPT(10)
+#define HIGH_PRIO K_PRIO_PREEMPT(5)
+
+struct pair {
+	struct k_sem wake;
+	struct k_sem ack;
+	volatile u32_t stamp;
+	u32_t yield_cycles;
+	u32_t wake_cycles;
+};
+
+static struct pair pairs[MAX_PAIRS];
+static struct k_thread threads[2 * MAX_PAIRS];
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, 2 * MAX_PAIRS, STACK_SIZE);
+
+static K_SEM_DEFINE(done, 0, 2 * MAX_PAIRS);
+
+static void yielder(void *p1, void *p2, void *p3)
+{
+	struct pair *p = p1;
+	int leader = (int)p2;
+	u32_t start = k_cycle_get_32();
+
+	ARG_UNUSED(p3);
+
+	for (int i = 0; i < ITERATIONS; i++) {
+		k_yield();
+	}
+
+	/* Both threads yield to each other, so each one's loop spans
+	 * 2 * ITERATIONS switches
+	 */
+	if (leader) {
+		p->yield_cycles = (k_cycle_get_32() - start) /
+			(2 * ITERATIONS);
+	}
+
+	k_sem_give(&done);
+}
+
+static void waker(void *p1, void *p2, void *p3)
+{
+	struct pair *p = p1;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (int i = 0; i < ITERATIONS; i++) {
+		p->stamp = k_cycle_get_32();
+		k_sem_give(&p->wake);
+		k_sem_take(&p->ack, K_FOREVER);
+	}
+
+	k_sem_give(&done);
+}
+
+static void wakee(void *p1, void *p2, void *p3)
+{
+	struct pair *p = p1;
+	u32_t total = 0;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (int i = 0; i < ITERATIONS; i++) {
+		k_sem_take(&p->wake, K_FOREVER);
+		total += k_cycle_get_32() - p->stamp;
+		k_sem_give(&p->ack);
+	}
+
+	p->wake_cycles = total / ITERATIONS;
+	k_sem_give(&done);
+}
+
+static void spawn(int idx, int cpu, k_thread_entry_t fn, void *p1, void *p2,
+		  int prio)
+{
+	k_tid_t tid = k_thread_create(&threads[idx], stacks[idx], STACK_SIZE,
+				      fn, p1, p2, NULL, prio, 0, K_FOREVER);
+
+#ifdef CONFIG_SCHED_CPU_MASK
+	k_thread_cpu_mask_clear(tid);
+	k_thread_cpu_mask_enable(tid, cpu);
+#else
+	ARG_UNUSED(cpu);
+#endif
+
+	k_thread_start(tid);
+}
+
+static void run(int npairs, k_thread_entry_t a, k_thread_entry_t b,
+		int prio_a, int prio_b)
+{
+	for (int i = 0; i < npairs; i++) {
+		k_sem_init(&pairs[i].wake, 0, 1);
+		k_sem_init(&pairs[i].ack, 0, 1);
+	}
+
+	/* Keep everything from starting until all threads exist */
+	k_sched_lock();
+	for (int i = 0; i < npairs; i++) {
+		spawn(2 * i, i, a, &pairs[i], (void *)1, prio_a);
+		spawn(2 * i + 1, i, b, &pairs[i], (void *)0, prio_b);
+	}
+	k_sched_unlock();
+
+	for (int i = 0; i < 2 * npairs; i++) {
+		k_sem_take(&done, K_FOREVER);
+	}
+}
+
+static u32_t average(int npairs, size_t offset)
+{
+	u32_t sum = 0;
+
+	for (int i = 0; i < npairs; i++) {
+		sum += *(u32_t *)((char *)&pairs[i] + offset);
+	}
+
+	return sum / npairs;
+}
+
+void main(void)
+{
+	TC_START("SMP Scheduler Benchmark");
+
+	TC_PRINT("Ready queue: %s, CPU affinity: %s\n",
+		 IS_ENABLED(CONFIG_SCHED_PER_CPU_RUNQ) ? "per-CPU" : "global",
+		 IS_ENABLED(CONFIG_SCHED_CPU_MASK) ? "pinned" : "none");
+	TC_PRINT("%6s %14s %14s  (cycles, avg of %d)\n",
+		 "pairs", "yield switch", "wakeup", ITERATIONS);
+
+	/* Stay out of the way of the pairs being measured */
+	k_thread_priority_set(k_current_get(), K_PRIO_PREEMPT(14));
+
+	for (int n = 1; n <= MAX_PAIRS; n++) {
+		u32_t yield, wake;
+
+		run(n, yielder, yielder, LOW_PRIO, LOW_PRIO);
+		yield = average(n, offsetof(struct pair, yield_cycles));
+
+		run(n, waker, wakee, LOW_PRIO, HIGH_PRIO);
+		wake = average(n, offsetof(struct pair, wake_cycles));
+
+		TC_PRINT("%6d %14u %14u\n", n, yield, wake);
+	}
+
+	TC_END_RESULT(TC_PASS);
+	TC_END_REPORT(TC_PASS);
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Measure the latency of deferred interrupt work
+ *
+ * A periodic timer ISR time stamps itself and defers to a handler, either
+ * through the system workqueue or a softirq, and the handler measures how
+ * long it took to start. Both are measured on an idle system and with the
+ * system workqueue busy with housekeeping work.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+
+#define SAMPLES 100
+#define PERIOD_MS 10
+
+/* housekeeping work items kept queued, and how long each one runs */
+#define HOUSEKEEPING_ITEMS 4
+#define HOUSEKEEPING_US 500
+
+enum method {
+	METHOD_WORK,
+	METHOD_SOFTIRQ,
+};
+
+struct result {
+	u32_t min;
+	u32_t max;
+	u64_t sum;
+	u32_t count;
+};
+
+static enum method method;
+static volatile u32_t irq_stamp;
+static struct result result;
+static K_SEM_DEFINE(done, 0, 1);
+
+static struct k_work housekeeping[HOUSEKEEPING_ITEMS];
+static volatile bool housekeeping_on;
+
+static void record(void)
+{
+	u32_t latency = k_cycle_get_32() - irq_stamp;
+
+	if (result.count == SAMPLES) {
+		return;
+	}
+
+	result.min = min(result.min, latency);
+	result.max = max(result.max, latency);
+	result.sum += latency;
+
+	if (++result.count == SAMPLES) {
+		k_sem_give(&done);
+	}
+}
+
+static void work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	record();
+}
+
+static int softirq_handler(struct k_softirq *softirq, int budget)
+{
+	ARG_UNUSED(softirq);
+	ARG_UNUSED(budget);
+
+	record();
+
+	return 1;
+}
+
+static K_WORK_DEFINE(work, work_handler);
+static K_SOFTIRQ_DEFINE(softirq, softirq_handler, 0);
+
+static void timer_isr(struct k_timer *timer)
+{
+	ARG_UNUSED(timer);
+
+	irq_stamp = k_cycle_get_32();
+
+	if (method == METHOD_WORK) {
+		k_work_submit(&work);
+	} else {
+		(void)k_softirq_raise(&softirq);
+	}
+}
+
+static K_TIMER_DEFINE(timer, timer_isr, NULL);
+
+static void housekeeping_handler(struct k_work *item)
+{
+	k_busy_wait(HOUSEKEEPING_US);
+
+	if (housekeeping_on) {
+		k_work_submit(item);
+	}
+}
+
+static void run(const char *name, enum method m, bool busy)
+{
+	u32_t avg;
+
+	result = (struct result){ .min = UINT32_MAX };
+	method = m;
+
+	housekeeping_on = busy;
+	if (busy) {
+		for (int i = 0; i < HOUSEKEEPING_ITEMS; i++) {
+			k_work_submit(&housekeeping[i]);
+		}
+	}
+
+	k_timer_start(&timer, K_MSEC(PERIOD_MS), K_MSEC(PERIOD_MS));
+	k_sem_take(&done, K_FOREVER);
+	k_timer_stop(&timer);
+
+	housekeeping_on = false;
+	/* let the housekeeping and any last deferral drain */
+	k_sleep(PERIOD_MS + HOUSEKEEPING_ITEMS * HOUSEKEEPING_US / 1000 + 1);
+
+	avg = (u32_t)(result.sum / result.count);
+	TC_PRINT("%-10s %-5s %8u %8u %8u   (%u/%u/%u ns)\n", name,
+		 busy ? "busy" : "idle", result.min, avg, result.max,
+		 SYS_CLOCK_HW_CYCLES_TO_NS(result.min),
+		 SYS_CLOCK_HW_CYCLES_TO_NS(avg),
+		 SYS_CLOCK_HW_CYCLES_TO_NS(result.max));
+}
+
+void main(void)
+{
+	TC_START("Deferred Interrupt Latency Benchmark");
+
+	for (int i = 0; i < HOUSEKEEPING_ITEMS; i++) {
+		k_work_init(&housekeeping[i], housekeeping_handler);
+	}
+
+	TC_PRINT("ISR to deferred handler latency over %d samples, cycles\n",
+		 SAMPLES);
+	TC_PRINT("%-10s %-5s %8s %8s %8s\n", "method", "load", "min", "avg",
+		 "max");
+
+	run("k_work", METHOD_WORK, false);
+	run("softirq", METHOD_SOFTIRQ, false);
+	run("k_work", METHOD_WORK, true);
+	run("softirq", METHOD_SOFTIRQ, true);
+
+	TC_END_RESULT(TC_PASS);
+	TC_END_REPORT(TC_PASS);
+}
@@ -141,7 +141,7 @@ void lifo_thread3(void *par1, void *par2, void *par3)
  */
 int lifo_test(void)
 {
-	u32_t t;
+	bench_time_t t;
 	int i = 0;
 	int return_value = 0;
 	int element[2];
@@ -150,13 +150,10 @@ int lifo_test(void)
 	k_fifo_init(&sync_fifo);
 
 	/* test get/wait & put thread functions between co-op threads */
-	fprintf(output_file, sz_test_case_fmt,
-			"LIFO #1");
-	fprintf(output_file, sz_description,
-			"\n\tk_lifo_init"
-			"\n\tk_lifo_get(K_FOREVER)"
-			"\n\tk_lifo_put");
-	printf(sz_test_start_fmt);
+	begin_case("LIFO #1",
+		   "\n\tk_lifo_init"
+		   "\n\tk_lifo_get(K_FOREVER)"
+		   "\n\tk_lifo_put");
 
 	lifo_test_init();
 
@@ -170,7 +167,7 @@ int lifo_test(void)
 			 (void *) &i, (void *) number_of_loops, NULL,
 			 K_PRIO_COOP(3), 0, K_NO_WAIT);
 
-	t = TIME_STAMP_DELTA_GET(t);
+	t = bench_time_get() - t;
 
 	return_value += check_result(i, t);
 
@@ -180,15 +177,12 @@ int lifo_test(void)
 	}
 
 	/* test get/yield & put thread functions between co-op threads */
-	fprintf(output_file, sz_test_case_fmt,
-			"LIFO #2");
-	fprintf(output_file, sz_description,
-			"\n\tk_lifo_init"
-			"\n\tk_lifo_get(K_FOREVER)"
-			"\n\tk_lifo_get(TICKS_NONE)"
-			"\n\tk_lifo_put"
-			"\n\tk_yield");
-	printf(sz_test_start_fmt);
+	begin_case("LIFO #2",
+		   "\n\tk_lifo_init"
+		   "\n\tk_lifo_get(K_FOREVER)"
+		   "\n\tk_lifo_get(TICKS_NONE)"
+		   "\n\tk_lifo_put"
+		   "\n\tk_yield");
 
 	lifo_test_init();
 
@@ -204,7 +198,7 @@ int lifo_test(void)
 			 (void *) &i, (void *) number_of_loops, NULL,
 			 K_PRIO_COOP(3), 0, K_NO_WAIT);
 
-	t = TIME_STAMP_DELTA_GET(t);
+	t = bench_time_get() - t;
 
 	return_value += check_result(i, t);
 
@@ -214,15 +208,12 @@ int lifo_test(void)
 	}
 
 	/* test get wait & put functions between co-op and premptive threads */
-	fprintf(output_file, sz_test_case_fmt,
-			"LIFO #3");
-	fprintf(output_file, sz_description,
-			"\n\tk_lifo_init"
-			"\n\tk_lifo_get(K_FOREVER)"
-			"\n\tk_lifo_put"
-			"\n\tk_lifo_get(K_FOREVER)"
-			"\n\tk_lifo_put");
-	printf(sz_test_start_fmt);
+	begin_case("LIFO #3",
+		   "\n\tk_lifo_init"
+		   "\n\tk_lifo_get(K_FOREVER)"
+		   "\n\tk_lifo_put"
+		   "\n\tk_lifo_get(K_FOREVER)"
+		   "\n\tk_lifo_put");
 
 	lifo_test_init();
 
@@ -252,7 +243,7 @@ int lifo_test(void)
 		}
 	}
 
-	t = TIME_STAMP_DELTA_GET(t);
+	t = bench_time_get() - t;
 
 	return_value += check_result(i * 2, t);
 
@@ -141,7 +141,7 @@ void fifo_thread3(void *par1, void *par2, void *par3)
  */
 int fifo_test(void)
 {
-	u32_t t;
+	bench_time_t t;
 	int i = 0;
 	int return_value = 0;
 	int element[2];
@@ -150,13 +150,10 @@ int fifo_test(void)
 	k_fifo_init(&sync_fifo);
 
 	/* test get wait & put thread functions between co-op threads */
-	fprintf(output_file, sz_test_case_fmt,
-			"FIFO #1");
-	fprintf(output_file, sz_description,
-			"\n\tk_fifo_init"
-			"\n\tk_fifo_get(K_FOREVER)"
-			"\n\tk_fifo_put");
-	printf(sz_test_start_fmt);
+	begin_case("FIFO #1",
+		   "\n\tk_fifo_init"
+		   "\n\tk_fifo_get(K_FOREVER)"
+		   "\n\tk_fifo_put");
 
 	fifo_test_init();
 
@@ -169,7 +166,7 @@ int fifo_test(void)
 			 (void *) &i, (void *) number_of_loops, NULL,
 			 K_PRIO_COOP(3), 0, K_NO_WAIT);
 
-	t = TIME_STAMP_DELTA_GET(t);
+	t = bench_time_get() - t;
 
 	return_value += check_result(i, t);
 
@@ -179,15 +176,12 @@ int fifo_test(void)
 	}
 
 	/* test get/yield & put thread functions between co-op threads */
-	fprintf(output_file, sz_test_case_fmt,
-			"FIFO #2");
-	fprintf(output_file, sz_description,
-			"\n\tk_fifo_init"
-			"\n\tk_fifo_get(K_FOREVER)"
-			"\n\tk_fifo_get(TICKS_NONE)"
-			"\n\tk_fifo_put"
-			"\n\tk_yield");
-	printf(sz_test_start_fmt);
+	begin_case("FIFO #2",
+		   "\n\tk_fifo_init"
+		   "\n\tk_fifo_get(K_FOREVER)"
+		   "\n\tk_fifo_get(TICKS_NONE)"
+		   "\n\tk_fifo_put"
+		   "\n\tk_yield");
 
 	fifo_test_init();
 
@@ -201,7 +195,7 @@ int fifo_test(void)
 			 (void *) &i, (void *) number_of_loops, NULL,
 			 K_PRIO_COOP(3), 0, K_NO_WAIT);
 
-	t = TIME_STAMP_DELTA_GET(t);
+	t = bench_time_get() - t;
 
 	return_value += check_result(i, t);
 
@@ -211,15 +205,12 @@ int fifo_test(void)
 	}
 
 	/* test get wait & put functions between co-op and premptive threads */
-	fprintf(output_file, sz_test_case_fmt,
-			"FIFO #3");
-	fprintf(output_file, sz_description,
-			"\n\tk_fifo_init"
-			"\n\tk_fifo_get(K_FOREVER)"
-			"\n\tk_fifo_put"
-			"\n\tk_fifo_get(K_FOREVER)"
-			"\n\tk_fifo_put");
-	printf(sz_test_start_fmt);
+	begin_case("FIFO #3",
+		   "\n\tk_fifo_init"
+		   "\n\tk_fifo_get(K_FOREVER)"
+		   "\n\tk_fifo_put"
+		   "\n\tk_fifo_get(K_FOREVER)"
+		   "\n\tk_fifo_put");
 
 	fifo_test_init();
 
@@ -251,7 +242,7 @@ int fifo_test(void)
 			break;
 		}
 	}
-	t = TIME_STAMP_DELTA_GET(t);
+	t = bench_time_get() - t;
 
 	return_value += check_result(i * 2, t);
 
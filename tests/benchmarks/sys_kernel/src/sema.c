@@ -110,17 +110,14 @@ void sema_thread3(void *par1, void *par2, void *par3)
  */
 int sema_test(void)
 {
-	u32_t t;
+	bench_time_t t;
 	int i = 0;
 	int return_value = 0;
 
-	fprintf(output_file, sz_test_case_fmt,
-			"Semaphore #1");
-	fprintf(output_file, sz_description,
-			"\n\tk_sem_init"
-			"\n\tk_sem_take(K_FOREVER)"
-			"\n\tk_sem_give");
-	printf(sz_test_start_fmt);
+	begin_case("Semaphore #1",
+		   "\n\tk_sem_init"
+		   "\n\tk_sem_take(K_FOREVER)"
+		   "\n\tk_sem_give");
 
 	sema_test_init();
 
@@ -133,18 +130,15 @@ int sema_test(void)
 			 (void *) &i, (void *) number_of_loops, NULL,
 			 K_PRIO_COOP(3), 0, K_NO_WAIT);
 
-	t = TIME_STAMP_DELTA_GET(t);
+	t = bench_time_get() - t;
 
 	return_value += check_result(i, t);
 
-	fprintf(output_file, sz_test_case_fmt,
-			"Semaphore #2");
-	fprintf(output_file, sz_description,
-			"\n\tk_sem_init"
-			"\n\tk_sem_take(TICKS_NONE)"
-			"\n\tk_yield"
-			"\n\tk_sem_give");
-	printf(sz_test_start_fmt);
+	begin_case("Semaphore #2",
+		   "\n\tk_sem_init"
+		   "\n\tk_sem_take(TICKS_NONE)"
+		   "\n\tk_yield"
+		   "\n\tk_sem_give");
 
 	sema_test_init();
 	i = 0;
@@ -158,19 +152,16 @@ int sema_test(void)
 			 (void *) &i, (void *) number_of_loops, NULL,
 			 K_PRIO_COOP(3), 0, K_NO_WAIT);
 
-	t = TIME_STAMP_DELTA_GET(t);
+	t = bench_time_get() - t;
 
 	return_value += check_result(i, t);
 
-	fprintf(output_file, sz_test_case_fmt,
-			"Semaphore #3");
-	fprintf(output_file, sz_description,
-			"\n\tk_sem_init"
-			"\n\tk_sem_take(K_FOREVER)"
-			"\n\tk_sem_give"
-			"\n\tk_sem_give"
-			"\n\tk_sem_take(K_FOREVER)");
-	printf(sz_test_start_fmt);
+	begin_case("Semaphore #3",
+		   "\n\tk_sem_init"
+		   "\n\tk_sem_take(K_FOREVER)"
+		   "\n\tk_sem_give"
+		   "\n\tk_sem_give"
+		   "\n\tk_sem_take(K_FOREVER)");
 
 	sema_test_init();
 
@@ -184,7 +175,7 @@ int sema_test(void)
 		k_sem_take(&sem2, K_FOREVER);
 	}
 
-	t = TIME_STAMP_DELTA_GET(t);
+	t = bench_time_get() - t;
 
 	return_value += check_result(i, t);
 
@@ -143,18 +143,15 @@ void stack_thread3(void *par1, void *par2, void *par3)
  */
 int stack_test(void)
 {
-	u32_t t;
+	bench_time_t t;
 	int i = 0;
 	int return_value = 0;
 
 	/* test get wait & put stack functions between co-op threads */
-	fprintf(output_file, sz_test_case_fmt,
-			"Stack #1");
-	fprintf(output_file, sz_description,
-			"\n\tk_stack_init"
-			"\n\tk_stack_pop(K_FOREVER)"
-			"\n\tk_stack_push");
-	printf(sz_test_start_fmt);
+	begin_case("Stack #1",
+		   "\n\tk_stack_init"
+		   "\n\tk_stack_pop(K_FOREVER)"
+		   "\n\tk_stack_push");
 
 	stack_test_init();
 
@@ -167,20 +164,17 @@ int stack_test(void)
 			 (void *) &i, (void *) number_of_loops, NULL,
 			 K_PRIO_COOP(3), 0, K_NO_WAIT);
 
-	t = TIME_STAMP_DELTA_GET(t);
+	t = bench_time_get() - t;
 
 	return_value += check_result(i, t);
 
 	/* test get/yield & put stack functions between co-op threads */
-	fprintf(output_file, sz_test_case_fmt,
-			"Stack #2");
-	fprintf(output_file, sz_description,
-			"\n\tk_stack_init"
-			"\n\tk_stack_pop(K_FOREVER)"
-			"\n\tk_stack_pop"
-			"\n\tk_stack_push"
-			"\n\tk_yield");
-	printf(sz_test_start_fmt);
+	begin_case("Stack #2",
+		   "\n\tk_stack_init"
+		   "\n\tk_stack_pop(K_FOREVER)"
+		   "\n\tk_stack_pop"
+		   "\n\tk_stack_push"
+		   "\n\tk_yield");
 
 	stack_test_init();
 
@@ -194,22 +188,19 @@ int stack_test(void)
 			 (void *) &i, (void *) number_of_loops, NULL,
 			 K_PRIO_COOP(3), 0, K_NO_WAIT);
 
-	t = TIME_STAMP_DELTA_GET(t);
+	t = bench_time_get() - t;
 
 	return_value += check_result(i, t);
 
 	/* test get wait & put stack functions across co-op and premptive
 	 * threads
 	 */
-	fprintf(output_file, sz_test_case_fmt,
-			"Stack #3");
-	fprintf(output_file, sz_description,
-			"\n\tk_stack_init"
-			"\n\tk_stack_pop(K_FOREVER)"
-			"\n\tk_stack_push"
-			"\n\tk_stack_pop(K_FOREVER)"
-			"\n\tk_stack_push");
-	printf(sz_test_start_fmt);
+	begin_case("Stack #3",
+		   "\n\tk_stack_init"
+		   "\n\tk_stack_pop(K_FOREVER)"
+		   "\n\tk_stack_push"
+		   "\n\tk_stack_pop(K_FOREVER)"
+		   "\n\tk_stack_push");
 
 	stack_test_init();
 
@@ -237,7 +228,7 @@ int stack_test(void)
 		}
 	}
 
-	t = TIME_STAMP_DELTA_GET(t);
+	t = bench_time_get() - t;
 
 	return_value += check_result(i * 2, t);
 
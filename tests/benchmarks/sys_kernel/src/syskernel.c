@@ -26,12 +26,18 @@ const char sz_success[] = "SUCCESSFUL";
 const char sz_partial[] = "PARTIAL";
 const char sz_fail[] = "FAILED";
 
-/* time necessary to read the time */
-u32_t tm_off;
-
 /* Holds the loop count that need to be carried out. */
 u32_t number_of_loops;
 
+/* one benchmark for each test case, with a sample for each run */
+static bench_time_t case_samples[NUMBER_OF_CASES][NUMBER_OF_RUNS];
+static struct bench cases[NUMBER_OF_CASES];
+static struct bench *current_case;
+static int case_count;
+
+/* only the warmup run prints the progress of the test cases */
+static bool verbose;
+
 /**
  *
  * @brief Get the time ticks before test starts
@@ -51,44 +57,69 @@ void begin_test(void)
 
 /**
  *
- * @brief Checks number of tests and calculate average time
+ * @brief Start a test case
+ *
+ * @param name          Name of the test case.
+ * @param description   Kernel APIs the test case exercises.
+ *
+ * @return N/A
+ */
+void begin_case(const char *name, const char *description)
+{
+	current_case = &cases[case_count++];
+	current_case->name = name;
+
+	if (verbose) {
+		fprintf(output_file, sz_test_case_fmt, name);
+		fprintf(output_file, sz_description, description);
+		printf(sz_test_start_fmt);
+	}
+}
+
+/**
+ *
+ * @brief Checks number of tests and records the time as a sample
  *
  * @return 1 if success and 0 on failure
  *
  * @param i   Number of tests.
  * @param t   Time in ticks for the whole test.
  */
-int check_result(int i, u32_t t)
+int check_result(int i, bench_time_t t)
 {
+	const char *details = NULL;
+
 	/*
 	 * bench_test_end checks tCheck static variable.
 	 * bench_test_start modifies it
 	 */
 	if (bench_test_end() != 0) {
-		fprintf(output_file, sz_case_result_fmt, sz_fail);
-		fprintf(output_file, sz_case_details_fmt,
-				"timer tick happened. Results are inaccurate");
-		fprintf(output_file, sz_case_end_fmt);
-		return 0;
+		details = "timer tick happened. Results are inaccurate";
+	} else if (i != number_of_loops) {
+		details = "loop counter mismatch";
 	}
-	if (i != number_of_loops) {
+
+	if (details != NULL) {
+		if (!verbose) {
+			fprintf(output_file, sz_test_case_fmt,
+				current_case->name);
+		}
 		fprintf(output_file, sz_case_result_fmt, sz_fail);
-		fprintf(output_file, sz_case_details_fmt, "loop counter = ");
-		fprintf(output_file, "%i !!!", i);
+		fprintf(output_file, sz_case_details_fmt, details);
+		fprintf(output_file, " (%i)", i);
 		fprintf(output_file, sz_case_end_fmt);
 		return 0;
 	}
-	fprintf(output_file, sz_case_result_fmt, sz_success);
-	fprintf(output_file, sz_case_details_fmt,
-			"Average time for 1 iteration: ");
-	fprintf(output_file, sz_case_timing_fmt,
-			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(t, number_of_loops));
 
-	fprintf(output_file, sz_case_end_fmt);
+	bench_sample_add(current_case, t);
+
+	if (verbose) {
+		fprintf(output_file, sz_case_result_fmt, sz_success);
+		fprintf(output_file, sz_case_end_fmt);
+	}
 	return 1;
 }
 
-
 /**
  *
  * @brief Check for a key press
@@ -141,6 +172,7 @@ void main(void)
 {
 	int	    continuously = 0;
 	int	    test_result;
+	int	    run, i;
 
 	number_of_loops = NUMBER_OF_LOOPS;
 
@@ -158,9 +190,13 @@ void main(void)
 	}
 
 	init_output(&continuously);
-	bench_test_init();
-
 
+	for (i = 0; i < NUMBER_OF_CASES; i++) {
+		cases[i].samples = case_samples[i];
+		cases[i].size = NUMBER_OF_RUNS;
+		cases[i].warmup = 1;
+		cases[i].ops = number_of_loops;
+	}
 
 	do {
 		fprintf(output_file, sz_module_title_fmt,
@@ -168,20 +204,35 @@ void main(void)
 		fprintf(output_file, sz_kernel_ver_fmt,
 			sys_kernel_version_get());
 		fprintf(output_file,
-			"\n\nEach test below is repeated %d times;\n"
-			"average time for one iteration is displayed.",
-			number_of_loops);
+			"\n\nEach test below is repeated %d times, in %d runs"
+			" after a warmup run;\n"
+			"the time for one iteration is reported.",
+			number_of_loops, NUMBER_OF_RUNS);
+
+		for (i = 0; i < NUMBER_OF_CASES; i++) {
+			bench_reset(&cases[i]);
+		}
 
 		test_result = 0;
 
-		test_result += sema_test();
-		test_result += lifo_test();
-		test_result += fifo_test();
-		test_result += stack_test();
+		for (run = 0; run <= NUMBER_OF_RUNS; run++) {
+			verbose = run == 0;
+			case_count = 0;
+
+			test_result += sema_test();
+			test_result += lifo_test();
+			test_result += fifo_test();
+			test_result += stack_test();
+		}
+
+		fprintf(output_file, "\n\n");
+		for (i = 0; i < case_count; i++) {
+			bench_report(&cases[i]);
+		}
 
 		if (test_result) {
-			/* sema/lifo/fifo/stack account for 12 tests in total */
-			if (test_result == 12) {
+			if (test_result ==
+			    NUMBER_OF_CASES * (NUMBER_OF_RUNS + 1)) {
 				fprintf(output_file, sz_module_result_fmt,
 					sz_success);
 			} else {
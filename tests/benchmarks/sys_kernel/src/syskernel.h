@@ -10,6 +10,7 @@
 #define SYSKERNEK_H
 
 #include <timestamp.h>
+#include <bench.h>
 
 #include <stdio.h>
 #include <toolchain.h>
@@ -17,6 +18,12 @@
 #define STACK_SIZE 2048
 #define NUMBER_OF_LOOPS 1000
 
+/* sema/lifo/fifo/stack account for 12 test cases in total */
+#define NUMBER_OF_CASES 12
+
+/* runs of the test cases that are measured, after a warmup run */
+#define NUMBER_OF_RUNS 5
+
 extern K_THREAD_STACK_DEFINE(thread_stack1, STACK_SIZE);
 extern K_THREAD_STACK_DEFINE(thread_stack2, STACK_SIZE);
 extern struct k_thread thread_data1;
@@ -45,7 +52,8 @@ extern u32_t number_of_loops;
 #define sz_case_end_fmt		"\nEND TEST CASE"
 #define sz_case_timing_fmt	"%u nSec"
 
-int check_result(int i, u32_t ticks);
+void begin_case(const char *name, const char *description);
+int check_result(int i, bench_time_t ticks);
 
 int sema_test(void);
 int lifo_test(void);
@@ -53,12 +61,12 @@ int fifo_test(void);
 int stack_test(void);
 void begin_test(void);
 
-static inline u32_t BENCH_START(void)
+static inline bench_time_t BENCH_START(void)
 {
-	u32_t et;
+	bench_time_t et;
 
 	begin_test();
-	et = TIME_STAMP_DELTA_GET(0);
+	et = bench_time_get();
 	return et;
 }
 
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Measure timeout queue scaling
+ *
+ * Measures the average cost, in hardware clock cycles, of arming,
+ * cancelling and expiring one timeout while 10, 100, 1000 and 10000
+ * other timeouts are pending, for whichever timeout queue backend
+ * (CONFIG_TIMEOUT_QUEUE_*) the image was built with.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <timeout_q.h>
+#include <drivers/system_timer.h>
+
+#define MAX_PENDING 10000
+#define REPS 100
+
+/* Background timeouts are armed this far out, so none of them can
+ * expire while the benchmark runs
+ */
+#define FAR_TICKS (1 << 24)
+
+static struct _timeout pending[MAX_PENDING];
+static struct _timeout probe;
+static volatile u32_t expired;
+
+static const int sizes[] = { 10, 100, 1000, MAX_PENDING };
+
+static u32_t rand_state = 0x2545F491;
+
+static u32_t next_rand(void)
+{
+	/* xorshift32, reproducible across runs and backends */
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+	return rand_state;
+}
+
+static s32_t far_ticks(int n)
+{
+	return FAR_TICKS + (next_rand() % (4 * n));
+}
+
+static void timeout_fn(struct _timeout *t)
+{
+	ARG_UNUSED(t);
+	expired++;
+}
+
+static u32_t measure_arm(int n)
+{
+	u32_t total = 0;
+
+	for (int i = 0; i < REPS; i++) {
+		s32_t ticks = far_ticks(n);
+		unsigned int key = irq_lock();
+		u32_t start = k_cycle_get_32();
+
+		_add_timeout(&probe, timeout_fn, ticks);
+		total += k_cycle_get_32() - start;
+		irq_unlock(key);
+
+		_abort_timeout(&probe);
+	}
+
+	return total / REPS;
+}
+
+static u32_t measure_cancel(int n)
+{
+	u32_t total = 0;
+
+	for (int i = 0; i < REPS; i++) {
+		_add_timeout(&probe, timeout_fn, far_ticks(n));
+
+		unsigned int key = irq_lock();
+		u32_t start = k_cycle_get_32();
+
+		_abort_timeout(&probe);
+		total += k_cycle_get_32() - start;
+		irq_unlock(key);
+	}
+
+	return total / REPS;
+}
+
+static u32_t measure_expire(void)
+{
+	u32_t total = 0;
+
+	for (int i = 0; i < REPS; i++) {
+		unsigned int key = irq_lock();
+
+		_add_timeout(&probe, timeout_fn, 1);
+
+		/* Announce the partial tick in progress plus the one
+		 * the probe is waiting for, so it is always the timeout
+		 * that expires
+		 */
+		s32_t ticks = z_clock_elapsed() + 1;
+		u32_t start = k_cycle_get_32();
+
+		z_clock_announce(ticks);
+		total += k_cycle_get_32() - start;
+		irq_unlock(key);
+	}
+
+	return total / REPS;
+}
+
+void main(void)
+{
+	int rv = TC_PASS;
+
+	TC_START("Timeout Queue Benchmark");
+
+	TC_PRINT("Backend: %s\n",
+		 IS_ENABLED(CONFIG_TIMEOUT_QUEUE_SCALABLE) ?
+		 "red/black tree" : "delta list");
+	TC_PRINT("%8s %12s %12s %12s  (cycles, avg of %d)\n",
+		 "pending", "arm", "cancel", "expire", REPS);
+
+	for (int s = 0; s < ARRAY_SIZE(sizes); s++) {
+		int n = sizes[s];
+		u32_t arm, cancel, expire;
+
+		for (int i = 0; i < n; i++) {
+			_init_timeout(&pending[i], timeout_fn);
+			_add_timeout(&pending[i], timeout_fn, far_ticks(n));
+		}
+		_init_timeout(&probe, timeout_fn);
+
+		arm = measure_arm(n);
+		cancel = measure_cancel(n);
+		expired = 0;
+		expire = measure_expire();
+
+		if (expired != REPS) {
+			TC_PRINT("expected %d expirations, got %u\n",
+				 REPS, expired);
+			rv = TC_FAIL;
+		}
+
+		for (int i = 0; i < n; i++) {
+			if (_abort_timeout(&pending[i]) != 0) {
+				TC_PRINT("timeout %d was not pending\n", i);
+				rv = TC_FAIL;
+			}
+		}
+
+		TC_PRINT("%8d %12u %12u %12u\n", n, arm, cancel, expire);
+	}
+
+	TC_PRINT("1 cycle is %u nsec\n", SYS_CLOCK_HW_CYCLES_TO_NS(1));
+
+	TC_END_RESULT(rv);
+	TC_END_REPORT(rv);
+}
@@ -47,6 +47,7 @@ void drop_to_user_mode(void);
 void user_thread_creation(void);
 void syscall_overhead(void);
 void validation_overhead(void);
+void object_syscall_overhead(void);
 
 void userspace_bench(void)
 {
@@ -58,6 +59,7 @@ void userspace_bench(void)
 
 	validation_overhead();
 
+	object_syscall_overhead();
 }
 /******************************************************************************/
 
@@ -273,3 +275,49 @@ void validation_overhead(void)
 
 
 }
+
+/******************************************************************************/
+/* Repeated system calls on the same kernel object, the case the per-thread
+ * object cache (CONFIG_USERSPACE_OBJ_CACHE) speeds up
+ */
+#define OBJ_SYSCALL_LOOPS 100
+
+K_SEM_DEFINE(obj_syscall_sema, 0, 1);
+u32_t obj_syscall_start_time, obj_syscall_end_time;
+
+void object_syscall_user_thread(void *p1, void *p2, void *p3)
+{
+	/* first call validates the object the slow way */
+	k_sem_give(&obj_syscall_sema);
+	k_sem_take(&obj_syscall_sema, K_NO_WAIT);
+
+	obj_syscall_start_time = userspace_read_timer_value();
+	for (int i = 0; i < OBJ_SYSCALL_LOOPS; i++) {
+		k_sem_give(&obj_syscall_sema);
+		k_sem_take(&obj_syscall_sema, K_NO_WAIT);
+	}
+	obj_syscall_end_time = userspace_read_timer_value();
+}
+
+void object_syscall_overhead(void)
+{
+	k_thread_access_grant(k_current_get(), &obj_syscall_sema, NULL);
+
+	k_thread_create(&my_thread_user, my_stack_area, STACK_SIZE,
+			object_syscall_user_thread,
+			NULL, NULL, NULL,
+			-1 /*priority*/, K_INHERIT_PERMS | K_USER, 0);
+
+	u32_t total_cycles = (u32_t)
+		((SUBTRACT_CLOCK_CYCLES(obj_syscall_end_time) -
+		  SUBTRACT_CLOCK_CYCLES(obj_syscall_start_time)) &
+		 0xFFFFFFFFULL);
+
+	/* two system calls per loop */
+	u32_t cycles_per_syscall = total_cycles / (2 * OBJ_SYSCALL_LOOPS);
+
+	PRINT_STATS("Syscall on kernel object (k_sem give/take)",
+		    cycles_per_syscall,
+		    (u32_t) (CYCLES_TO_NS(cycles_per_syscall) &
+			     0xFFFFFFFFULL));
+}
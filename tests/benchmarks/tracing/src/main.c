@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Measure the cost of recording tracing events
+ *
+ * Each measurement runs BATCHES batches of BATCH_SIZE operations and only
+ * times the batches themselves: with the CTF backend the ring buffers are
+ * flushed between batches, so that every event of a batch fits.
+ */
+
+#include <zephyr.h>
+#include <tracing.h>
+#include <tc_util.h>
+
+#define BATCHES 100
+#define BATCH_SIZE 32
+#define OPS (BATCHES * BATCH_SIZE)
+
+#define BENCH_TRACE_ID (SYS_TRACE_ID_OFFSET + 31)
+
+K_SEM_DEFINE(bench_sem, 0, 1);
+
+enum bench {
+	BENCH_EMPTY,
+	BENCH_HOOKS,
+	BENCH_SEM,
+};
+
+static const char * const bench_names[] = {
+	"empty loop", "trace hooks", "sem give/take",
+};
+
+/* Events recorded per operation when tracing is enabled */
+static const int bench_events[] = { 0, 2, 4 };
+
+static void flush(void)
+{
+#ifdef CONFIG_TRACING_CTF
+	ctf_flush();
+#endif
+}
+
+static u32_t run(enum bench bench)
+{
+	u32_t cycles = 0;
+
+	for (int b = 0; b < BATCHES; b++) {
+		u32_t start;
+
+		flush();
+		start = k_cycle_get_32();
+
+		for (int i = 0; i < BATCH_SIZE; i++) {
+			switch (bench) {
+			case BENCH_EMPTY:
+				compiler_barrier();
+				break;
+			case BENCH_HOOKS:
+				sys_trace_void(BENCH_TRACE_ID);
+				sys_trace_end_call(BENCH_TRACE_ID);
+				break;
+			case BENCH_SEM:
+				k_sem_give(&bench_sem);
+				k_sem_take(&bench_sem, K_NO_WAIT);
+				break;
+			}
+		}
+
+		cycles += k_cycle_get_32() - start;
+	}
+
+	return cycles;
+}
+
+void main(void)
+{
+	int status = TC_PASS;
+#ifdef CONFIG_TRACING_CTF
+	struct ctf_stats stats;
+#endif
+
+	TC_START("Tracing Overhead Benchmark");
+
+#ifdef CONFIG_TRACING_CTF
+	TC_PRINT("CTF backend, %d byte ring buffers\n",
+		 CONFIG_TRACING_CTF_BUFFER_SIZE);
+#else
+	TC_PRINT("tracing disabled\n");
+#endif
+	TC_PRINT("%d batches of %d operations\n", BATCHES, BATCH_SIZE);
+	TC_PRINT("%14s %14s %14s\n", "", "cycles/kop", "events/op");
+
+	for (enum bench bench = BENCH_EMPTY; bench <= BENCH_SEM; bench++) {
+		u32_t cycles = run(bench);
+
+		TC_PRINT("%14s %14u %14d\n", bench_names[bench],
+			 (u32_t)((u64_t)cycles * 1000 / OPS),
+			 IS_ENABLED(CONFIG_TRACING) ? bench_events[bench] : 0);
+	}
+
+#ifdef CONFIG_TRACING_CTF
+	flush();
+	ctf_stats_get(&stats);
+	TC_PRINT("%u bytes of events recorded, %u events lost\n",
+		 stats.bytes, stats.lost);
+	if (stats.lost != 0) {
+		status = TC_FAIL;
+	}
+#endif
+
+	TC_END_RESULT(status);
+	TC_END_REPORT(status);
+}
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Measure copying vs. in place message queue and pipe transfers
+ *
+ * A producer thread generates FRAMES frames of FRAME_SIZE bytes that a
+ * consumer thread checks, either through a buffer of their own copied
+ * into and out of the kernel object, or in place through the claim and
+ * finish calls.  The frame is generated and checked byte by byte in both
+ * cases, only the copies differ.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+
+#define FRAMES 1000
+#define FRAME_SIZE 256
+#define QUEUE_FRAMES 8
+#define STACK_SIZE (512 + FRAME_SIZE + CONFIG_TEST_EXTRA_STACKSIZE)
+#define PRIO K_PRIO_PREEMPT(10)
+
+K_MSGQ_DEFINE(bench_msgq, FRAME_SIZE, QUEUE_FRAMES, 4);
+K_PIPE_DEFINE(bench_pipe, FRAME_SIZE * QUEUE_FRAMES, 4);
+
+static struct k_thread producer_thread, consumer_thread;
+static K_THREAD_STACK_DEFINE(producer_stack, STACK_SIZE);
+static K_THREAD_STACK_DEFINE(consumer_stack, STACK_SIZE);
+
+static K_SEM_DEFINE(done, 0, 2);
+
+static volatile int errors;
+
+enum mode {
+	MSGQ_COPY,
+	MSGQ_CLAIM,
+	PIPE_COPY,
+	PIPE_CLAIM,
+};
+
+static const char * const mode_names[] = {
+	"msgq copy", "msgq claim", "pipe copy", "pipe claim",
+};
+
+static void generate(u8_t *p, size_t offset, size_t len, u32_t frame)
+{
+	for (size_t i = 0; i < len; i++) {
+		p[i] = (u8_t)(frame + offset + i);
+	}
+}
+
+static void check(const u8_t *p, size_t offset, size_t len, u32_t frame)
+{
+	for (size_t i = 0; i < len; i++) {
+		if (p[i] != (u8_t)(frame + offset + i)) {
+			errors++;
+			return;
+		}
+	}
+}
+
+static void producer(void *p1, void *p2, void *p3)
+{
+	enum mode mode = POINTER_TO_INT(p1);
+	u8_t frame[FRAME_SIZE];
+	size_t bytes, done_bytes;
+	void *buf;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (u32_t n = 0; n < FRAMES; n++) {
+		switch (mode) {
+		case MSGQ_COPY:
+			generate(frame, 0, FRAME_SIZE, n);
+			k_msgq_put(&bench_msgq, frame, K_FOREVER);
+			break;
+		case MSGQ_CLAIM:
+			k_msgq_put_claim(&bench_msgq, &buf, K_FOREVER);
+			generate(buf, 0, FRAME_SIZE, n);
+			k_msgq_put_finish(&bench_msgq);
+			break;
+		case PIPE_COPY:
+			generate(frame, 0, FRAME_SIZE, n);
+			k_pipe_put(&bench_pipe, frame, FRAME_SIZE, &bytes,
+				   FRAME_SIZE, K_FOREVER);
+			break;
+		case PIPE_CLAIM:
+			/* a claim stops at the end of the pipe's buffer */
+			for (done_bytes = 0; done_bytes < FRAME_SIZE;
+			     done_bytes += bytes) {
+				bytes = FRAME_SIZE - done_bytes;
+				k_pipe_put_claim(&bench_pipe, &buf, &bytes,
+						 K_FOREVER);
+				generate(buf, done_bytes, bytes, n);
+				k_pipe_put_finish(&bench_pipe, bytes);
+			}
+			break;
+		}
+	}
+
+	k_sem_give(&done);
+}
+
+static void consumer(void *p1, void *p2, void *p3)
+{
+	enum mode mode = POINTER_TO_INT(p1);
+	u8_t frame[FRAME_SIZE];
+	size_t bytes, done_bytes;
+	void *buf;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (u32_t n = 0; n < FRAMES; n++) {
+		switch (mode) {
+		case MSGQ_COPY:
+			k_msgq_get(&bench_msgq, frame, K_FOREVER);
+			check(frame, 0, FRAME_SIZE, n);
+			break;
+		case MSGQ_CLAIM:
+			k_msgq_get_claim(&bench_msgq, &buf, K_FOREVER);
+			check(buf, 0, FRAME_SIZE, n);
+			k_msgq_get_finish(&bench_msgq);
+			break;
+		case PIPE_COPY:
+			k_pipe_get(&bench_pipe, frame, FRAME_SIZE, &bytes,
+				   FRAME_SIZE, K_FOREVER);
+			check(frame, 0, FRAME_SIZE, n);
+			break;
+		case PIPE_CLAIM:
+			for (done_bytes = 0; done_bytes < FRAME_SIZE;
+			     done_bytes += bytes) {
+				bytes = FRAME_SIZE - done_bytes;
+				k_pipe_get_claim(&bench_pipe, &buf, &bytes,
+						 K_FOREVER);
+				check(buf, done_bytes, bytes, n);
+				k_pipe_get_finish(&bench_pipe, bytes);
+			}
+			break;
+		}
+	}
+
+	k_sem_give(&done);
+}
+
+static u32_t run(int mode)
+{
+	u32_t start;
+
+	k_sched_lock();
+	k_thread_create(&consumer_thread, consumer_stack, STACK_SIZE,
+			consumer, INT_TO_POINTER(mode), NULL, NULL,
+			PRIO, 0, K_NO_WAIT);
+	k_thread_create(&producer_thread, producer_stack, STACK_SIZE,
+			producer, INT_TO_POINTER(mode), NULL, NULL,
+			PRIO, 0, K_NO_WAIT);
+	start = k_cycle_get_32();
+	k_sched_unlock();
+
+	k_sem_take(&done, K_FOREVER);
+	k_sem_take(&done, K_FOREVER);
+
+	return (k_cycle_get_32() - start) / FRAMES;
+}
+
+void main(void)
+{
+	int status = TC_PASS;
+
+	TC_START("Zero-Copy Message Queue and Pipe Benchmark");
+
+	TC_PRINT("%d frames of %d bytes, %d frames buffered\n",
+		 FRAMES, FRAME_SIZE, QUEUE_FRAMES);
+	TC_PRINT("%12s %14s %16s\n", "", "cycles/frame", "bytes/kcycle");
+
+	/* Stay out of the way of the threads being measured */
+	k_thread_priority_set(k_current_get(), K_PRIO_PREEMPT(14));
+
+	for (int mode = MSGQ_COPY; mode <= PIPE_CLAIM; mode++) {
+		u32_t cycles = run(mode);
+
+		TC_PRINT("%12s %14u %16u\n", mode_names[mode], cycles,
+			 cycles ? FRAME_SIZE * 1000 / cycles : 0);
+	}
+
+	if (errors != 0) {
+		TC_PRINT("%d frames received corrupted or out of order\n",
+			 errors);
+		status = TC_FAIL;
+	}
+
+	TC_END_RESULT(status);
+	TC_END_REPORT(status);
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <zephyr.h>
+
+#include "native_perf.h"
+
+#define WAIT_TIME 100 /* ms */
+#define TOLERANCE 20 /* ms */
+#define READS 1000
+
+/**
+ * @brief Test the host performance counter never goes back
+ */
+static void test_monotonic(void)
+{
+	u64_t prev = native_perf_counter_get();
+
+	for (int i = 0; i < READS; i++) {
+		u64_t now = native_perf_counter_get();
+
+		zassert_true(now >= prev, "counter went back");
+		prev = now;
+	}
+}
+
+/**
+ * @brief Test the host performance counter follows real time
+ *
+ * The process runs in real time, so sleeping takes as long on the host,
+ * while the code itself takes no simulated time at all.
+ */
+static void test_rate(void)
+{
+	u64_t freq = native_perf_counter_freq_get();
+	u64_t start, ms;
+
+	zassert_true(freq > 0, "no counter frequency");
+
+	start = native_perf_counter_get();
+	k_sleep(WAIT_TIME);
+	ms = (native_perf_counter_get() - start) * MSEC_PER_SEC / freq;
+
+	zassert_true(ms >= WAIT_TIME - TOLERANCE &&
+		     ms <= WAIT_TIME + TOLERANCE,
+		     "slept %u ms on the host instead of %u", (u32_t)ms,
+		     WAIT_TIME);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(native_perf_counter,
+			 ztest_unit_test(test_monotonic),
+			 ztest_unit_test(test_rate));
+
+	ztest_run_test_suite(native_perf_counter);
+}
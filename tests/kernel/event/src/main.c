@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @brief Tests for event objects
+ * @defgroup kernel_event_tests Events
+ * @ingroup all_tests
+ * @{
+ */
+
+#include <ztest.h>
+#include <irq_offload.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define TIMEOUT 100
+#define PRIO K_PRIO_PREEMPT(5)
+
+#define EV_A BIT(0)
+#define EV_B BIT(1)
+#define EV_C BIT(2)
+
+/**TESTPOINT: init via K_EVENT_DEFINE*/
+K_EVENT_DEFINE(event);
+
+static K_THREAD_STACK_ARRAY_DEFINE(tstack, 2, STACK_SIZE);
+static struct k_thread tdata[2];
+
+static volatile u32_t result[2];
+
+struct waiter_args {
+	u32_t events;
+	bool all;
+	bool consume;
+};
+
+static void waiter(void *p1, void *p2, void *p3)
+{
+	int idx = POINTER_TO_INT(p1);
+	struct waiter_args *args = p2;
+
+	ARG_UNUSED(p3);
+
+	if (args->all) {
+		result[idx] = k_event_wait_all(&event, args->events,
+					       args->consume, TIMEOUT);
+	} else {
+		result[idx] = k_event_wait(&event, args->events,
+					   args->consume, TIMEOUT);
+	}
+}
+
+static void spawn(int idx, struct waiter_args *args)
+{
+	result[idx] = UINT32_MAX;
+	k_thread_create(&tdata[idx], tstack[idx], STACK_SIZE, waiter,
+			INT_TO_POINTER(idx), args, NULL, PRIO, 0, 0);
+}
+
+/* The tests run in a cooperative thread, let woken waiters run */
+static void settle(void)
+{
+	k_sleep(TIMEOUT / 10);
+}
+
+static void post_isr(void *events)
+{
+	k_event_post(&event, POINTER_TO_UINT(events));
+}
+
+/**
+ * @brief Test waiting for any of a set of events
+ */
+void test_event_wait_any(void)
+{
+	k_event_init(&event);
+
+	zassert_equal(k_event_wait(&event, EV_A | EV_B, false, K_NO_WAIT),
+		      0, "wait satisfied with no event posted");
+
+	k_event_post(&event, EV_B | EV_C);
+
+	/**TESTPOINT: only the events waited for are returned */
+	zassert_equal(k_event_wait(&event, EV_A | EV_B, false, K_NO_WAIT),
+		      EV_B, NULL);
+
+	/**TESTPOINT: consumed events are cleared */
+	zassert_equal(k_event_wait(&event, EV_B, true, K_NO_WAIT), EV_B,
+		      NULL);
+	zassert_equal(k_event_wait(&event, EV_B, false, K_NO_WAIT), 0,
+		      "event not consumed");
+	zassert_equal(k_event_wait(&event, EV_C, false, K_NO_WAIT), EV_C,
+		      "other event consumed");
+}
+
+/**
+ * @brief Test waiting for all of a set of events
+ */
+void test_event_wait_all(void)
+{
+	k_event_init(&event);
+
+	k_event_post(&event, EV_A);
+	zassert_equal(k_event_wait_all(&event, EV_A | EV_B, false,
+				       K_NO_WAIT), 0,
+		      "wait for all satisfied with some events");
+
+	k_event_post(&event, EV_B);
+	zassert_equal(k_event_wait_all(&event, EV_A | EV_B, true, K_NO_WAIT),
+		      EV_A | EV_B, NULL);
+	zassert_equal(k_event_wait(&event, EV_A | EV_B, false, K_NO_WAIT),
+		      0, "events not consumed");
+}
+
+/**
+ * @brief Test setting and clearing events
+ */
+void test_event_set_clear(void)
+{
+	k_event_init(&event);
+
+	k_event_post(&event, EV_A | EV_B);
+
+	/**TESTPOINT: setting replaces the posted events */
+	k_event_set(&event, EV_C);
+	zassert_equal(k_event_wait(&event, EV_A | EV_B | EV_C, false,
+				   K_NO_WAIT), EV_C, NULL);
+
+	k_event_clear(&event, EV_C);
+	zassert_equal(k_event_wait(&event, EV_C, false, K_NO_WAIT), 0,
+		      "event not cleared");
+}
+
+/**
+ * @brief Test waking a waiting thread, from a thread and an ISR
+ */
+void test_event_wake(void)
+{
+	struct waiter_args any = { .events = EV_A | EV_B, .consume = true };
+	struct waiter_args all = { .events = EV_A | EV_B, .all = true };
+
+	k_event_init(&event);
+
+	spawn(0, &any);
+	k_sleep(TIMEOUT / 2);
+	zassert_equal(result[0], UINT32_MAX, "waiter did not wait");
+
+	k_event_post(&event, EV_B);
+	settle();
+	zassert_equal(result[0], EV_B, "waiter not woken");
+	zassert_equal(k_event_wait(&event, EV_B, false, K_NO_WAIT), 0,
+		      "waiter did not consume the event");
+
+	spawn(0, &all);
+	k_sleep(TIMEOUT / 2);
+
+	/**TESTPOINT: a wait for all is not satisfied by some events */
+	irq_offload(post_isr, UINT_TO_POINTER(EV_A));
+	settle();
+	zassert_equal(result[0], UINT32_MAX, "waiter woken too early");
+
+	/**TESTPOINT: posting from an ISR wakes the waiter */
+	irq_offload(post_isr, UINT_TO_POINTER(EV_B));
+	settle();
+	zassert_equal(result[0], EV_A | EV_B, "waiter not woken");
+}
+
+/**
+ * @brief Test that waiting for events times out
+ */
+void test_event_timeout(void)
+{
+	struct waiter_args args = { .events = EV_C };
+
+	k_event_init(&event);
+
+	spawn(0, &args);
+	k_event_post(&event, EV_A);
+	k_sleep(2 * TIMEOUT);
+	zassert_equal(result[0], 0, "wait did not time out");
+}
+
+/**
+ * @brief Test posting to several waiting threads
+ */
+void test_event_multiple_waiters(void)
+{
+	struct waiter_args peek = { .events = EV_A };
+	struct waiter_args consume = { .events = EV_A, .consume = true };
+
+	k_event_init(&event);
+
+	/**TESTPOINT: an event not consumed wakes all the waiters */
+	spawn(0, &peek);
+	spawn(1, &peek);
+	k_sleep(TIMEOUT / 2);
+	k_event_post(&event, EV_A);
+	settle();
+	zassert_equal(result[0], EV_A, "first waiter not woken");
+	zassert_equal(result[1], EV_A, "second waiter not woken");
+
+	/**TESTPOINT: a consumed event wakes only the first waiter */
+	k_event_init(&event);
+	spawn(0, &consume);
+	spawn(1, &consume);
+	k_sleep(TIMEOUT / 2);
+	k_event_post(&event, EV_A);
+	settle();
+	zassert_equal(result[0], EV_A, "first waiter not woken");
+	zassert_equal(result[1], UINT32_MAX, "second waiter woken");
+
+	k_sleep(TIMEOUT);
+	zassert_equal(result[1], 0, "second waiter did not time out");
+}
+
+/**
+ * @}
+ */
+
+void test_main(void)
+{
+	ztest_test_suite(event,
+			 ztest_unit_test(test_event_wait_any),
+			 ztest_unit_test(test_event_wait_all),
+			 ztest_unit_test(test_event_set_clear),
+			 ztest_unit_test(test_event_wake),
+			 ztest_unit_test(test_event_timeout),
+			 ztest_unit_test(test_event_multiple_waiters));
+	ztest_run_test_suite(event);
+}
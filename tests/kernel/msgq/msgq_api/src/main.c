@@ -21,6 +21,9 @@ extern void test_msgq_purge_when_put(void);
 extern void test_msgq_attrs_get(void);
 extern void test_msgq_alloc(void);
 extern void test_msgq_pend_thread(void);
+extern void test_msgq_claim(void);
+extern void test_msgq_claim_pend(void);
+extern void test_msgq_claim_busy(void);
 #ifdef CONFIG_USERSPACE
 extern void test_msgq_user_thread(void);
 extern void test_msgq_user_thread_overflow(void);
@@ -74,6 +77,9 @@ void test_main(void)
 			 ztest_unit_test(test_msgq_purge_when_put),
 			 ztest_user_unit_test(test_msgq_user_purge_when_put),
 			 ztest_unit_test(test_msgq_pend_thread),
+			 ztest_unit_test(test_msgq_claim),
+			 ztest_unit_test(test_msgq_claim_pend),
+			 ztest_unit_test(test_msgq_claim_busy),
 			 ztest_unit_test(test_msgq_alloc));
 	ztest_run_test_suite(msgq_api);
 }
@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "test_msgq.h"
+
+K_THREAD_STACK_EXTERN(tstack);
+K_THREAD_STACK_EXTERN(tstack1);
+extern struct k_thread tdata;
+extern struct k_thread tdata1;
+extern struct k_msgq msgq;
+static char __aligned(4) tbuffer[MSG_SIZE * MSGQ_LEN];
+static u32_t data[MSGQ_LEN] = { MSG0, MSG1 };
+static struct k_sem claim_sema;
+static int busy_result[2];
+static u32_t busy_value[2];
+
+static void claim_reader_entry(void *p1, void *p2, void *p3)
+{
+	struct k_msgq *q = p1;
+	void *msg;
+
+	/**TESTPOINT: get claim pending on an empty queue*/
+	zassert_equal(k_msgq_get_claim(q, &msg, K_FOREVER), 0, NULL);
+	zassert_equal(*(u32_t *)msg, data[0], NULL);
+	k_msgq_get_finish(q);
+	k_sem_give(&claim_sema);
+}
+
+static void claim_writer_entry(void *p1, void *p2, void *p3)
+{
+	struct k_msgq *q = p1;
+	void *msg;
+
+	/**TESTPOINT: put claim pending on a full queue*/
+	zassert_equal(k_msgq_put_claim(q, &msg, K_FOREVER), 0, NULL);
+	*(u32_t *)msg = data[1];
+	k_msgq_put_finish(q);
+	k_sem_give(&claim_sema);
+}
+
+static void busy_reader_entry(void *p1, void *p2, void *p3)
+{
+	struct k_msgq *q = p1;
+	int id = POINTER_TO_INT(p2);
+	void *msg;
+
+	busy_result[id] = k_msgq_get_claim(q, &msg, K_FOREVER);
+	if (busy_result[id] == 0) {
+		busy_value[id] = *(u32_t *)msg;
+		k_msgq_get_finish(q);
+	}
+	k_sem_give(&claim_sema);
+}
+
+static void busy_copy_reader_entry(void *p1, void *p2, void *p3)
+{
+	struct k_msgq *q = p1;
+
+	busy_result[1] = k_msgq_get(q, &busy_value[1], K_FOREVER);
+	k_sem_give(&claim_sema);
+}
+
+static void busy_claim_writer_entry(void *p1, void *p2, void *p3)
+{
+	struct k_msgq *q = p1;
+	void *msg;
+
+	busy_result[0] = k_msgq_put_claim(q, &msg, K_FOREVER);
+	if (busy_result[0] == 0) {
+		/* let the copying writer run while the slot is claimed */
+		k_sleep(TIMEOUT >> 1);
+		*(u32_t *)msg = MSG1;
+		k_msgq_put_finish(q);
+	}
+	k_sem_give(&claim_sema);
+}
+
+static void busy_copy_writer_entry(void *p1, void *p2, void *p3)
+{
+	struct k_msgq *q = p1;
+	u32_t msg = OVERFLOW_SIZE_MSG;
+
+	busy_result[1] = k_msgq_put(q, &msg, K_FOREVER);
+	k_sem_give(&claim_sema);
+}
+
+/**
+ * @addtogroup kernel_message_queue_tests
+ * @{
+ */
+
+/**
+ * @brief Test writing and reading messages in place
+ * @see k_msgq_put_claim(), k_msgq_put_finish(), k_msgq_get_claim(),
+ * k_msgq_get_finish()
+ */
+void test_msgq_claim(void)
+{
+	void *msg;
+	u32_t rx;
+
+	k_msgq_init(&msgq, tbuffer, MSG_SIZE, MSGQ_LEN);
+
+	for (int i = 0; i < MSGQ_LEN; i++) {
+		zassert_equal(k_msgq_put_claim(&msgq, &msg, K_NO_WAIT), 0,
+			      NULL);
+		/**TESTPOINT: claimed slot is in the queue's buffer*/
+		zassert_true((char *)msg >= tbuffer &&
+			     (char *)msg < tbuffer + sizeof(tbuffer), NULL);
+		*(u32_t *)msg = data[i];
+		k_msgq_put_finish(&msgq);
+	}
+
+	/**TESTPOINT: no slot to claim in a full queue*/
+	zassert_equal(k_msgq_put_claim(&msgq, &msg, K_NO_WAIT), -ENOMSG, NULL);
+	zassert_equal(k_msgq_put_claim(&msgq, &msg, TIMEOUT), -EAGAIN, NULL);
+
+	/**TESTPOINT: claimed messages mix with copied ones in FIFO order*/
+	zassert_equal(k_msgq_get_claim(&msgq, &msg, K_NO_WAIT), 0, NULL);
+	zassert_equal(*(u32_t *)msg, data[0], NULL);
+	zassert_equal(k_msgq_num_used_get(&msgq), MSGQ_LEN, NULL);
+	k_msgq_get_finish(&msgq);
+	zassert_equal(k_msgq_num_used_get(&msgq), MSGQ_LEN - 1, NULL);
+
+	zassert_equal(k_msgq_get(&msgq, &rx, K_NO_WAIT), 0, NULL);
+	zassert_equal(rx, data[1], NULL);
+
+	zassert_equal(k_msgq_get_claim(&msgq, &msg, K_NO_WAIT), -ENOMSG, NULL);
+}
+
+/**
+ * @brief Test blocking in place claims
+ * @see k_msgq_put_claim(), k_msgq_get_claim()
+ */
+void test_msgq_claim_pend(void)
+{
+	u32_t rx;
+
+	k_msgq_init(&msgq, tbuffer, MSG_SIZE, MSGQ_LEN);
+	k_sem_init(&claim_sema, 0, 1);
+
+	/* reader claims a message sent later by k_msgq_put() */
+	k_thread_create(&tdata, tstack, STACK_SIZE,
+			claim_reader_entry, &msgq, NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(TIMEOUT >> 1);
+	zassert_equal(k_msgq_put(&msgq, &data[0], K_NO_WAIT), 0, NULL);
+	zassert_equal(k_sem_take(&claim_sema, TIMEOUT), 0, NULL);
+	zassert_equal(k_msgq_num_used_get(&msgq), 0, NULL);
+	k_thread_abort(&tdata);
+
+	/* writer claims the slot freed by k_msgq_get() */
+	for (int i = 0; i < MSGQ_LEN; i++) {
+		zassert_equal(k_msgq_put(&msgq, &data[0], K_NO_WAIT), 0, NULL);
+	}
+	k_thread_create(&tdata, tstack, STACK_SIZE,
+			claim_writer_entry, &msgq, NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(TIMEOUT >> 1);
+	zassert_equal(k_msgq_get(&msgq, &rx, K_NO_WAIT), 0, NULL);
+	zassert_equal(k_sem_take(&claim_sema, TIMEOUT), 0, NULL);
+	k_thread_abort(&tdata);
+
+	zassert_equal(k_msgq_get(&msgq, &rx, K_NO_WAIT), 0, NULL);
+	zassert_equal(rx, data[0], NULL);
+	zassert_equal(k_msgq_get(&msgq, &rx, K_NO_WAIT), 0, NULL);
+	zassert_equal(rx, data[1], NULL);
+}
+
+/**
+ * @brief Test that a claimed slot or message goes to one thread only
+ * @see k_msgq_put_claim(), k_msgq_get_claim(), k_msgq_purge()
+ */
+void test_msgq_claim_busy(void)
+{
+	void *msg;
+	u32_t rx;
+
+	k_msgq_init(&msgq, tbuffer, MSG_SIZE, MSGQ_LEN);
+	k_sem_init(&claim_sema, 0, 2);
+	busy_result[0] = busy_result[1] = -1;
+
+	/* two get claims waiting on an empty queue */
+	k_thread_create(&tdata, tstack, STACK_SIZE,
+			busy_reader_entry, &msgq, INT_TO_POINTER(0), NULL,
+			K_PRIO_PREEMPT(0), 0, 0);
+	k_thread_create(&tdata1, tstack1, STACK_SIZE,
+			busy_reader_entry, &msgq, INT_TO_POINTER(1), NULL,
+			K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(TIMEOUT >> 1);
+	zassert_equal(k_msgq_put(&msgq, &data[0], K_NO_WAIT), 0, NULL);
+	zassert_equal(k_sem_take(&claim_sema, TIMEOUT), 0, NULL);
+
+	/**TESTPOINT: the message is claimed once, the other claim waits on*/
+	zassert_equal(busy_result[0], 0, NULL);
+	zassert_equal(busy_value[0], data[0], NULL);
+	zassert_equal(busy_result[1], -1, NULL);
+	zassert_equal(k_msgq_put(&msgq, &data[1], K_NO_WAIT), 0, NULL);
+	zassert_equal(k_sem_take(&claim_sema, TIMEOUT), 0, NULL);
+	zassert_equal(busy_result[1], 0, NULL);
+	zassert_equal(busy_value[1], data[1], NULL);
+	zassert_equal(k_msgq_num_used_get(&msgq), 0, NULL);
+	k_thread_abort(&tdata);
+	k_thread_abort(&tdata1);
+
+	/**TESTPOINT: nothing else is read while a message is claimed*/
+	zassert_equal(k_msgq_put(&msgq, &data[0], K_NO_WAIT), 0, NULL);
+	zassert_equal(k_msgq_put(&msgq, &data[1], K_NO_WAIT), 0, NULL);
+	zassert_equal(k_msgq_get_claim(&msgq, &msg, K_NO_WAIT), 0, NULL);
+	zassert_equal(k_msgq_get_claim(&msgq, &msg, K_NO_WAIT), -EBUSY, NULL);
+	zassert_equal(k_msgq_get(&msgq, &rx, K_NO_WAIT), -EBUSY, NULL);
+	zassert_equal(k_msgq_get(&msgq, &rx, TIMEOUT), -EAGAIN, NULL);
+
+	/**TESTPOINT: a reader waiting for the claim gets the next message*/
+	busy_result[1] = -1;
+	k_thread_create(&tdata1, tstack1, STACK_SIZE,
+			busy_copy_reader_entry, &msgq, NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(TIMEOUT >> 1);
+	zassert_equal(busy_result[1], -1, NULL);
+	k_msgq_get_finish(&msgq);
+	zassert_equal(k_sem_take(&claim_sema, TIMEOUT), 0, NULL);
+	zassert_equal(busy_result[1], 0, NULL);
+	zassert_equal(busy_value[1], data[1], NULL);
+	zassert_equal(k_msgq_num_used_get(&msgq), 0, NULL);
+	k_thread_abort(&tdata1);
+
+	/**TESTPOINT: purging keeps the message being read in place*/
+	zassert_equal(k_msgq_put(&msgq, &data[0], K_NO_WAIT), 0, NULL);
+	zassert_equal(k_msgq_put(&msgq, &data[1], K_NO_WAIT), 0, NULL);
+	zassert_equal(k_msgq_get_claim(&msgq, &msg, K_NO_WAIT), 0, NULL);
+	k_msgq_purge(&msgq);
+	zassert_equal(k_msgq_num_used_get(&msgq), 1, NULL);
+	zassert_equal(k_msgq_get_claim(&msgq, &msg, K_NO_WAIT), -EBUSY, NULL);
+	zassert_equal(k_msgq_put(&msgq, &data[1], K_NO_WAIT), 0, NULL);
+	zassert_equal(*(u32_t *)msg, data[0], NULL);
+	k_msgq_get_finish(&msgq);
+	zassert_equal(k_msgq_get(&msgq, &rx, K_NO_WAIT), 0, NULL);
+	zassert_equal(rx, data[1], NULL);
+	zassert_equal(k_msgq_num_used_get(&msgq), 0, NULL);
+
+	/* a put claim and a copying put waiting on a full queue */
+	busy_result[0] = busy_result[1] = -1;
+	zassert_equal(k_msgq_put(&msgq, &data[0], K_NO_WAIT), 0, NULL);
+	zassert_equal(k_msgq_put(&msgq, &data[1], K_NO_WAIT), 0, NULL);
+	k_thread_create(&tdata, tstack, STACK_SIZE,
+			busy_claim_writer_entry, &msgq, NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(TIMEOUT >> 1);
+	k_thread_create(&tdata1, tstack1, STACK_SIZE,
+			busy_copy_writer_entry, &msgq, NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(TIMEOUT >> 1);
+	zassert_equal(k_msgq_get(&msgq, &rx, K_NO_WAIT), 0, NULL);
+	zassert_equal(rx, data[0], NULL);
+
+	/**TESTPOINT: nothing else is written while a slot is claimed*/
+	zassert_equal(k_msgq_put(&msgq, &data[0], K_NO_WAIT), -EBUSY, NULL);
+	zassert_equal(k_msgq_put_claim(&msgq, &msg, K_NO_WAIT), -EBUSY, NULL);
+
+	zassert_equal(k_sem_take(&claim_sema, TIMEOUT), 0, NULL);
+	zassert_equal(busy_result[0], 0, NULL);
+
+	/**TESTPOINT: the writer waiting for the claim waits for space next*/
+	zassert_equal(busy_result[1], -1, NULL);
+	zassert_equal(k_msgq_get(&msgq, &rx, K_NO_WAIT), 0, NULL);
+	zassert_equal(rx, data[1], NULL);
+	zassert_equal(k_sem_take(&claim_sema, TIMEOUT), 0, NULL);
+	zassert_equal(busy_result[1], 0, NULL);
+	k_thread_abort(&tdata);
+	k_thread_abort(&tdata1);
+
+	/**TESTPOINT: the claimed slot holds what its claimer wrote*/
+	zassert_equal(k_msgq_get(&msgq, &rx, K_NO_WAIT), 0, NULL);
+	zassert_equal(rx, MSG1, NULL);
+	zassert_equal(k_msgq_get(&msgq, &rx, K_NO_WAIT), 0, NULL);
+	zassert_equal(rx, OVERFLOW_SIZE_MSG, NULL);
+	zassert_equal(k_msgq_num_used_get(&msgq), 0, NULL);
+}
+
+/**
+ * @}
+ */
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <string.h>
+
+#define STACK_SIZE	1024
+#define PIPE_LEN	16
+#define TIMEOUT		100
+
+static unsigned char __aligned(4) data[] = "abcd1234$%^&PIPE";
+
+K_PIPE_DEFINE(claim_pipe, PIPE_LEN, 4);
+static K_THREAD_STACK_DEFINE(claim_stack, STACK_SIZE);
+static struct k_thread claim_thread;
+static K_SEM_DEFINE(claim_sema, 0, 1);
+static K_THREAD_STACK_DEFINE(busy_stack, STACK_SIZE);
+static struct k_thread busy_thread;
+static K_SEM_DEFINE(busy_sema, 0, 1);
+static int busy_result;
+
+static void put_in_place(struct k_pipe *p, const unsigned char *src,
+			 size_t len, size_t expect)
+{
+	void *buf;
+	size_t bytes = len;
+
+	zassert_equal(k_pipe_put_claim(p, &buf, &bytes, K_NO_WAIT), 0, NULL);
+	zassert_equal(bytes, expect, NULL);
+	memcpy(buf, src, bytes);
+	k_pipe_put_finish(p, bytes);
+}
+
+static void get_in_place(struct k_pipe *p, const unsigned char *expect_data,
+			 size_t len, size_t expect)
+{
+	void *buf;
+	size_t bytes = len;
+
+	zassert_equal(k_pipe_get_claim(p, &buf, &bytes, K_NO_WAIT), 0, NULL);
+	zassert_equal(bytes, expect, NULL);
+	zassert_false(memcmp(buf, expect_data, bytes), NULL);
+	k_pipe_get_finish(p, bytes);
+}
+
+static void claim_reader_entry(void *p1, void *p2, void *p3)
+{
+	void *buf;
+	size_t bytes = PIPE_LEN;
+
+	/**TESTPOINT: get claim pending on an empty pipe*/
+	zassert_equal(k_pipe_get_claim(&claim_pipe, &buf, &bytes, K_FOREVER),
+		      0, NULL);
+	zassert_equal(bytes, 4, NULL);
+	zassert_false(memcmp(buf, data, bytes), NULL);
+	k_pipe_get_finish(&claim_pipe, bytes);
+	k_sem_give(&claim_sema);
+}
+
+static void claim_writer_entry(void *p1, void *p2, void *p3)
+{
+	void *buf;
+	size_t bytes = PIPE_LEN;
+
+	/**TESTPOINT: put claim pending on a full pipe*/
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &buf, &bytes, K_FOREVER),
+		      0, NULL);
+	zassert_equal(bytes, 4, NULL);
+	memcpy(buf, data, bytes);
+	k_pipe_put_finish(&claim_pipe, bytes);
+	k_sem_give(&claim_sema);
+}
+
+static void busy_holder_entry(void *p1, void *p2, void *p3)
+{
+	void *buf;
+	size_t bytes = PIPE_LEN;
+
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &buf, &bytes, K_FOREVER),
+		      0, NULL);
+	k_sem_give(&claim_sema);
+
+	/* hold the claim until the test is done with it */
+	k_sem_take(&busy_sema, K_FOREVER);
+	k_pipe_put_finish(&claim_pipe, 0);
+}
+
+static void busy_waiter_entry(void *p1, void *p2, void *p3)
+{
+	void *buf;
+	size_t bytes = PIPE_LEN;
+
+	busy_result = k_pipe_put_claim(&claim_pipe, &buf, &bytes, K_FOREVER);
+	k_sem_give(&claim_sema);
+}
+
+/**
+ * @addtogroup kernel_pipe_tests
+ * @{
+ */
+
+/**
+ * @brief Test writing and reading a pipe's buffer in place
+ * @see k_pipe_put_claim(), k_pipe_put_finish(), k_pipe_get_claim(),
+ * k_pipe_get_finish()
+ */
+void test_pipe_claim(void)
+{
+	unsigned char rx[PIPE_LEN];
+	size_t bytes;
+	void *buf;
+
+	put_in_place(&claim_pipe, data, 12, 12);
+
+	/**TESTPOINT: data written in place can be read with k_pipe_get()*/
+	zassert_equal(k_pipe_get(&claim_pipe, rx, 8, &bytes, 8, K_NO_WAIT),
+		      0, NULL);
+	zassert_false(memcmp(rx, data, 8), NULL);
+
+	/**TESTPOINT: claims stop at the end of the buffer*/
+	put_in_place(&claim_pipe, data, PIPE_LEN, 4);
+	put_in_place(&claim_pipe, data + 4, PIPE_LEN, 8);
+
+	bytes = PIPE_LEN;
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &buf, &bytes, K_NO_WAIT),
+		      -EIO, NULL);
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &buf, &bytes, TIMEOUT),
+		      -EAGAIN, NULL);
+
+	get_in_place(&claim_pipe, data + 8, 4, 4);
+	get_in_place(&claim_pipe, data, PIPE_LEN, 4);
+	get_in_place(&claim_pipe, data + 4, PIPE_LEN, 8);
+
+	bytes = PIPE_LEN;
+	zassert_equal(k_pipe_get_claim(&claim_pipe, &buf, &bytes, K_NO_WAIT),
+		      -EIO, NULL);
+}
+
+/**
+ * @brief Test blocking in place claims
+ * @see k_pipe_put_claim(), k_pipe_get_claim()
+ */
+void test_pipe_claim_pend(void)
+{
+	unsigned char rx[PIPE_LEN];
+	size_t bytes;
+
+	/* reader claims data written later by k_pipe_put() */
+	k_thread_create(&claim_thread, claim_stack, STACK_SIZE,
+			claim_reader_entry, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(TIMEOUT >> 1);
+	zassert_equal(k_pipe_put(&claim_pipe, data, 4, &bytes, 4, K_NO_WAIT),
+		      0, NULL);
+	zassert_equal(k_sem_take(&claim_sema, TIMEOUT), 0, NULL);
+	k_thread_abort(&claim_thread);
+
+	/* writer claims the space freed by k_pipe_get() */
+	zassert_equal(k_pipe_put(&claim_pipe, data, PIPE_LEN, &bytes,
+				 PIPE_LEN, K_NO_WAIT), 0, NULL);
+	k_thread_create(&claim_thread, claim_stack, STACK_SIZE,
+			claim_writer_entry, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(TIMEOUT >> 1);
+	zassert_equal(k_pipe_get(&claim_pipe, rx, 4, &bytes, 4, K_NO_WAIT),
+		      0, NULL);
+	zassert_equal(k_sem_take(&claim_sema, TIMEOUT), 0, NULL);
+	k_thread_abort(&claim_thread);
+
+	zassert_equal(k_pipe_get(&claim_pipe, rx, PIPE_LEN, &bytes,
+				 PIPE_LEN, K_NO_WAIT), 0, NULL);
+	zassert_false(memcmp(rx, data + 4, PIPE_LEN - 4), NULL);
+	zassert_false(memcmp(rx + PIPE_LEN - 4, data, 4), NULL);
+}
+
+/**
+ * @brief Test that a claim is handed to one thread only
+ * @see k_pipe_put_claim(), k_pipe_get_claim()
+ */
+void test_pipe_claim_busy(void)
+{
+	unsigned char rx[PIPE_LEN];
+	size_t bytes, claimed;
+	void *buf;
+
+	/**TESTPOINT: no second claim or copy while a claim is held*/
+	claimed = PIPE_LEN;
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &buf, &claimed,
+				       K_NO_WAIT), 0, NULL);
+	bytes = PIPE_LEN;
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &buf, &bytes, K_NO_WAIT),
+		      -EBUSY, NULL);
+	zassert_equal(k_pipe_put(&claim_pipe, data, 4, &bytes, 4, K_NO_WAIT),
+		      -EBUSY, NULL);
+	zassert_equal(bytes, 0, NULL);
+	k_pipe_put_finish(&claim_pipe, 0);
+
+	zassert_equal(k_pipe_put(&claim_pipe, data, 4, &bytes, 4, K_NO_WAIT),
+		      0, NULL);
+
+	claimed = PIPE_LEN;
+	zassert_equal(k_pipe_get_claim(&claim_pipe, &buf, &claimed,
+				       K_NO_WAIT), 0, NULL);
+	bytes = PIPE_LEN;
+	zassert_equal(k_pipe_get_claim(&claim_pipe, &buf, &bytes, K_NO_WAIT),
+		      -EBUSY, NULL);
+	zassert_equal(k_pipe_get(&claim_pipe, rx, 4, &bytes, 4, K_NO_WAIT),
+		      -EBUSY, NULL);
+	zassert_equal(bytes, 0, NULL);
+	k_pipe_get_finish(&claim_pipe, claimed);
+
+	/**TESTPOINT: of two claims waiting for space, one gets it*/
+	zassert_equal(k_pipe_put(&claim_pipe, data, PIPE_LEN, &bytes,
+				 PIPE_LEN, K_NO_WAIT), 0, NULL);
+	k_thread_create(&claim_thread, claim_stack, STACK_SIZE,
+			busy_holder_entry, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, 0);
+	k_thread_create(&busy_thread, busy_stack, STACK_SIZE,
+			busy_waiter_entry, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(1), 0, 0);
+	k_sleep(TIMEOUT >> 1);
+
+	zassert_equal(k_pipe_get(&claim_pipe, rx, 4, &bytes, 4, K_NO_WAIT),
+		      0, NULL);
+	zassert_equal(k_sem_take(&claim_sema, TIMEOUT), 0, NULL);
+	zassert_equal(k_sem_take(&claim_sema, TIMEOUT), 0, NULL);
+	zassert_equal(busy_result, -EBUSY, NULL);
+
+	k_sem_give(&busy_sema);
+	k_sleep(TIMEOUT >> 1);
+	k_thread_abort(&claim_thread);
+	k_thread_abort(&busy_thread);
+
+	zassert_equal(k_pipe_get(&claim_pipe, rx, PIPE_LEN - 4, &bytes,
+				 PIPE_LEN - 4, K_NO_WAIT), 0, NULL);
+}
+
+/**
+ * @}
+ */
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <kernel.h>
+
+#define NUM_SEMS 8
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+struct fifo_msg {
+	void *private;
+	u32_t msg;
+};
+
+static struct k_poll_set set;
+static struct k_sem sems[NUM_SEMS];
+static struct k_poll_set_event sem_events[NUM_SEMS];
+static struct k_fifo fifo;
+static struct k_poll_set_event fifo_event;
+static struct k_poll_signal signal;
+static struct k_poll_set_event signal_event;
+
+static K_THREAD_STACK_DEFINE(giver_stack, STACK_SIZE);
+static struct k_thread giver_thread;
+
+static void giver(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	k_sem_give(&sems[(int)p1]);
+}
+
+static void init_set(void)
+{
+	k_poll_set_init(&set);
+
+	for (int i = 0; i < NUM_SEMS; i++) {
+		k_sem_init(&sems[i], 0, 1);
+		k_poll_event_init(&sem_events[i].event,
+				  K_POLL_TYPE_SEM_AVAILABLE,
+				  K_POLL_MODE_NOTIFY_ONLY, &sems[i]);
+		zassert_equal(k_poll_set_add(&set, &sem_events[i]), 0, NULL);
+	}
+
+	k_fifo_init(&fifo);
+	k_poll_event_init(&fifo_event.event, K_POLL_TYPE_FIFO_DATA_AVAILABLE,
+			  K_POLL_MODE_NOTIFY_ONLY, &fifo);
+	zassert_equal(k_poll_set_add(&set, &fifo_event), 0, NULL);
+
+	k_poll_signal_init(&signal);
+	k_poll_event_init(&signal_event.event, K_POLL_TYPE_SIGNAL,
+			  K_POLL_MODE_NOTIFY_ONLY, &signal);
+	zassert_equal(k_poll_set_add(&set, &signal_event), 0, NULL);
+}
+
+static void fini_set(void)
+{
+	for (int i = 0; i < NUM_SEMS; i++) {
+		k_poll_set_remove(&set, &sem_events[i]);
+	}
+	k_poll_set_remove(&set, &fifo_event);
+	k_poll_set_remove(&set, &signal_event);
+}
+
+/**
+ * @brief Test that a poll set only reports the events that triggered
+ *
+ * @ingroup kernel_poll_tests
+ *
+ * @see k_poll_set_init(), k_poll_set_add(), k_poll_set_wait(),
+ * k_poll_set_remove()
+ */
+void test_poll_set_ready_subset(void)
+{
+	struct k_poll_set_event *ready[NUM_SEMS + 2];
+	struct fifo_msg msg = { NULL, 0 };
+	int n;
+
+	init_set();
+
+	zassert_equal(k_poll_set_wait(&set, ready, ARRAY_SIZE(ready),
+				      K_NO_WAIT), -EAGAIN, NULL);
+
+	k_sem_give(&sems[3]);
+	k_fifo_put(&fifo, &msg);
+
+	n = k_poll_set_wait(&set, ready, ARRAY_SIZE(ready), K_NO_WAIT);
+	zassert_equal(n, 2, NULL);
+	zassert_equal(ready[0], &sem_events[3], NULL);
+	zassert_equal(ready[0]->event.state, K_POLL_STATE_SEM_AVAILABLE, NULL);
+	zassert_equal(ready[1], &fifo_event, NULL);
+	zassert_equal(ready[1]->event.state, K_POLL_STATE_FIFO_DATA_AVAILABLE,
+		      NULL);
+
+	/* Level-triggered: the FIFO still has data, the semaphore not */
+	zassert_equal(k_sem_take(&sems[3], K_NO_WAIT), 0, NULL);
+	n = k_poll_set_wait(&set, ready, ARRAY_SIZE(ready), K_NO_WAIT);
+	zassert_equal(n, 1, NULL);
+	zassert_equal(ready[0], &fifo_event, NULL);
+
+	zassert_equal(k_fifo_get(&fifo, K_NO_WAIT), &msg, NULL);
+	zassert_equal(k_poll_set_wait(&set, ready, ARRAY_SIZE(ready),
+				      K_NO_WAIT), -EAGAIN, NULL);
+
+	/* At most max events are returned, the rest on the next call */
+	k_sem_give(&sems[1]);
+	k_sem_give(&sems[5]);
+	k_poll_signal_raise(&signal, 0);
+	zassert_equal(k_poll_set_wait(&set, ready, 2, K_NO_WAIT), 2, NULL);
+	zassert_equal(ready[0], &sem_events[1], NULL);
+	zassert_equal(ready[1], &sem_events[5], NULL);
+	k_sem_take(&sems[1], K_NO_WAIT);
+	k_sem_take(&sems[5], K_NO_WAIT);
+	zassert_equal(k_poll_set_wait(&set, ready, 2, K_NO_WAIT), 1, NULL);
+	zassert_equal(ready[0], &signal_event, NULL);
+	zassert_equal(ready[0]->event.state, K_POLL_STATE_SIGNALED, NULL);
+	k_poll_signal_reset(&signal);
+
+	/* Removed events are not reported anymore */
+	k_poll_set_remove(&set, &sem_events[0]);
+	k_sem_give(&sems[0]);
+	zassert_equal(k_poll_set_wait(&set, ready, ARRAY_SIZE(ready),
+				      K_NO_WAIT), -EAGAIN, NULL);
+	zassert_equal(k_poll_set_add(&set, &sem_events[0]), 0, NULL);
+	zassert_equal(k_poll_set_wait(&set, ready, ARRAY_SIZE(ready),
+				      K_NO_WAIT), 1, NULL);
+	zassert_equal(ready[0], &sem_events[0], NULL);
+	k_sem_take(&sems[0], K_NO_WAIT);
+
+	fini_set();
+}
+
+/**
+ * @brief Test waiting on a poll set, with and without timeout
+ *
+ * @ingroup kernel_poll_tests
+ *
+ * @see k_poll_set_wait()
+ */
+void test_poll_set_wait(void)
+{
+	struct k_poll_set_event *ready[4];
+
+	init_set();
+
+	zassert_equal(k_poll_set_wait(&set, ready, ARRAY_SIZE(ready), 10),
+		      -EAGAIN, NULL);
+
+	/* A lower priority thread gives the semaphore once we pend */
+	k_thread_create(&giver_thread, giver_stack, STACK_SIZE, giver,
+			(void *)6, NULL, NULL,
+			k_thread_priority_get(k_current_get()) + 1, 0,
+			K_NO_WAIT);
+
+	zassert_equal(k_poll_set_wait(&set, ready, ARRAY_SIZE(ready),
+				      K_FOREVER), 1, NULL);
+	zassert_equal(ready[0], &sem_events[6], NULL);
+	zassert_equal(k_sem_take(&sems[6], K_NO_WAIT), 0, NULL);
+	k_thread_abort(&giver_thread);
+
+	/* k_poll() waiters still get notified ahead of the set */
+	struct k_poll_event event;
+
+	k_poll_event_init(&event, K_POLL_TYPE_SEM_AVAILABLE,
+			  K_POLL_MODE_NOTIFY_ONLY, &sems[2]);
+	k_thread_create(&giver_thread, giver_stack, STACK_SIZE, giver,
+			(void *)2, NULL, NULL,
+			k_thread_priority_get(k_current_get()) + 1, 0,
+			K_NO_WAIT);
+	zassert_equal(k_poll(&event, 1, K_FOREVER), 0, NULL);
+	zassert_equal(event.state, K_POLL_STATE_SEM_AVAILABLE, NULL);
+	zassert_equal(k_sem_take(&sems[2], K_NO_WAIT), 0, NULL);
+	k_thread_abort(&giver_thread);
+
+	fini_set();
+}
@@ -19,6 +19,7 @@ static qdata_t data[LIST_LEN];
 static qdata_t data_p[LIST_LEN];
 static qdata_t data_l[LIST_LEN];
 static qdata_t data_sl[LIST_LEN];
+static qdata_t data_b[LIST_LEN];
 
 static qdata_t *data_append;
 static qdata_t *data_prepend;
@@ -58,6 +59,14 @@ static void tqueue_append(struct k_queue *pqueue)
 	sys_slist_append(&slist, (sys_snode_t *)&(data_sl[0].snode));
 	sys_slist_append(&slist, (sys_snode_t *)&(data_sl[1].snode));
 	k_queue_merge_slist(pqueue, &slist);
+
+	/**TESTPOINT: queue append batch*/
+	void *batch[LIST_LEN];
+
+	for (int i = 0; i < LIST_LEN; i++) {
+		batch[i] = (void *)&data_b[i];
+	}
+	k_queue_append_batch(pqueue, batch, LIST_LEN);
 }
 
 static void tqueue_get(struct k_queue *pqueue)
@@ -86,6 +95,11 @@ static void tqueue_get(struct k_queue *pqueue)
 		rx_data = k_queue_get(pqueue, K_NO_WAIT);
 		zassert_equal(rx_data, (void *)&data_sl[i], NULL);
 	}
+	/*get queue data from "queue_append_batch"*/
+	for (int i = 0; i < LIST_LEN; i++) {
+		rx_data = k_queue_get(pqueue, K_NO_WAIT);
+		zassert_equal(rx_data, (void *)&data_b[i], NULL);
+	}
 }
 
 /*entry of contexts*/
@@ -225,6 +239,46 @@ void test_queue_get_2threads(void)
 	tqueue_get_2threads(&queue);
 }
 
+static void tqueue_batch_2threads(struct k_queue *pqueue)
+{
+	void *batch[] = { &data_b[0], &data_b[1], &data[0] };
+
+	k_sem_init(&end_sema, 0, 1);
+	k_tid_t tid = k_thread_create(&tdata, tstack, STACK_SIZE,
+				      tThread_get, pqueue, NULL, NULL,
+				      K_PRIO_PREEMPT(0), 0, 0);
+
+	k_tid_t tid1 = k_thread_create(&tdata1, tstack1, STACK_SIZE,
+				       tThread_get, pqueue, NULL, NULL,
+				       K_PRIO_PREEMPT(0), 0, 0);
+
+	/* Wait threads to initialize */
+	k_sleep(10);
+
+	/**TESTPOINT: one batch wakes both waiters, the rest is queued*/
+	k_queue_append_batch(pqueue, batch, ARRAY_SIZE(batch));
+	k_sem_take(&end_sema, K_FOREVER);
+	k_sem_take(&end_sema, K_FOREVER);
+
+	zassert_equal(k_queue_get(pqueue, K_NO_WAIT), (void *)&data[0], NULL);
+	zassert_true(k_queue_is_empty(pqueue), NULL);
+
+	k_thread_abort(tid);
+	k_thread_abort(tid1);
+}
+
+/**
+ * @brief Verify k_queue_append_batch() with pending threads
+ * @ingroup kernel_queue_tests
+ * @see k_queue_init(), k_queue_get(), k_queue_append_batch()
+ */
+void test_queue_append_batch_2threads(void)
+{
+	k_queue_init(&queue);
+
+	tqueue_batch_2threads(&queue);
+}
+
 static void tqueue_alloc(struct k_queue *pqueue)
 {
 	/* Alloc append without resource pool */
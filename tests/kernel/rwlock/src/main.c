@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @brief Tests for reader/writer locks and RCU
+ * @defgroup kernel_rwlock_tests Reader/Writer Locks
+ * @ingroup all_tests
+ * @{
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define TIMEOUT 100
+#define LOW_PRIO K_PRIO_PREEMPT(10)
+#define HIGH_PRIO K_PRIO_PREEMPT(5)
+
+/**TESTPOINT: init via K_RWLOCK_DEFINE*/
+K_RWLOCK_DEFINE(rwlock);
+
+static K_THREAD_STACK_ARRAY_DEFINE(tstack, 2, STACK_SIZE);
+static struct k_thread tdata[2];
+
+static K_SEM_DEFINE(release, 0, 1);
+static volatile int result;
+
+static k_tid_t spawn(int idx, k_thread_entry_t fn, int prio)
+{
+	return k_thread_create(&tdata[idx], tstack[idx], STACK_SIZE, fn,
+			       NULL, NULL, NULL, prio, 0, 0);
+}
+
+static void try_read(void *p1, void *p2, void *p3)
+{
+	result = k_rwlock_read_lock(&rwlock, K_NO_WAIT);
+	if (result == 0) {
+		k_rwlock_read_unlock(&rwlock);
+	}
+}
+
+static void try_write(void *p1, void *p2, void *p3)
+{
+	result = k_rwlock_write_lock(&rwlock, K_NO_WAIT);
+	if (result == 0) {
+		k_rwlock_write_unlock(&rwlock);
+	}
+}
+
+static void timed_read(void *p1, void *p2, void *p3)
+{
+	result = k_rwlock_read_lock(&rwlock, TIMEOUT);
+	if (result == 0) {
+		k_rwlock_read_unlock(&rwlock);
+	}
+}
+
+static void blocking_write(void *p1, void *p2, void *p3)
+{
+	result = k_rwlock_write_lock(&rwlock, K_FOREVER);
+	if (result == 0) {
+		k_rwlock_write_unlock(&rwlock);
+	}
+}
+
+static void write_and_hold(void *p1, void *p2, void *p3)
+{
+	k_rwlock_write_lock(&rwlock, K_FOREVER);
+	k_sem_take(&release, K_FOREVER);
+	k_rwlock_write_unlock(&rwlock);
+}
+
+static void run(k_thread_entry_t fn)
+{
+	k_tid_t tid = spawn(0, fn, HIGH_PRIO);
+
+	k_sleep(TIMEOUT / 2);
+	k_thread_abort(tid);
+}
+
+/**
+ * @brief Test that readers share the lock and exclude writers
+ */
+void test_rwlock_read(void)
+{
+	k_rwlock_init(&rwlock);
+
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_NO_WAIT), 0, NULL);
+
+	/**TESTPOINT: a second reader gets the lock */
+	result = -1;
+	run(try_read);
+	zassert_equal(result, 0, "reader excluded by reader");
+
+	/**TESTPOINT: a writer does not */
+	result = -1;
+	run(try_write);
+	zassert_equal(result, -EBUSY, "writer not excluded by reader");
+
+	k_rwlock_read_unlock(&rwlock);
+
+	result = -1;
+	run(try_write);
+	zassert_equal(result, 0, "writer excluded by released lock");
+}
+
+/**
+ * @brief Test that a writer excludes readers and writers
+ */
+void test_rwlock_write(void)
+{
+	zassert_equal(k_rwlock_write_lock(&rwlock, K_NO_WAIT), 0, NULL);
+
+	result = -1;
+	run(try_read);
+	zassert_equal(result, -EBUSY, "reader not excluded by writer");
+
+	result = -1;
+	run(try_write);
+	zassert_equal(result, -EBUSY, "writer not excluded by writer");
+
+	/**TESTPOINT: waiting for the lock times out */
+	result = -1;
+	spawn(0, timed_read, HIGH_PRIO);
+	k_sleep(2 * TIMEOUT);
+	zassert_equal(result, -EAGAIN, "read lock did not time out");
+
+	k_rwlock_write_unlock(&rwlock);
+
+	result = -1;
+	run(try_read);
+	zassert_equal(result, 0, "reader excluded by released lock");
+}
+
+/**
+ * @brief Test that a waiting writer keeps new readers out
+ */
+void test_rwlock_writer_preference(void)
+{
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_NO_WAIT), 0, NULL);
+
+	result = -1;
+	spawn(1, blocking_write, HIGH_PRIO);
+	k_sleep(TIMEOUT / 2);
+	zassert_equal(result, -1, "writer did not wait for reader");
+
+	/**TESTPOINT: new reader queues behind the waiting writer */
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_NO_WAIT), -EBUSY, NULL);
+
+	/**TESTPOINT: last reader hands the lock to the writer */
+	k_rwlock_read_unlock(&rwlock);
+	k_sleep(TIMEOUT / 2);
+	zassert_equal(result, 0, "writer did not get the lock");
+
+	zassert_equal(k_rwlock_write_lock(&rwlock, K_NO_WAIT), 0, NULL);
+	k_rwlock_write_unlock(&rwlock);
+}
+
+/**
+ * @brief Test priority inheritance of the writer
+ */
+void test_rwlock_prio_inherit(void)
+{
+	k_tid_t writer = spawn(1, write_and_hold, LOW_PRIO);
+
+	k_sleep(TIMEOUT / 2);
+
+	/**TESTPOINT: a waiting reader raises the writer's priority */
+	result = -1;
+	spawn(0, timed_read, HIGH_PRIO);
+	k_sleep(TIMEOUT / 2);
+	zassert_equal(k_thread_priority_get(writer), HIGH_PRIO,
+		      "writer priority not raised");
+
+	/**TESTPOINT: and it drops back once the reader gives up */
+	k_sleep(TIMEOUT);
+	zassert_equal(result, -EAGAIN, NULL);
+	zassert_equal(k_thread_priority_get(writer), LOW_PRIO,
+		      "writer priority not restored");
+
+	k_sem_give(&release);
+	k_sleep(TIMEOUT / 2);
+	zassert_equal(k_rwlock_write_lock(&rwlock, K_NO_WAIT), 0, NULL);
+	k_rwlock_write_unlock(&rwlock);
+}
+
+struct rcu_data {
+	int value;
+};
+
+static struct rcu_data rcu_a = { .value = 1 };
+static struct rcu_data rcu_b = { .value = 2 };
+static struct rcu_data *rcu_ptr = &rcu_a;
+
+/**
+ * @brief Test RCU read-side sections and grace periods
+ */
+void test_rcu(void)
+{
+#ifdef CONFIG_RCU
+	struct rcu_data *old;
+
+	k_rcu_read_lock();
+	zassert_equal(K_RCU_DEREF(rcu_ptr)->value, 1, NULL);
+
+	/**TESTPOINT: read-side sections nest */
+	k_rcu_read_lock();
+	zassert_equal(K_RCU_DEREF(rcu_ptr)->value, 1, NULL);
+	k_rcu_read_unlock();
+	k_rcu_read_unlock();
+
+	old = rcu_ptr;
+	K_RCU_ASSIGN(rcu_ptr, &rcu_b);
+
+	/**TESTPOINT: grace period completes with no readers */
+	k_rcu_synchronize();
+	old->value = 0;
+
+	k_rcu_read_lock();
+	zassert_equal(K_RCU_DEREF(rcu_ptr)->value, 2, NULL);
+	k_rcu_read_unlock();
+#else
+	ztest_test_skip();
+#endif
+}
+
+/**
+ * @}
+ */
+
+void test_main(void)
+{
+	ztest_test_suite(rwlock,
+			 ztest_unit_test(test_rwlock_read),
+			 ztest_unit_test(test_rwlock_write),
+			 ztest_unit_test(test_rwlock_writer_preference),
+			 ztest_unit_test(test_rwlock_prio_inherit),
+			 ztest_unit_test(test_rcu));
+	ztest_run_test_suite(rwlock);
+}
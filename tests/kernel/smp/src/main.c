@@ -434,6 +434,70 @@ void test_wakeup_pending_threads(void)
 	test_wakeup_threads();
 }
 
+static struct k_mutex handoff_mutex;
+static atomic_t mutex_holders;
+static atomic_t mutex_taken;
+static volatile int mutex_overlap;
+
+static void mutex_entry(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	k_mutex_lock(&handoff_mutex, K_FOREVER);
+
+	if (atomic_inc(&mutex_holders) != 0) {
+		mutex_overlap = 1;
+	}
+	/* give the other thread a chance to get in too */
+	k_busy_wait(DELAY_US / 10);
+	atomic_dec(&mutex_holders);
+	atomic_inc(&mutex_taken);
+
+	k_mutex_unlock(&handoff_mutex);
+}
+
+/**
+ * @brief Test a mutex handed over to a waiter while another CPU spins
+ *
+ * @ingroup kernel_smp_tests
+ *
+ * @details A thread pends on a mutex while its owner sleeps, then a
+ * second thread tries to lock it on another CPU while the owner runs,
+ * which spins with CONFIG_MUTEX_ADAPTIVE_SPIN. The owner unlocks,
+ * handing the mutex over to the pended thread: the spinning thread must
+ * not take it as well.
+ */
+void test_mutex_handoff_spin(void)
+{
+	k_mutex_init(&handoff_mutex);
+	mutex_holders = 0;
+	mutex_taken = 0;
+	mutex_overlap = 0;
+
+	k_mutex_lock(&handoff_mutex, K_FOREVER);
+
+	/* the owner is not running, so the waiter pends */
+	k_thread_create(&tthread[0], tstack[0], STACK_SIZE, mutex_entry,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+	k_sleep(THREAD_DELAY * 100);
+
+	/* the owner is running, so the spinner spins */
+	k_thread_create(&tthread[1], tstack[1], STACK_SIZE, mutex_entry,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+	k_busy_wait(DELAY_US / 10);
+
+	k_mutex_unlock(&handoff_mutex);
+	k_sleep(TIMEOUT);
+
+	zassert_false(mutex_overlap, "mutex owned by two threads");
+	zassert_equal(atomic_get(&mutex_taken), 2, "mutex not taken");
+
+	k_thread_abort(&tthread[0]);
+	k_thread_abort(&tthread[1]);
+}
+
 void test_main(void)
 {
 	/* Sleep a bit to guarantee that both CPUs enter an idle
@@ -450,7 +514,8 @@ void test_main(void)
 			 ztest_unit_test(test_yield_threads),
 			 ztest_unit_test(test_sleep_threads),
 			 ztest_unit_test(test_wakeup_threads),
-			 ztest_unit_test(test_wakeup_pending_threads)
+			 ztest_unit_test(test_wakeup_pending_threads),
+			 ztest_unit_test(test_mutex_handoff_spin)
 			 );
 	ztest_run_test_suite(smp);
 }
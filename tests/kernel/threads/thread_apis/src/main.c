@@ -33,6 +33,8 @@ extern void test_essential_thread_operation(void);
 extern void test_threads_priority_set(void);
 extern void test_delayed_thread_abort(void);
 extern void test_k_thread_foreach(void);
+extern void test_threads_runtime_stats(void);
+extern void test_threads_stack_usage(void);
 
 __kernel struct k_thread tdata;
 #define STACK_SIZE (256 + CONFIG_TEST_EXTRA_STACKSIZE)
@@ -225,6 +227,8 @@ void test_main(void)
 			 ztest_user_unit_test(test_customdata_get_set_preempt),
 			 ztest_unit_test(test_k_thread_foreach),
 			 ztest_unit_test(test_thread_name_get_set),
+			 ztest_unit_test(test_threads_runtime_stats),
+			 ztest_unit_test(test_threads_stack_usage),
 			 ztest_unit_test(test_user_mode)
 			 );
 
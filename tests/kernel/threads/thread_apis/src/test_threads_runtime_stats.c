@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define BUSY_MS 50
+#define STACKSIZE (256 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+K_THREAD_STACK_EXTERN(tstack);
+extern struct k_thread tdata;
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+static void busy_entry(void *p1, void *p2, void *p3)
+{
+	k_busy_wait(BUSY_MS * USEC_PER_MSEC);
+}
+
+/**
+ * @ingroup kernel_thread_tests
+ * @brief Test thread runtime statistics
+ *
+ * @details Run a thread that busy waits for BUSY_MS and check that it is
+ * charged at least most of that time, and that the system total covers
+ * it.
+ *
+ * @see k_thread_runtime_stats_get(), k_thread_runtime_stats_all_get()
+ */
+void test_threads_runtime_stats(void)
+{
+	struct k_thread_runtime_stats stats, self, all_before, all_after;
+	u64_t busy = (u64_t)sys_clock_hw_cycles_per_sec() * BUSY_MS /
+		MSEC_PER_SEC;
+
+	zassert_equal(k_thread_runtime_stats_get(NULL, &stats), -EINVAL,
+		      NULL);
+	zassert_equal(k_thread_runtime_stats_all_get(NULL), -EINVAL, NULL);
+
+	k_thread_runtime_stats_all_get(&all_before);
+
+	/**TESTPOINT: a thread is charged the time it ran for */
+	k_thread_create(&tdata, tstack, STACKSIZE, busy_entry, NULL, NULL,
+			NULL, K_PRIO_PREEMPT(1), 0, 0);
+	k_sleep(BUSY_MS * 2);
+
+	zassert_equal(k_thread_runtime_stats_get(&tdata, &stats), 0, NULL);
+	zassert_true(stats.execution_cycles >= busy * 9 / 10,
+		     "thread charged too little");
+
+	/**TESTPOINT: the system total covers the thread's time */
+	k_thread_runtime_stats_all_get(&all_after);
+	zassert_true(all_after.execution_cycles - all_before.execution_cycles
+		     >= stats.execution_cycles, NULL);
+
+	/**TESTPOINT: the calling thread's statistics are up to date */
+	k_thread_runtime_stats_get(k_current_get(), &self);
+	k_busy_wait(BUSY_MS * USEC_PER_MSEC);
+	k_thread_runtime_stats_get(k_current_get(), &stats);
+	zassert_true(stats.execution_cycles - self.execution_cycles >=
+		     busy * 9 / 10, "calling thread charged too little");
+}
+#else
+void test_threads_runtime_stats(void)
+{
+	ztest_test_skip();
+}
+#endif
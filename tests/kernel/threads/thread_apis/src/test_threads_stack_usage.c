@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <string.h>
+
+#define STACKSIZE (256 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define USED_BYTES 128
+
+K_THREAD_STACK_EXTERN(tstack);
+extern struct k_thread tdata;
+
+#ifdef CONFIG_STACK_WATERMARK
+static K_SEM_DEFINE(stack_used, 0, 1);
+static K_SEM_DEFINE(stack_done, 0, 1);
+
+static void stack_entry(void *p1, void *p2, void *p3)
+{
+	volatile u8_t buf[USED_BYTES];
+
+	memset((void *)buf, 0, sizeof(buf));
+	k_sem_give(&stack_used);
+	k_sem_take(&stack_done, K_FOREVER);
+}
+
+/**
+ * @ingroup kernel_thread_tests
+ * @brief Test thread stack high-water marks
+ *
+ * @details Run a thread that puts a USED_BYTES buffer on its stack and
+ * check that the idle thread records a high-water mark for it, and that
+ * k_thread_stack_usage_get() covers the buffer.
+ *
+ * @see k_thread_stack_usage_get()
+ */
+void test_threads_stack_usage(void)
+{
+	struct k_thread_stack_usage usage;
+
+	zassert_equal(k_thread_stack_usage_get(NULL, &usage), -EINVAL, NULL);
+	zassert_equal(k_thread_stack_usage_get(k_current_get(), NULL),
+		      -EINVAL, NULL);
+
+	k_thread_create(&tdata, tstack, STACKSIZE, stack_entry, NULL, NULL,
+			NULL, K_PRIO_PREEMPT(1), 0, 0);
+	k_sem_take(&stack_used, K_FOREVER);
+
+	/**TESTPOINT: the idle thread scans the stacks of all threads, one
+	 * every time it runs
+	 */
+	for (int i = 0; i < 100 && tdata.stack_info.max_used == 0; i++) {
+		k_sleep(10);
+	}
+	zassert_true(tdata.stack_info.max_used > 0,
+		     "stack not scanned from idle");
+
+	/**TESTPOINT: the high-water mark is within the stack */
+	zassert_equal(k_thread_stack_usage_get(&tdata, &usage), 0, NULL);
+	zassert_equal(usage.size, tdata.stack_info.size, NULL);
+	zassert_true(usage.max_used <= usage.size, NULL);
+
+#ifndef CONFIG_ARCH_POSIX
+	/**TESTPOINT: and covers what the thread put on its stack; POSIX
+	 * threads run on stacks of their own
+	 */
+	zassert_true(usage.max_used >= USED_BYTES, "stack usage too low");
+#endif
+
+	k_sem_give(&stack_done);
+	k_thread_abort(&tdata);
+}
+#else
+void test_threads_stack_usage(void)
+{
+	ztest_test_skip();
+}
+#endif
@@ -466,6 +466,54 @@ void test_timer_user_data(void)
 }
 
 
+static struct k_timer slack_timer, fence_timer;
+static s64_t slack_expired;
+
+static void slack_expire(struct k_timer *timer)
+{
+	slack_expired = k_uptime_get();
+}
+
+/**
+ * @brief Test a timer with slack
+ *
+ * A timer with slack may expire late, but never early and never later
+ * than its slack allows. With coalescing enabled in a tickless kernel, it
+ * expires together with a later timer due within its slack.
+ *
+ * @see k_timer_slack_set(), k_wakeup_stats_get()
+ */
+void test_timer_slack(void)
+{
+	s64_t start;
+#if defined(CONFIG_TIMER_COALESCING) && defined(CONFIG_TICKLESS_KERNEL)
+	struct k_wakeup_stats before, after;
+
+	k_wakeup_stats_get(&before);
+#endif
+
+	k_timer_init(&slack_timer, slack_expire, NULL);
+	k_timer_init(&fence_timer, NULL, NULL);
+	k_timer_slack_set(&slack_timer, DURATION);
+	slack_expired = 0;
+
+	start = k_uptime_get();
+	k_timer_start(&slack_timer, PERIOD, 0);
+	k_timer_start(&fence_timer, DURATION, 0);
+	k_timer_status_sync(&fence_timer);
+
+	/** TESTPOINT: expiry delayed by no more than the slack */
+	zassert_true(slack_expired != 0, NULL);
+	zassert_true(WITHIN_ERROR(slack_expired - start, PERIOD, DURATION),
+		     NULL);
+
+#if defined(CONFIG_TIMER_COALESCING) && defined(CONFIG_TICKLESS_KERNEL)
+	/** TESTPOINT: both timers expired in a single wakeup */
+	k_wakeup_stats_get(&after);
+	zassert_true(after.wakeups_saved > before.wakeups_saved, NULL);
+#endif
+}
+
 void test_main(void)
 {
 	ztest_test_suite(timer_api,
@@ -477,6 +525,7 @@ void test_main(void)
 			 ztest_unit_test(test_timer_status_get_anytime),
 			 ztest_unit_test(test_timer_status_sync),
 			 ztest_unit_test(test_timer_k_define),
-			 ztest_unit_test(test_timer_user_data));
+			 ztest_unit_test(test_timer_user_data),
+			 ztest_unit_test(test_timer_slack));
 	ztest_run_test_suite(timer_api);
 }
@@ -20,11 +20,14 @@
 #define NUM_OF_WORK 2
 
 static K_THREAD_STACK_DEFINE(tstack, STACK_SIZE);
-static struct k_work_q workq;
+static K_THREAD_STACK_ARRAY_DEFINE(pool_stacks, 2, STACK_SIZE);
+static struct k_thread pool_extra_thread;
+static struct k_work_q workq, poolq;
 static struct k_work work[NUM_OF_WORK];
 static struct k_delayed_work new_work;
 static struct k_delayed_work delayed_work[NUM_OF_WORK], delayed_work_sleepy;
 static struct k_sem sync_sema;
+static struct k_sem gate_sema;
 
 static void work_sleepy(struct k_work *w)
 {
@@ -37,6 +40,12 @@ static void work_handler(struct k_work *w)
 	k_sem_give(&sync_sema);
 }
 
+static void work_blocked(struct k_work *w)
+{
+	k_sem_take(&gate_sema, K_FOREVER);
+	k_sem_give(&sync_sema);
+}
+
 static void new_work_handler(struct k_work *w)
 {
 	k_sem_give(&sync_sema);
@@ -441,6 +450,78 @@ void test_delayed_work_cancel_isr(void)
 	}
 }
 
+#ifdef CONFIG_WORKQUEUE_STATS
+/* The worker records the time of a handler after it returns, which is
+ * after the handler gave sync_sema, so poll the stats for a while.
+ */
+static bool handler_tracked(k_work_handler_t handler)
+{
+	struct k_work_handler_stats stats[CONFIG_WORKQUEUE_STATS_HANDLERS];
+	s64_t end = k_uptime_get() + TIMEOUT;
+	bool found = false;
+
+	do {
+		int n = k_work_handler_stats_get(stats, ARRAY_SIZE(stats));
+
+		for (int i = 0; i < n; i++) {
+			if (i > 0) {
+				zassert_true(stats[i - 1].max_cycles >=
+					     stats[i].max_cycles,
+					     "not sorted");
+			}
+			if (stats[i].handler == handler) {
+				found = true;
+			}
+		}
+
+		if (!found) {
+			k_sleep(1);
+		}
+	} while (!found && k_uptime_get() < end);
+
+	return found;
+}
+#endif
+
+/**
+ * @brief Test a work queue with more than one worker thread
+ *
+ * A work item blocked in its handler must not hold up the next item
+ * when the queue has a second worker.
+ *
+ * @ingroup kernel_workqueue_tests
+ *
+ * @see k_work_q_start(), k_work_q_worker_add()
+ */
+void test_work_q_worker_add(void)
+{
+	k_sem_init(&gate_sema, 0, 1);
+	k_sem_reset(&sync_sema);
+
+	k_work_q_start(&poolq, pool_stacks[0], STACK_SIZE,
+		       CONFIG_MAIN_THREAD_PRIORITY);
+	k_work_q_worker_add(&poolq, &pool_extra_thread, pool_stacks[1],
+			    STACK_SIZE, CONFIG_MAIN_THREAD_PRIORITY,
+			    K_WORK_Q_ANY_CPU);
+
+	k_work_init(&work[0], work_blocked);
+	k_work_init(&work[1], work_handler);
+	k_work_submit_to_queue(&poolq, &work[0]);
+	k_work_submit_to_queue(&poolq, &work[1]);
+
+	/**TESTPOINT: second item runs while the first one is blocked*/
+	zassert_equal(k_sem_take(&sync_sema, TIMEOUT), 0, NULL);
+	zassert_equal(k_sem_count_get(&gate_sema), 0, NULL);
+
+	k_sem_give(&gate_sema);
+	zassert_equal(k_sem_take(&sync_sema, TIMEOUT), 0, NULL);
+
+#ifdef CONFIG_WORKQUEUE_STATS
+	/**TESTPOINT: the blocked handler was timed*/
+	zassert_true(handler_tracked(work_blocked),
+		     "blocked handler not tracked");
+#endif
+}
 
 void test_main(void)
 {
@@ -459,6 +540,7 @@ void test_main(void)
 			 ztest_unit_test(test_delayed_work_cancel_from_queue_thread),
 			 ztest_unit_test(test_delayed_work_cancel_from_queue_isr),
 			 ztest_unit_test(test_delayed_work_cancel_thread),
-			 ztest_unit_test(test_delayed_work_cancel_isr));
+			 ztest_unit_test(test_delayed_work_cancel_isr),
+			 ztest_unit_test(test_work_q_worker_add));
 	ztest_run_test_suite(workqueue_api);
 }
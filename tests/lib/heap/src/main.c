@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <zephyr.h>
+#include <ztest.h>
+#include <misc/heap.h>
+
+#define HEAP_SIZE 4096
+#define MAX_ALLOCS 128
+
+static char __aligned(SYS_HEAP_ALIGN) heap_mem[HEAP_SIZE];
+static struct sys_heap heap;
+
+static void *ptrs[MAX_ALLOCS];
+static size_t sizes[MAX_ALLOCS];
+
+static u32_t rand_state = 123456789;
+
+/* Deterministic LCG, so failures are reproducible */
+static u32_t next_rand(void)
+{
+	rand_state = rand_state * 1103515245 + 12345;
+
+	return rand_state >> 8;
+}
+
+struct walk_data {
+	int used;
+	int free;
+	size_t free_bytes;
+};
+
+static void walk_cb(void *mem, size_t bytes, bool used, void *user_data)
+{
+	struct walk_data *w = user_data;
+
+	ARG_UNUSED(mem);
+
+	if (used) {
+		w->used++;
+	} else {
+		w->free++;
+		w->free_bytes += bytes;
+	}
+}
+
+static struct walk_data walk(void)
+{
+	struct walk_data w = { 0 };
+
+	sys_heap_walk(&heap, walk_cb, &w);
+
+	return w;
+}
+
+/**
+ * @brief Test that freed neighbours are coalesced
+ *
+ * @see sys_heap_alloc(), sys_heap_free(), sys_heap_walk()
+ */
+void test_heap_coalesce(void)
+{
+	struct sys_heap_stats stats, empty;
+	struct walk_data w;
+	void *a, *b, *c;
+
+	sys_heap_init(&heap, heap_mem, sizeof(heap_mem));
+	sys_heap_stats_get(&heap, &empty);
+
+	w = walk();
+	zassert_true(w.used == 0 && w.free == 1, "fresh heap not one block");
+
+	a = sys_heap_alloc(&heap, 100);
+	b = sys_heap_alloc(&heap, 200);
+	c = sys_heap_alloc(&heap, 300);
+	zassert_true(a && b && c, "allocation failed");
+	zassert_true(((uintptr_t)a & (SYS_HEAP_ALIGN - 1)) == 0,
+		     "misaligned allocation");
+	zassert_true(sys_heap_usable_size(&heap, b) >= 200,
+		     "usable size too small");
+	zassert_true(sys_heap_validate(&heap), "heap corrupted");
+
+	w = walk();
+	zassert_true(w.used == 3 && w.free == 1, "unexpected layout");
+
+	sys_heap_free(&heap, b);
+	w = walk();
+	zassert_true(w.used == 2 && w.free == 2, "hole not created");
+
+	/* Freeing a merges it with the hole left by b */
+	sys_heap_free(&heap, a);
+	w = walk();
+	zassert_true(w.used == 1 && w.free == 2, "prev not coalesced");
+
+	/* Freeing c merges it with both neighbours */
+	sys_heap_free(&heap, c);
+	w = walk();
+	zassert_true(w.used == 0 && w.free == 1, "next not coalesced");
+	zassert_true(sys_heap_validate(&heap), "heap corrupted");
+
+	sys_heap_stats_get(&heap, &stats);
+	zassert_equal(stats.free_bytes, empty.free_bytes, "bytes leaked");
+	zassert_equal(stats.allocated_bytes, 0, "bytes still allocated");
+	zassert_true(stats.max_allocated_bytes >= 600, "bad high-water mark");
+}
+
+/**
+ * @brief Test random allocation and free sequences
+ *
+ * Fills the heap with allocations of random sizes, frees them in random
+ * order and checks the heap's consistency after every operation.
+ *
+ * @see sys_heap_alloc(), sys_heap_free(), sys_heap_validate()
+ */
+void test_heap_random(void)
+{
+	struct sys_heap_stats stats, empty;
+	int count = 0;
+
+	sys_heap_init(&heap, heap_mem, sizeof(heap_mem));
+	sys_heap_stats_get(&heap, &empty);
+
+	for (int round = 0; round < 8; round++) {
+		/* Allocate until full or out of slots */
+		while (count < MAX_ALLOCS) {
+			size_t size = 1 + next_rand() % 256;
+			void *p = sys_heap_alloc(&heap, size);
+
+			zassert_true(sys_heap_validate(&heap),
+				     "heap corrupted on alloc");
+			if (p == NULL) {
+				break;
+			}
+
+			(void)memset(p, count, size);
+			ptrs[count] = p;
+			sizes[count] = size;
+			count++;
+		}
+
+		zassert_true(count > 0, "nothing allocated");
+
+		/* Free a random half, checking the contents survived */
+		for (int n = count / 2; n > 0; n--) {
+			int i = next_rand() % count;
+			u8_t *p = ptrs[i];
+
+			for (size_t j = 0; j < sizes[i]; j++) {
+				zassert_equal(p[j], (u8_t)i,
+					      "allocation overwritten");
+			}
+
+			sys_heap_free(&heap, p);
+			zassert_true(sys_heap_validate(&heap),
+				     "heap corrupted on free");
+
+			/* keep the slots packed, renumbering the moved one */
+			count--;
+			if (i != count) {
+				ptrs[i] = ptrs[count];
+				sizes[i] = sizes[count];
+				(void)memset(ptrs[i], i, sizes[i]);
+			}
+		}
+	}
+
+	while (count > 0) {
+		sys_heap_free(&heap, ptrs[--count]);
+	}
+
+	zassert_true(sys_heap_validate(&heap), "heap corrupted");
+	sys_heap_stats_get(&heap, &stats);
+	zassert_equal(stats.free_bytes, empty.free_bytes, "bytes leaked");
+	zassert_equal(walk().free, 1, "free blocks not coalesced");
+}
+
+/**
+ * @brief Test allocations that cannot be satisfied
+ *
+ * @see sys_heap_alloc()
+ */
+void test_heap_exhaust(void)
+{
+	void *p;
+
+	sys_heap_init(&heap, heap_mem, sizeof(heap_mem));
+
+	zassert_is_null(sys_heap_alloc(&heap, 0), "zero size allocated");
+	zassert_is_null(sys_heap_alloc(&heap, HEAP_SIZE), "too large allocated");
+
+	p = sys_heap_alloc(&heap, HEAP_SIZE / 2);
+	zassert_not_null(p, "half of the heap not available");
+	zassert_is_null(sys_heap_alloc(&heap, HEAP_SIZE / 2),
+			"heap allocated twice");
+
+	sys_heap_free(&heap, p);
+	sys_heap_free(&heap, NULL);
+	zassert_true(sys_heap_validate(&heap), "heap corrupted");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_heap,
+			 ztest_unit_test(test_heap_coalesce),
+			 ztest_unit_test(test_heap_random),
+			 ztest_unit_test(test_heap_exhaust));
+	ztest_run_test_suite(test_heap);
+}
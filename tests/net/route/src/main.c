@@ -428,6 +428,40 @@ static void route_lookup_fail(void)
 			"Route lookup failed for peer address");
 }
 
+static void route_lookup_longest(void)
+{
+	struct in6_addr prefix_32 = { { { 0x20, 0x01, 0x0d, 0xb8 } } };
+	struct in6_addr other_addr = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 1 } } };
+	struct net_route_entry *route_64, *route_32;
+
+	route_64 = net_route_add(my_iface, &generic_addr, 64, &peer_addr);
+	zassert_not_null(route_64, "Route add failed");
+
+	route_32 = net_route_add(my_iface, &prefix_32, 32, &peer_addr);
+	zassert_not_null(route_32, "Route add failed");
+
+	zassert_equal_ptr(net_route_lookup(my_iface, &dest_addr), entry,
+			  "Host route not preferred");
+	zassert_equal_ptr(net_route_lookup(NULL, &dest_addr), entry,
+			  "Host route not preferred on any iface");
+	zassert_equal_ptr(net_route_lookup(my_iface, &generic_addr), route_64,
+			  "Longest prefix not found");
+	zassert_equal_ptr(net_route_lookup(my_iface, &other_addr), route_32,
+			  "Shorter prefix not found");
+	zassert_is_null(net_route_lookup(peer_iface, &generic_addr),
+			"Route found on wrong iface");
+
+	zassert_false(net_route_del(route_64), "Route del failed");
+	zassert_equal_ptr(net_route_lookup(my_iface, &generic_addr), route_32,
+			  "Covering prefix not found");
+	zassert_equal_ptr(net_route_lookup(my_iface, &dest_addr), entry,
+			  "Host route lost");
+
+	zassert_false(net_route_del(route_32), "Route del failed");
+	zassert_is_null(net_route_lookup(my_iface, &generic_addr),
+			"Deleted route found");
+}
+
 static void route_del_nexthop(void)
 {
 	struct in6_addr *nexthop = &peer_addr;
@@ -484,6 +518,7 @@ void test_main(void)
 			ztest_unit_test(route_get_nexthop),
 			ztest_unit_test(route_lookup_ok),
 			ztest_unit_test(route_lookup_fail),
+			ztest_unit_test(route_lookup_longest),
 			ztest_unit_test(route_del),
 			ztest_unit_test(route_add),
 			ztest_unit_test(route_del_nexthop),
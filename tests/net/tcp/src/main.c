@@ -37,6 +37,17 @@
 #include "tcp_internal.h"
 #include "net_private.h"
 
+/* Internals of tcp.c, available with CONFIG_NET_TEST */
+extern void net_tcp_set_options(struct net_tcp *tcp,
+				const struct net_tcp_options *opts);
+extern void net_tcp_ack_update(struct net_tcp *tcp,
+			       struct net_tcp_hdr *tcp_hdr,
+			       const struct net_tcp_options *opts,
+			       u32_t data_len);
+extern void net_tcp_rtt_update(struct net_tcp *tcp, u32_t rtt);
+extern bool net_tcp_ooo_queue(struct net_tcp *tcp, struct net_pkt *pkt);
+extern void net_tcp_ooo_deliver(struct net_context *context);
+
 static bool test_failed;
 static bool fail = true;
 static struct k_sem recv_lock;
@@ -1470,6 +1481,785 @@ static bool test_tcp_seq_validity(void)
 	return true;
 }
 
+/* Get a context of its own for a test that changes the TCP state */
+static struct net_context *get_test_ctx(void)
+{
+	struct sockaddr_in6 addr = my_v6_addr;
+	struct net_context *ctx;
+	int ret;
+
+	ret = net_context_get(AF_INET6, SOCK_STREAM, IPPROTO_TCP, &ctx);
+	if (ret) {
+		DBG("Context get failed (%d)\n", ret);
+		return NULL;
+	}
+
+	addr.sin6_port = htons(MY_TCP_PORT + 1);
+
+	ret = net_context_bind(ctx, (struct sockaddr *)&addr, sizeof(addr));
+	if (ret) {
+		DBG("Context bind failed (%d)\n", ret);
+		net_context_put(ctx);
+		return NULL;
+	}
+
+	return ctx;
+}
+
+/* Build a segment carrying len bytes of data from seq on. Only the
+ * length is set, the data itself does not matter here.
+ */
+static struct net_pkt *get_data_segment(struct net_tcp *tcp, u32_t seq,
+					u16_t len)
+{
+	u32_t send_seq = tcp->send_seq;
+	struct net_pkt *pkt = NULL;
+	int ret;
+
+	tcp->send_seq = seq;
+	ret = net_tcp_prepare_segment(tcp, NET_TCP_PSH | NET_TCP_ACK, NULL, 0,
+				      NULL, (struct sockaddr *)&peer_v6_addr,
+				      &pkt);
+	tcp->send_seq = send_seq;
+
+	if (ret) {
+		DBG("Prepare segment failed (%d)\n", ret);
+		return NULL;
+	}
+
+	net_pkt_set_appdatalen(pkt, len);
+
+	return pkt;
+}
+
+static int get_opts(struct net_pkt *pkt, struct net_tcp_options *opts)
+{
+	struct net_tcp_hdr hdr, *tcp_hdr;
+
+	tcp_hdr = net_tcp_get_hdr(pkt, &hdr);
+	if (!tcp_hdr) {
+		return -EINVAL;
+	}
+
+	(void)memset(opts, 0, sizeof(*opts));
+
+	return net_tcp_parse_opts(pkt, NET_TCP_HDR_LEN(tcp_hdr) -
+				  sizeof(struct net_tcp_hdr), opts);
+}
+
+/* Build a segment with the given options and parse them back */
+static int parse_opts(u8_t *options, size_t optlen,
+		      struct net_tcp_options *opts)
+{
+	struct net_pkt *pkt = NULL;
+	int ret;
+
+	ret = net_tcp_prepare_segment(v6_ctx->tcp, NET_TCP_ACK, options,
+				      optlen, NULL,
+				      (struct sockaddr *)&peer_v6_addr, &pkt);
+	if (ret) {
+		DBG("Prepare segment failed (%d)\n", ret);
+		return ret;
+	}
+
+	ret = get_opts(pkt, opts);
+
+	net_pkt_unref(pkt);
+
+	return ret;
+}
+
+static bool test_tcp_parse_opts(void)
+{
+	u8_t syn[] = {
+		NET_TCP_MSS_OPT, NET_TCP_MSS_SIZE, 0x05, 0xb4,
+		NET_TCP_NOP_OPT, NET_TCP_WINDOW_SCALE_OPT,
+		NET_TCP_WINDOW_SCALE_SIZE, 7,
+		NET_TCP_SACK_PERM_OPT, NET_TCP_SACK_PERM_SIZE,
+		NET_TCP_TIMESTAMP_OPT, NET_TCP_TIMESTAMP_SIZE,
+		0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+	};
+	u8_t sack[] = {
+		NET_TCP_NOP_OPT, NET_TCP_NOP_OPT,
+		NET_TCP_SACK_OPT, 2 + 2 * NET_TCP_SACK_BLOCK_SIZE,
+		0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x20, 0x00,
+		0x00, 0x00, 0x30, 0x00, 0x00, 0x00, 0x40, 0x00,
+	};
+	static u8_t malformed[][8] = {
+		/* Length shorter than the kind and length octets */
+		{ NET_TCP_MSS_OPT, 1, 0x05, 0xb4 },
+		/* Length not the one of the option */
+		{ NET_TCP_MSS_OPT, 3, 0x05, NET_TCP_NOP_OPT },
+		{ NET_TCP_WINDOW_SCALE_OPT, 4, 7, 0 },
+		{ NET_TCP_SACK_PERM_OPT, 3, 0, NET_TCP_NOP_OPT },
+		{ NET_TCP_TIMESTAMP_OPT, 6, 0, 0, 0, 0, NET_TCP_NOP_OPT,
+		  NET_TCP_NOP_OPT },
+		/* SACK with a partial block */
+		{ NET_TCP_SACK_OPT, 6, 0, 0, 0, 0, NET_TCP_NOP_OPT,
+		  NET_TCP_NOP_OPT },
+		/* Longer than what is left of the options */
+		{ NET_TCP_NOP_OPT, NET_TCP_NOP_OPT, NET_TCP_TIMESTAMP_OPT,
+		  NET_TCP_TIMESTAMP_SIZE, 0, 0, 0, 0 },
+		/* Kind without a length */
+		{ NET_TCP_NOP_OPT, NET_TCP_NOP_OPT, NET_TCP_NOP_OPT,
+		  NET_TCP_NOP_OPT, NET_TCP_NOP_OPT, NET_TCP_NOP_OPT,
+		  NET_TCP_NOP_OPT, NET_TCP_MSS_OPT },
+	};
+	struct net_tcp_options opts;
+	int i, ret;
+
+	ret = parse_opts(syn, sizeof(syn), &opts);
+	if (ret) {
+		DBG("SYN options not parsed (%d)\n", ret);
+		return false;
+	}
+
+	if (opts.mss != 1460 || !opts.window_scale_ok ||
+	    opts.window_scale != 7 || !opts.sack_perm || !opts.ts_ok ||
+	    opts.tsval != 0x01020304 || opts.tsecr != 0x05060708 ||
+	    opts.sack_count) {
+		DBG("SYN options mismatch, mss %u ws %d/%u sack %d ts %d "
+		    "%u/%u\n", opts.mss, opts.window_scale_ok,
+		    opts.window_scale, opts.sack_perm, opts.ts_ok,
+		    opts.tsval, opts.tsecr);
+		return false;
+	}
+
+	ret = parse_opts(sack, sizeof(sack), &opts);
+	if (ret) {
+		DBG("SACK option not parsed (%d)\n", ret);
+		return false;
+	}
+
+	if (opts.sack_count != 2 ||
+	    opts.sack[0].start != 0x1000 || opts.sack[0].end != 0x2000 ||
+	    opts.sack[1].start != 0x3000 || opts.sack[1].end != 0x4000) {
+		DBG("SACK blocks mismatch (%u blocks)\n", opts.sack_count);
+		return false;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(malformed); i++) {
+		ret = parse_opts(malformed[i], sizeof(malformed[i]), &opts);
+		if (ret != -EINVAL) {
+			DBG("Malformed option %d accepted (%d)\n", i, ret);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Answer a SYN with the given options, the SYN-ACK must offer the
+ * options the SYN did and no other.
+ */
+static bool check_syn_ack_opts(struct net_tcp *tcp, u8_t *syn, size_t len)
+{
+	struct net_tcp_options peer, opts;
+	struct net_pkt *pkt = NULL;
+	int ret;
+
+	ret = parse_opts(syn, len, &peer);
+	if (ret) {
+		DBG("SYN options not parsed (%d)\n", ret);
+		return false;
+	}
+
+	net_tcp_set_options(tcp, &peer);
+
+	ret = net_tcp_prepare_ack(tcp, (struct sockaddr *)&peer_v6_addr,
+				  &pkt);
+	if (ret) {
+		DBG("Prepare SYN-ACK failed (%d)\n", ret);
+		return false;
+	}
+
+	ret = get_opts(pkt, &opts);
+	net_pkt_unref(pkt);
+
+	if (ret) {
+		DBG("SYN-ACK options not parsed (%d)\n", ret);
+		return false;
+	}
+
+	if (!opts.mss ||
+	    opts.window_scale_ok != (peer.window_scale_ok &&
+				     IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE)) ||
+	    opts.sack_perm != (peer.sack_perm &&
+			       IS_ENABLED(CONFIG_NET_TCP_SACK)) ||
+	    opts.ts_ok != (peer.ts_ok &&
+			   IS_ENABLED(CONFIG_NET_TCP_TIMESTAMPS))) {
+		DBG("SYN-ACK options mismatch, mss %u ws %d sack %d ts %d\n",
+		    opts.mss, opts.window_scale_ok, opts.sack_perm,
+		    opts.ts_ok);
+		return false;
+	}
+
+	if (opts.ts_ok && opts.tsecr != peer.tsval) {
+		DBG("SYN-ACK echoes %u, not %u\n", opts.tsecr, peer.tsval);
+		return false;
+	}
+
+	return true;
+}
+
+static bool test_tcp_syn_ack_opts(void)
+{
+	u8_t syn_all[] = {
+		NET_TCP_MSS_OPT, NET_TCP_MSS_SIZE, 0x05, 0xb4,
+		NET_TCP_SACK_PERM_OPT, NET_TCP_SACK_PERM_SIZE,
+		NET_TCP_TIMESTAMP_OPT, NET_TCP_TIMESTAMP_SIZE,
+		0x00, 0x00, 0x12, 0x34, 0x00, 0x00, 0x00, 0x00,
+		NET_TCP_NOP_OPT, NET_TCP_WINDOW_SCALE_OPT,
+		NET_TCP_WINDOW_SCALE_SIZE, 7,
+	};
+	u8_t syn_sack[] = {
+		NET_TCP_MSS_OPT, NET_TCP_MSS_SIZE, 0x05, 0xb4,
+		NET_TCP_NOP_OPT, NET_TCP_NOP_OPT,
+		NET_TCP_SACK_PERM_OPT, NET_TCP_SACK_PERM_SIZE,
+	};
+	u8_t syn_mss[] = {
+		NET_TCP_MSS_OPT, NET_TCP_MSS_SIZE, 0x05, 0xb4,
+	};
+	struct net_context *ctx;
+	bool ret;
+
+	ctx = get_test_ctx();
+	if (!ctx) {
+		return false;
+	}
+
+	net_tcp_change_state(ctx->tcp, NET_TCP_SYN_RCVD);
+
+	ret = check_syn_ack_opts(ctx->tcp, syn_all, sizeof(syn_all)) &&
+	      check_syn_ack_opts(ctx->tcp, syn_sack, sizeof(syn_sack)) &&
+	      check_syn_ack_opts(ctx->tcp, syn_mss, sizeof(syn_mss));
+
+	net_context_put(ctx);
+
+	return ret;
+}
+
+/* Take an ACK from the peer, with the window it advertised before */
+static void ack_update(struct net_tcp *tcp, u32_t ack,
+		       const struct net_tcp_options *opts)
+{
+	struct net_tcp_hdr hdr = { 0 };
+
+	hdr.flags = NET_TCP_ACK;
+	sys_put_be32(ack, hdr.ack);
+	sys_put_be16(tcp->send_wnd >> tcp->send_wscale, hdr.wnd);
+
+	net_tcp_ack_update(tcp, &hdr, opts, 0);
+}
+
+static bool test_tcp_fast_retransmit(void)
+{
+	struct net_tcp_options opts = { 0 };
+	struct net_context *ctx;
+	struct net_tcp *tcp;
+	struct net_pkt *pkt;
+	u32_t cwnd;
+	int i;
+
+	ctx = get_test_ctx();
+	if (!ctx) {
+		return false;
+	}
+
+	tcp = ctx->tcp;
+
+	/* Four segments of 100 bytes sent from 1000 on */
+	for (i = 0; i < 4; i++) {
+		pkt = get_data_segment(tcp, 1000 + i * 100, 100);
+		if (!pkt) {
+			goto fail;
+		}
+
+		sys_slist_append(&tcp->sent_list, &pkt->sent_list);
+	}
+
+	tcp->send_mss = 100;
+	tcp->send_seq = 1400;
+	tcp->send_una = 1000;
+	tcp->send_nxt = 1400;
+	tcp->send_max = 1400;
+	tcp->recover = 999;
+	tcp->high_rxt = 1000;
+	tcp->send_wnd = 1000;
+	tcp->cwnd = 400;
+	tcp->ssthresh = UINT32_MAX;
+
+	ack_update(tcp, 1000, &opts);
+	ack_update(tcp, 1000, &opts);
+
+	if (tcp->dupacks != 2 || (tcp->flags & NET_TCP_IN_RECOVERY) ||
+	    tcp->cwnd != 400) {
+		DBG("Recovery before the third duplicate ACK\n");
+		goto fail;
+	}
+
+	ack_update(tcp, 1000, &opts);
+
+	if (!(tcp->flags & NET_TCP_IN_RECOVERY) || tcp->ssthresh >= 400 ||
+	    tcp->cwnd != tcp->ssthresh + 3 * 100 || tcp->recover != 1400) {
+		DBG("No fast recovery, ssthresh %u cwnd %u recover %u\n",
+		    tcp->ssthresh, tcp->cwnd, tcp->recover);
+		goto fail;
+	}
+
+	if (tcp->high_rxt != 1100) {
+		DBG("First segment not retransmitted (%u)\n", tcp->high_rxt);
+		goto fail;
+	}
+
+	/* Each further duplicate ACK inflates the window */
+	cwnd = tcp->cwnd;
+	ack_update(tcp, 1000, &opts);
+
+	if (tcp->cwnd != cwnd + 100 || tcp->high_rxt != 1100) {
+		DBG("Window not inflated (%u vs %u)\n", tcp->cwnd, cwnd);
+		goto fail;
+	}
+
+	/* A partial ACK resends the next hole and deflates the window by
+	 * what it acked, less one segment.
+	 */
+	cwnd = tcp->cwnd;
+	ack_update(tcp, 1200, &opts);
+
+	if (!(tcp->flags & NET_TCP_IN_RECOVERY) || tcp->high_rxt != 1300 ||
+	    tcp->cwnd != cwnd - 200 + 100) {
+		DBG("Partial ACK, high_rxt %u cwnd %u\n", tcp->high_rxt,
+		    tcp->cwnd);
+		goto fail;
+	}
+
+	/* A full ACK ends the recovery */
+	ack_update(tcp, 1400, &opts);
+
+	if ((tcp->flags & NET_TCP_IN_RECOVERY) ||
+	    tcp->cwnd > tcp->ssthresh || tcp->dupacks) {
+		DBG("Full ACK, cwnd %u ssthresh %u\n", tcp->cwnd,
+		    tcp->ssthresh);
+		goto fail;
+	}
+
+	net_context_put(ctx);
+
+	return true;
+
+fail:
+	net_context_put(ctx);
+
+	return false;
+}
+
+static bool test_tcp_rtt(void)
+{
+	struct net_context *ctx;
+	struct net_tcp *tcp;
+	bool ret = false;
+
+	ctx = get_test_ctx();
+	if (!ctx) {
+		return false;
+	}
+
+	tcp = ctx->tcp;
+
+	/* RFC 6298 2.2: SRTT = R, RTTVAR = R / 2, RTO = SRTT + 4 RTTVAR */
+	net_tcp_rtt_update(tcp, 100);
+	if (tcp->srtt >> 3 != 100 || tcp->rttvar >> 2 != 50 ||
+	    tcp->rto != 300) {
+		DBG("1) srtt %u rttvar %u rto %u\n", tcp->srtt, tcp->rttvar,
+		    tcp->rto);
+		goto out;
+	}
+
+	/* RFC 6298 2.3: RTTVAR = 3/4 50 + 1/4 100, SRTT = 7/8 100 + 1/8 200 */
+	net_tcp_rtt_update(tcp, 200);
+	if (tcp->srtt != 900 || tcp->rttvar != 250 || tcp->rto != 362) {
+		DBG("2) srtt %u rttvar %u rto %u\n", tcp->srtt, tcp->rttvar,
+		    tcp->rto);
+		goto out;
+	}
+
+	tcp->srtt = 0;
+	net_tcp_rtt_update(tcp, 1);
+	if (tcp->rto != NET_TCP_MIN_RTO) {
+		DBG("3) rto %u below the minimum\n", tcp->rto);
+		goto out;
+	}
+
+	tcp->srtt = 0;
+	net_tcp_rtt_update(tcp, 100000);
+	if (tcp->rto != NET_TCP_MAX_RTO) {
+		DBG("4) rto %u above the maximum\n", tcp->rto);
+		goto out;
+	}
+
+	ret = true;
+
+out:
+	net_context_put(ctx);
+
+	return ret;
+}
+
+static bool test_tcp_close_wait_fin(void)
+{
+	struct net_tcp_hdr hdr, *tcp_hdr;
+	struct net_context *ctx;
+	struct net_tcp *tcp;
+	struct net_pkt *pkt, *fin;
+	int ret;
+
+	ctx = get_test_ctx();
+	if (!ctx) {
+		return false;
+	}
+
+	tcp = ctx->tcp;
+
+	/* 100 bytes from 1000 on still wait for the window. Like
+	 * net_tcp_queue_pkt(), hold the reference of the driver.
+	 */
+	pkt = get_data_segment(tcp, 1000, 100);
+	if (!pkt) {
+		goto fail;
+	}
+
+	net_pkt_ref(pkt);
+	sys_slist_append(&tcp->sent_list, &pkt->sent_list);
+
+	net_tcp_change_state(tcp, NET_TCP_CLOSE_WAIT);
+	tcp->send_seq = 1100;
+	tcp->send_una = 1000;
+	tcp->send_nxt = 1000;
+	tcp->send_max = 1000;
+
+	/* The ACK goes now, the FIN after the data */
+	pkt = NULL;
+	ret = net_tcp_prepare_ack(tcp, (struct sockaddr *)&peer_v6_addr,
+				  &pkt);
+	if (ret) {
+		DBG("Prepare ACK failed (%d)\n", ret);
+		goto fail;
+	}
+
+	tcp_hdr = net_tcp_get_hdr(pkt, &hdr);
+	if (!tcp_hdr || (NET_TCP_FLAGS(tcp_hdr) & NET_TCP_FIN) ||
+	    sys_get_be32(tcp_hdr->seq) != 1000) {
+		DBG("ACK carries a FIN or the wrong sequence number\n");
+		net_pkt_unref(pkt);
+		goto fail;
+	}
+
+	net_pkt_unref(pkt);
+
+	fin = SYS_SLIST_PEEK_TAIL_CONTAINER(&tcp->sent_list, fin, sent_list);
+	tcp_hdr = fin ? net_tcp_get_hdr(fin, &hdr) : NULL;
+	if (!tcp_hdr || !(NET_TCP_FLAGS(tcp_hdr) & NET_TCP_FIN) ||
+	    sys_get_be32(tcp_hdr->seq) != 1100 || tcp->send_seq != 1101 ||
+	    net_tcp_get_state(tcp) != NET_TCP_LAST_ACK) {
+		DBG("FIN not queued behind the data\n");
+		goto fail;
+	}
+
+	net_context_put(ctx);
+
+	return true;
+
+fail:
+	net_context_put(ctx);
+
+	return false;
+}
+
+#if defined(CONFIG_NET_TCP_SACK)
+static bool is_sacked(struct net_tcp *tcp, u32_t start, u32_t end)
+{
+	int i;
+
+	for (i = 0; i < NET_TCP_MAX_SACK; i++) {
+		if (tcp->sacked[i].start == start &&
+		    tcp->sacked[i].end == end) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static int sacked_count(struct net_tcp *tcp)
+{
+	int i, count = 0;
+
+	for (i = 0; i < NET_TCP_MAX_SACK; i++) {
+		if (tcp->sacked[i].start != tcp->sacked[i].end) {
+			count++;
+		}
+	}
+
+	return count;
+}
+
+static void sack_update(struct net_tcp *tcp, u32_t ack,
+			const struct net_tcp_sack_block *blocks, int count)
+{
+	struct net_tcp_options opts = { 0 };
+
+	if (count) {
+		memcpy(opts.sack, blocks, count * sizeof(*blocks));
+		opts.sack_count = count;
+	}
+
+	ack_update(tcp, ack, &opts);
+}
+
+static bool test_tcp_sack_update(void)
+{
+	static const struct net_tcp_sack_block apart[] = {
+		{ 1100, 1200 }, { 1300, 1400 },
+	};
+	static const struct net_tcp_sack_block between[] = {
+		{ 1200, 1300 },
+	};
+	static const struct net_tcp_sack_block below_una[] = {
+		{ 900, 1050 },
+	};
+	static const struct net_tcp_sack_block invalid[] = {
+		{ 500, 600 }, { 2100, 2200 }, { 1600, 1600 },
+	};
+	static const struct net_tcp_sack_block more[] = {
+		{ 1500, 1550 }, { 1600, 1650 }, { 1700, 1750 }, { 1800, 1850 },
+	};
+	struct net_context *ctx;
+	struct net_tcp *tcp;
+	bool ret = false;
+
+	ctx = get_test_ctx();
+	if (!ctx) {
+		return false;
+	}
+
+	tcp = ctx->tcp;
+
+	tcp->send_mss = 100;
+	tcp->send_seq = 2000;
+	tcp->send_una = 1000;
+	tcp->send_nxt = 2000;
+	tcp->send_max = 2000;
+	tcp->send_wnd = 1000;
+	tcp->cwnd = 1000;
+
+	/* Keep the duplicate ACKs below from starting a recovery */
+	tcp->recover = tcp->send_max;
+
+	sack_update(tcp, 1000, apart, ARRAY_SIZE(apart));
+	if (sacked_count(tcp) != 2 || !is_sacked(tcp, 1100, 1200) ||
+	    !is_sacked(tcp, 1300, 1400)) {
+		DBG("1) Blocks not recorded\n");
+		goto out;
+	}
+
+	/* Filling the gap merges the three into one */
+	sack_update(tcp, 1000, between, ARRAY_SIZE(between));
+	if (sacked_count(tcp) != 1 || !is_sacked(tcp, 1100, 1400)) {
+		DBG("2) Blocks not merged\n");
+		goto out;
+	}
+
+	/* The part below the cumulative ACK is left out */
+	sack_update(tcp, 1000, below_una, ARRAY_SIZE(below_una));
+	if (sacked_count(tcp) != 2 || !is_sacked(tcp, 1000, 1050)) {
+		DBG("3) Block not trimmed to the cumulative ACK\n");
+		goto out;
+	}
+
+	sack_update(tcp, 1000, invalid, ARRAY_SIZE(invalid));
+	if (sacked_count(tcp) != 2) {
+		DBG("4) Invalid blocks recorded\n");
+		goto out;
+	}
+
+	/* Out of slots, the lowest blocks go first */
+	sack_update(tcp, 1000, more, ARRAY_SIZE(more));
+	if (sacked_count(tcp) != NET_TCP_MAX_SACK ||
+	    is_sacked(tcp, 1000, 1050) || is_sacked(tcp, 1100, 1400) ||
+	    !is_sacked(tcp, 1800, 1850)) {
+		DBG("5) Lowest blocks not evicted\n");
+		goto out;
+	}
+
+	/* A cumulative ACK drops what it covers */
+	sack_update(tcp, 1620, NULL, 0);
+	if (sacked_count(tcp) != 3 || !is_sacked(tcp, 1620, 1650)) {
+		DBG("6) Blocks not trimmed\n");
+		goto out;
+	}
+
+	ret = true;
+
+out:
+	net_context_put(ctx);
+
+	return ret;
+}
+
+static int ooo_received;
+static u32_t ooo_received_seq;
+
+static void ooo_recv_cb(struct net_context *context, struct net_pkt *pkt,
+			int status, void *user_data)
+{
+	ooo_received++;
+	ooo_received_seq = sys_get_be32(NET_TCP_HDR(pkt)->seq);
+
+	net_pkt_unref(pkt);
+}
+
+static bool test_tcp_ooo_queue(void)
+{
+	struct net_tcp_options opts;
+	struct net_pkt *pkt, *seg[2];
+	struct net_context *ctx;
+	struct net_tcp *tcp;
+	int ret, i;
+
+	ctx = get_test_ctx();
+	if (!ctx) {
+		return false;
+	}
+
+	tcp = ctx->tcp;
+
+	ret = net_tcp_register((struct sockaddr *)&peer_v6_addr, NULL,
+			       PEER_TCP_PORT, MY_TCP_PORT + 1,
+			       test_fail, NULL, &ctx->conn_handler);
+	if (ret) {
+		DBG("TCP register failed (%d)\n", ret);
+		goto fail;
+	}
+
+	ctx->recv_cb = ooo_recv_cb;
+	ooo_received = 0;
+
+	net_tcp_change_state(tcp, NET_TCP_ESTABLISHED);
+	tcp->flags |= NET_TCP_SACK_OK;
+	tcp->send_nxt = tcp->send_seq;
+	tcp->send_ack = 1000;
+
+	/* Two segments past a hole at 1000, received in reverse order */
+	seg[0] = get_data_segment(tcp, 1300, 100);
+	seg[1] = get_data_segment(tcp, 1100, 100);
+	if (!seg[0] || !seg[1]) {
+		goto fail;
+	}
+
+	if (!net_tcp_ooo_queue(tcp, seg[0])) {
+		DBG("Segment at 1300 not held\n");
+		net_pkt_unref(seg[1]);
+		goto fail;
+	}
+
+	if (!net_tcp_ooo_queue(tcp, seg[1])) {
+		DBG("Segment at 1100 not held\n");
+		goto fail;
+	}
+
+	pkt = get_data_segment(tcp, 1100, 100);
+	if (!pkt) {
+		goto fail;
+	}
+
+	if (net_tcp_ooo_queue(tcp, pkt)) {
+		DBG("Duplicate segment held\n");
+		goto fail;
+	}
+
+	net_pkt_unref(pkt);
+
+	/* The ACK reports the blocks held, the latest one first */
+	pkt = NULL;
+	ret = net_tcp_prepare_ack(tcp, (struct sockaddr *)&peer_v6_addr,
+				  &pkt);
+	if (ret) {
+		DBG("Prepare ACK failed (%d)\n", ret);
+		goto fail;
+	}
+
+	ret = get_opts(pkt, &opts);
+	net_pkt_unref(pkt);
+
+	if (ret || opts.sack_count != 2 ||
+	    opts.sack[0].start != 1100 || opts.sack[0].end != 1200 ||
+	    opts.sack[1].start != 1300 || opts.sack[1].end != 1400) {
+		DBG("SACK option mismatch (%d, %u blocks)\n", ret,
+		    opts.sack_count);
+		goto fail;
+	}
+
+	net_tcp_ooo_deliver(ctx);
+	if (ooo_received) {
+		DBG("Segment delivered past the hole\n");
+		goto fail;
+	}
+
+	/* The hole is filled, the segments that follow it go up */
+	tcp->send_ack = 1100;
+	net_tcp_ooo_deliver(ctx);
+	if (ooo_received != 1 || ooo_received_seq != 1100 ||
+	    tcp->send_ack != 1200) {
+		DBG("Segment at 1100 not delivered\n");
+		goto fail;
+	}
+
+	tcp->send_ack = 1300;
+	net_tcp_ooo_deliver(ctx);
+	if (ooo_received != 2 || ooo_received_seq != 1300 ||
+	    tcp->send_ack != 1400 || !sys_slist_is_empty(&tcp->ooo_list)) {
+		DBG("Segment at 1300 not delivered\n");
+		goto fail;
+	}
+
+	/* Only so many segments are held */
+	for (i = 0; i < CONFIG_NET_TCP_MAX_OOO_SEGMENTS; i++) {
+		pkt = get_data_segment(tcp, 1500 + i * 20, 10);
+		if (!pkt) {
+			goto fail;
+		}
+
+		if (!net_tcp_ooo_queue(tcp, pkt)) {
+			DBG("Segment %d not held\n", i);
+			net_pkt_unref(pkt);
+			goto fail;
+		}
+	}
+
+	pkt = get_data_segment(tcp, 1500 + i * 20, 10);
+	if (!pkt) {
+		goto fail;
+	}
+
+	if (net_tcp_ooo_queue(tcp, pkt)) {
+		DBG("Segment held past the limit\n");
+		goto fail;
+	}
+
+	net_pkt_unref(pkt);
+
+	net_context_put(ctx);
+
+	return true;
+
+fail:
+	net_context_put(ctx);
+
+	return false;
+}
+#endif /* CONFIG_NET_TCP_SACK */
+
 static bool test_init_tcp_reply_context(void)
 {
 	struct net_if *iface = peer_iface;
@@ -1754,6 +2544,15 @@ static const struct {
 	{ "test IPv6 TCP seq check", test_v6_seq_check },
 	{ "test IPv4 TCP seq check", test_v4_seq_check },
 	{ "test TCP seq validity", test_tcp_seq_validity },
+	{ "test TCP option parsing", test_tcp_parse_opts },
+	{ "test TCP SYN-ACK options", test_tcp_syn_ack_opts },
+	{ "test TCP fast retransmit", test_tcp_fast_retransmit },
+	{ "test TCP RTT estimate", test_tcp_rtt },
+	{ "test TCP FIN queued in CLOSE_WAIT", test_tcp_close_wait_fin },
+#if defined(CONFIG_NET_TCP_SACK)
+	{ "test TCP SACK scoreboard", test_tcp_sack_update },
+	{ "test TCP out of order queue", test_tcp_ooo_queue },
+#endif
 	{ "test TCP reply context init", test_init_tcp_reply_context },
 	{ "test TCP accept init", test_init_tcp_accept },
 #if 0
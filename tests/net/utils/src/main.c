@@ -539,6 +539,58 @@ void test_utils(void)
 #endif /* CONFIG_NET_IPV4 */
 }
 
+void test_chksum_update(void)
+{
+#if defined(CONFIG_NET_IPV4)
+	struct net_pkt *pkt;
+	struct net_buf *frag;
+	u16_t chksum, updated;
+	u8_t *icmp;
+
+	/* pkt5 has a correct checksum */
+	pkt = net_pkt_get_reserve_rx(0, K_SECONDS(1));
+	zassert_not_null(pkt, "Out of mem");
+
+	frag = net_pkt_get_reserve_rx_data(sizeof(struct net_eth_hdr),
+					   K_SECONDS(1));
+	zassert_not_null(frag, "Out of mem");
+
+	net_pkt_frag_add(pkt, frag);
+
+	net_pkt_set_ll_reserve(pkt, sizeof(struct net_eth_hdr));
+	memcpy(net_pkt_ll(pkt), pkt5, sizeof(pkt5));
+	net_buf_add(frag, sizeof(pkt5) - sizeof(struct net_eth_hdr));
+
+	net_pkt_set_ip_hdr_len(pkt, sizeof(struct net_ipv4_hdr));
+	net_pkt_set_family(pkt, AF_INET);
+	net_pkt_set_ipv6_ext_len(pkt, 0);
+
+	icmp = frag->data + net_pkt_ip_hdr_len(pkt);
+	chksum = UNALIGNED_GET((u16_t *)&icmp[2]);
+
+	/* Rewrite the 16 bit identifier, then the 32 bit identifier and
+	 * sequence number, updating the checksum as it goes
+	 */
+	updated = net_chksum_update_16(chksum, sys_get_be16(&icmp[4]),
+				       0xabcd);
+	sys_put_be16(0xabcd, &icmp[4]);
+
+	updated = net_chksum_update_32(updated, sys_get_be32(&icmp[4]),
+				       0x12345678);
+	sys_put_be32(0x12345678, &icmp[4]);
+
+	icmp[2] = 0;
+	icmp[3] = 0;
+	chksum = ~net_calc_chksum(pkt, IPPROTO_ICMP);
+
+	zassert_equal(updated, chksum,
+		      "Updated chksum 0x%x, should be 0x%x",
+		      ntohs(updated), ntohs(chksum));
+
+	net_pkt_unref(pkt);
+#endif /* CONFIG_NET_IPV4 */
+}
+
 struct net_addr_test_data {
 	sa_family_t family;
 	bool pton;
@@ -1604,6 +1656,7 @@ void test_main(void)
 {
 	ztest_test_suite(test_utils_fn,
 			 ztest_unit_test(test_utils),
+			 ztest_unit_test(test_chksum_update),
 			 ztest_unit_test(test_net_addr),
 			 ztest_unit_test(test_addr_parse),
 			 ztest_unit_test(test_net_pkt_addr_parse));